@@ -0,0 +1,892 @@
+#include "furi_shim.h"
+#include <furi_hal_cortex.h>
+#include <furi_hal_gpio.h>
+#include <furi_hal_i2c.h>
+#include <furi_hal_resources.h>
+#include <furi_hal_usb.h>
+#include <furi_hal_usb_cdc.h>
+#include <storage/storage.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Kernel
+
+static const std::chrono::steady_clock::time_point shim_epoch = std::chrono::steady_clock::now();
+
+uint64_t furi_shim_now_us(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - shim_epoch)
+        .count();
+}
+
+void furi_crash(const char* message) {
+    fprintf(stderr, "furi_crash: %s\n", message);
+    abort();
+}
+
+uint32_t furi_get_tick(void) {
+    return static_cast<uint32_t>(furi_shim_now_us() / 1000);
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+void furi_delay_us(uint32_t microseconds) {
+    std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
+}
+
+// Mutex
+
+struct FuriMutex {
+    std::recursive_timed_mutex mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    return new FuriMutex();
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    delete mutex;
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    if (timeout == FuriWaitForever) {
+        mutex->mutex.lock();
+        return FuriStatusOk;
+    }
+    if (mutex->mutex.try_lock_for(std::chrono::milliseconds(timeout))) return FuriStatusOk;
+    return FuriStatusErrorTimeout;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    mutex->mutex.unlock();
+    return FuriStatusOk;
+}
+
+// Thread
+
+struct FuriThread {
+    FuriThreadCallback callback;
+    void* context;
+    std::thread thread;
+
+    std::mutex flags_lock;
+    std::condition_variable flags_changed;
+    uint32_t flags;
+};
+
+static thread_local FuriThread* shim_current_thread = NULL;
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    UNUSED(name);
+    UNUSED(stack_size);
+    FuriThread* thread = new FuriThread();
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    furi_assert(!thread->thread.joinable());
+    delete thread;
+}
+
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority) {
+    UNUSED(thread);
+    UNUSED(priority);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    thread->thread = std::thread([thread]() {
+        shim_current_thread = thread;
+        thread->callback(thread->context);
+    });
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if (thread->thread.joinable()) thread->thread.join();
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+void furi_thread_yield(void) {
+    std::this_thread::yield();
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    FuriThread* thread = static_cast<FuriThread*>(thread_id);
+    std::lock_guard<std::mutex> guard(thread->flags_lock);
+    thread->flags |= flags;
+    thread->flags_changed.notify_all();
+    return thread->flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    FuriThread* thread = shim_current_thread;
+    furi_assert(thread);
+    std::unique_lock<std::mutex> lock(thread->flags_lock);
+    auto ready = [&]() {
+        return (options & FuriFlagWaitAll) ? (thread->flags & flags) == flags : (thread->flags & flags) != 0;
+    };
+    if (timeout == FuriWaitForever) {
+        thread->flags_changed.wait(lock, ready);
+    } else if (!thread->flags_changed.wait_for(lock, std::chrono::milliseconds(timeout), ready)) {
+        return FuriFlagErrorTimeout;
+    }
+    uint32_t result = thread->flags & flags;
+    if (!(options & FuriFlagNoClear)) thread->flags &= ~result;
+    return result;
+}
+
+// String
+
+struct FuriString {
+    std::string value;
+};
+
+FuriString* furi_string_alloc(void) {
+    return new FuriString();
+}
+
+void furi_string_free(FuriString* string) {
+    delete string;
+}
+
+int furi_string_printf(FuriString* string, const char format[], ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int result = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    string->value = buffer;
+    return result;
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->value.c_str();
+}
+
+// Records
+
+struct Gui {
+    int unused;
+};
+
+static Gui shim_gui;
+
+struct Storage {
+    int unused;
+};
+
+static Storage shim_storage;
+
+void* furi_record_open(const char* name) {
+    if (strcmp(name, RECORD_GUI) == 0) return &shim_gui;
+    if (strcmp(name, RECORD_STORAGE) == 0) return &shim_storage;
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// Storage
+
+struct File {
+    FILE* stream;
+};
+
+static struct {
+    std::mutex lock;
+    std::string root = "ext";
+    uint32_t write_us;
+    uint32_t stall_period;
+    uint32_t stall_us;
+    uint32_t write_index;
+} shim_storage_state;
+
+void furi_shim_storage_set_root(const char* root) {
+    std::lock_guard<std::mutex> guard(shim_storage_state.lock);
+    shim_storage_state.root = root;
+}
+
+void furi_shim_storage_set_latency(uint32_t write_us, uint32_t stall_period, uint32_t stall_us) {
+    std::lock_guard<std::mutex> guard(shim_storage_state.lock);
+    shim_storage_state.write_us = write_us;
+    shim_storage_state.stall_period = stall_period;
+    shim_storage_state.stall_us = stall_us;
+    shim_storage_state.write_index = 0;
+}
+
+bool furi_shim_storage_host_path(const char* path, char* out, size_t size) {
+    if (strncmp(path, "/ext", 4) != 0) return false;
+    std::lock_guard<std::mutex> guard(shim_storage_state.lock);
+    return snprintf(out, size, "%s%s", shim_storage_state.root.c_str(), path + 4) < static_cast<int>(size);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return new File();
+}
+
+void storage_file_free(File* file) {
+    if (file && file->stream) fclose(file->stream);
+    delete file;
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    char host_path[256];
+    if (!furi_shim_storage_host_path(path, host_path, sizeof(host_path))) return false;
+    const char* mode = "rb";
+    if (access_mode & FSAM_WRITE) {
+        if (open_mode == FSOM_CREATE_NEW) {
+            mode = "wxb";
+        } else if (open_mode == FSOM_OPEN_APPEND) {
+            mode = "ab";
+        } else {
+            mode = "wb";
+        }
+    }
+    file->stream = fopen(host_path, mode);
+    return file->stream != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if (!file->stream) return false;
+    bool ok = fclose(file->stream) == 0;
+    file->stream = NULL;
+    return ok;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    return file->stream ? fread(buff, 1, bytes_to_read, file->stream) : 0;
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    uint32_t delay_us;
+    {
+        std::lock_guard<std::mutex> guard(shim_storage_state.lock);
+        uint32_t index = ++shim_storage_state.write_index;
+        bool stall = shim_storage_state.stall_period && (index % shim_storage_state.stall_period) == 0;
+        delay_us = stall ? shim_storage_state.stall_us : shim_storage_state.write_us;
+    }
+    // SD writes block the calling thread without using the CPU
+    if (delay_us) furi_delay_us(delay_us);
+    return file->stream ? fwrite(buff, 1, bytes_to_write, file->stream) : 0;
+}
+
+uint64_t storage_file_size(File* file) {
+    struct stat info;
+    return file->stream && fstat(fileno(file->stream), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[256];
+    struct stat info;
+    return furi_shim_storage_host_path(path, host_path, sizeof(host_path)) && stat(host_path, &info) == 0 &&
+           S_ISREG(info.st_mode);
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[256];
+    if (!furi_shim_storage_host_path(path, host_path, sizeof(host_path))) return false;
+    // Create missing parents too; on the device /ext/apps_data always exists
+    for (char* slash = strchr(host_path + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        mkdir(host_path, 0755);
+        *slash = '/';
+    }
+    return mkdir(host_path, 0755) == 0 || errno == EEXIST;
+}
+
+// I2C
+
+FuriHalI2cBusHandle furi_hal_i2c_handle_external = {1};
+
+#define SHIM_I2C_MAX_DEVICES 4
+
+static struct {
+    std::recursive_mutex lock;
+    Mpu6050Sim* devices[SHIM_I2C_MAX_DEVICES];
+    Mpu6050Bus buses[SHIM_I2C_MAX_DEVICES];
+    size_t device_count;
+    uint8_t pending_reg;
+    uint32_t bus_hz;
+    uint32_t overhead_us;
+    uint32_t error_period;
+    uint32_t transfer_index;
+    uint32_t stuck_clocks; // SCL pulses until the stuck slave lets go of SDA, 0 = free
+    bool scl;              // Pin levels driven while the pins are GPIOs
+    bool sda;
+    FuriShimI2cStats stats;
+} shim_i2c = {};
+
+void furi_shim_i2c_attach(Mpu6050Sim* sim) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    furi_assert(shim_i2c.device_count < SHIM_I2C_MAX_DEVICES);
+    shim_i2c.devices[shim_i2c.device_count] = sim;
+    mpu6050_sim_bind(sim, &shim_i2c.buses[shim_i2c.device_count]);
+    shim_i2c.device_count++;
+}
+
+void furi_shim_i2c_detach(Mpu6050Sim* sim) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    size_t kept = 0;
+    for (size_t i = 0; i < shim_i2c.device_count; i++) {
+        if (shim_i2c.devices[i] == sim) continue;
+        shim_i2c.devices[kept] = shim_i2c.devices[i];
+        mpu6050_sim_bind(shim_i2c.devices[kept], &shim_i2c.buses[kept]);
+        kept++;
+    }
+    shim_i2c.device_count = kept;
+}
+
+void furi_shim_i2c_detach_all(void) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    shim_i2c.device_count = 0;
+}
+
+void furi_shim_i2c_set_timing(uint32_t bus_hz, uint32_t overhead_us) {
+    shim_i2c.bus_hz = bus_hz;
+    shim_i2c.overhead_us = overhead_us;
+}
+
+void furi_shim_i2c_set_error_period(uint32_t period) {
+    shim_i2c.error_period = period;
+}
+
+void furi_shim_i2c_set_stuck(uint32_t clocks) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    shim_i2c.stuck_clocks = clocks;
+}
+
+bool furi_shim_i2c_stuck(void) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    return shim_i2c.stuck_clocks != 0;
+}
+
+void furi_shim_i2c_stats(FuriShimI2cStats* stats) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    *stats = shim_i2c.stats;
+}
+
+void furi_hal_i2c_acquire(FuriHalI2cBusHandle* handle) {
+    UNUSED(handle);
+    shim_i2c.lock.lock();
+}
+
+void furi_hal_i2c_release(FuriHalI2cBusHandle* handle) {
+    UNUSED(handle);
+    shim_i2c.lock.unlock();
+}
+
+// Occupies the (simulated) wire for one transfer
+static void shim_i2c_wire(size_t bytes, bool stop) {
+    shim_i2c.stats.bytes += bytes;
+    if (stop) shim_i2c.stats.transactions++;
+    if (shim_i2c.bus_hz == 0) return;
+
+    uint64_t wire_us = shim_i2c.overhead_us + (bytes * 9ULL * 1000000ULL) / shim_i2c.bus_hz;
+    shim_i2c.stats.busy_us += wire_us;
+    uint64_t until = furi_shim_now_us() + wire_us;
+    while (furi_shim_now_us() < until) {
+        // Busy-wait: sleeps are far coarser than a byte time
+    }
+}
+
+static const Mpu6050Bus* shim_i2c_device(uint16_t address, uint64_t now_us) {
+    for (size_t i = 0; i < shim_i2c.device_count; i++) {
+        Mpu6050Sim* sim = shim_i2c.devices[i];
+        if ((sim->address << 1) != address) continue;
+        if (now_us > sim->time_us) mpu6050_sim_advance(sim, static_cast<uint32_t>(now_us - sim->time_us));
+        return &shim_i2c.buses[i];
+    }
+    return NULL;
+}
+
+// SDA held low: the peripheral never gets the bus and gives up after `timeout`
+static bool shim_i2c_blocked(uint32_t timeout) {
+    if (!shim_i2c.stuck_clocks) return false;
+    shim_i2c.stats.failures++;
+    shim_i2c.stats.timeouts++;
+    furi_delay_ms(timeout);
+    return true;
+}
+
+static bool shim_i2c_inject_error(void) {
+    shim_i2c.transfer_index++;
+    return shim_i2c.error_period && (shim_i2c.transfer_index % shim_i2c.error_period) == 0;
+}
+
+bool furi_hal_i2c_tx_ext(
+    FuriHalI2cBusHandle* handle,
+    uint16_t address,
+    bool ten_bit,
+    const uint8_t* data,
+    size_t size,
+    FuriHalI2cBegin begin,
+    FuriHalI2cEnd end,
+    uint32_t timeout) {
+    UNUSED(handle);
+    UNUSED(ten_bit);
+    UNUSED(begin);
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    if (shim_i2c_blocked(timeout)) return false;
+
+    shim_i2c_wire(size + 1, end == FuriHalI2cEndStop);
+    const Mpu6050Bus* bus = shim_i2c_device(address, furi_shim_now_us());
+    if (!bus || size == 0 || shim_i2c_inject_error()) {
+        shim_i2c.stats.failures++;
+        return false;
+    }
+
+    if (end == FuriHalI2cEndAwaitRestart) {
+        // Register pointer for the following read
+        shim_i2c.pending_reg = data[0];
+        return true;
+    }
+    bool success = bus->write(bus->context, address >> 1, data[0], data + 1, size - 1);
+    if (!success) shim_i2c.stats.failures++;
+    return success;
+}
+
+bool furi_hal_i2c_rx_ext(
+    FuriHalI2cBusHandle* handle,
+    uint16_t address,
+    bool ten_bit,
+    uint8_t* data,
+    size_t size,
+    FuriHalI2cBegin begin,
+    FuriHalI2cEnd end,
+    uint32_t timeout) {
+    UNUSED(handle);
+    UNUSED(ten_bit);
+    UNUSED(begin);
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    if (shim_i2c_blocked(timeout)) return false;
+
+    shim_i2c_wire(size + 1, end == FuriHalI2cEndStop);
+    const Mpu6050Bus* bus = shim_i2c_device(address, furi_shim_now_us());
+    if (!bus || shim_i2c_inject_error()) {
+        shim_i2c.stats.failures++;
+        return false;
+    }
+    bool success = bus->read(bus->context, address >> 1, shim_i2c.pending_reg, data, size);
+    if (!success) shim_i2c.stats.failures++;
+    return success;
+}
+
+// GPIO: the external I2C pins, for bus recovery
+
+const GpioPin gpio_ext_pc0 = {2, 0};
+const GpioPin gpio_ext_pc1 = {2, 1};
+
+void furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed) {
+    UNUSED(gpio);
+    UNUSED(mode);
+    UNUSED(pull);
+    UNUSED(speed);
+}
+
+void furi_hal_gpio_init_ex(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed, GpioAltFn alt_fn) {
+    UNUSED(alt_fn);
+    furi_hal_gpio_init(gpio, mode, pull, speed);
+}
+
+void furi_hal_gpio_write(const GpioPin* gpio, bool state) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    if (gpio == &gpio_ext_pc0) {
+        // Every rising SCL edge clocks one bit out of the stuck slave
+        if (state && !shim_i2c.scl) {
+            shim_i2c.stats.scl_pulses++;
+            if (shim_i2c.stuck_clocks) shim_i2c.stuck_clocks--;
+        }
+        shim_i2c.scl = state;
+    } else if (gpio == &gpio_ext_pc1) {
+        shim_i2c.sda = state;
+    }
+}
+
+bool furi_hal_gpio_read(const GpioPin* gpio) {
+    std::lock_guard<std::recursive_mutex> guard(shim_i2c.lock);
+    if (gpio == &gpio_ext_pc0) return shim_i2c.scl;
+    if (gpio == &gpio_ext_pc1) return shim_i2c.sda && !shim_i2c.stuck_clocks;
+    return false;
+}
+
+// Cortex
+
+#define SHIM_CORE_MHZ 64
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return SHIM_CORE_MHZ;
+}
+
+FuriShimDwt::Counter::operator uint32_t() const {
+    return static_cast<uint32_t>(furi_shim_now_us() * SHIM_CORE_MHZ);
+}
+
+static FuriShimDwt shim_dwt;
+FuriShimDwt* const DWT = &shim_dwt;
+
+// USB
+
+FuriHalUsbInterface usb_cdc_single = {"cdc_single"};
+FuriHalUsbInterface usb_cdc_dual = {"cdc_dual"};
+
+static std::atomic<FuriHalUsbInterface*> shim_usb_config{&usb_cdc_single};
+
+FuriHalUsbInterface* furi_hal_usb_get_config(void) {
+    return shim_usb_config;
+}
+
+bool furi_hal_usb_set_config(FuriHalUsbInterface* new_if, void* ctx) {
+    UNUSED(ctx);
+    shim_usb_config = new_if;
+    return true;
+}
+
+void furi_hal_usb_unlock(void) {
+}
+
+// USB CDC: interface 1 is a pty master. A pump thread plays the USB endpoints:
+// it writes the pending packet when the pty can take it and then reports the
+// transfer done, and reports received bytes. Like a USB host, the pty only
+// takes a little data nobody has read yet, so a reader that stops reading
+// stalls the port quickly.
+
+#define SHIM_CDC_PTY_IF 1
+#define SHIM_CDC_UNREAD_MAX 1024
+
+static struct {
+    std::mutex lock;
+    int master = -1;
+    int slave = -1; // Held open so the master keeps working between readers
+    std::thread pump;
+    std::atomic<bool> running;
+    CdcCallbacks* callbacks;
+    void* context;
+    uint8_t ctrl_lines;
+    uint8_t tx[CDC_DATA_SZ];
+    size_t tx_size;
+    size_t tx_done;
+    uint8_t rx[CDC_DATA_SZ];
+    size_t rx_size;
+} shim_cdc;
+
+static void shim_cdc_pump(void) {
+    while (shim_cdc.running) {
+        struct pollfd poller = {shim_cdc.master, POLLIN, 0};
+        {
+            std::lock_guard<std::mutex> guard(shim_cdc.lock);
+            int unread = 0;
+            ioctl(shim_cdc.slave, FIONREAD, &unread);
+            if (shim_cdc.tx_size && unread < SHIM_CDC_UNREAD_MAX) poller.events |= POLLOUT;
+            if (shim_cdc.rx_size) poller.events &= ~POLLIN; // Not collected yet
+        }
+        if (poll(&poller, 1, 5) <= 0) continue;
+
+        std::lock_guard<std::mutex> guard(shim_cdc.lock);
+        if ((poller.revents & POLLOUT) && shim_cdc.tx_size) {
+            ssize_t written =
+                write(shim_cdc.master, &shim_cdc.tx[shim_cdc.tx_done], shim_cdc.tx_size - shim_cdc.tx_done);
+            if (written > 0) shim_cdc.tx_done += written;
+            if (shim_cdc.tx_done == shim_cdc.tx_size) {
+                shim_cdc.tx_size = 0;
+                shim_cdc.tx_done = 0;
+                if (shim_cdc.callbacks && shim_cdc.callbacks->tx_ep_callback) {
+                    shim_cdc.callbacks->tx_ep_callback(shim_cdc.context);
+                }
+            }
+        }
+        if ((poller.revents & POLLIN) && !shim_cdc.rx_size) {
+            ssize_t size = read(shim_cdc.master, shim_cdc.rx, sizeof(shim_cdc.rx));
+            if (size > 0) {
+                shim_cdc.rx_size = size;
+                if (shim_cdc.callbacks && shim_cdc.callbacks->rx_ep_callback) {
+                    shim_cdc.callbacks->rx_ep_callback(shim_cdc.context);
+                }
+            }
+        }
+    }
+}
+
+bool furi_shim_cdc_open_pty(char* path, size_t size) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) return false;
+    if (grantpt(master) != 0 || unlockpt(master) != 0 || snprintf(path, size, "%s", ptsname(master)) >= (int)size) {
+        close(master);
+        return false;
+    }
+    int slave = open(path, O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        close(master);
+        return false;
+    }
+    struct termios mode;
+    tcgetattr(slave, &mode);
+    cfmakeraw(&mode);
+    tcsetattr(slave, TCSANOW, &mode);
+
+    shim_cdc.master = master;
+    shim_cdc.slave = slave;
+    shim_cdc.tx_size = 0;
+    shim_cdc.tx_done = 0;
+    shim_cdc.rx_size = 0;
+    shim_cdc.running = true;
+    shim_cdc.pump = std::thread(shim_cdc_pump);
+    return true;
+}
+
+void furi_shim_cdc_close(void) {
+    if (shim_cdc.master < 0) return;
+    shim_cdc.running = false;
+    shim_cdc.pump.join();
+    close(shim_cdc.slave);
+    close(shim_cdc.master);
+    shim_cdc.slave = -1;
+    shim_cdc.master = -1;
+}
+
+void furi_shim_cdc_set_ctrl_line(uint8_t ctrl_lines) {
+    std::lock_guard<std::mutex> guard(shim_cdc.lock);
+    shim_cdc.ctrl_lines = ctrl_lines;
+    if (shim_cdc.callbacks && shim_cdc.callbacks->ctrl_line_callback) {
+        shim_cdc.callbacks->ctrl_line_callback(shim_cdc.context, static_cast<CdcCtrlLine>(ctrl_lines));
+    }
+}
+
+void furi_hal_cdc_set_callbacks(uint8_t if_num, CdcCallbacks* cb, void* context) {
+    if (if_num != SHIM_CDC_PTY_IF) return;
+    std::lock_guard<std::mutex> guard(shim_cdc.lock);
+    shim_cdc.callbacks = cb;
+    shim_cdc.context = context;
+}
+
+uint8_t furi_hal_cdc_get_ctrl_line_state(uint8_t if_num) {
+    if (if_num != SHIM_CDC_PTY_IF) return 0;
+    std::lock_guard<std::mutex> guard(shim_cdc.lock);
+    return shim_cdc.ctrl_lines;
+}
+
+void furi_hal_cdc_send(uint8_t if_num, uint8_t* buf, uint16_t len) {
+    if (if_num != SHIM_CDC_PTY_IF || shim_cdc.master < 0) return;
+    furi_check(len <= CDC_DATA_SZ);
+    std::lock_guard<std::mutex> guard(shim_cdc.lock);
+    // Like the endpoint, one packet at a time: the caller waits for tx_ep_callback
+    memcpy(shim_cdc.tx, buf, len);
+    shim_cdc.tx_size = len;
+    shim_cdc.tx_done = 0;
+}
+
+int32_t furi_hal_cdc_receive(uint8_t if_num, uint8_t* buf, uint16_t max_len) {
+    if (if_num != SHIM_CDC_PTY_IF) return 0;
+    std::lock_guard<std::mutex> guard(shim_cdc.lock);
+    size_t size = shim_cdc.rx_size < max_len ? shim_cdc.rx_size : max_len;
+    memcpy(buf, shim_cdc.rx, size);
+    memmove(shim_cdc.rx, &shim_cdc.rx[size], shim_cdc.rx_size - size);
+    shim_cdc.rx_size -= size;
+    return static_cast<int32_t>(size);
+}
+
+// GUI
+
+struct Canvas {
+    uint32_t operations;
+    std::string text; // Strings drawn since the last canvas_clear, one per line
+};
+
+struct ViewPort {
+    ViewPortDrawCallback draw_callback;
+    void* draw_context;
+    ViewPortInputCallback input_callback;
+    void* input_context;
+};
+
+static struct {
+    std::mutex lock;
+    ViewPort* view_port;
+    Canvas canvas;
+    FuriShimDrawHook draw_hook;
+    void* draw_hook_context;
+} shim_gui_state = {};
+
+ViewPort* view_port_alloc(void) {
+    return new ViewPort();
+}
+
+void view_port_free(ViewPort* view_port) {
+    delete view_port;
+}
+
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context) {
+    view_port->draw_callback = callback;
+    view_port->draw_context = context;
+}
+
+void view_port_input_callback_set(ViewPort* view_port, ViewPortInputCallback callback, void* context) {
+    view_port->input_callback = callback;
+    view_port->input_context = context;
+}
+
+void view_port_update(ViewPort* view_port) {
+    // The real GUI draws asynchronously on its own thread; drawing synchronously
+    // here keeps the measurement of draw cost simple.
+    std::lock_guard<std::mutex> guard(shim_gui_state.lock);
+    if (!view_port->draw_callback) return;
+    uint64_t start = furi_shim_now_us();
+    view_port->draw_callback(&shim_gui_state.canvas, view_port->draw_context);
+    uint64_t draw_us = furi_shim_now_us() - start;
+    if (shim_gui_state.draw_hook) shim_gui_state.draw_hook(draw_us, shim_gui_state.draw_hook_context);
+}
+
+void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
+    UNUSED(gui);
+    UNUSED(layer);
+    std::lock_guard<std::mutex> guard(shim_gui_state.lock);
+    shim_gui_state.view_port = view_port;
+}
+
+void gui_remove_view_port(Gui* gui, ViewPort* view_port) {
+    UNUSED(gui);
+    std::lock_guard<std::mutex> guard(shim_gui_state.lock);
+    if (shim_gui_state.view_port == view_port) shim_gui_state.view_port = NULL;
+}
+
+void furi_shim_set_draw_hook(FuriShimDrawHook hook, void* context) {
+    std::lock_guard<std::mutex> guard(shim_gui_state.lock);
+    shim_gui_state.draw_hook = hook;
+    shim_gui_state.draw_hook_context = context;
+}
+
+void furi_shim_screen_text(char* out, size_t size) {
+    std::lock_guard<std::mutex> guard(shim_gui_state.lock);
+    snprintf(out, size, "%s", shim_gui_state.canvas.text.c_str());
+}
+
+void furi_shim_send_input(InputKey key, InputType type) {
+    ViewPort* view_port;
+    {
+        std::lock_guard<std::mutex> guard(shim_gui_state.lock);
+        view_port = shim_gui_state.view_port;
+    }
+    if (!view_port || !view_port->input_callback) return;
+    InputEvent event = {0, key, type};
+    view_port->input_callback(&event, view_port->input_context);
+}
+
+// Canvas: drawing is only counted, there is no frame buffer
+
+void canvas_clear(Canvas* canvas) {
+    canvas->operations++;
+    canvas->text.clear();
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    UNUSED(color);
+    canvas->operations++;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(font);
+    canvas->operations++;
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    UNUSED(x);
+    UNUSED(y);
+    canvas->operations++;
+    canvas->text += str;
+    canvas->text += '\n';
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    canvas->operations++;
+    canvas->text += str;
+    canvas->text += '\n';
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+    canvas->operations++;
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+    canvas->operations++;
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    UNUSED(x1);
+    UNUSED(y1);
+    UNUSED(x2);
+    UNUSED(y2);
+    canvas->operations++;
+}
+
+void canvas_draw_dot(Canvas* canvas, int32_t x, int32_t y) {
+    UNUSED(x);
+    UNUSED(y);
+    canvas->operations++;
+}
+
+void canvas_draw_circle(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(radius);
+    canvas->operations++;
+}
+
+void canvas_draw_disc(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(radius);
+    canvas->operations++;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <furi.h>
+#include <gui/gui.h>
+#include "mpu6050_sim.h"
+
+// Host-only controls for the furi/HAL shim, used by the benchmark harness.
+
+// Microseconds since the shim started (the time base of furi_get_tick as well)
+uint64_t furi_shim_now_us(void);
+
+// Puts a simulated device on the external I2C bus. Transfers to its address are
+// forwarded to the model after its clock has been advanced to the current time.
+void furi_shim_i2c_attach(Mpu6050Sim* sim);
+void furi_shim_i2c_detach(Mpu6050Sim* sim);
+void furi_shim_i2c_detach_all(void);
+
+// Wire timing: every transfer busy-waits for (address + payload) * 9 bit times
+// at `bus_hz` plus `overhead_us`. A bus_hz of 0 makes transfers instantaneous.
+void furi_shim_i2c_set_timing(uint32_t bus_hz, uint32_t overhead_us);
+
+// Makes one in every `period` transfers fail (0 disables injection)
+void furi_shim_i2c_set_error_period(uint32_t period);
+
+// A slave holds SDA low until SCL has been clocked `clocks` more times, like
+// one cut off in the middle of a byte; every transfer meanwhile fails after its
+// full timeout. 0 frees the bus.
+void furi_shim_i2c_set_stuck(uint32_t clocks);
+bool furi_shim_i2c_stuck(void);
+
+typedef struct {
+    uint32_t transactions; // START..STOP sequences
+    uint32_t failures;     // Transfers that returned false
+    uint32_t timeouts;     // Failures that waited out the timeout on a stuck bus
+    uint32_t scl_pulses;   // SCL clocked by hand
+    uint64_t bytes;        // Bytes on the wire including address bytes
+    uint64_t busy_us;      // Simulated wire time
+} FuriShimI2cStats;
+
+void furi_shim_i2c_stats(FuriShimI2cStats* stats);
+
+// Host directory that stands in for the SD card's /ext (default: ./ext)
+void furi_shim_storage_set_root(const char* root);
+
+// Translates an /ext/... path into a host path under the storage root
+bool furi_shim_storage_host_path(const char* path, char* out, size_t size);
+
+// SD card timing: every file write sleeps `write_us`, and one in every
+// `stall_period` writes sleeps `stall_us` instead (0 disables stalls)
+void furi_shim_storage_set_latency(uint32_t write_us, uint32_t stall_period, uint32_t stall_us);
+
+// Called after every completed draw with the draw duration
+typedef void (*FuriShimDrawHook)(uint64_t draw_us, void* context);
+void furi_shim_set_draw_hook(FuriShimDrawHook hook, void* context);
+
+// Text of the last drawn frame, one drawn string per line
+void furi_shim_screen_text(char* out, size_t size);
+
+// Delivers an input event to the view port's input callback
+void furi_shim_send_input(InputKey key, InputType type);
+
+// USB CDC interface 1 becomes a pseudo terminal; `path` receives the name of the
+// terminal a reader opens. The port stays closed (no DTR) until set below.
+bool furi_shim_cdc_open_pty(char* path, size_t size);
+void furi_shim_cdc_close(void);
+
+// Control lines as set by the host (CdcCtrlLine bits), reported to the callbacks
+void furi_shim_cdc_set_ctrl_line(uint8_t ctrl_lines);
@@ -0,0 +1,106 @@
+#pragma once
+// Host stand-in for the Flipper Zero furi core API, covering what the app uses.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define furi_assert(x)                                                          \
+    do {                                                                        \
+        if (!(x)) furi_crash("furi_assert failed: " #x);                        \
+    } while (0)
+#define furi_check(x) furi_assert(x)
+
+void furi_crash(const char* message) __attribute__((noreturn));
+
+// Kernel
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+uint32_t furi_kernel_get_tick_frequency(void);
+void furi_delay_ms(uint32_t milliseconds);
+void furi_delay_us(uint32_t microseconds);
+
+// Mutex
+typedef struct FuriMutex FuriMutex;
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+// Thread
+typedef struct FuriThread FuriThread;
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef enum {
+    FuriThreadPriorityNone = 0,
+    FuriThreadPriorityIdle = 1,
+    FuriThreadPriorityLowest = 14,
+    FuriThreadPriorityLow = 15,
+    FuriThreadPriorityNormal = 16,
+    FuriThreadPriorityHigh = 17,
+    FuriThreadPriorityHighest = 18,
+    FuriThreadPriorityIsr = 32,
+} FuriThreadPriority;
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+
+typedef void* FuriThreadId;
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+void furi_thread_yield(void);
+
+// Thread flags
+typedef enum {
+    FuriFlagWaitAny = 0x00000000U,
+    FuriFlagWaitAll = 0x00000001U,
+    FuriFlagNoClear = 0x00000002U,
+    FuriFlagError = 0x80000000U,
+    FuriFlagErrorTimeout = 0xFFFFFFFEU,
+} FuriFlag;
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+// String
+typedef struct FuriString FuriString;
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+int furi_string_printf(FuriString* string, const char format[], ...)
+    __attribute__((format(printf, 2, 3)));
+const char* furi_string_get_cstr(const FuriString* string);
+
+// Records
+#define RECORD_GUI "gui"
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
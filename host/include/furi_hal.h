@@ -0,0 +1,9 @@
+#pragma once
+#include <furi.h>
+#include <furi_hal_i2c.h>
+#include <furi_hal_gpio.h>
+#include <furi_hal_resources.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_cortex.h>
+#include <furi_hal_usb.h>
+#include <furi_hal_usb_cdc.h>
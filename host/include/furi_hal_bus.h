@@ -0,0 +1,2 @@
+#pragma once
+// Host stand-in: peripheral clocks need no management on the host.
@@ -0,0 +1,22 @@
+#pragma once
+// Host stand-in for the Cortex-M4 cycle counter. DWT->CYCCNT reads the host
+// clock scaled to the STM32WB's 64 MHz core clock.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+
+#ifdef __cplusplus
+}
+
+struct FuriShimDwt {
+    struct Counter {
+        operator uint32_t() const;
+    } CYCCNT;
+};
+
+extern FuriShimDwt* const DWT;
+#endif
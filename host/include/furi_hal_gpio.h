@@ -0,0 +1,51 @@
+#pragma once
+#include <furi.h>
+
+// Host stand-in: only what bus recovery uses. The external I2C pins are wired
+// to the shim's bus model, see furi_shim_i2c_set_stuck().
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int port;
+    uint16_t pin;
+} GpioPin;
+
+typedef enum {
+    GpioModeInput,
+    GpioModeOutputPushPull,
+    GpioModeOutputOpenDrain,
+    GpioModeAltFunctionPushPull,
+    GpioModeAltFunctionOpenDrain,
+    GpioModeAnalog,
+} GpioMode;
+
+typedef enum {
+    GpioPullNo,
+    GpioPullUp,
+    GpioPullDown,
+} GpioPull;
+
+typedef enum {
+    GpioSpeedLow,
+    GpioSpeedMedium,
+    GpioSpeedHigh,
+    GpioSpeedVeryHigh,
+} GpioSpeed;
+
+typedef enum {
+    GpioAltFn4I2C1 = 4,
+    GpioAltFn4I2C3 = 4,
+    GpioAltFnUnused = 16,
+} GpioAltFn;
+
+void furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed);
+void furi_hal_gpio_init_ex(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed, GpioAltFn alt_fn);
+void furi_hal_gpio_write(const GpioPin* gpio, bool state);
+bool furi_hal_gpio_read(const GpioPin* gpio);
+
+#ifdef __cplusplus
+}
+#endif
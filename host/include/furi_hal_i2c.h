@@ -0,0 +1,51 @@
+#pragma once
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int id;
+} FuriHalI2cBusHandle;
+
+typedef enum {
+    FuriHalI2cBeginStart,
+    FuriHalI2cBeginRestart,
+    FuriHalI2cBeginResume,
+} FuriHalI2cBegin;
+
+typedef enum {
+    FuriHalI2cEndStop,
+    FuriHalI2cEndAwaitRestart,
+    FuriHalI2cEndPause,
+} FuriHalI2cEnd;
+
+extern FuriHalI2cBusHandle furi_hal_i2c_handle_external;
+
+void furi_hal_i2c_acquire(FuriHalI2cBusHandle* handle);
+void furi_hal_i2c_release(FuriHalI2cBusHandle* handle);
+
+bool furi_hal_i2c_tx_ext(
+    FuriHalI2cBusHandle* handle,
+    uint16_t address,
+    bool ten_bit,
+    const uint8_t* data,
+    size_t size,
+    FuriHalI2cBegin begin,
+    FuriHalI2cEnd end,
+    uint32_t timeout);
+
+bool furi_hal_i2c_rx_ext(
+    FuriHalI2cBusHandle* handle,
+    uint16_t address,
+    bool ten_bit,
+    uint8_t* data,
+    size_t size,
+    FuriHalI2cBegin begin,
+    FuriHalI2cEnd end,
+    uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+#include <furi_hal_gpio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External header: SCL and SDA of the external I2C bus
+extern const GpioPin gpio_ext_pc0;
+extern const GpioPin gpio_ext_pc1;
+
+#ifdef __cplusplus
+}
+#endif
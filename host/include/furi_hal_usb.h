@@ -0,0 +1,23 @@
+#pragma once
+// Host stand-in for the USB device configuration. Only the interface identity
+// matters: the CDC shim ignores which configuration is active.
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char* name;
+} FuriHalUsbInterface;
+
+extern FuriHalUsbInterface usb_cdc_single;
+extern FuriHalUsbInterface usb_cdc_dual;
+
+FuriHalUsbInterface* furi_hal_usb_get_config(void);
+bool furi_hal_usb_set_config(FuriHalUsbInterface* new_if, void* ctx);
+void furi_hal_usb_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+// Host stand-in for the USB CDC ports. Interface 1 is backed by a pseudo
+// terminal (see furi_shim_cdc_open_pty); interface 0 accepts and drops data.
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CDC_DATA_SZ 64
+
+typedef enum {
+    CdcStateDisconnected,
+    CdcStateConnected,
+} CdcState;
+
+typedef enum {
+    CdcCtrlLineDTR = (1 << 0),
+    CdcCtrlLineRTS = (1 << 1),
+} CdcCtrlLine;
+
+typedef struct {
+    void (*tx_ep_callback)(void* context);
+    void (*rx_ep_callback)(void* context);
+    void (*state_callback)(void* context, CdcState state);
+    void (*ctrl_line_callback)(void* context, CdcCtrlLine ctrl_lines);
+    void (*config_callback)(void* context, void* config);
+} CdcCallbacks;
+
+void furi_hal_cdc_set_callbacks(uint8_t if_num, CdcCallbacks* cb, void* context);
+uint8_t furi_hal_cdc_get_ctrl_line_state(uint8_t if_num);
+void furi_hal_cdc_send(uint8_t if_num, uint8_t* buf, uint16_t len);
+int32_t furi_hal_cdc_receive(uint8_t if_num, uint8_t* buf, uint16_t max_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+// Host stand-in for the storage service: /ext/... paths map to a directory on
+// the host file system (see furi_shim_storage_set_root).
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RECORD_STORAGE "storage"
+#define EXT_PATH(path) "/ext/" path
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+typedef enum {
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+    FSAM_READ_WRITE = FSAM_READ | FSAM_WRITE,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read);
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write);
+uint64_t storage_file_size(File* file);
+bool storage_file_exists(Storage* storage, const char* path);
+bool storage_simply_mkdir(Storage* storage, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1835 @@
+// Acquisition benchmark: runs the unmodified app against the simulated MPU-6050
+// and reports throughput, bus cost per sample and sample-to-display latency.
+#include "furi_shim.h"
+#include <math.h>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mpu6050_block.h"
+#include "mpu6050_decimator.h"
+#include "mpu6050_fft.h"
+#include "mpu6050_filter.h"
+#include "mpu6050_fusion.h"
+#include "mpu6050_log.h"
+#include "mpu6050_multi.h"
+#include "mpu6050_render.h"
+#include "mpu6050_settings.h"
+#include "mpu6050_stats.h"
+#include "mpu6050_timebase.h"
+#include "mpu6050_trigger.h"
+#include "mpu6050_units.h"
+
+extern "C" int32_t mpu6050_reader_app(void* p);
+
+// Checks that failed; main() returns nonzero when there are any
+static uint32_t bench_failures;
+
+// One check of a bench's results: a failure is printed and fails the run
+static bool bench_expect(bool ok, const char* what) {
+    if (!ok) {
+        bench_failures++;
+        printf("FAILED:          %s\n", what);
+    }
+    return ok;
+}
+
+// Storage root of the benches without one of their own; the settings file
+// every run saves on exit lands there
+static std::filesystem::path bench_shared_root(void) {
+    return std::filesystem::temp_directory_path() / "mpu6050_bench_ext";
+}
+
+// Removes a bench's own storage root and goes back to the shared one
+static void bench_storage_release(const std::filesystem::path& root) {
+    std::filesystem::remove_all(root);
+    furi_shim_storage_set_root(bench_shared_root().c_str());
+}
+
+// Starts the app on its own thread from the default settings: the file an
+// earlier run saved would carry its choices and sensor profiles over
+static std::thread bench_launch(void) {
+    char path[64];
+    char host_path[512];
+    mpu6050_settings_path(path, sizeof(path));
+    if (furi_shim_storage_host_path(path, host_path, sizeof(host_path))) std::filesystem::remove(host_path);
+    return std::thread([]() { mpu6050_reader_app(NULL); });
+}
+
+// Makes `count` freshly powered-up simulated sensors the only devices on the
+// bus, sims[i] at 0x68 + i, with the given wire timing and injected errors.
+// Scripts, motion and biases can be set on them afterwards.
+static void bench_attach_sims(
+    Mpu6050Sim* sims,
+    size_t count,
+    uint32_t bus_hz,
+    uint32_t overhead_us,
+    uint32_t error_period) {
+    furi_shim_i2c_detach_all();
+    for (size_t i = 0; i < count; i++) {
+        mpu6050_sim_init(&sims[i], static_cast<uint8_t>(MPU6050_I2C_ADDR + i));
+        sims[i].time_us = furi_shim_now_us();
+        furi_shim_i2c_attach(&sims[i]);
+    }
+    furi_shim_i2c_set_timing(bus_hz, overhead_us);
+    furi_shim_i2c_set_error_period(error_period);
+}
+
+static void bench_attach_sim(Mpu6050Sim* sim, uint32_t bus_hz, uint32_t overhead_us, uint32_t error_period) {
+    bench_attach_sims(sim, 1, bus_hz, overhead_us, error_period);
+}
+
+typedef struct {
+    const char* name;
+    uint32_t bus_hz;       // 0 = instantaneous transfers
+    uint32_t overhead_us;  // Fixed cost per transfer (driver, interrupts)
+    uint32_t error_period; // Fail one in N transfers, 0 = never
+} BenchScenario;
+
+static const BenchScenario bench_scenarios[] = {
+    {"ideal", 0, 0, 0},
+    {"i2c-400k", 400000, 20, 0},
+    {"i2c-100k", 100000, 20, 0},
+    {"i2c-400k-errors", 400000, 20, 50},
+};
+
+typedef struct {
+    Mpu6050Sim* sim;
+    uint32_t draws;
+    uint64_t draw_us_total;
+    uint64_t latency_us_total;
+    uint64_t latency_us_max;
+    uint32_t latency_samples;
+} BenchDrawStats;
+
+static void bench_draw_hook(uint64_t draw_us, void* context) {
+    BenchDrawStats* stats = static_cast<BenchDrawStats*>(context);
+    stats->draws++;
+    stats->draw_us_total += draw_us;
+
+    // Age of the newest sample that made it out of the FIFO when the frame was drawn
+    uint64_t newest = stats->sim->last_read_sample_us;
+    if (newest == 0) return;
+    uint64_t latency = furi_shim_now_us() - newest;
+    stats->latency_us_total += latency;
+    if (latency > stats->latency_us_max) stats->latency_us_max = latency;
+    stats->latency_samples++;
+}
+
+static void bench_run(const BenchScenario* scenario, uint32_t seconds) {
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, scenario->bus_hz, scenario->overhead_us, scenario->error_period);
+
+    BenchDrawStats draw = {};
+    draw.sim = &sim;
+    furi_shim_set_draw_hook(bench_draw_hook, &draw);
+
+    FuriShimI2cStats before;
+    furi_shim_i2c_stats(&before);
+    uint64_t start_us = furi_shim_now_us();
+
+    std::thread app = bench_launch();
+    // Steady state for the loss check: past the bring-up and before the exit
+    furi_delay_ms(200);
+    uint32_t steady_produced = sim.samples_to_fifo;
+    uint32_t steady_delivered = sim.frames_read;
+    furi_delay_ms(seconds * 1000 - 200);
+    steady_produced = sim.samples_to_fifo - steady_produced;
+    steady_delivered = sim.frames_read - steady_delivered;
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    uint64_t elapsed_us = furi_shim_now_us() - start_us;
+    furi_shim_set_draw_hook(NULL, NULL);
+    FuriShimI2cStats after;
+    furi_shim_i2c_stats(&after);
+
+    double elapsed_s = static_cast<double>(elapsed_us) / 1e6;
+    uint32_t produced = sim.samples_to_fifo;
+    uint32_t delivered = sim.frames_read;
+    uint32_t transactions = after.transactions - before.transactions;
+    uint64_t bytes = after.bytes - before.bytes;
+    double per_sample = delivered ? 1.0 / delivered : 0.0;
+    double steady_lost_pct =
+        steady_produced > steady_delivered ? 100.0 * (steady_produced - steady_delivered) / steady_produced : 0.0;
+
+    printf("%-16s %9.0f %8.2f%% %8.3f %8.1f %6.1f%% %6u %7.1f %8.1f %8.1f\n",
+           scenario->name,
+           delivered / elapsed_s,
+           produced ? 100.0 * (produced - delivered) / produced : 0.0,
+           transactions * per_sample,
+           bytes * per_sample,
+           100.0 * (after.busy_us - before.busy_us) / elapsed_us,
+           after.failures - before.failures,
+           draw.draws ? static_cast<double>(draw.draw_us_total) / draw.draws : 0.0,
+           draw.latency_samples ? draw.latency_us_total / 1000.0 / draw.latency_samples : 0.0,
+           draw.latency_us_max / 1000.0);
+    // A failed transfer takes the sensor back without a reset, its FIFO intact
+    if (scenario->error_period) {
+        bench_expect(steady_lost_pct < 3.0, "bus errors cost under 3% of the samples once running");
+    }
+}
+
+// Measures how long a Settings change takes to reach the chip while sampling
+static void bench_reconfigure(void) {
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(500);
+    uint32_t resets_before = sim.resets;
+
+    // Main -> Settings, cursor to Accel FSR
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyDown, InputTypeShort);
+
+    const int changes = 8;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+    for (int i = 0; i < changes; i++) {
+        uint8_t before = sim.regs[0x1C];
+        uint64_t start = furi_shim_now_us();
+        furi_shim_send_input(InputKeyRight, InputTypeShort);
+        while (sim.regs[0x1C] == before && furi_shim_now_us() - start < 1000000) {
+            furi_delay_us(20); // Yield: the host may have a single core
+        }
+        uint64_t took = furi_shim_now_us() - start;
+        total_us += took;
+        if (took > max_us) max_us = took;
+        furi_delay_ms(50);
+    }
+
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Settings -> Main
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Exit
+    app.join();
+
+    // A change waits at most for the FIFO burst on the bus when it arrives, plus
+    // a millisecond of scheduling on the host
+    uint64_t burst_us = MPU6050_FIFO_BURST_FRAMES * MPU6050_FRAME_SIZE * 9 * 1000000ULL / 400000;
+    printf("\nsettings change: avg %.0f us, max %.0f us to reach ACCEL_CONFIG (bound %.0f us), %u device resets\n",
+           static_cast<double>(total_us) / changes,
+           static_cast<double>(max_us),
+           static_cast<double>(burst_us + 1000),
+           sim.resets - resets_before);
+    bench_expect(max_us < burst_us + 1000, "settings change reaches ACCEL_CONFIG within one FIFO burst");
+    bench_expect(sim.resets == resets_before, "settings change without a device reset");
+}
+
+// Records through the app while the simulated SD card stalls now and then, then
+// decodes the file and checks it for gaps and damage
+static void bench_record(uint32_t seconds) {
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "mpu6050_bench_ext";
+    std::filesystem::remove_all(root);
+    furi_shim_storage_set_root(root.c_str());
+    // 2 ms per write and a 250 ms stall every other write
+    furi_shim_storage_set_latency(2000, 2, 250000);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    uint32_t overflows_before = sim.fifo_overflows;
+
+    // Main (accel) -> gyro -> tilt -> record page, then start
+    for (int page = 0; page < 3; page++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_delay_ms(seconds * 1000);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_delay_ms(300);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+    furi_shim_storage_set_latency(0, 0, 0);
+
+    uint32_t overflows = sim.fifo_overflows - overflows_before;
+
+    std::vector<uint8_t> data;
+    FILE* file = fopen((root / "apps_data/mpu6050/log_000.bin").c_str(), "rb");
+    if (file) {
+        uint8_t buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + n);
+        fclose(file);
+    }
+
+    static Mpu6050SampleBlock block;
+    Mpu6050LogHeader header;
+    Mpu6050LogChunkHeader chunk;
+    uint32_t samples = 0;
+    uint32_t dropped = 0;
+    uint32_t damaged = 0;
+    uint32_t expected = 0;
+    bool valid = data.size() >= sizeof(header);
+    if (valid) {
+        memcpy(&header, data.data(), sizeof(header));
+        valid = mpu6050_log_header_valid(&header);
+    }
+    size_t offset = sizeof(header);
+    while (valid && offset < data.size()) {
+        size_t used = mpu6050_log_decode_chunk(&data[offset], data.size() - offset, &chunk, &block);
+        if (!used) {
+            offset++;
+            damaged++;
+            continue;
+        }
+        offset += used;
+        if (chunk.sequence > expected) dropped += chunk.sequence - expected;
+        expected = chunk.sequence + 1;
+        samples += block.count;
+    }
+
+    printf("record %us:      %s, %u samples, %.2f B/sample, %.1f kB/s, %u chunks dropped, %u damaged bytes, "
+           "%u FIFO overflows\n",
+           seconds,
+           valid ? "valid" : "INVALID",
+           samples,
+           samples ? static_cast<double>(data.size()) / samples : 0.0,
+           data.size() / 1024.0 / seconds,
+           dropped,
+           damaged,
+           overflows);
+    bench_expect(valid && samples > 0, "recording decodes");
+    bench_expect(dropped == 0 && damaged == 0, "recording has no gaps or damage");
+    bench_expect(overflows == 0, "recording costs no FIFO overflows");
+
+    // Chunk timing at the slowest rate, 3.9 Hz: the period no longer fits 16 bits
+    static Mpu6050SampleBlock slow;
+    static uint8_t encoded[MPU6050_LOG_CHUNK_MAX];
+    memset(&slow, 0, sizeof(slow));
+    slow.count = 4;
+    for (uint32_t i = 0; i < slow.count; i++) slow.timestamp[i] = 1000 + i * 256000;
+    size_t size = mpu6050_log_encode_chunk(&slow, 0, encoded);
+    bool slow_ok = mpu6050_log_decode_chunk(encoded, size, &chunk, &block) == size && block.count == slow.count &&
+                   block.timestamp[slow.count - 1] == slow.timestamp[slow.count - 1];
+    bench_expect(slow_ok, "a 256 ms chunk period survives the round trip");
+}
+
+// Times the fixed-point spectrum per frame size and checks it finds a known tone
+static void bench_fft(void) {
+    static Mpu6050Spectrum spectrum;
+    static int16_t tone[MPU6050_FFT_MAX_SIZE];
+    const double tone_hz = 123.4;
+    const double tone_counts = 1000.0;
+    for (uint32_t n = 0; n < MPU6050_FFT_MAX_SIZE; n++) {
+        // 1 g of gravity at 4 g FSR plus the tone
+        tone[n] = static_cast<int16_t>(8192 + tone_counts * sin(2 * M_PI * tone_hz * n / 1000.0));
+    }
+
+    for (int size = 0; size < Mpu6050FftSize_Count; size++) {
+        mpu6050_spectrum_init(&spectrum, static_cast<Mpu6050FftSize>(size), 1000);
+        const uint32_t rounds = 2000;
+        uint64_t start = furi_shim_now_us();
+        for (uint32_t r = 0; r < rounds; r++) {
+            spectrum.input_fill = 0;
+            mpu6050_spectrum_push(&spectrum, tone, spectrum.size, Mpu6050AccelFsr_4g);
+            while (!mpu6050_spectrum_process(&spectrum, UINT32_MAX)) {
+            }
+            mpu6050_spectrum_accumulate(&spectrum);
+        }
+        uint64_t took = furi_shim_now_us() - start;
+
+        uint32_t peak = mpu6050_spectrum_peak_bin(&spectrum);
+        uint32_t centi_hz = mpu6050_spectrum_bin_centi_hz(&spectrum, peak);
+        double amplitude = mpu6050_spectrum_amplitude(&spectrum, peak) / 16.0;
+        printf("fft %4u:        %6.1f us/frame, peak %.2f Hz (tone %.1f, bin %.2f Hz), %.0f counts (tone %.0f)\n",
+               spectrum.size,
+               static_cast<double>(took) / rounds,
+               centi_hz / 100.0,
+               tone_hz,
+               1000.0 / spectrum.size,
+               amplitude,
+               tone_counts);
+        bench_expect(fabs(centi_hz / 100.0 - tone_hz) <= 1000.0 / spectrum.size, "fft peak within a bin of the tone");
+    }
+}
+
+// Opens the spectrum screen on the simulator's 35 Hz, 0.25 g X vibration and
+// reports what the screen shows once the average has settled
+static void bench_spectrum_screen(void) {
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(200);
+    furi_shim_send_input(InputKeyOk, InputTypeLong);
+    furi_shim_send_input(InputKeyRight, InputTypeShort); // Z -> X
+    furi_delay_ms(3000);
+
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    char* newline = strchr(text, '\n');
+    if (newline) *newline = '\0';
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    printf("spectrum screen: \"%s\" (simulated 35 Hz, 250 mg)\n", text);
+    bench_expect(strstr(text, "35.") != NULL, "spectrum screen shows the 35 Hz peak");
+}
+
+// Two sensors on one bus, 0x68 level and 0x69 tilted 30 degrees about Y: both
+// should stream at the full rate and the Dual page should show their difference
+static void bench_dual(uint32_t seconds) {
+    static const Mpu6050SimSegment level[] = {{1000, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f}};
+    static const Mpu6050SimSegment tilted[] = {{1000, {0.5f, 0.0f, 0.866f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f}};
+    static Mpu6050Sim sims[2];
+    bench_attach_sims(sims, 2, 400000, 20, 0);
+    mpu6050_sim_set_script(&sims[0], level, COUNT_OF(level));
+    mpu6050_sim_set_script(&sims[1], tilted, COUNT_OF(tilted));
+    sims[1].clock_ppm = 2000; // The two parts never tick quite together
+
+    std::thread app = bench_launch();
+    furi_delay_ms(500); // Both sensors up, start-up overflow behind us
+    uint32_t read_before[2] = {sims[0].frames_read, sims[1].frames_read};
+    uint32_t overflows_before[2] = {sims[0].fifo_overflows, sims[1].fifo_overflows};
+    uint64_t start_us = furi_shim_now_us();
+    for (int page = 0; page < 6; page++) furi_shim_send_input(InputKeyDown, InputTypeShort); // Dual page
+    furi_delay_ms(seconds * 1000);
+    double elapsed_s = (furi_shim_now_us() - start_us) / 1e6;
+
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    for (int i = 0; i < 2; i++) {
+        double rate = (sims[i].frames_read - read_before[i]) / elapsed_s;
+        printf("dual %c:          %.0f samples/s, %lu FIFO overflows\n",
+               'A' + i,
+               rate,
+               (unsigned long)(sims[i].fifo_overflows - overflows_before[i]));
+        bench_expect(rate > 900.0, "both sensors stream at the full rate");
+    }
+    // The difference should read -0.50 on X and about 0.13 on Z
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("dual screen:     \"%s\"\n", text);
+    bench_expect(strstr(text, "-0.50") != NULL, "dual page shows the X difference");
+}
+
+// Runs the host stream reader against the pty for `seconds` and returns its
+// summary line
+static std::string bench_stream_read(const std::string& reader, const char* pty, const char* mode, uint32_t seconds) {
+    std::string command = reader + " " + pty + " --seconds " + std::to_string(seconds) + " " + mode;
+    FILE* pipe = popen(command.c_str(), "r");
+    std::string summary = "reader did not run";
+    if (!pipe) return summary;
+    char line[256];
+    while (fgets(line, sizeof(line), pipe)) {
+        if (strncmp(line, "total: ", 7) == 0) {
+            line[strcspn(line, "\n")] = '\0';
+            summary = line + 7;
+        }
+    }
+    pclose(pipe);
+    return summary;
+}
+
+// The number in front of ` label` in a reader summary, -1 without it
+static double bench_stream_value(const std::string& summary, const char* label) {
+    size_t end = summary.find(std::string(" ") + label);
+    if (end == std::string::npos || end == 0) return -1;
+    size_t start = summary.rfind(' ', end - 1);
+    start = start == std::string::npos ? 0 : start + 1;
+    return atof(summary.substr(start, end - start).c_str());
+}
+
+// Streams live samples to the host reader over a pty standing in for the USB
+// port, delta then raw; then leaves the port unread for a second, which must
+// drop whole frames on the app side without costing the sensor FIFO anything
+static void bench_stream(const char* argv0, uint32_t seconds) {
+    std::string reader = (std::filesystem::path(argv0).parent_path() / "mpu6050_stream_reader").string();
+    char pty[64];
+    if (!furi_shim_cdc_open_pty(pty, sizeof(pty))) {
+        printf("stream:          no pty available, skipped\n");
+        return;
+    }
+
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    for (int page = 0; page < 7; page++) furi_shim_send_input(InputKeyDown, InputTypeShort); // Stream page
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_delay_ms(100);
+    furi_shim_cdc_set_ctrl_line(CdcCtrlLineDTR);
+    uint32_t overflows_before = sim.fifo_overflows;
+
+    std::string delta = bench_stream_read(reader, pty, "--delta", seconds);
+    std::string raw = bench_stream_read(reader, pty, "--raw", seconds);
+    furi_delay_ms(1000); // Nobody reading: the pty fills up, then the ring
+    std::string stalled = bench_stream_read(reader, pty, "--delta", 1);
+    uint32_t overflows = sim.fifo_overflows - overflows_before;
+    // Stopped and started again under a reader: the sequence starts over
+    std::string restarted;
+    std::thread restart_reader([&]() { restarted = bench_stream_read(reader, pty, "--delta", 2); });
+    furi_delay_ms(700);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_delay_ms(100);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    restart_reader.join();
+
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    furi_shim_cdc_set_ctrl_line(0);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+    furi_shim_cdc_close();
+
+    printf("stream delta:    %s\n", delta.c_str());
+    printf("stream raw:      %s\n", raw.c_str());
+    printf("stream stalled:  %s\n", stalled.c_str());
+    printf("stream restart:  %s\n", restarted.c_str());
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("stream screen:   \"%s\", %lu FIFO overflows\n", text, (unsigned long)overflows);
+    bench_expect(delta.find(" 0 crc errors") != std::string::npos, "delta stream has no CRC errors");
+    bench_expect(raw.find(" 0 crc errors") != std::string::npos, "raw stream has no CRC errors");
+    bench_expect(overflows == 0, "a stalled stream costs no FIFO overflows");
+    double stalled_rate = bench_stream_value(stalled, "samples/s");
+    bench_expect(stalled_rate > 900 && stalled_rate < 1050, "a stalled stream reports the 1 kHz sample rate");
+    bench_expect(bench_stream_value(restarted, "resyncs") == 1, "a restarted stream counts one resync");
+    double restart_dropped = bench_stream_value(restarted, "dropped");
+    bench_expect(restart_dropped >= 0 && restart_dropped < 100, "a restarted stream counts no wrapped drops");
+}
+
+// Still, shaken, still again with sleep after 2 s enabled: the sensor should go
+// idle 2 s after the setting, wake within a poll of the shaking and go idle again.
+// Reports when each happened, what the motion wake sampled, and the samples the
+// power page counted as kept and skipped.
+static void bench_power(void) {
+    static const Mpu6050SimSegment script[] = {
+        {4000, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f},
+        {1500, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 0.5f, 8.0f},
+        {4000, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f}};
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+    mpu6050_sim_set_script(&sim, script, COUNT_OF(script));
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    // Settings: sleep when still for 2 s
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    for (int row = 0; row < 8; row++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    uint64_t set_us = furi_shim_now_us();
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    for (int page = 0; page < 8; page++) furi_shim_send_input(InputKeyDown, InputTypeShort); // Power page
+
+    // Sensor time of the shaking; the script started at the reset
+    uint64_t reset_us = sim.time_us - sim.motion_time_ns / 1000;
+    uint64_t shake_us = reset_us + 4000000;
+    uint64_t idle_us[2] = {0, 0};
+    uint64_t wake_us = 0;
+    uint32_t frames_before = sim.frames_read;
+    uint32_t overflows_before = sim.fifo_overflows;
+    while (furi_shim_now_us() < reset_us + 9000000) {
+        bool cycling = mpu6050_sim_cycling(&sim);
+        uint64_t now = furi_shim_now_us();
+        if (cycling && !idle_us[0]) idle_us[0] = now;
+        if (!cycling && idle_us[0] && !wake_us && now > shake_us) wake_us = now;
+        if (cycling && wake_us && !idle_us[1]) idle_us[1] = now;
+        furi_delay_ms(1);
+    }
+    furi_delay_ms(300); // A frame of the page after the last change
+    uint32_t frames = sim.frames_read - frames_before;
+    uint32_t overflows = sim.fifo_overflows - overflows_before;
+
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    printf("power:           idle %.2f s after the setting, woke %.0f ms after the shaking, idle again %.2f s later\n",
+           idle_us[0] ? (idle_us[0] - set_us) / 1e6 : -1.0,
+           wake_us ? (wake_us - shake_us) / 1e3 : -1.0,
+           idle_us[1] ? (idle_us[1] - shake_us) / 1e6 : -1.0);
+    printf("power:           %lu wake samples, %lu motion interrupts, %lu frames read, %lu FIFO overflows\n",
+           (unsigned long)sim.cycle_samples,
+           (unsigned long)sim.motion_events,
+           (unsigned long)frames,
+           (unsigned long)overflows);
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("power screen:    \"%s\"\n", text);
+    bench_expect(idle_us[0] && wake_us && idle_us[1], "sensor goes idle, wakes on the shaking and goes idle again");
+}
+
+// Waits until `sim` has delivered frames past `frames`, up to `timeout_ms`;
+// returns how long that took in ms, or -1
+static double bench_wait_frames(const Mpu6050Sim* sim, uint32_t frames, uint64_t since_us, uint32_t timeout_ms) {
+    while (furi_shim_now_us() - since_us < timeout_ms * 1000ULL) {
+        if (sim->frames_read > frames) return (furi_shim_now_us() - since_us) / 1e3;
+        furi_delay_us(200);
+    }
+    return -1.0;
+}
+
+// Sensor faults while two sensors sample at 400 kHz: A is unplugged and plugged
+// back in, then a slave holds SDA low. Times each recovery from the fault (or
+// the replug) to A's first sample, and checks B keeps sampling through A's.
+static void bench_recovery(void) {
+    static Mpu6050Sim sims[2];
+    bench_attach_sims(sims, 2, 400000, 20, 0);
+
+    uint64_t start_us = furi_shim_now_us();
+    std::thread app = bench_launch();
+    double bring_up_ms = bench_wait_frames(&sims[0], 0, start_us, 1000);
+    furi_delay_ms(500);
+
+    // Unplugged for 300 ms; B is counted while A is away and while it comes back
+    uint32_t produced_before[2] = {sims[0].samples_to_fifo, sims[1].samples_to_fifo};
+    uint32_t read_before[2] = {sims[0].frames_read, sims[1].frames_read};
+    furi_shim_i2c_detach(&sims[0]);
+    uint32_t b_before = sims[1].frames_read;
+    uint64_t unplug_us = furi_shim_now_us();
+    furi_delay_ms(300);
+    sims[0].time_us = furi_shim_now_us();
+    mpu6050_sim_power_cycle(&sims[0]);
+    furi_shim_i2c_attach(&sims[0]);
+    uint64_t replug_us = furi_shim_now_us();
+    double replug_ms = bench_wait_frames(&sims[0], sims[0].frames_read, replug_us, 2000);
+    double b_rate = (sims[1].frames_read - b_before) / ((furi_shim_now_us() - unplug_us) / 1e6);
+    furi_delay_ms(300);
+
+    // Stuck SDA: every transfer times out until the bus is clocked free
+    FuriShimI2cStats before;
+    furi_shim_i2c_stats(&before);
+    uint32_t resets_before[2] = {sims[0].resets, sims[1].resets};
+    uint32_t a_frames = sims[0].frames_read;
+    uint32_t b_frames = sims[1].frames_read;
+    uint64_t stuck_us = furi_shim_now_us();
+    furi_shim_i2c_set_stuck(5);
+    double stuck_ms = bench_wait_frames(&sims[0], a_frames, stuck_us, 3000);
+    double stuck_b_ms = bench_wait_frames(&sims[1], b_frames, stuck_us, 3000);
+    FuriShimI2cStats after;
+    furi_shim_i2c_stats(&after);
+    furi_delay_ms(500);
+
+    // Dual page: the rings carried on, nothing counts as lost
+    for (int page = 0; page < 6; page++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_delay_ms(300);
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+    furi_shim_i2c_set_stuck(0);
+
+    printf("recovery:        first sample %.0f ms after start, %.0f ms after replug (B at %.0f samples/s meanwhile)\n",
+           bring_up_ms,
+           replug_ms,
+           b_rate);
+    printf("recovery:        stuck SDA: A back after %.0f ms, B after %.0f ms, %lu timeouts, %lu SCL pulses, "
+           "%lu / %lu resets\n",
+           stuck_ms,
+           stuck_b_ms,
+           (unsigned long)(after.timeouts - before.timeouts),
+           (unsigned long)(after.scl_pulses - before.scl_pulses),
+           (unsigned long)(sims[0].resets - resets_before[0]),
+           (unsigned long)(sims[1].resets - resets_before[1]));
+    // Samples the chips produced that never made it off them: the ones that
+    // overflowed or were reset away while the bus was stuck
+    printf("recovery:        samples missed A %ld, B %ld\n",
+           (long)((sims[0].samples_to_fifo - produced_before[0]) - (sims[0].frames_read - read_before[0])),
+           (long)((sims[1].samples_to_fifo - produced_before[1]) - (sims[1].frames_read - read_before[1])));
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("recovery screen: \"%s\"\n", text);
+    bench_expect(bring_up_ms >= 0 && replug_ms >= 0, "sensor comes up and back after a replug");
+    bench_expect(stuck_ms >= 0 && stuck_b_ms >= 0, "both sensors come back after a stuck bus");
+}
+
+// An MPU-6500 (WHO_AM_I 0x70) answering where an MPU-6050 is expected: the app
+// must not reset or configure it, and names it on the main screen. Swapped for
+// the right part, the sensor comes up without a restart.
+static void bench_part(void) {
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+    sim.regs[MPU6050_REG_WHO_AM_I] = 0x70;
+
+    std::thread app = bench_launch();
+    furi_delay_ms(500);
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    uint32_t resets = sim.resets;
+    uint32_t frames = sim.frames_read;
+    sim.regs[MPU6050_REG_WHO_AM_I] = 0x68;
+    uint64_t swap_us = furi_shim_now_us();
+    double swap_ms = bench_wait_frames(&sim, 0, swap_us, 2000);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("part:            0x70 left alone (%lu resets, %lu frames), right part up %.0f ms after the swap\n",
+           (unsigned long)resets,
+           (unsigned long)frames,
+           swap_ms);
+    printf("part screen:     \"%s\"\n", text);
+    bench_expect(resets == 0 && frames == 0, "a foreign part is not reset or read");
+    bench_expect(strstr(text, "Wrong chip 0x70") != NULL, "the main screen names a foreign part");
+    bench_expect(swap_ms >= 0, "the right part comes up after a swap");
+}
+
+// Start-up line of the diagnostics Counters page, or "" without MPU6050_PROFILE.
+// Leaves the app on the main screen.
+static void bench_warm_start_line(char* line, size_t size) {
+    line[0] = '\0';
+#ifdef MPU6050_PROFILE
+    // Main -> About -> Diagnostics -> Counters
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_delay_ms(100);
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    const char* start = strstr(text, "Start");
+    if (start) {
+        size_t length = strcspn(start, "\n");
+        snprintf(line, size, "%.*s", static_cast<int>(length), start);
+    }
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Diagnostics -> About
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // About -> Main
+#else
+    UNUSED(size);
+#endif
+}
+
+// Launches the app four times on one sensor, asleep in between:
+// cold, warm from the profile the first run saved on exit, after a power cycle
+// and with a profile of another chip, both of which must fall back to a reset.
+// Times each from launch to the first sample and checks the Settings change
+// made in the first run reached the chip every time.
+static void bench_warm_start(void) {
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "mpu6050_bench_warm";
+    std::filesystem::remove_all(root);
+    furi_shim_storage_set_root(root.c_str());
+
+    // Cold, then Accel FSR one step up in Settings
+    uint64_t start_us = furi_shim_now_us();
+    std::thread cold = bench_launch();
+    double cold_ms = bench_wait_frames(&sim, 0, start_us, 1000);
+    furi_delay_ms(200);
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_delay_ms(100);
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Settings -> Main
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Exit
+    cold.join();
+    uint8_t accel_config = sim.regs[0x1C];
+    char path[64];
+    char host_path[512];
+    mpu6050_settings_path(path, sizeof(path));
+    furi_shim_storage_host_path(path, host_path, sizeof(host_path));
+    bool saved = std::filesystem::exists(host_path);
+
+    // Warm: the launches below keep the saved settings. Until then the chip
+    // sleeps and samples nothing.
+    uint32_t produced = sim.samples_to_fifo;
+    furi_delay_ms(100);
+    bool slept = (sim.regs[0x6B] & 0x40) && sim.samples_to_fifo == produced;
+    uint32_t resets = sim.resets;
+    start_us = furi_shim_now_us();
+    std::thread warm([]() { mpu6050_reader_app(NULL); });
+    double warm_ms = bench_wait_frames(&sim, sim.frames_read, start_us, 1000);
+    furi_delay_ms(200);
+    bool warm_kept = sim.regs[0x1C] == accel_config;
+    uint32_t warm_resets = sim.resets - resets;
+    char warm_line[48];
+    bench_warm_start_line(warm_line, sizeof(warm_line));
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    warm.join();
+
+    // Power cycled while the app was away: the check fails, the chip is reset
+    sim.time_us = furi_shim_now_us();
+    mpu6050_sim_power_cycle(&sim);
+    resets = sim.resets;
+    start_us = furi_shim_now_us();
+    std::thread cycled([]() { mpu6050_reader_app(NULL); });
+    double cycled_ms = bench_wait_frames(&sim, sim.frames_read, start_us, 1000);
+    furi_delay_ms(200);
+    bool cycled_kept = sim.regs[0x1C] == accel_config;
+    uint32_t cycled_resets = sim.resets - resets;
+    char cycled_line[48];
+    bench_warm_start_line(cycled_line, sizeof(cycled_line));
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    cycled.join();
+
+    // Swapped: the profile was saved for a chip with another WHO_AM_I
+    Mpu6050Settings settings;
+    bool swapped_saved = mpu6050_settings_load(&settings) && settings.profiles[0].valid;
+    settings.profiles[0].who_am_i ^= 0x01;
+    swapped_saved = swapped_saved && mpu6050_settings_save(&settings);
+    resets = sim.resets;
+    start_us = furi_shim_now_us();
+    std::thread swapped([]() { mpu6050_reader_app(NULL); });
+    double swapped_ms = bench_wait_frames(&sim, sim.frames_read, start_us, 1000);
+    furi_delay_ms(200);
+    bool swapped_kept = sim.regs[0x1C] == accel_config;
+    uint32_t swapped_resets = sim.resets - resets;
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    swapped.join();
+    bench_storage_release(root);
+
+    printf("warm start:      settings %s, sensor %s; first sample %.0f ms cold, %.0f ms warm (%lu resets, Accel FSR %s), "
+           "%.0f ms after a power cycle (%lu resets, Accel FSR %s)\n",
+           saved ? "saved" : "NOT SAVED",
+           slept ? "asleep" : "NOT ASLEEP",
+           cold_ms,
+           warm_ms,
+           (unsigned long)warm_resets,
+           warm_kept ? "kept" : "LOST",
+           cycled_ms,
+           (unsigned long)cycled_resets,
+           cycled_kept ? "restored" : "LOST");
+    printf("warm start:      %.0f ms with another chip's profile (%lu resets, Accel FSR %s)\n",
+           swapped_ms,
+           (unsigned long)swapped_resets,
+           swapped_kept ? "restored" : "LOST");
+    if (warm_line[0]) printf("warm start:      diagnostics \"%s\", then \"%s\"\n", warm_line, cycled_line);
+    bench_expect(saved, "settings saved on exit");
+    bench_expect(slept, "sensor sleeps while the app is closed");
+    bench_expect(warm_ms >= 0 && warm_resets == 0 && warm_kept, "warm start takes the sensor over without a reset");
+    bench_expect(cycled_ms >= 0 && cycled_resets > 0 && cycled_kept, "power-cycled sensor is reset and reconfigured");
+    bench_expect(
+        swapped_saved && swapped_ms >= 0 && swapped_resets > 0 && swapped_kept,
+        "a profile of another chip is not resumed");
+}
+
+// Writes a recording the way the logger lays it out: `seconds` at 1 kHz in
+// 10-sample chunks, gravity on Z, a 5 Hz wobble on X and a 3 g knock on X
+// every two seconds
+static void bench_replay_write(const std::filesystem::path& path, uint32_t seconds) {
+    Mpu6050LogHeader header;
+    mpu6050_log_header_init(&header, mpu6050_default_config, 0);
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return;
+    fwrite(&header, sizeof(header), 1, file);
+
+    static Mpu6050SampleBlock block;
+    static uint8_t chunk[MPU6050_LOG_CHUNK_MAX];
+    const float counts_per_g = 16384.0f / (1 << mpu6050_default_config.accel_fsr);
+    uint32_t total = seconds * 1000;
+    for (uint32_t n = 0, sequence = 0; n < total; n += 10, sequence++) {
+        block.count = 10;
+        block.accel_fsr = mpu6050_default_config.accel_fsr;
+        block.gyro_fsr = mpu6050_default_config.gyro_fsr;
+        for (uint32_t i = 0; i < block.count; i++) {
+            uint32_t t = n + i;
+            float x = 0.3f * sinf(2.0f * static_cast<float>(M_PI) * 5.0f * t / 1000.0f) + (t % 2000 < 5 ? 3.0f : 0.0f);
+            block.acc[0][i] = static_cast<int16_t>(lrintf(x * counts_per_g));
+            block.acc[1][i] = 0;
+            block.acc[2][i] = static_cast<int16_t>(lrintf(counts_per_g));
+            for (int axis = 0; axis < 3; axis++) block.gyro[axis][i] = static_cast<int16_t>(axis * 10);
+            block.temp[i] = 0;
+            block.timestamp[i] = t * 1000;
+        }
+        fwrite(chunk, mpu6050_log_encode_chunk(&block, sequence, chunk), 1, file);
+    }
+    fclose(file);
+}
+
+// Waits until the replay page says the replay just started is over, at most
+// `timeout_ms`, and returns the rate it shows. The page may still show the last
+// replay's end for a frame after the start.
+static uint32_t bench_replay_wait(char* screen, size_t size, uint32_t timeout_ms) {
+    uint64_t start = furi_shim_now_us();
+    do {
+        furi_delay_ms(5);
+        furi_shim_screen_text(screen, size);
+    } while (strstr(screen, "Replay done") && furi_shim_now_us() - start < 200000);
+    do {
+        furi_delay_ms(10);
+        furi_shim_screen_text(screen, size);
+    } while (!strstr(screen, "Replay done") && furi_shim_now_us() - start < timeout_ms * 1000ULL);
+
+    const char* unit = strstr(screen, " smp/s");
+    if (!unit) return 0;
+    const char* digits = unit;
+    while (digits > screen && digits[-1] >= '0' && digits[-1] <= '9') digits--;
+    return static_cast<uint32_t>(strtoul(digits, NULL, 10));
+}
+
+// Replays a 300 s recording twice at Max through the unmodified app, with no
+// sensor attached, and checks both runs leave the screens in the same state;
+// then a 16 s one at 16x, which must take a sixteenth of its length. Finally
+// exports the events the replays caught.
+static void bench_replay(void) {
+    furi_shim_i2c_detach_all();
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "mpu6050_bench_ext";
+    std::filesystem::path dir = root / "apps_data/mpu6050";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(dir);
+    furi_shim_storage_set_root(root.c_str());
+    bench_replay_write(dir / "log_000.bin", 300);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    // Settings: replay speed 1x -> Max, then the replay page
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    for (int row = 0; row < 10; row++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    furi_shim_send_input(InputKeyUp, InputTypeShort); // Replay page, one back from the first
+
+    char screen[256];
+    std::string states[2];
+    uint32_t rates[2];
+    for (int run = 0; run < 2; run++) {
+        furi_shim_send_input(InputKeyOk, InputTypeShort);
+        furi_delay_ms(100);
+        rates[run] = bench_replay_wait(screen, sizeof(screen), 30000);
+        // What the replay left in the statistics and the events, then back
+        furi_shim_send_input(InputKeyDown, InputTypeShort);
+        furi_shim_send_input(InputKeyOk, InputTypeShort); // Max G
+        furi_delay_ms(100);
+        furi_shim_screen_text(screen, sizeof(screen));
+        states[run] = screen;
+        furi_shim_send_input(InputKeyBack, InputTypeShort);
+        for (int page = 0; page < 4; page++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+        furi_delay_ms(100);
+        furi_shim_screen_text(screen, sizeof(screen));
+        states[run] += screen;
+        for (int page = 0; page < 5; page++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+    }
+
+    // A newer, shorter recording at 16x
+    bench_replay_write(dir / "log_001.bin", 16);
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    uint64_t paced_start = furi_shim_now_us();
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    uint32_t paced_rate = bench_replay_wait(screen, sizeof(screen), 5000);
+    double paced_s = (furi_shim_now_us() - paced_start) / 1e6;
+
+    // Replay page -> Events page -> Events screen, long OK saves the events
+    for (int page = 0; page < 5; page++) furi_shim_send_input(InputKeyUp, InputTypeShort);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_shim_send_input(InputKeyOk, InputTypeLong);
+    char export_screen[256];
+    uint64_t export_start = furi_shim_now_us();
+    do {
+        furi_delay_ms(5);
+        furi_shim_screen_text(export_screen, sizeof(export_screen));
+    } while (!strstr(export_screen, "Saved to SD") && furi_shim_now_us() - export_start < 2000000);
+    double export_ms = (furi_shim_now_us() - export_start) / 1e3;
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Events -> Main
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+    uint32_t export_lines = 0;
+    FILE* csv = fopen((dir / "events_000.csv").c_str(), "r");
+    if (csv) {
+        for (int c = fgetc(csv); c != EOF; c = fgetc(csv)) export_lines += c == '\n';
+        fclose(csv);
+    }
+
+    bool identical = states[0] == states[1];
+    printf("replay max:      300000 samples at %lu and %lu samples/s, end state %s\n",
+           (unsigned long)rates[0],
+           (unsigned long)rates[1],
+           identical ? "identical" : "DIFFERENT");
+    printf("replay 16x:      16 s of data at %lu samples/s, done after %.2f s\n", (unsigned long)paced_rate, paced_s);
+    printf("event export:    %lu lines, saved after %.0f ms\n", (unsigned long)export_lines, export_ms);
+    for (char& c : states[0]) {
+        if (c == '\n') c = ' ';
+    }
+    printf("replay end:      \"%s\"\n", states[0].c_str());
+    for (char* c = screen; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("replay screen:   \"%s\"\n", screen);
+    bench_expect(identical, "two replays end in the same state");
+    bench_expect(paced_rate > 0 && paced_s > 0.9 && paced_s < 1.5, "16x replay keeps its pace");
+    bench_expect(
+        strstr(export_screen, "Saved to SD") && export_lines == 1 + MPU6050_EVENT_POOL * MPU6050_EVENT_SAMPLES,
+        "every captured event is exported");
+}
+
+// Gravity in each calibration pose, in the order the calibration asks for them
+static const float bench_cal_gravity[6][3] = {
+    {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f},
+    {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}};
+
+static void bench_cal_motion(void* context, float t, float acc[3], float gyro[3], float* temp_c) {
+    UNUSED(t);
+    UNUSED(temp_c);
+    const float* gravity = static_cast<const float*>(*static_cast<const float**>(context));
+    for (int i = 0; i < 3; i++) {
+        acc[i] = gravity[i];
+        gyro[i] = 0.0f;
+    }
+}
+
+// Error the sensor shows with the offsets it currently holds, in mg and mdps
+static void bench_cal_residual(const Mpu6050Sim* sim, int32_t accel_mg[3], int32_t gyro_mdps[3]) {
+    for (int i = 0; i < 3; i++) {
+        int32_t trim = static_cast<int16_t>((sim->regs[0x06 + i * 2] << 8) | sim->regs[0x07 + i * 2]) & ~1;
+        float accel = sim->acc_bias[i] + static_cast<float>(trim - (sim->accel_trim[i] & ~1)) / 2048.0f;
+        int16_t gyro_offset = static_cast<int16_t>((sim->regs[0x13 + i * 2] << 8) | sim->regs[0x14 + i * 2]);
+        float gyro = sim->gyro_bias[i] + static_cast<float>(gyro_offset) / 32.8f;
+        accel_mg[i] = static_cast<int32_t>(lrintf(accel * 1000.0f));
+        gyro_mdps[i] = static_cast<int32_t>(lrintf(gyro * 1000.0f));
+    }
+}
+
+// Waits until the calibration screen stops showing `text`, at most `timeout_ms`.
+// The first frame after a key press takes up to a frame slot and a loop pass, so
+// the screen must show `text` first; until then it may still be the old one.
+static void bench_cal_wait_while(const char* text, uint32_t timeout_ms) {
+    char screen[256];
+    uint64_t start = furi_shim_now_us();
+    do {
+        furi_delay_ms(5);
+        furi_shim_screen_text(screen, sizeof(screen));
+    } while (!strstr(screen, text) && furi_shim_now_us() - start < 500000);
+    do {
+        furi_delay_ms(20);
+        furi_shim_screen_text(screen, sizeof(screen));
+    } while (strstr(screen, text) && furi_shim_now_us() - start < timeout_ms * 1000ULL);
+}
+
+// Calibrates a sensor with known offsets through the six-pose screen, one pose
+// first shown the wrong way up, and checks what is left of the offsets; then
+// restarts the app on a freshly reset sensor, which must restore them from the
+// saved file without calibrating again
+static void bench_calibration(void) {
+    static Mpu6050Sim sim;
+    static const float* gravity = bench_cal_gravity[0];
+    bench_attach_sim(&sim, 400000, 20, 0);
+    mpu6050_sim_set_motion(&sim, bench_cal_motion, &gravity);
+    const float acc_bias[3] = {0.060f, -0.045f, 0.120f};
+    const float gyro_bias[3] = {2.5f, -1.2f, 0.8f};
+    for (int i = 0; i < 3; i++) {
+        sim.acc_bias[i] = acc_bias[i];
+        sim.gyro_bias[i] = gyro_bias[i];
+    }
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "mpu6050_bench_cal";
+    std::filesystem::remove_all(root);
+    furi_shim_storage_set_root(root.c_str());
+
+    int32_t before_mg[3];
+    int32_t before_mdps[3];
+    bench_cal_residual(&sim, before_mg, before_mdps);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    uint64_t start_us = furi_shim_now_us();
+    // Main -> Settings -> Calibrate row -> calibration screen
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    for (int row = 0; row < 11; row++) furi_shim_send_input(InputKeyDown, InputTypeShort); // Calibrate
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_delay_ms(100);
+
+    // Upside down when the first pose wants the screen up: must be rejected
+    gravity = bench_cal_gravity[1];
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    bench_cal_wait_while("Hold still", 5000);
+    char screen[256];
+    furi_shim_screen_text(screen, sizeof(screen));
+    bool rejected = strstr(screen, "Moved or wrong way up") != NULL;
+
+    for (int pose = 0; pose < 6; pose++) {
+        gravity = bench_cal_gravity[pose];
+        furi_delay_ms(50);
+        furi_shim_send_input(InputKeyOk, InputTypeShort);
+        bench_cal_wait_while("Hold still", 5000);
+    }
+    bench_cal_wait_while("Writing offsets", 2000);
+    double took_s = (furi_shim_now_us() - start_us) / 1e6;
+    furi_shim_screen_text(screen, sizeof(screen));
+    bool saved = strstr(screen, "Saved") != NULL;
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Calibrate -> Settings
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Settings -> Main
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Exit
+    app.join();
+
+    int32_t after_mg[3];
+    int32_t after_mdps[3];
+    bench_cal_residual(&sim, after_mg, after_mdps);
+
+    // A fresh start: the reset puts the factory trims back, init() the saved offsets
+    mpu6050_sim_init(&sim, MPU6050_I2C_ADDR);
+    mpu6050_sim_set_motion(&sim, bench_cal_motion, &gravity);
+    for (int i = 0; i < 3; i++) {
+        sim.acc_bias[i] = acc_bias[i];
+        sim.gyro_bias[i] = gyro_bias[i];
+    }
+    sim.time_us = furi_shim_now_us();
+    std::thread restart = bench_launch();
+    furi_delay_ms(300);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    restart.join();
+    int32_t reload_mg[3];
+    int32_t reload_mdps[3];
+    bench_cal_residual(&sim, reload_mg, reload_mdps);
+    bench_storage_release(root);
+
+    printf("calibration:     %s in %.1f s, wrong pose %s\n",
+           saved ? "saved" : "NOT SAVED",
+           took_s,
+           rejected ? "rejected" : "ACCEPTED");
+    printf("  before:        accel %ld %ld %ld mg, gyro %ld %ld %ld mdps\n",
+           (long)before_mg[0], (long)before_mg[1], (long)before_mg[2],
+           (long)before_mdps[0], (long)before_mdps[1], (long)before_mdps[2]);
+    printf("  after:         accel %ld %ld %ld mg, gyro %ld %ld %ld mdps\n",
+           (long)after_mg[0], (long)after_mg[1], (long)after_mg[2],
+           (long)after_mdps[0], (long)after_mdps[1], (long)after_mdps[2]);
+    printf("  after restart: accel %ld %ld %ld mg, gyro %ld %ld %ld mdps\n",
+           (long)reload_mg[0], (long)reload_mg[1], (long)reload_mg[2],
+           (long)reload_mdps[0], (long)reload_mdps[1], (long)reload_mdps[2]);
+    bool cancelled = true;
+    for (int i = 0; i < 3; i++) {
+        if (abs(after_mg[i]) > 10 || abs(after_mdps[i]) > 100) cancelled = false;
+        if (reload_mg[i] != after_mg[i] || reload_mdps[i] != after_mdps[i]) cancelled = false;
+    }
+    bench_expect(saved && rejected, "calibration saved, wrong pose rejected");
+    bench_expect(cancelled, "calibration cancels the offsets and survives a restart");
+}
+
+// Opens the diagnostics screen while sampling at 400 kHz and prints each page,
+// then dumps the counters to the SD card
+static void bench_diagnostics(uint32_t seconds) {
+#ifdef MPU6050_PROFILE
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "mpu6050_bench_diag";
+    std::filesystem::remove_all(root);
+    furi_shim_storage_set_root(root.c_str());
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    // Main -> About -> Diagnostics, counting from here
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyOk, InputTypeShort);
+    furi_delay_ms(seconds * 1000 + 1000);
+
+    for (int page = 0; page < 4; page++) {
+        furi_delay_ms(100);
+        char text[256];
+        furi_shim_screen_text(text, sizeof(text));
+        for (char* c = text; *c; c++) {
+            if (*c == '\n') *c = '|';
+        }
+        printf("diagnostics %d:   \"%s\"\n", page, text);
+        furi_shim_send_input(InputKeyRight, InputTypeShort);
+    }
+    furi_shim_send_input(InputKeyOk, InputTypeLong);
+    furi_delay_ms(200);
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Diagnostics -> About
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // About -> Main
+    furi_shim_send_input(InputKeyBack, InputTypeShort); // Exit
+    app.join();
+
+    FILE* file = fopen((root / "apps_data/mpu6050/diag_000.txt").c_str(), "r");
+    printf("diagnostics dump: %s\n", file ? "diag_000.txt written" : "MISSING");
+    bench_expect(file != NULL, "diagnostics dump written");
+    if (file) {
+        char line[128];
+        while (fgets(line, sizeof(line), file)) printf("  %s", line);
+        fclose(file);
+    }
+    bench_storage_release(root);
+#else
+    UNUSED(seconds);
+    printf("diagnostics:     built without MPU6050_PROFILE\n");
+#endif
+}
+
+// Runs the main screen against a still and a vibrating sensor: the still one
+// should only draw when forced, the moving one at the frame rate cap. Also
+// compares float printf with the cached integer formatting the screens use.
+static void bench_render(uint32_t seconds) {
+    static const Mpu6050SimSegment still[] = {{1000, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f}};
+    for (int moving = 0; moving < 2; moving++) {
+        static Mpu6050Sim sim;
+        bench_attach_sim(&sim, 400000, 20, 0);
+        if (!moving) mpu6050_sim_set_script(&sim, still, COUNT_OF(still));
+
+        BenchDrawStats draw = {};
+        draw.sim = &sim;
+        std::thread app = bench_launch();
+        furi_delay_ms(200); // Let the first reading settle
+        furi_shim_set_draw_hook(bench_draw_hook, &draw);
+        uint64_t start_us = furi_shim_now_us();
+        furi_delay_ms(seconds * 1000);
+        furi_shim_set_draw_hook(NULL, NULL);
+        uint64_t elapsed_us = furi_shim_now_us() - start_us;
+
+        // The About screen reports the app's own frame counters
+        furi_shim_send_input(InputKeyRight, InputTypeShort);
+        furi_delay_ms(100);
+        char text[256];
+        furi_shim_screen_text(text, sizeof(text));
+        const char* counters = strstr(text, " fr ");
+        while (counters && counters > text && counters[-1] != '\n') counters--;
+        char line[64] = "";
+        if (counters) snprintf(line, sizeof(line), "%.*s", static_cast<int>(strcspn(counters, "\n")), counters);
+        furi_shim_send_input(InputKeyBack, InputTypeShort);
+        furi_shim_send_input(InputKeyBack, InputTypeShort);
+        app.join();
+
+        double fps = draw.draws * 1e6 / elapsed_us;
+        printf("render %-8s  %5.1f fps, %.1f us/frame, about: \"%s\"\n",
+               moving ? "moving:" : "still:",
+               fps,
+               draw.draws ? static_cast<double>(draw.draw_us_total) / draw.draws : 0.0,
+               line);
+        bench_expect(moving ? fps > 12.0 : fps < 2.0, "frames drawn only when the screen changes");
+    }
+
+    // Formatting: a slowly drifting value, as a settled reading is
+    const uint32_t rounds = 200000;
+    char buffer[16];
+    volatile uint32_t sink = 0;
+    uint64_t start = furi_shim_now_us();
+    for (uint32_t i = 0; i < rounds; i++) {
+        snprintf(buffer, sizeof(buffer), "%.2f g", static_cast<double>(1000 + i / 64) / 1000.0);
+        sink = sink + buffer[0];
+    }
+    uint64_t float_us = furi_shim_now_us() - start;
+    Mpu6050CachedText cache = {};
+    start = furi_shim_now_us();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sink = sink + mpu6050_cached_milli(&cache, 1000 + i / 64, 2, " g")[0];
+    }
+    uint64_t cached_us = furi_shim_now_us() - start;
+    printf("render format:   float printf %.1f ns/value, cached integer %.1f ns/value\n",
+           float_us * 1000.0 / rounds,
+           cached_us * 1000.0 / rounds);
+}
+
+// Times the statistics engine per sample and checks every window against a
+// brute-force pass over the samples it reports to cover
+static void bench_stats(void) {
+    static Mpu6050Stats stats;
+    static Mpu6050SampleBlock block;
+    static int16_t history[3][25000];
+    const uint32_t total = sizeof(history[0]) / sizeof(history[0][0]);
+    uint32_t seed = 777;
+    for (uint32_t i = 0; i < total; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            seed = seed * 1103515245 + 12345;
+            int32_t noise = static_cast<int32_t>((seed >> 16) % 4001) - 2000;
+            history[axis][i] = static_cast<int16_t>((axis == 2 ? 8192 : 0) + noise * (1 + (i / 5000) % 3));
+        }
+    }
+
+    stats.init(1000);
+    uint64_t start = furi_shim_now_us();
+    // Blocks of varying length, as the ring hands them out
+    for (uint32_t done = 0; done < total;) {
+        uint32_t n = 13 + done % 67;
+        if (n > total - done) n = total - done;
+        for (int axis = 0; axis < 3; axis++) memcpy(block.acc[axis], &history[axis][done], n * sizeof(int16_t));
+        block.count = n;
+        block.accel_fsr = Mpu6050AccelFsr_4g;
+        stats.push(block);
+        done += n;
+    }
+    uint64_t took = furi_shim_now_us() - start;
+
+    bool match = true;
+    for (int window = 0; window < Mpu6050StatsWindow_Count; window++) {
+        for (uint8_t channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+            Mpu6050StatsResult result;
+            stats.window(static_cast<Mpu6050StatsWindow>(window)).result(channel, &result);
+            int64_t sum = 0;
+            int64_t sum_sq = 0;
+            int32_t min = INT32_MAX;
+            int32_t max = INT32_MIN;
+            for (uint32_t i = total - result.samples; i < total; i++) {
+                int32_t value;
+                if (channel < 3) {
+                    value = history[channel][i];
+                } else {
+                    int32_t x = history[0][i], y = history[1][i], z = history[2][i];
+                    value = static_cast<int32_t>(mpu6050_isqrt32(x * x + y * y + z * z));
+                }
+                sum += value;
+                sum_sq += static_cast<int64_t>(value) * value;
+                if (value < min) min = value;
+                if (value > max) max = value;
+            }
+            double mean = static_cast<double>(sum) / result.samples;
+            double std_dev = sqrt(static_cast<double>(sum_sq) / result.samples - mean * mean);
+            if (result.min != min || result.max != max || result.mean != static_cast<int32_t>(sum / result.samples) ||
+                fabs(result.std_dev - std_dev) > 1.0) {
+                match = false;
+            }
+        }
+    }
+
+    printf("stats:           %.1f ns/sample for 3 windows x 4 channels, brute-force check %s\n",
+           took * 1000.0 / total,
+           bench_expect(match, "statistics match a brute-force pass") ? "ok" : "FAILED");
+}
+
+// Times the trigger per sample on a noisy 1 g stream with a 3 g shock every
+// second (offset by half a second, so the first one has history behind it). Events are collected as soon as the pool fills, so every shock must
+// be captured once, with the trigger on the shock's first sample.
+static void bench_trigger(void) {
+    static Mpu6050Trigger trigger;
+    static Mpu6050SampleBlock block;
+    const uint32_t total = 60000;
+    const uint32_t period = 1000;
+    const uint32_t shock_length = 5;
+    const Mpu6050TriggerConfig config = {
+        Mpu6050TriggerMode_Auto, Mpu6050TriggerSource_Magnitude, Mpu6050TriggerEdge_Rising, 2000, 50, 500};
+    mpu6050_trigger_init(&trigger, config, 1000);
+
+    uint32_t seed = 4242;
+    uint32_t captured = 0;
+    bool aligned = true;
+    uint64_t took = 0;
+    for (uint32_t done = 0; done < total;) {
+        uint32_t n = 13 + done % 67;
+        if (n > total - done) n = total - done;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t sample = done + i;
+            for (int axis = 0; axis < 3; axis++) {
+                seed = seed * 1103515245 + 12345;
+                block.acc[axis][i] = static_cast<int16_t>(static_cast<int32_t>((seed >> 16) % 401) - 200);
+            }
+            bool shock = (sample + period / 2) % period < shock_length;
+            block.acc[2][i] = static_cast<int16_t>(block.acc[2][i] + (shock ? 3 * 8192 : 8192));
+            block.timestamp[i] = sample * 1000;
+        }
+        block.count = n;
+        block.accel_fsr = Mpu6050AccelFsr_4g;
+
+        uint64_t start = furi_shim_now_us();
+        mpu6050_trigger_push(&trigger, &block);
+        took += furi_shim_now_us() - start;
+        done += n;
+
+        // Collect finished events, as a user browsing and deleting them would
+        while (mpu6050_trigger_event_count(&trigger)) {
+            const Mpu6050Event* event = mpu6050_trigger_event(&trigger, 0);
+            if ((event->timestamp_us / 1000 + period / 2) % period != 0 || event->count != MPU6050_EVENT_SAMPLES ||
+                event->acc[2][event->pre_samples] < 2 * 8192 || event->acc[2][event->pre_samples - 1] > 2 * 8192) {
+                aligned = false;
+            }
+            captured++;
+            mpu6050_trigger_delete(&trigger, 0);
+        }
+    }
+
+    printf("trigger:         %.1f ns/sample, %u/%u shocks captured, %u missed, alignment %s\n",
+           took * 1000.0 / total,
+           captured,
+           total / period,
+           trigger.missed,
+           aligned ? "ok" : "FAILED");
+    bench_expect(aligned, "events aligned on the shock");
+    bench_expect(captured == total / period && trigger.missed == 0, "every shock captured once");
+}
+
+// Times min/max decimation of six channels at the slowest timebase and checks
+// that a one-sample spike survives in the column that covers it
+static void bench_decimator(void) {
+    static Mpu6050Decimator decimator;
+    static Mpu6050SampleBlock block;
+    const uint32_t total = 100000;
+    const uint32_t spike_period = 997;
+    const uint32_t samples_per_column = 160;
+    mpu6050_decimator_init(&decimator, samples_per_column);
+
+    uint32_t seed = 99;
+    uint32_t spikes = 0;
+    uint32_t kept = 0;
+    uint64_t took = 0;
+    for (uint32_t done = 0; done < total;) {
+        uint32_t n = 13 + done % 67;
+        if (n > total - done) n = total - done;
+        for (uint32_t i = 0; i < n; i++) {
+            for (int axis = 0; axis < 3; axis++) {
+                seed = seed * 1103515245 + 12345;
+                int16_t noise = static_cast<int16_t>(static_cast<int32_t>((seed >> 16) % 201) - 100);
+                block.acc[axis][i] = noise;
+                block.gyro[axis][i] = noise;
+            }
+            if ((done + i) % spike_period == spike_period / 2) block.acc[0][i] = 20000;
+        }
+        const int16_t* rows[MPU6050_DECIMATOR_CHANNELS] = {
+            block.acc[0], block.acc[1], block.acc[2], block.gyro[0], block.gyro[1], block.gyro[2]};
+
+        uint64_t start = furi_shim_now_us();
+        mpu6050_decimator_push(&decimator, rows, n, 0x11);
+        took += furi_shim_now_us() - start;
+        done += n;
+    }
+
+    // Every spike in the columns still in the ring must show as that column's max
+    uint32_t available = mpu6050_decimator_available(&decimator);
+    for (uint32_t column = decimator.columns - available; column < decimator.columns; column++) {
+        uint32_t first = column * samples_per_column;
+        bool spike = false;
+        for (uint32_t sample = first; sample < first + samples_per_column; sample++) {
+            if (sample % spike_period == spike_period / 2) spike = true;
+        }
+        if (!spike) continue;
+        spikes++;
+        if (decimator.max[0][mpu6050_decimator_slot(column)] == 20000) kept++;
+    }
+
+    printf("decimator:       %.1f ns/sample for 6 channels, %u/%u spikes kept at %u samples/column\n",
+           took * 1000.0 / total,
+           kept,
+           spikes,
+           samples_per_column);
+    bench_expect(spikes > 0 && kept == spikes, "decimator keeps every spike");
+}
+
+static double bench_filter_rms(const int16_t* row, uint32_t count) {
+    double sum_sq = 0.0;
+    for (uint32_t i = 0; i < count; i++) sum_sq += static_cast<double>(row[i]) * row[i];
+    return count ? sqrt(sum_sq / count) : 0.0;
+}
+
+// Fills `count` samples of a 4000-count cosine (a constant at 0 Hz) starting at
+// sample `first`
+static void bench_filter_tone(int16_t* row, uint32_t first, uint32_t count, double hz, uint32_t rate) {
+    for (uint32_t i = 0; i < count; i++) {
+        row[i] = static_cast<int16_t>(lrint(4000.0 * cos(2.0 * M_PI * hz * (first + i) / rate)));
+    }
+}
+
+// Times every biquad type and the decimating FIR over blocks of three rows and
+// measures their gain in the pass and the stop band, then runs the Max G screen
+// behind a high-pass with the chip's low-pass opened up to 98 Hz
+static void bench_filter(void) {
+    typedef struct {
+        const char* name;
+        uint8_t type;
+        uint16_t corner_hz;
+        double pass_hz;
+        double stop_hz;
+    } BenchFilter;
+    static const BenchFilter filters[] = {
+        {"low-pass 20", Mpu6050FilterType_LowPass, 20, 2.0, 200.0},
+        {"high-pass 1", Mpu6050FilterType_HighPass, 1, 10.0, 0.0},
+        {"band-pass 35", Mpu6050FilterType_BandPass, 35, 35.0, 200.0},
+        {"notch 50", Mpu6050FilterType_Notch, 50, 10.0, 50.0},
+    };
+    const uint32_t rate = 1000;
+    const uint32_t total = 20 * rate;  // Per tone and row
+    const uint32_t settled = 10 * rate; // Gain measured past this
+    static Mpu6050SampleBlock block;
+    static Mpu6050SampleBlock out;
+    static Mpu6050FilterChain chain;
+    static int16_t tone_in[2][10 * 1000];
+    static int16_t tone_out[2][10 * 1000];
+    block.accel_fsr = Mpu6050AccelFsr_4g;
+
+    printf("filter stage:    %-13s %10s %8s %8s\n", "", "samples/s", "pass", "stop");
+    for (const BenchFilter& filter : filters) {
+        Mpu6050FilterConfig config = {filter.type, 2, filter.corner_hz};
+        uint64_t took = 0;
+        for (int tone = 0; tone < 2; tone++) {
+            mpu6050_filter_init(&chain, &config, rate);
+            double hz = tone ? filter.stop_hz : filter.pass_hz;
+            for (uint32_t done = 0; done < total; done += MPU6050_BLOCK_SIZE) {
+                for (int axis = 0; axis < 3; axis++) {
+                    bench_filter_tone(block.acc[axis], done, MPU6050_BLOCK_SIZE, hz, rate);
+                }
+                block.count = MPU6050_BLOCK_SIZE;
+                uint64_t start = furi_shim_now_us();
+                mpu6050_filter_run(&chain, &block, &out);
+                took += furi_shim_now_us() - start;
+                if (done >= settled) {
+                    memcpy(&tone_in[tone][done - settled], block.acc[2], sizeof(block.acc[2]));
+                    memcpy(&tone_out[tone][done - settled], out.acc[2], sizeof(out.acc[2]));
+                }
+            }
+        }
+        // Two tones, three rows, two stages
+        double stage_samples = 2.0 * 3 * total * config.stages;
+        double pass = bench_filter_rms(tone_out[0], total - settled) / bench_filter_rms(tone_in[0], total - settled);
+        double stop = bench_filter_rms(tone_out[1], total - settled) / bench_filter_rms(tone_in[1], total - settled);
+        printf("filter stage:    %-13s %9.1fM %8.3f %8.3f   (order 4, %.0f / %.0f Hz)\n",
+               filter.name,
+               took ? stage_samples / took : 0.0,
+               pass,
+               stop,
+               filter.pass_hz,
+               filter.stop_hz);
+        bench_expect(pass > 0.9 && stop < 0.1, "filter passes its pass band and stops its stop band");
+    }
+
+    // The FIR: a tone at 0.2 of the output rate passes, one that would alias
+    // onto 0.25 of it is stopped
+    static Mpu6050Fir fir;
+    static int16_t decimated[MPU6050_BLOCK_SIZE];
+    for (uint8_t decimation = 2; decimation <= MPU6050_FIR_MAX_DECIMATION; decimation *= 2) {
+        uint64_t took = 0;
+        double gain[2];
+        for (int tone = 0; tone < 2; tone++) {
+            mpu6050_fir_init(&fir, decimation);
+            double hz = (tone ? 0.75 : 0.2) * rate / decimation;
+            uint32_t kept = 0;
+            for (uint32_t done = 0; done < total; done += MPU6050_BLOCK_SIZE) {
+                bench_filter_tone(block.acc[0], done, MPU6050_BLOCK_SIZE, hz, rate);
+                uint64_t start = furi_shim_now_us();
+                uint32_t n = mpu6050_fir_decimate(&fir, block.acc[0], MPU6050_BLOCK_SIZE, decimated);
+                took += furi_shim_now_us() - start;
+                if (done >= settled) {
+                    memcpy(&tone_out[tone][kept], decimated, n * sizeof(int16_t));
+                    kept += n;
+                }
+            }
+            gain[tone] = bench_filter_rms(tone_out[tone], kept) * M_SQRT2 / 4000.0;
+        }
+        printf("filter stage:    fir /%-7u %9.1fM %8.3f %8.3f   (%u taps, %.0f / %.0f Hz)\n",
+               decimation,
+               took ? 2.0 * total / took : 0.0,
+               gain[0],
+               gain[1],
+               decimation * MPU6050_FIR_TAPS_PER_PHASE,
+               0.2 * rate / decimation,
+               0.75 * rate / decimation);
+        bench_expect(gain[0] > 0.9 && gain[1] < 0.05, "FIR passes below and stops what would alias");
+    }
+
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    // Settings: chip low-pass 20 -> 98 Hz, filter off -> high-pass (10 Hz, order 4)
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    for (int row = 0; row < 3; row++) furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyLeft, InputTypeShort);
+    furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyRight, InputTypeShort);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    furi_shim_send_input(InputKeyOk, InputTypeShort); // Max G
+    furi_delay_ms(1500);
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    uint8_t config_reg = sim.regs[0x1A];
+    uint32_t sim_rate = mpu6050_sim_sample_rate(&sim);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("filter chip:     CONFIG 0x%02X, %lu samples/s\n", config_reg, (unsigned long)sim_rate);
+    printf("filter screen:   \"%s\" (gravity on Z removed)\n", text);
+    bench_expect(config_reg == 0x02 && sim_rate == 1000, "chip low-pass reaches CONFIG at 1 kHz");
+    bench_expect(strstr(text, "Z: 0.00 0.00") != NULL, "high-pass takes gravity out");
+}
+
+// Rocking motion for the fusion bench: roll 30 degrees at 0.5 Hz, pitch 20
+// degrees at 0.3 Hz, no yaw. Angles in radians, accel in g, gyro in deg/s.
+static void bench_fusion_motion(float t, float* roll, float* pitch, float acc[3], float gyro[3]) {
+    const float pi = 3.14159265f;
+    *roll = 30.0f * pi / 180.0f * sinf(2.0f * pi * 0.5f * t);
+    *pitch = 20.0f * pi / 180.0f * sinf(2.0f * pi * 0.3f * t);
+    float roll_rate = 30.0f * 2.0f * pi * 0.5f * cosf(2.0f * pi * 0.5f * t);
+    float pitch_rate = 20.0f * 2.0f * pi * 0.3f * cosf(2.0f * pi * 0.3f * t);
+    acc[0] = -sinf(*pitch);
+    acc[1] = sinf(*roll) * cosf(*pitch);
+    acc[2] = cosf(*roll) * cosf(*pitch);
+    gyro[0] = roll_rate;
+    gyro[1] = cosf(*roll) * pitch_rate;
+    gyro[2] = -sinf(*roll) * pitch_rate;
+}
+
+// Runs both fusion filters over a minute of simulated rocking with sensor noise
+// and a 0.5 deg/s gyro bias, then checks the Tilt page on a sensor held at 30
+// degrees of roll
+static void bench_fusion(void) {
+    static Mpu6050SampleBlock block;
+    const uint32_t rate = 1000;
+    const uint32_t total = 60 * rate;
+    const float acc_lsb = mpu6050_accel_lsb_per_g[Mpu6050AccelFsr_4g];
+    const float gyro_lsb = mpu6050_gyro_lsb_per_dps_x10[Mpu6050GyroFsr_500] / 10.0f;
+    block.accel_fsr = Mpu6050AccelFsr_4g;
+    block.gyro_fsr = Mpu6050GyroFsr_500;
+
+    for (int filter = 0; filter < Mpu6050FusionFilter_Count; filter++) {
+        static Mpu6050Fusion fusion;
+        mpu6050_fusion_init(&fusion, static_cast<Mpu6050FusionFilter>(filter), rate);
+        uint32_t seed = 7;
+        uint64_t took = 0;
+        double error_sq = 0.0;
+        uint32_t errors = 0;
+        for (uint32_t done = 0; done < total; done += MPU6050_BLOCK_SIZE) {
+            float roll = 0.0f;
+            float pitch = 0.0f;
+            for (uint32_t i = 0; i < MPU6050_BLOCK_SIZE; i++) {
+                float acc[3];
+                float gyro[3];
+                bench_fusion_motion(static_cast<float>(done + i) / rate, &roll, &pitch, acc, gyro);
+                gyro[0] += 0.5f;
+                for (int axis = 0; axis < 3; axis++) {
+                    seed = seed * 1103515245 + 12345;
+                    float noise = static_cast<float>(static_cast<int32_t>((seed >> 16) % 201) - 100) / 100.0f;
+                    block.acc[axis][i] = static_cast<int16_t>(lrintf((acc[axis] + noise * 0.01f) * acc_lsb));
+                    block.gyro[axis][i] = static_cast<int16_t>(lrintf((gyro[axis] + noise * 0.2f) * gyro_lsb));
+                }
+            }
+            block.count = MPU6050_BLOCK_SIZE;
+
+            uint64_t start = furi_shim_now_us();
+            mpu6050_fusion_push(&fusion, &block);
+            took += furi_shim_now_us() - start;
+
+            // Compare against the truth at the block's last sample, past the first seconds
+            if (done < 5 * rate) continue;
+            Mpu6050Euler euler;
+            mpu6050_fusion_euler(&fusion, &euler);
+            double roll_error = euler.roll / 1000.0 - roll * 180.0 / M_PI;
+            double pitch_error = euler.pitch / 1000.0 - pitch * 180.0 / M_PI;
+            error_sq += roll_error * roll_error + pitch_error * pitch_error;
+            errors += 2;
+        }
+        printf("fusion:          %-13s %.1f ns/update, roll/pitch rms error %.2f deg\n",
+               filter == Mpu6050FusionFilter_Madgwick ? "Madgwick" : "Complementary",
+               took * 1000.0 / total,
+               sqrt(error_sq / errors));
+        bench_expect(sqrt(error_sq / errors) < 1.0, "fusion roll/pitch within a degree");
+    }
+
+    static const Mpu6050SimSegment tilted[] = {{1000, {0.0f, 0.5f, 0.866f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f}};
+    static Mpu6050Sim sim;
+    bench_attach_sim(&sim, 400000, 20, 0);
+    mpu6050_sim_set_script(&sim, tilted, COUNT_OF(tilted));
+
+    std::thread app = bench_launch();
+    furi_delay_ms(300);
+    furi_shim_send_input(InputKeyDown, InputTypeShort);
+    furi_shim_send_input(InputKeyDown, InputTypeShort); // Tilt page
+    furi_delay_ms(1000);
+    char text[256];
+    furi_shim_screen_text(text, sizeof(text));
+    furi_shim_send_input(InputKeyBack, InputTypeShort);
+    app.join();
+
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') *c = ' ';
+    }
+    printf("tilt screen:     \"%s\" (simulated roll 30.0)\n", text);
+    bench_expect(strstr(text, "Roll: 30.") != NULL || strstr(text, "Roll: 29.") != NULL, "tilt page shows the roll");
+}
+
+// Keeps the optimiser from discarding benchmark results
+static volatile int32_t bench_sink;
+
+// Float path the app used before fixed-point units: every sample is divided
+// into g and folded into a float running maximum
+static __attribute__((noinline)) void bench_convert_float(const Mpu6050SampleBlock* block, float max_g[3]) {
+    float sensitivity = mpu6050_accel_lsb_per_g[block->accel_fsr];
+    for (int axis = 0; axis < 3; axis++) {
+        for (uint32_t i = 0; i < block->count; i++) {
+            float g = fabsf(block->acc[axis][i] / sensitivity);
+            if (g > max_g[axis]) max_g[axis] = g;
+        }
+    }
+}
+
+// Fixed-point path: integer peak over the raw row, one conversion per block
+static __attribute__((noinline)) void bench_convert_fixed(const Mpu6050SampleBlock* block, int32_t max_mg[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t mg = mpu6050_accel_counts_to_mg(mpu6050_row_peak(block->acc[axis], block->count), block->accel_fsr);
+        if (mg > max_mg[axis]) max_mg[axis] = mg;
+    }
+}
+
+// Timestamps a sensor whose clock runs 1.5% fast, read every 4 to 6 ms against
+// the 1 ms system tick, in simulated time. After a 2 s settle the stamps are
+// compared with the times the simulator produced the samples at, next to the
+// old stamping (the newest sample at the tick, the rest at the nominal period).
+// A 150 ms stall halfway overflows the FIFO and must show up as dropped samples.
+static void bench_timebase(void) {
+    static Mpu6050Sim sim;
+    static uint8_t frames[MPU6050_FIFO_MAX_FRAMES * MPU6050_FRAME_SIZE];
+    static Mpu6050SampleBlock block;
+    static Mpu6050Timebase timebase;
+    mpu6050_sim_init(&sim, MPU6050_I2C_ADDR);
+    sim.clock_ppm = 15000;
+    Mpu6050Bus bus;
+    mpu6050_sim_bind(&sim, &bus);
+    Mpu6050 sensor;
+    sensor.bind(&bus);
+    const Mpu6050Config& config = mpu6050_default_config;
+    Mpu6050InitStatus status = sensor.begin_init(config) ? Mpu6050InitStatus_Pending : Mpu6050InitStatus_Failed;
+    while (status == Mpu6050InitStatus_Pending) {
+        mpu6050_sim_advance(&sim, 1000);
+        status = sensor.continue_init();
+    }
+    mpu6050_timebase_init(&timebase, config.sample_rate_hz());
+
+    const uint32_t polls = 4000;
+    const uint32_t stall_poll = polls / 2;
+    const double true_period_us = 1e6 / config.sample_rate_hz() * (1.0 - sim.clock_ppm / 1e6);
+    uint32_t seed = 12345;
+    double tracked_sq = 0.0;
+    double naive_sq = 0.0;
+    int32_t tracked_max = 0;
+    int32_t naive_max = 0;
+    double interval_max = 0.0; // Largest departure of a sample interval from the true period
+    uint32_t checked = 0;
+    uint32_t last_stamp = 0;
+    for (uint32_t poll = 0; poll < polls; poll++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t wait_us = poll == stall_poll ? 150000 : 4000 + (seed >> 16) % 2000;
+        mpu6050_sim_advance(&sim, wait_us);
+
+        uint32_t now_us = static_cast<uint32_t>(sim.time_us / 1000 * 1000 + 500); // Middle of the system tick
+        uint32_t lost = sensor.fifo().frames_lost;
+        size_t count = 0;
+        sensor.read_fifo(frames, MPU6050_FIFO_MAX_FRAMES, &count);
+        mpu6050_decode_block(frames, count, &block);
+        mpu6050_timebase_stamp(&timebase, &block, config.sample_rate_hz(), now_us, sensor.fifo().frames_lost - lost);
+        if (!count) continue;
+
+        if (poll >= 400 && (poll < stall_poll || poll >= stall_poll + 10)) {
+            uint32_t truth = static_cast<uint32_t>(sim.last_read_sample_us);
+            int32_t tracked = static_cast<int32_t>(block.timestamp[count - 1] - truth);
+            int32_t naive = static_cast<int32_t>(now_us - 500 - truth); // At the start of the tick, as before
+            tracked_sq += static_cast<double>(tracked) * tracked;
+            naive_sq += static_cast<double>(naive) * naive;
+            if (abs(tracked) > tracked_max) tracked_max = abs(tracked);
+            if (abs(naive) > naive_max) naive_max = abs(naive);
+            checked++;
+            uint32_t previous = last_stamp;
+            for (size_t i = 0; i < count; i++) {
+                double off = fabs(static_cast<double>(block.timestamp[i] - previous) - true_period_us);
+                if ((i || poll != stall_poll + 10) && off > interval_max) interval_max = off;
+                previous = block.timestamp[i];
+            }
+        }
+        last_stamp = block.timestamp[count - 1];
+    }
+
+    Mpu6050TimebaseStats stats;
+    mpu6050_timebase_get_stats(&timebase, &stats);
+    // Every sample produced and not read back, bar the ones still queued
+    uint32_t sim_lost = sim.samples_to_fifo - sim.frames_read - sim.fifo_count / MPU6050_FRAME_SIZE;
+    printf("timebase:        %.3f Hz estimated, %.3f Hz true, drift %+ld ppm (true %+.0f)\n",
+           stats.rate_mhz / 1000.0,
+           1e6 / true_period_us,
+           (long)stats.drift_ppm,
+           (1000.0 / true_period_us - 1.0) * 1e6);
+    printf("timebase:        newest stamp off by %.0f us RMS / %ld us max, tick stamping %.0f / %ld us\n",
+           checked ? sqrt(tracked_sq / checked) : 0.0,
+           (long)tracked_max,
+           checked ? sqrt(naive_sq / checked) : 0.0,
+           (long)naive_max);
+    printf("timebase:        sample intervals within %.0f us of the period, step %lu us, anchor %lu us\n",
+           interval_max,
+           (unsigned long)stats.step_us,
+           (unsigned long)stats.anchor_error_us);
+    printf("timebase:        dropped %lu (simulator lost %lu), %lu resyncs, %lu samples\n",
+           (unsigned long)stats.dropped,
+           (unsigned long)sim_lost,
+           (unsigned long)stats.resyncs,
+           (unsigned long)stats.samples);
+    bench_expect(fabs(stats.rate_mhz / 1000.0 - 1e6 / true_period_us) < 1.0, "timebase rate within 1 Hz");
+    bench_expect(checked && sqrt(tracked_sq / checked) < sqrt(naive_sq / checked), "timebase beats tick stamping");
+    bench_expect(stats.dropped == sim_lost, "timebase counts every dropped sample");
+}
+
+// Compares the per-block cost of the float and fixed-point max-G paths
+static void bench_convert(void) {
+    static Mpu6050SampleBlock block;
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < MPU6050_BLOCK_SIZE; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            seed = seed * 1103515245 + 12345;
+            block.acc[axis][i] = static_cast<int16_t>(seed >> 16);
+        }
+    }
+    block.count = MPU6050_BLOCK_SIZE;
+    block.accel_fsr = Mpu6050AccelFsr_4g;
+
+    const uint32_t rounds = 200000;
+    float max_g[3] = {0, 0, 0};
+    uint64_t start = furi_shim_now_us();
+    for (uint32_t r = 0; r < rounds; r++) bench_convert_float(&block, max_g);
+    uint64_t float_us = furi_shim_now_us() - start;
+
+    int32_t max_mg[3] = {0, 0, 0};
+    start = furi_shim_now_us();
+    for (uint32_t r = 0; r < rounds; r++) bench_convert_fixed(&block, max_mg);
+    uint64_t fixed_us = furi_shim_now_us() - start;
+    bench_sink = static_cast<int32_t>(max_g[0] * 1000) + max_mg[0];
+
+    double samples = static_cast<double>(rounds) * MPU6050_BLOCK_SIZE;
+    printf("max-g convert:   float %.2f ns/sample, fixed %.2f ns/sample (%.1fx), peak %.3f g vs %d mg\n",
+           float_us * 1000.0 / samples,
+           fixed_us * 1000.0 / samples,
+           fixed_us ? static_cast<double>(float_us) / fixed_us : 0.0,
+           static_cast<double>(max_g[0]),
+           static_cast<int>(max_mg[0]));
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = 3;
+    const char* only = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--scenario NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    furi_shim_storage_set_root(bench_shared_root().c_str());
+    printf("%-16s %9s %9s %8s %8s %7s %6s %7s %8s %8s\n",
+           "scenario", "samples/s", "lost", "tx/smp", "B/smp", "bus", "errors", "draw us",
+           "lat ms", "lat max");
+    for (size_t i = 0; i < sizeof(bench_scenarios) / sizeof(bench_scenarios[0]); i++) {
+        if (only && strcmp(only, bench_scenarios[i].name) != 0) continue;
+        bench_run(&bench_scenarios[i], seconds);
+    }
+    if (!only) {
+        bench_reconfigure();
+        bench_record(seconds);
+        bench_convert();
+        bench_stats();
+        bench_trigger();
+        bench_decimator();
+        bench_fft();
+        bench_spectrum_screen();
+        bench_filter();
+        bench_fusion();
+        bench_timebase();
+        bench_render(seconds);
+        bench_dual(seconds);
+        bench_calibration();
+        bench_diagnostics(seconds);
+        bench_stream(argv[0], seconds);
+        bench_power();
+        bench_recovery();
+        bench_part();
+        bench_warm_start();
+        bench_replay();
+    }
+    if (bench_failures) printf("\n%lu checks FAILED\n", (unsigned long)bench_failures);
+    return bench_failures ? 1 : 0;
+}
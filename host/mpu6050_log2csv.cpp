@@ -0,0 +1,108 @@
+// Validates a recording made by the app and converts it to CSV.
+//
+//   mpu6050_log2csv log_000.bin [out.csv]
+//
+// One row per sample: timestamp, raw counts, and milli-g / milli-deg/s /
+// centi-deg C. A summary (chunks, samples, dropped chunks, damaged bytes) goes
+// to stderr; the exit status is non-zero if the file is not a clean recording.
+#include <stdio.h>
+#include <vector>
+#include "mpu6050_log.h"
+#include "mpu6050_units.h"
+
+static bool read_file(const char* path, std::vector<uint8_t>* data) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data->insert(data->end(), buffer, buffer + n);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s LOG [CSV]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!read_file(argv[1], &data)) {
+        fprintf(stderr, "%s: cannot read\n", argv[1]);
+        return 2;
+    }
+    Mpu6050LogHeader header;
+    if (data.size() < sizeof(header)) {
+        fprintf(stderr, "%s: too short for a header\n", argv[1]);
+        return 1;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (!mpu6050_log_header_valid(&header)) {
+        fprintf(stderr, "%s: not an MPU-6050 recording (or unsupported version)\n", argv[1]);
+        return 1;
+    }
+
+    FILE* out = argc == 3 ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "%s: cannot write\n", argv[2]);
+        return 2;
+    }
+    fprintf(out, "t_us,ax,ay,az,gx,gy,gz,temp,ax_mg,ay_mg,az_mg,gx_mdps,gy_mdps,gz_mdps,temp_cc\n");
+
+    static Mpu6050SampleBlock block;
+    Mpu6050LogChunkHeader chunk;
+    uint32_t chunks = 0;
+    uint32_t samples = 0;
+    uint32_t dropped = 0;
+    uint32_t damaged_bytes = 0;
+    uint32_t expected_sequence = 0;
+    size_t offset = sizeof(header);
+
+    while (offset < data.size()) {
+        size_t used = mpu6050_log_decode_chunk(&data[offset], data.size() - offset, &chunk, &block);
+        if (!used) {
+            // Resynchronise on the next sync marker
+            offset++;
+            damaged_bytes++;
+            continue;
+        }
+        offset += used;
+
+        if (chunk.sequence > expected_sequence) dropped += chunk.sequence - expected_sequence;
+        expected_sequence = chunk.sequence + 1;
+        chunks++;
+        samples += block.count;
+
+        for (uint32_t i = 0; i < block.count; i++) {
+            fprintf(out, "%lu", (unsigned long)block.timestamp[i]);
+            for (int axis = 0; axis < 3; axis++) fprintf(out, ",%d", block.acc[axis][i]);
+            for (int axis = 0; axis < 3; axis++) fprintf(out, ",%d", block.gyro[axis][i]);
+            fprintf(out, ",%d", block.temp[i]);
+            for (int axis = 0; axis < 3; axis++) {
+                fprintf(out, ",%ld", (long)mpu6050_accel_counts_to_mg(block.acc[axis][i], block.accel_fsr));
+            }
+            for (int axis = 0; axis < 3; axis++) {
+                fprintf(out, ",%ld", (long)mpu6050_gyro_counts_to_mdps(block.gyro[axis][i], block.gyro_fsr));
+            }
+            fprintf(out, ",%ld\n", (long)mpu6050_temp_counts_to_centi_c<Mpu6050Variant::Mpu6050>(block.temp[i]));
+        }
+    }
+    if (out != stdout) fclose(out);
+
+    fprintf(stderr,
+            "%s: addr 0x%02X, %u Hz, accel fsr %u, gyro fsr %u\n"
+            "%u chunks, %u samples, %.2f bytes/sample, %u chunks dropped, %u damaged bytes\n",
+            argv[1],
+            header.address,
+            header.sample_rate_hz,
+            header.accel_fsr,
+            header.gyro_fsr,
+            chunks,
+            samples,
+            samples ? static_cast<double>(data.size()) / samples : 0.0,
+            dropped,
+            damaged_bytes);
+    return damaged_bytes ? 1 : 0;
+}
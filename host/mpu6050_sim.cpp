@@ -0,0 +1,354 @@
+#include "mpu6050_sim.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_REG_XA_OFFS_H 0x06
+#define SIM_REG_XG_OFFS_USRH 0x13
+#define SIM_REG_SMPLRT_DIV 0x19
+#define SIM_REG_CONFIG 0x1A
+#define SIM_REG_GYRO_CONFIG 0x1B
+#define SIM_REG_ACCEL_CONFIG 0x1C
+#define SIM_REG_MOT_THR 0x1F
+#define SIM_REG_ACCEL_XOUT_H 0x3B
+#define SIM_REG_FIFO_COUNTL 0x73
+#define SIM_REG_PWR_MGMT_1 0x6B
+#define SIM_REG_PWR_MGMT_2 0x6C
+#define SIM_REG_WHO_AM_I 0x75
+
+#define SIM_PWR_RESET 0x80
+#define SIM_PWR_SLEEP 0x40
+#define SIM_PWR_CYCLE 0x20
+
+// Cycle mode wake periods by LP_WAKE_CTRL: 1.25, 5, 20 and 40 Hz
+static const uint64_t sim_wake_period_ns[4] = {800000000, 200000000, 50000000, 25000000};
+
+static void put_be16(uint8_t* out, int16_t value) {
+    out[0] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+    out[1] = static_cast<uint8_t>(value);
+}
+
+static int16_t get_be16(const uint8_t* data) {
+    return static_cast<int16_t>((data[0] << 8) | data[1]);
+}
+
+static void sim_reset(Mpu6050Sim* sim) {
+    memset(sim->regs, 0, sizeof(sim->regs));
+    for (int i = 0; i < 3; i++) put_be16(&sim->regs[SIM_REG_XA_OFFS_H + i * 2], sim->accel_trim[i]);
+    sim->regs[SIM_REG_PWR_MGMT_1] = SIM_PWR_SLEEP; // Power-on default is sleep
+    sim->regs[SIM_REG_WHO_AM_I] = 0x68;
+    sim->fifo_head = 0;
+    sim->fifo_count = 0;
+    sim->frame_time_head = 0;
+    sim->frame_time_count = 0;
+    sim->partial_pop = 0;
+    sim->partial_drop = 0;
+    sim->sample_index = 0;
+    sim->motion_time_ns = 0;
+    for (int i = 0; i < 3; i++) sim->motion_last[i] = 0;
+    sim->next_sample_ns = sim->time_us * 1000;
+    sim->reset_done_us = 0;
+}
+
+void mpu6050_sim_init(Mpu6050Sim* sim, uint8_t address) {
+    sim->address = address;
+    sim->time_us = 0;
+    sim->clock_ppm = 0;
+    sim->reset_us = 30000;
+    for (int i = 0; i < 3; i++) {
+        sim->acc_bias[i] = 0.0f;
+        sim->gyro_bias[i] = 0.0f;
+    }
+    // Typical factory trims; bit 0 is reserved and kept by the driver
+    sim->accel_trim[0] = -2531;
+    sim->accel_trim[1] = 1080;
+    sim->accel_trim[2] = 1451;
+    sim->motion = NULL;
+    sim->motion_context = NULL;
+    sim->script = NULL;
+    sim->script_length = 0;
+    sim->samples_to_fifo = 0;
+    sim->frames_read = 0;
+    sim->fifo_overflows = 0;
+    sim->resets = 0;
+    sim->cycle_samples = 0;
+    sim->motion_events = 0;
+    sim->last_read_sample_us = 0;
+    sim_reset(sim);
+}
+
+void mpu6050_sim_power_cycle(Mpu6050Sim* sim) {
+    sim_reset(sim);
+}
+
+void mpu6050_sim_set_motion(Mpu6050Sim* sim, Mpu6050SimMotion motion, void* context) {
+    sim->motion = motion;
+    sim->motion_context = context;
+}
+
+void mpu6050_sim_set_script(Mpu6050Sim* sim, const Mpu6050SimSegment* segments, size_t count) {
+    sim->script = segments;
+    sim->script_length = count;
+}
+
+uint32_t mpu6050_sim_sample_rate(const Mpu6050Sim* sim) {
+    uint8_t dlpf = sim->regs[SIM_REG_CONFIG] & 0x07;
+    uint32_t gyro_rate = (dlpf == 0 || dlpf == 7) ? 8000 : 1000;
+    return gyro_rate / (1 + sim->regs[SIM_REG_SMPLRT_DIV]);
+}
+
+bool mpu6050_sim_cycling(const Mpu6050Sim* sim) {
+    return (sim->regs[SIM_REG_PWR_MGMT_1] & (SIM_PWR_CYCLE | SIM_PWR_SLEEP)) == SIM_PWR_CYCLE;
+}
+
+// Time to the next sample: the wake period in cycle mode, else the sample rate
+static uint64_t sim_sample_period_ns(const Mpu6050Sim* sim) {
+    if (mpu6050_sim_cycling(sim)) return sim_wake_period_ns[sim->regs[SIM_REG_PWR_MGMT_2] >> 6];
+    return 1000000000 / mpu6050_sim_sample_rate(sim);
+}
+
+static int16_t to_counts(float value, float lsb_per_unit) {
+    float counts = value * lsb_per_unit;
+    if (counts > 32767.0f) counts = 32767.0f;
+    if (counts < -32768.0f) counts = -32768.0f;
+    return static_cast<int16_t>(lrintf(counts));
+}
+
+#define SIM_TWO_PI 6.2831853f
+
+// Default motion: gravity on Z with a small vibration on X/Y and a slow rotation
+static void sim_default_motion(float t, float acc[3], float gyro[3]) {
+    acc[0] = 0.25f * sinf(SIM_TWO_PI * 35.0f * t);
+    acc[1] = 0.1f * cosf(SIM_TWO_PI * 12.0f * t);
+    acc[2] = 1.0f;
+    gyro[0] = 20.0f * sinf(SIM_TWO_PI * 0.5f * t);
+    gyro[1] = -10.0f;
+    gyro[2] = 5.0f * cosf(SIM_TWO_PI * 2.0f * t);
+}
+
+static void sim_script_motion(const Mpu6050Sim* sim, float t, float acc[3], float gyro[3]) {
+    uint32_t total_ms = 0;
+    for (size_t i = 0; i < sim->script_length; i++) total_ms += sim->script[i].duration_ms;
+
+    uint32_t at_ms = total_ms ? static_cast<uint32_t>(t * 1000.0f) % total_ms : 0;
+    const Mpu6050SimSegment* segment = &sim->script[0];
+    for (size_t i = 0; i < sim->script_length; i++) {
+        segment = &sim->script[i];
+        if (at_ms < segment->duration_ms) break;
+        at_ms -= segment->duration_ms;
+    }
+
+    float vibration = segment->vib_g * sinf(SIM_TWO_PI * segment->vib_hz * t);
+    for (int i = 0; i < 3; i++) {
+        acc[i] = segment->acc[i] + vibration;
+        gyro[i] = segment->gyro[i];
+    }
+}
+
+// Raises MOT_INT when an accel axis changed by more than MOT_THR since the last sample
+static void sim_detect_motion(Mpu6050Sim* sim, const float acc[3]) {
+    float threshold_g = sim->regs[SIM_REG_MOT_THR] * 0.002f;
+    bool motion = false;
+    for (int i = 0; i < 3; i++) {
+        int16_t counts = to_counts(acc[i], 2048.0f); // Full 16 g range
+        if (abs(counts - sim->motion_last[i]) > threshold_g * 2048.0f) motion = true;
+        sim->motion_last[i] = counts;
+    }
+    if (motion && sim->sample_index && (sim->regs[MPU6050_REG_INT_ENABLE] & MPU6050_INT_MOT)) {
+        sim->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_MOT;
+        sim->motion_events++;
+    }
+}
+
+// Produces one sample into the data registers
+static void sim_generate(Mpu6050Sim* sim) {
+    float t = static_cast<float>(sim->motion_time_ns / 1000) / 1e6f;
+    float accel_lsb = 16384.0f / static_cast<float>(1 << ((sim->regs[SIM_REG_ACCEL_CONFIG] >> 3) & 3));
+    float gyro_lsb = 131.0f / static_cast<float>(1 << ((sim->regs[SIM_REG_GYRO_CONFIG] >> 3) & 3));
+
+    float acc[3];
+    float gyro[3];
+    float temp_c = 25.0f;
+    if (sim->motion) {
+        sim->motion(sim->motion_context, t, acc, gyro, &temp_c);
+    } else if (sim->script_length) {
+        sim_script_motion(sim, t, acc, gyro);
+    } else {
+        sim_default_motion(t, acc, gyro);
+    }
+
+    // Sensor errors less what the offset registers cancel, as they stand now
+    for (int i = 0; i < 3; i++) {
+        int32_t trim = get_be16(&sim->regs[SIM_REG_XA_OFFS_H + i * 2]) & ~1;
+        acc[i] += sim->acc_bias[i] + static_cast<float>(trim - (sim->accel_trim[i] & ~1)) / 2048.0f;
+        int16_t gyro_offset = get_be16(&sim->regs[SIM_REG_XG_OFFS_USRH + i * 2]);
+        gyro[i] += sim->gyro_bias[i] + static_cast<float>(gyro_offset) / 32.8f;
+    }
+
+    sim_detect_motion(sim, acc);
+
+    uint8_t* out = &sim->regs[SIM_REG_ACCEL_XOUT_H];
+    for (int i = 0; i < 3; i++) put_be16(out + i * 2, to_counts(acc[i], accel_lsb));
+    put_be16(out + 6, static_cast<int16_t>(lrintf((temp_c - 36.53f) * 340.0f)));
+    for (int i = 0; i < 3; i++) put_be16(out + 8 + i * 2, to_counts(gyro[i], gyro_lsb));
+    sim->sample_index++;
+}
+
+#define SIM_FRAME_TIMES (MPU6050_FIFO_MAX_FRAMES + 1)
+
+static void sim_frame_time_pop(Mpu6050Sim* sim, bool read_back) {
+    if (sim->frame_time_count == 0) return;
+    if (read_back) {
+        sim->last_read_sample_us = sim->frame_time_us[sim->frame_time_head];
+        sim->frames_read++;
+    }
+    sim->frame_time_head = (sim->frame_time_head + 1) % SIM_FRAME_TIMES;
+    sim->frame_time_count--;
+}
+
+static void sim_frame_time_push(Mpu6050Sim* sim) {
+    if (sim->frame_time_count == SIM_FRAME_TIMES) sim_frame_time_pop(sim, false);
+    sim->frame_time_us[(sim->frame_time_head + sim->frame_time_count) % SIM_FRAME_TIMES] = sim->time_us;
+    sim->frame_time_count++;
+}
+
+static void sim_fifo_push(Mpu6050Sim* sim, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (sim->fifo_count == MPU6050_FIFO_SIZE) {
+            // Full: the chip overwrites the oldest byte
+            sim->fifo_head = (sim->fifo_head + 1) % MPU6050_FIFO_SIZE;
+            sim->fifo_count--;
+            sim->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_FIFO_OFLOW;
+            if (i == 0) sim->fifo_overflows++;
+            if (++sim->partial_drop == MPU6050_FRAME_SIZE) {
+                sim->partial_drop = 0;
+                sim_frame_time_pop(sim, false);
+            }
+        }
+        sim->fifo[(sim->fifo_head + sim->fifo_count) % MPU6050_FIFO_SIZE] = data[i];
+        sim->fifo_count++;
+    }
+}
+
+static void sim_sample(Mpu6050Sim* sim) {
+    sim_generate(sim);
+    if (mpu6050_sim_cycling(sim)) {
+        sim->cycle_samples++;
+        return; // A single accel sample, nothing goes to the FIFO
+    }
+
+    bool fifo_on = sim->regs[MPU6050_REG_USER_CTRL] & MPU6050_USER_CTRL_FIFO_EN;
+    uint8_t fifo_en = sim->regs[MPU6050_REG_FIFO_EN];
+    if (!fifo_on || fifo_en == 0) return;
+
+    // FIFO order follows the register order: accel, temp, gyro X/Y/Z
+    const uint8_t* data = &sim->regs[SIM_REG_ACCEL_XOUT_H];
+    if (fifo_en & MPU6050_FIFO_EN_ACCEL) sim_fifo_push(sim, data, 6);
+    if (fifo_en & MPU6050_FIFO_EN_TEMP) sim_fifo_push(sim, data + 6, 2);
+    if (fifo_en & MPU6050_FIFO_EN_XG) sim_fifo_push(sim, data + 8, 2);
+    if (fifo_en & MPU6050_FIFO_EN_YG) sim_fifo_push(sim, data + 10, 2);
+    if (fifo_en & MPU6050_FIFO_EN_ZG) sim_fifo_push(sim, data + 12, 2);
+    sim_frame_time_push(sim);
+    sim->samples_to_fifo++;
+}
+
+void mpu6050_sim_advance(Mpu6050Sim* sim, uint32_t microseconds) {
+    uint64_t end = sim->time_us + microseconds;
+    while (sim->next_sample_ns <= end * 1000) {
+        sim->time_us = sim->next_sample_ns / 1000;
+        // A positive clock error makes the sensor run fast
+        int64_t period_ns = sim_sample_period_ns(sim);
+        if (!(sim->regs[SIM_REG_PWR_MGMT_1] & SIM_PWR_SLEEP)) sim_sample(sim);
+        sim->motion_time_ns += period_ns;
+        sim->next_sample_ns += period_ns - (period_ns * sim->clock_ppm) / 1000000;
+    }
+    sim->time_us = end;
+    if (sim->reset_done_us && sim->time_us >= sim->reset_done_us) {
+        sim->reset_done_us = 0;
+        sim->regs[SIM_REG_PWR_MGMT_1] &= ~SIM_PWR_RESET;
+    }
+}
+
+static void sim_write_reg(Mpu6050Sim* sim, uint8_t reg, uint8_t value) {
+    switch (reg) {
+    case SIM_REG_PWR_MGMT_1:
+        if (value & SIM_PWR_RESET) {
+            sim->resets++;
+            sim_reset(sim);
+            // DEVICE_RESET reads back set until the reset is over
+            sim->regs[SIM_REG_PWR_MGMT_1] |= SIM_PWR_RESET;
+            sim->reset_done_us = sim->time_us + sim->reset_us;
+            return;
+        }
+        break;
+    case MPU6050_REG_USER_CTRL:
+        if (value & MPU6050_USER_CTRL_FIFO_RESET) {
+            sim->fifo_head = 0;
+            sim->fifo_count = 0;
+            sim->frame_time_count = 0;
+            sim->partial_pop = 0;
+            sim->partial_drop = 0;
+            value &= ~MPU6050_USER_CTRL_FIFO_RESET; // Self-clearing
+        }
+        break;
+    case SIM_REG_WHO_AM_I:
+    case MPU6050_REG_INT_STATUS:
+        return; // Read-only
+    default:
+        break;
+    }
+    sim->regs[reg] = value;
+}
+
+static uint8_t sim_read_reg(Mpu6050Sim* sim, uint8_t reg) {
+    switch (reg) {
+    case MPU6050_REG_FIFO_COUNTH:
+        return static_cast<uint8_t>(sim->fifo_count >> 8);
+    case SIM_REG_FIFO_COUNTL:
+        return static_cast<uint8_t>(sim->fifo_count);
+    case MPU6050_REG_FIFO_R_W: {
+        if (sim->fifo_count == 0) return 0xFF;
+        uint8_t value = sim->fifo[sim->fifo_head];
+        sim->fifo_head = (sim->fifo_head + 1) % MPU6050_FIFO_SIZE;
+        sim->fifo_count--;
+        if (++sim->partial_pop == MPU6050_FRAME_SIZE) {
+            sim->partial_pop = 0;
+            sim_frame_time_pop(sim, true);
+        }
+        return value;
+    }
+    case MPU6050_REG_INT_STATUS: {
+        uint8_t value = sim->regs[reg];
+        sim->regs[reg] = 0; // Cleared on read
+        return value;
+    }
+    default:
+        return sim->regs[reg & 0x7F];
+    }
+}
+
+static bool sim_bus_write(void* context, uint8_t address, uint8_t reg, const uint8_t* data, size_t size) {
+    Mpu6050Sim* sim = static_cast<Mpu6050Sim*>(context);
+    if (address != sim->address) return false; // NACK
+    if (sim->reset_done_us) return true;       // Ignored while resetting
+    for (size_t i = 0; i < size; i++) sim_write_reg(sim, (reg + i) & 0x7F, data[i]);
+    return true;
+}
+
+static bool sim_bus_read(void* context, uint8_t address, uint8_t reg, uint8_t* data, size_t size) {
+    Mpu6050Sim* sim = static_cast<Mpu6050Sim*>(context);
+    if (address != sim->address) return false; // NACK
+    for (size_t i = 0; i < size; i++) {
+        // The FIFO data port does not auto-increment
+        uint8_t current = (reg == MPU6050_REG_FIFO_R_W) ? reg : (reg + i) & 0x7F;
+        data[i] = sim_read_reg(sim, current);
+    }
+    return true;
+}
+
+void mpu6050_sim_bind(Mpu6050Sim* sim, Mpu6050Bus* bus) {
+    bus->context = sim;
+    bus->write = sim_bus_write;
+    bus->read = sim_bus_read;
+    bus->recover = NULL;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "../mpu6050_fifo.h"
+
+// Motion applied to the simulated sensor, in g, deg/s and deg C at time `t` seconds
+typedef void (*Mpu6050SimMotion)(void* context, float t, float acc[3], float gyro[3], float* temp_c);
+
+// One step of a scripted motion; the script loops when it reaches the end
+typedef struct {
+    uint32_t duration_ms;
+    float acc[3];    // Static acceleration, g
+    float gyro[3];   // Angular rate, deg/s
+    float vib_g;     // Sinusoidal vibration added to every accel axis
+    float vib_hz;    // Vibration frequency
+} Mpu6050SimSegment;
+
+// Register-level model of an MPU-6050 used by the host build. It implements the
+// parts of the register map the app touches: reset/sleep, sample rate, DLPF, FSR,
+// the data registers and the 1024-byte FIFO including its overflow behaviour, and
+// cycle mode with the motion interrupt. Motion detection compares the change of
+// each accel axis since the previous sample, a stand-in for the chip's high-pass
+// filter, with MOT_THR.
+typedef struct {
+    uint8_t address;
+    uint8_t regs[128];
+
+    uint8_t fifo[MPU6050_FIFO_SIZE];
+    uint16_t fifo_head; // Index of the oldest byte
+    uint16_t fifo_count;
+
+    uint64_t time_us;        // Simulated time
+    uint64_t next_sample_ns; // When the next sample is produced
+    uint32_t sample_index;   // Samples produced since reset
+    uint64_t motion_time_ns; // Sensor time of the next sample, drives the motion
+    int16_t motion_last[3];  // Accel of the previous sample, for motion detection
+
+    int32_t clock_ppm; // Sample clock error against the host clock
+
+    // A reset takes `reset_us`; until it is over DEVICE_RESET reads back set and
+    // writes are ignored
+    uint32_t reset_us;
+    uint64_t reset_done_us; // 0 = not resetting
+
+    // Sensor errors. The factory trims are what the accel offset registers hold
+    // after a reset and cancel the chip's own offset; moving a register away from
+    // its trim, or the gyro offsets away from zero, shifts the output like the
+    // real offset registers do.
+    float acc_bias[3];     // g, on top of the trimmed output
+    float gyro_bias[3];    // deg/s
+    int16_t accel_trim[3]; // XA/YA/ZA_OFFS after reset
+
+    Mpu6050SimMotion motion;
+    void* motion_context;
+    const Mpu6050SimSegment* script;
+    size_t script_length;
+
+    // Production times of the frames currently in the FIFO, oldest first
+    uint64_t frame_time_us[MPU6050_FIFO_MAX_FRAMES + 1];
+    uint16_t frame_time_head;
+    uint16_t frame_time_count;
+    uint16_t partial_pop;  // Bytes popped from the frame at the head
+    uint16_t partial_drop; // Bytes overwritten from the frame at the head
+
+    uint32_t samples_to_fifo; // Samples pushed into the FIFO
+    uint32_t frames_read;     // Complete frames read back through FIFO_R_W
+    uint32_t fifo_overflows;  // Times a sample overwrote unread FIFO data
+    uint32_t resets;          // Device resets through PWR_MGMT_1
+    uint32_t cycle_samples;   // Single accel samples taken in cycle mode
+    uint32_t motion_events;   // Samples that raised MOT_INT
+    uint64_t last_read_sample_us; // Production time of the newest frame read back
+} Mpu6050Sim;
+
+void mpu6050_sim_init(Mpu6050Sim* sim, uint8_t address);
+
+// Power-on state at the current time, as after the sensor was unplugged
+void mpu6050_sim_power_cycle(Mpu6050Sim* sim);
+
+// Runs the internal sample clock forward
+void mpu6050_sim_advance(Mpu6050Sim* sim, uint32_t microseconds);
+
+// Replaces the default motion (gravity on Z plus a 35 Hz vibration)
+void mpu6050_sim_set_motion(Mpu6050Sim* sim, Mpu6050SimMotion motion, void* context);
+
+// Plays a looping motion script; `segments` must outlive the simulator
+void mpu6050_sim_set_script(Mpu6050Sim* sim, const Mpu6050SimSegment* segments, size_t count);
+
+// Current output data rate in Hz, derived from CONFIG and SMPLRT_DIV
+uint32_t mpu6050_sim_sample_rate(const Mpu6050Sim* sim);
+
+// True while the chip is in cycle mode (low-power motion wake)
+bool mpu6050_sim_cycling(const Mpu6050Sim* sim);
+
+// Fills `bus` so that transfers to sim->address hit the model
+void mpu6050_sim_bind(Mpu6050Sim* sim, Mpu6050Bus* bus);
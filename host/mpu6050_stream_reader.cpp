@@ -0,0 +1,148 @@
+// Reads the app's live stream from its USB serial port and reports throughput.
+//
+//   mpu6050_stream_reader /dev/ttyACM1 [--seconds N] [--raw|--delta] [--csv OUT]
+//
+// Selects the encoding, then parses frames for N seconds (default: until
+// interrupted), printing one line per second and a summary: frames, samples,
+// the sample rate over the time the frames cover on the device (so a backlog
+// that arrives at once does not count as a faster sensor), throughput, frames
+// dropped by the device (sequence gaps), sender restarts and CRC errors.
+// With --csv every received sample is written out as t_us,ax,ay,az,gx,gy,gz.
+// The exit status is non-zero if no frame arrived.
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "mpu6050_stream.h"
+
+static volatile sig_atomic_t reader_interrupted = 0;
+
+static void reader_on_signal(int signal) {
+    (void)signal;
+    reader_interrupted = 1;
+}
+
+static double reader_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void reader_report(const char* label, const Mpu6050StreamParser* parser, double seconds) {
+    if (seconds <= 0) seconds = 1e-9;
+    double rate = parser->span_us ? parser->samples * 1e6 / parser->span_us : 0;
+    printf("%s: %u frames, %u samples, %.0f samples/s, %.1f kB/s, %u dropped, %u resyncs, %u crc errors, "
+           "%u bytes skipped\n",
+           label,
+           parser->frames,
+           parser->samples,
+           rate,
+           parser->bytes / seconds / 1000.0,
+           parser->frames_dropped,
+           parser->resyncs,
+           parser->crc_errors,
+           parser->bytes_skipped);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    const char* device = NULL;
+    const char* csv_path = NULL;
+    double seconds = 0;
+    char mode = 'd';
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--raw") == 0) {
+            mode = 'r';
+        } else if (strcmp(argv[i], "--delta") == 0) {
+            mode = 'd';
+        } else if (!device && argv[i][0] != '-') {
+            device = argv[i];
+        } else {
+            device = NULL;
+            break;
+        }
+    }
+    if (!device) {
+        fprintf(stderr, "usage: %s DEVICE [--seconds N] [--raw|--delta] [--csv OUT]\n", argv[0]);
+        return 2;
+    }
+
+    int port = open(device, O_RDWR | O_NOCTTY);
+    if (port < 0) {
+        fprintf(stderr, "%s: cannot open\n", device);
+        return 2;
+    }
+    struct termios termios_mode;
+    if (tcgetattr(port, &termios_mode) == 0) {
+        cfmakeraw(&termios_mode);
+        tcsetattr(port, TCSANOW, &termios_mode);
+    }
+    if (write(port, &mode, 1) != 1) {
+        fprintf(stderr, "%s: cannot write\n", device);
+        return 2;
+    }
+    FILE* csv = csv_path ? fopen(csv_path, "w") : NULL;
+    if (csv_path && !csv) {
+        fprintf(stderr, "%s: cannot write\n", csv_path);
+        return 2;
+    }
+    if (csv) fprintf(csv, "t_us,ax,ay,az,gx,gy,gz\n");
+    signal(SIGINT, reader_on_signal);
+    signal(SIGTERM, reader_on_signal);
+
+    static Mpu6050StreamParser parser;
+    static Mpu6050SampleBlock block;
+    mpu6050_stream_parser_init(&parser);
+    Mpu6050StreamHeader header;
+    uint8_t buffer[512];
+    double start = reader_now();
+    double next_report = start + 1;
+
+    while (!reader_interrupted) {
+        double now = reader_now();
+        if (seconds > 0 && now - start >= seconds) break;
+        if (now >= next_report) {
+            char label[16];
+            snprintf(label, sizeof(label), "%5.0fs", now - start);
+            reader_report(label, &parser, now - start);
+            next_report += 1;
+        }
+
+        struct pollfd poller = {port, POLLIN, 0};
+        if (poll(&poller, 1, 50) <= 0) continue;
+        ssize_t size = read(port, buffer, sizeof(buffer));
+        if (size <= 0) break;
+
+        size_t done = 0;
+        while (done < static_cast<size_t>(size)) {
+            done += mpu6050_stream_parser_feed(&parser, &buffer[done], size - done);
+            while (mpu6050_stream_parser_next(&parser, &header, &block)) {
+                if (!csv) continue;
+                for (uint32_t i = 0; i < block.count; i++) {
+                    fprintf(csv,
+                            "%lu,%d,%d,%d,%d,%d,%d\n",
+                            (unsigned long)block.timestamp[i],
+                            block.acc[0][i],
+                            block.acc[1][i],
+                            block.acc[2][i],
+                            block.gyro[0][i],
+                            block.gyro[1][i],
+                            block.gyro[2][i]);
+                }
+            }
+        }
+    }
+    reader_report("total", &parser, reader_now() - start);
+    if (csv) fclose(csv);
+    close(port);
+    return parser.frames ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include "mpu6050.h"
+#include <furi_hal.h>
+#include <string.h>
+
+// Bus write on the external I2C: register address followed by the payload
+static bool mpu6050_i2c_write(void* context, uint8_t address, uint8_t reg, const uint8_t* data, size_t size) {
+    UNUSED(context);
+    uint8_t buffer[8];
+    if (size + 1 > sizeof(buffer)) return false;
+    buffer[0] = reg;
+    memcpy(&buffer[1], data, size);
+
+    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
+    bool success = furi_hal_i2c_tx_ext(
+        &furi_hal_i2c_handle_external,
+        address << 1,
+        false,
+        buffer,
+        size + 1,
+        FuriHalI2cBeginStart,
+        FuriHalI2cEndStop,
+        MPU6050_I2C_TIMEOUT);
+    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
+    return success;
+}
+
+// Bus read on the external I2C: register address, repeated start, then `size` bytes
+static bool mpu6050_i2c_read(void* context, uint8_t address, uint8_t reg, uint8_t* data, size_t size) {
+    UNUSED(context);
+    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
+    bool success = furi_hal_i2c_tx_ext(
+        &furi_hal_i2c_handle_external,
+        address << 1,
+        false,
+        &reg,
+        1,
+        FuriHalI2cBeginStart,
+        FuriHalI2cEndAwaitRestart,
+        MPU6050_I2C_TIMEOUT);
+    if (success) {
+        success = furi_hal_i2c_rx_ext(
+            &furi_hal_i2c_handle_external,
+            address << 1,
+            false,
+            data,
+            size,
+            FuriHalI2cBeginRestart,
+            FuriHalI2cEndStop,
+            MPU6050_I2C_TIMEOUT);
+    }
+    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
+    return success;
+}
+
+// Bus recovery on the external I2C. A slave reset or unplugged in the middle of
+// a read may keep driving SDA low, waiting for the rest of its byte, and every
+// transfer then times out. Clocking SCL by hand until SDA is released, at most
+// nine times, finishes that byte; a STOP then leaves the bus idle.
+static bool mpu6050_i2c_recover(void* context) {
+    UNUSED(context);
+    const GpioPin* scl = &gpio_ext_pc0;
+    const GpioPin* sda = &gpio_ext_pc1;
+
+    // Acquiring the handle routes the pins to the peripheral; borrow them
+    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
+    furi_hal_gpio_write(scl, true);
+    furi_hal_gpio_write(sda, true);
+    furi_hal_gpio_init(scl, GpioModeOutputOpenDrain, GpioPullNo, GpioSpeedLow);
+    furi_hal_gpio_init(sda, GpioModeOutputOpenDrain, GpioPullNo, GpioSpeedLow);
+
+    // 100 kHz clock pulses while the slave holds SDA low
+    for (int pulse = 0; pulse < MPU6050_BUS_RECOVERY_CLOCKS && !furi_hal_gpio_read(sda); pulse++) {
+        furi_hal_gpio_write(scl, false);
+        furi_delay_us(5);
+        furi_hal_gpio_write(scl, true);
+        furi_delay_us(5);
+    }
+    // STOP: SDA rises while SCL is high
+    furi_hal_gpio_write(scl, false);
+    furi_hal_gpio_write(sda, false);
+    furi_delay_us(5);
+    furi_hal_gpio_write(scl, true);
+    furi_delay_us(5);
+    furi_hal_gpio_write(sda, true);
+    furi_delay_us(5);
+    bool released = furi_hal_gpio_read(sda);
+
+    furi_hal_gpio_init_ex(scl, GpioModeAltFunctionOpenDrain, GpioPullNo, GpioSpeedLow, GpioAltFn4I2C3);
+    furi_hal_gpio_init_ex(sda, GpioModeAltFunctionOpenDrain, GpioPullNo, GpioSpeedLow, GpioAltFn4I2C3);
+    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
+    return released;
+}
+
+void mpu6050_bus_init_external(Mpu6050Bus* bus) {
+    bus->context = NULL;
+    bus->write = mpu6050_i2c_write;
+    bus->read = mpu6050_i2c_read;
+    bus->recover = mpu6050_i2c_recover;
+}
@@ -1,6 +1,68 @@
 #pragma once
 #include <furi.h>
 #include <furi_hal_i2c.h>
+#include <string.h>
+#include "mpu6050_fifo.h"
+
+// MPU-6050 sensor I2C address (7-bit)
+// Default address is 0x68 (AD0 pulled low), 0x69 with AD0 pulled high
+#define MPU6050_I2C_ADDR 0x68
+#define MPU6050_I2C_ADDR_ALT 0x69
+
+// MPU-6050 registers
+#define MPU6050_REG_XA_OFFS_H 0x06    // Accel offsets X/Y/Z (factory-trimmed), big-endian pairs
+#define MPU6050_REG_XG_OFFS_USRH 0x13 // Gyro offsets X/Y/Z, big-endian pairs
+#define MPU6050_REG_SMPLRT_DIV 0x19   // Sample Rate Divider
+#define MPU6050_REG_CONFIG 0x1A       // Configuration
+#define MPU6050_REG_GYRO_CONFIG 0x1B  // Gyroscope Configuration
+#define MPU6050_REG_ACCEL_CONFIG 0x1C // Accelerometer Configuration
+#define MPU6050_REG_MOT_THR 0x1F      // Motion detection threshold
+#define MPU6050_REG_MOT_DUR 0x20      // Motion detection duration
+#define MPU6050_REG_ACCEL_XOUT_H 0x3B // High byte of Accel X-axis data
+#define MPU6050_REG_PWR_MGMT_1 0x6B   // Power Management 1
+#define MPU6050_REG_PWR_MGMT_2 0x6C   // Power Management 2
+#define MPU6050_REG_WHO_AM_I 0x75     // Device identity
+
+// Power Management 1 settings
+#define MPU6050_CLOCK_SEL_PLL_XG 0x01 // PLL with X axis gyroscope reference
+#define MPU6050_RESET 0x80            // Reset device
+#define MPU6050_SLEEP 0x40            // Low-power sleep, registers kept
+#define MPU6050_CYCLE 0x20            // Sleep between single accel samples
+#define MPU6050_TEMP_DIS 0x08         // Temperature sensor off
+
+// Power Management 2: wake rate in cycle mode (bits 7:6), gyro standby (bits 2:0)
+#define MPU6050_LP_WAKE_SHIFT 6
+#define MPU6050_STBY_GYRO 0x07
+
+// Motion detection: MOT_THR counts 2 mg, MOT_DUR 1 ms (one sample in cycle mode);
+// the detector compares the output of the accel high-pass filter
+#define MPU6050_MOT_THR_MG_PER_LSB 2
+#define MPU6050_ACCEL_HPF_5HZ 0x01
+
+// SMPLRT_DIV, CONFIG, GYRO_CONFIG and ACCEL_CONFIG form one contiguous block
+#define MPU6050_CONFIG_BLOCK_SIZE 4
+
+// SMPLRT_DIV..PWR_MGMT_1, read in one burst to check a running chip on a warm
+// start: the configuration, FIFO_EN, INT_ENABLE, USER_CTRL and PWR_MGMT_1
+#define MPU6050_RESUME_SPAN (MPU6050_REG_PWR_MGMT_1 - MPU6050_REG_SMPLRT_DIV + 1)
+
+// Offset register scales, independent of the selected FSR: the accel offsets
+// count in the +/-16g range with bit 0 reserved, the gyro offsets in +/-1000 deg/s
+#define MPU6050_ACCEL_OFFSET_LSB_PER_G 2048
+#define MPU6050_GYRO_OFFSET_LSB_PER_DPS_X10 328
+
+// Configuration settings (DLPF)
+#define MPU6050_DLPF_CFG_20HZ 0x04
+
+// Longest the chip takes to come back from a reset before it accepts configuration
+#define MPU6050_RESET_DELAY_MS 100
+
+// I2C operation timeout, ms. The longest transfer, a 252-byte FIFO burst, takes
+// 23 ms at 100 kHz; a stuck bus costs this much per transfer until recovered.
+#define MPU6050_I2C_TIMEOUT 30
+
+// SCL pulses that finish any byte a slave was sending when the bus was cut
+#define MPU6050_BUS_RECOVERY_CLOCKS 9
 
 // Struktura do przechowywania danych sensora
 typedef struct {
@@ -9,26 +71,549 @@ typedef struct {
     float temp_c;
 } Mpu6050Data;
 
-// Klasa do obsługi komunikacji z MPU6050
+// Parts sharing the MPU-6050 register map
+enum class Mpu6050Variant : uint8_t {
+    Mpu6050,
+    Mpu6500,
+    Mpu9250,
+};
+
+// Per-part constants, resolved at compile time
+template <Mpu6050Variant Variant>
+struct Mpu6050Traits;
+
+template <>
+struct Mpu6050Traits<Mpu6050Variant::Mpu6050> {
+    static constexpr Mpu6050Variant variant = Mpu6050Variant::Mpu6050;
+    static constexpr uint8_t who_am_i = 0x68;
+    static constexpr uint8_t accel_offset_reg = MPU6050_REG_XA_OFFS_H;
+    static constexpr uint8_t accel_offset_stride = 2; // X, Y and Z pairs back to back
+    static constexpr float temp_lsb_per_c = 340.0f;
+    static constexpr float temp_offset_c = 36.53f;
+};
+
+template <>
+struct Mpu6050Traits<Mpu6050Variant::Mpu6500> {
+    static constexpr Mpu6050Variant variant = Mpu6050Variant::Mpu6500;
+    static constexpr uint8_t who_am_i = 0x70;
+    static constexpr uint8_t accel_offset_reg = 0x77; // XA_OFFSET_H
+    static constexpr uint8_t accel_offset_stride = 3;
+    static constexpr float temp_lsb_per_c = 333.87f;
+    static constexpr float temp_offset_c = 21.0f;
+};
+
+template <>
+struct Mpu6050Traits<Mpu6050Variant::Mpu9250> {
+    static constexpr Mpu6050Variant variant = Mpu6050Variant::Mpu9250;
+    static constexpr uint8_t who_am_i = 0x71;
+    static constexpr uint8_t accel_offset_reg = 0x77; // XA_OFFSET_H
+    static constexpr uint8_t accel_offset_stride = 3;
+    static constexpr float temp_lsb_per_c = 333.87f;
+    static constexpr float temp_offset_c = 21.0f;
+};
+
+// Full-scale range indices as written to the FS_SEL / AFS_SEL fields
+enum Mpu6050AccelFsr : uint8_t {
+    Mpu6050AccelFsr_2g,
+    Mpu6050AccelFsr_4g,
+    Mpu6050AccelFsr_8g,
+    Mpu6050AccelFsr_16g,
+    Mpu6050AccelFsr_Count,
+};
+
+enum Mpu6050GyroFsr : uint8_t {
+    Mpu6050GyroFsr_250,
+    Mpu6050GyroFsr_500,
+    Mpu6050GyroFsr_1000,
+    Mpu6050GyroFsr_2000,
+    Mpu6050GyroFsr_Count,
+};
+
+// Sensitivity tables (LSB per g, LSB per deg/s x10), indexed by FSR
+static constexpr uint16_t mpu6050_accel_lsb_per_g[Mpu6050AccelFsr_Count] = {16384, 8192, 4096, 2048};
+static constexpr uint16_t mpu6050_gyro_lsb_per_dps_x10[Mpu6050GyroFsr_Count] = {1310, 655, 328, 164};
+
+// Sensor configuration. A literal type, so a default can be fixed at compile time.
+struct Mpu6050Config {
+    uint8_t address;
+    uint8_t accel_fsr;       // Mpu6050AccelFsr
+    uint8_t gyro_fsr;        // Mpu6050GyroFsr
+    uint8_t dlpf;            // DLPF_CFG, 0..6
+    uint8_t sample_rate_div; // Sample rate = gyro rate / (1 + div)
+
+    constexpr uint8_t config_reg() const {
+        return dlpf & 0x07;
+    }
+    constexpr uint8_t gyro_config_reg() const {
+        return static_cast<uint8_t>(gyro_fsr << 3);
+    }
+    constexpr uint8_t accel_config_reg() const {
+        return static_cast<uint8_t>(accel_fsr << 3);
+    }
+    // Register image of SMPLRT_DIV..ACCEL_CONFIG
+    void config_block(uint8_t block[MPU6050_CONFIG_BLOCK_SIZE]) const {
+        block[0] = sample_rate_div;
+        block[1] = config_reg();
+        block[2] = gyro_config_reg();
+        block[3] = accel_config_reg();
+    }
+    // Output data rate in Hz; the gyro runs at 8 kHz only with the DLPF off
+    constexpr uint32_t sample_rate_hz() const {
+        return ((dlpf == 0 || dlpf == 7) ? 8000u : 1000u) / (1u + sample_rate_div);
+    }
+};
+
+// Default: 0x68, +/-4g, +/-500 deg/s, 20 Hz DLPF, 1 kHz
+static constexpr Mpu6050Config mpu6050_default_config = {
+    MPU6050_I2C_ADDR, Mpu6050AccelFsr_4g, Mpu6050GyroFsr_500, MPU6050_DLPF_CFG_20HZ, 0};
+
+static_assert(mpu6050_default_config.sample_rate_hz() == 1000, "default must sample at 1 kHz");
+
+// Accelerometer sample rate in cycle mode (LP_WAKE_CTRL)
+enum Mpu6050WakeRate : uint8_t {
+    Mpu6050WakeRate_1Hz25,
+    Mpu6050WakeRate_5Hz,
+    Mpu6050WakeRate_20Hz,
+    Mpu6050WakeRate_40Hz,
+};
+
+// Progress of a non-blocking init
+enum Mpu6050InitStatus : uint8_t {
+    Mpu6050InitStatus_Pending, // Still resetting, poll again
+    Mpu6050InitStatus_Done,
+    Mpu6050InitStatus_Failed,
+};
+
+enum Mpu6050ReattachStatus : uint8_t {
+    Mpu6050ReattachStatus_Done,
+    Mpu6050ReattachStatus_NoAnswer, // A transfer failed again; the chip may still be as it was
+    Mpu6050ReattachStatus_Changed,  // It answered, but not as it was left
+};
+
+// Contents of the hardware offset registers. The chip adds them to every sample
+// before it reaches the data registers and the FIFO.
+typedef struct {
+    int16_t accel[3]; // XA/YA/ZA_OFFS, bit 0 of each is reserved
+    int16_t gyro[3];  // XG/YG/ZG_OFFS_USR
+} Mpu6050Offsets;
+
+// Binds `bus` to furi_hal_i2c_handle_external, with bus recovery on its pins
+void mpu6050_bus_init_external(Mpu6050Bus* bus);
+
+// Klasa do obsługi komunikacji z MPU6050.
+// Specialised per part at compile time; every call is a thin, inlineable wrapper
+// around the bus so it costs no more than the hand-written transfers it replaces.
+template <Mpu6050Variant Variant = Mpu6050Variant::Mpu6050>
 class Mpu6050 {
 public:
-    // Domyślny adres I2C (7-bitowy)
-    static constexpr uint8_t I2C_ADDR = 0x68; 
-    static constexpr uint8_t MPU6050_TIMEOUT = 100;
-    
-    Mpu6050();
-    ~Mpu6050();
+    typedef Mpu6050Traits<Variant> Traits;
+
+    Mpu6050()
+        : bus_(NULL)
+        , config_(mpu6050_default_config)
+        , who_am_i_(0)
+        , offsets_()
+        , stored_offsets_()
+        , has_stored_offsets_(false)
+        , shadow_valid_(false)
+        , motion_wake_(false)
+        , full_inits_(0)
+        , partial_writes_(0)
+        , warm_starts_(0)
+        , reattaches_(0) {
+    }
+    ~Mpu6050() {
+    }
 
-    // Inicjalizuje I2C i konfiguruje czujnik (budzi go)
-    bool init();
+    // Selects the transport; must be called before init()
+    void bind(const Mpu6050Bus* bus) {
+        bus_ = bus;
+    }
+
+    // Resets the chip, applies `config` and starts FIFO capture. Blocks for the
+    // reset; the sampler uses begin_init() / continue_init() instead.
+    bool init(const Mpu6050Config& config) {
+        if (!begin_init(config)) return false;
+        uint32_t start = furi_get_tick();
+        while (furi_get_tick() - start <= furi_ms_to_ticks(MPU6050_RESET_DELAY_MS)) {
+            furi_delay_ms(1);
+            Mpu6050InitStatus status = continue_init();
+            if (status != Mpu6050InitStatus_Pending) return status == Mpu6050InitStatus_Done;
+        }
+        return false;
+    }
+
+    // First half of a non-blocking init(): identifies the chip and resets it.
+    // Fails on a part other than Variant, whose offset registers and temperature
+    // scale differ; who_am_i() then tells what answered.
+    bool begin_init(const Mpu6050Config& config) {
+        config_ = config;
+        shadow_valid_ = false;
+        motion_wake_ = false;
+        full_inits_++;
+        mpu6050_fifo_init(&fifo_, bus_, config_.address);
+
+        // 1. Identify; a missing sensor NACKs here
+        if (!read_register(MPU6050_REG_WHO_AM_I, &who_am_i_, 1)) {
+            who_am_i_ = 0;
+            return false;
+        }
+        if (!is_expected_part()) return false;
+
+        // 2. Reset the device; DEVICE_RESET clears itself once it is done
+        return write_register(MPU6050_REG_PWR_MGMT_1, MPU6050_RESET);
+    }
+
+    // Second half, polled after begin_init(): Pending while the chip is still
+    // resetting, then configures it and starts FIFO capture. A chip busy with
+    // its reset may NACK, so a failed check is Pending as well; the caller gives
+    // up after MPU6050_RESET_DELAY_MS.
+    Mpu6050InitStatus continue_init() {
+        uint8_t power;
+        if (!read_register(MPU6050_REG_PWR_MGMT_1, &power, 1) || (power & MPU6050_RESET)) {
+            return Mpu6050InitStatus_Pending;
+        }
+
+        // 3. Wake up and set clock source
+        if (!write_register(MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_SEL_PLL_XG)) return Mpu6050InitStatus_Failed;
+
+        // 4. SMPLRT_DIV, CONFIG, GYRO_CONFIG and ACCEL_CONFIG are contiguous: one burst
+        config_.config_block(shadow_);
+        if (!write_registers(MPU6050_REG_SMPLRT_DIV, shadow_, MPU6050_CONFIG_BLOCK_SIZE)) {
+            return Mpu6050InitStatus_Failed;
+        }
+
+        // 5. Calibration: the reset restored the factory offsets; put the stored
+        // ones back, or keep the factory ones and remember them
+        if (has_stored_offsets_) {
+            if (!write_offsets(stored_offsets_)) return Mpu6050InitStatus_Failed;
+        } else if (!read_offsets(&offsets_)) {
+            return Mpu6050InitStatus_Failed;
+        }
+
+        // 6. Start FIFO capture (accel, temp and gyro every sample)
+        if (!mpu6050_fifo_start(&fifo_)) return Mpu6050InitStatus_Failed;
+        shadow_valid_ = true;
+        return Mpu6050InitStatus_Done;
+    }
+
+    // Warm start: takes over a chip that an earlier run left configured under
+    // `config`, asleep after sleep() or still sampling, without the reset.
+    // WHO_AM_I must still read `who_am_i`, the part the run saw, and this
+    // driver's; then one burst read checks the register image, the FIFO setup
+    // and the gyro clock. A chip swapped, power cycled, reset or left in motion
+    // wake since fails it. The offset registers are read too: with stored
+    // offsets they must hold exactly those, so a calibration saved since wins
+    // over what the chip kept; without, they are taken as the chip's own. On a
+    // match the chip is woken and only the FIFO is restarted, dropping whatever
+    // it queued meanwhile.
+    bool resume(const Mpu6050Config& config, uint8_t who_am_i) {
+        config_ = config;
+        shadow_valid_ = false;
+        motion_wake_ = false;
+        mpu6050_fifo_init(&fifo_, bus_, config_.address);
+
+        bool asleep = false;
+        if (read_back(who_am_i, &asleep) != Mpu6050ReattachStatus_Done) return false;
+        Mpu6050Offsets offsets;
+        if (!read_offsets(&offsets)) return false;
+        if (has_stored_offsets_ && memcmp(&stored_offsets_, &offsets, sizeof(offsets)) != 0) return false;
+        if (asleep && !write_register(MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_SEL_PLL_XG)) return false;
+        if (!mpu6050_fifo_start(&fifo_)) return false;
+        who_am_i_ = who_am_i;
+        offsets_ = offsets;
+        config_.config_block(shadow_);
+        shadow_valid_ = true;
+        warm_starts_++;
+        return true;
+    }
+
+    // Takes back a sensor that was sampling under `config` when a transfer to it
+    // failed, without the reset: the same two reads as resume() must find the
+    // part and the register image unchanged. The FIFO is left as it is, so no
+    // sample is lost to the fault: a failed count read does not touch it, and a
+    // failed burst has flushed it already. Motion wake, a new address or new
+    // settings need the full bring-up.
+    Mpu6050ReattachStatus reattach(const Mpu6050Config& config) {
+        if (motion_wake_ || config.address != config_.address || who_am_i_ != Traits::who_am_i) {
+            return Mpu6050ReattachStatus_Changed;
+        }
+        Mpu6050Config previous = config_;
+        config_ = config;
+        bool asleep = false;
+        Mpu6050ReattachStatus status = read_back(who_am_i_, &asleep);
+        if (status == Mpu6050ReattachStatus_Done && asleep) status = Mpu6050ReattachStatus_Changed;
+        if (status != Mpu6050ReattachStatus_Done) {
+            config_ = previous;
+            return status;
+        }
+        config_.config_block(shadow_);
+        shadow_valid_ = true;
+        reattaches_++;
+        return status;
+    }
+
+    // Sleep until resume() or the next init(): sampling stops and the chip
+    // draws a few uA, with its configuration, FIFO setup and offsets kept
+    bool sleep() {
+        return write_register(MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_SEL_PLL_XG | MPU6050_SLEEP);
+    }
+
+    // True when apply(config) would need a full init(): a new address, or a
+    // register shadow that is unknown after a fault
+    bool needs_init(const Mpu6050Config& config) const {
+        return !shadow_valid_ || config.address != config_.address;
+    }
+
+    // Moves a running sensor to `config` with the fewest bus writes. Only the
+    // changed span of SMPLRT_DIV..ACCEL_CONFIG is written, as one burst, and the
+    // FIFO keeps running; use fifo_queued() beforehand to know how many queued
+    // frames still belong to the old settings. A full init() happens only on an
+    // address change or when the register shadow is unknown after a fault, see
+    // needs_init().
+    bool apply(const Mpu6050Config& config) {
+        if (needs_init(config)) return init(config);
+
+        uint8_t wanted[MPU6050_CONFIG_BLOCK_SIZE];
+        config.config_block(wanted);
+        size_t first = MPU6050_CONFIG_BLOCK_SIZE;
+        size_t last = 0;
+        for (size_t i = 0; i < MPU6050_CONFIG_BLOCK_SIZE; i++) {
+            if (wanted[i] == shadow_[i]) continue;
+            if (first == MPU6050_CONFIG_BLOCK_SIZE) first = i;
+            last = i;
+        }
+
+        config_ = config;
+        if (first == MPU6050_CONFIG_BLOCK_SIZE) return true; // Nothing changed
+
+        size_t count = last - first + 1;
+        partial_writes_++;
+        if (!write_registers(MPU6050_REG_SMPLRT_DIV + first, &wanted[first], count)) {
+            shadow_valid_ = false;
+            return false;
+        }
+        memcpy(&shadow_[first], &wanted[first], count);
+        return true;
+    }
+
+    // Low-power motion wake: FIFO capture stops, the gyros go to standby and the
+    // accelerometer alone wakes `wake_rate` (Mpu6050WakeRate) times a second.
+    // A high-passed sample above `threshold_mg` latches MOT_INT, see
+    // motion_pending(). apply() must not be called until leave_motion_wake().
+    bool enter_motion_wake(uint16_t threshold_mg, uint8_t wake_rate) {
+        uint32_t threshold = threshold_mg / MPU6050_MOT_THR_MG_PER_LSB;
+        uint8_t motion[2] = {static_cast<uint8_t>(threshold < 1 ? 1 : threshold > 255 ? 255 : threshold), 1};
+        bool ok = mpu6050_fifo_stop(&fifo_) && write_registers(MPU6050_REG_MOT_THR, motion, sizeof(motion)) &&
+                  write_register(MPU6050_REG_ACCEL_CONFIG, config_.accel_config_reg() | MPU6050_ACCEL_HPF_5HZ) &&
+                  write_register(MPU6050_REG_INT_ENABLE, MPU6050_INT_MOT) &&
+                  write_register(
+                      MPU6050_REG_PWR_MGMT_2,
+                      static_cast<uint8_t>((wake_rate << MPU6050_LP_WAKE_SHIFT) | MPU6050_STBY_GYRO)) &&
+                  // The gyros are off, so the internal oscillator clocks the chip
+                  write_register(MPU6050_REG_PWR_MGMT_1, MPU6050_CYCLE | MPU6050_TEMP_DIS);
+        motion_wake_ = true;
+        if (!ok) shadow_valid_ = false;
+        return ok;
+    }
+
+    // Back to full-rate FIFO capture under the current configuration. The gyros
+    // need some 30 ms to settle after standby.
+    bool leave_motion_wake() {
+        motion_wake_ = false;
+        bool ok = write_register(MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_SEL_PLL_XG) &&
+                  write_register(MPU6050_REG_PWR_MGMT_2, 0x00) &&
+                  write_register(MPU6050_REG_ACCEL_CONFIG, config_.accel_config_reg()) &&
+                  mpu6050_fifo_start(&fifo_);
+        if (!ok) shadow_valid_ = false;
+        return ok;
+    }
+
+    // Reads (and so clears) MOT_INT
+    bool motion_pending(bool* motion) {
+        uint8_t status;
+        if (!read_register(MPU6050_REG_INT_STATUS, &status, 1)) return false;
+        *motion = (status & MPU6050_INT_MOT) != 0;
+        return true;
+    }
+
+    bool in_motion_wake() const {
+        return motion_wake_;
+    }
+
+    // Forces the next apply() to do a full init(), e.g. after a bus fault
+    void invalidate() {
+        shadow_valid_ = false;
+    }
+
+    // Offsets every init() writes after the reset; NULL keeps the factory ones
+    void set_stored_offsets(const Mpu6050Offsets* offsets) {
+        has_stored_offsets_ = offsets != NULL;
+        if (offsets) stored_offsets_ = *offsets;
+    }
+
+    // Writes the offset registers of the running chip
+    bool write_offsets(const Mpu6050Offsets& offsets) {
+        uint8_t raw[6];
+        for (int axis = 0; axis < 3; axis++) put_be16(&raw[axis * 2], offsets.accel[axis]);
+        if (Traits::accel_offset_stride == 2) {
+            if (!write_registers(Traits::accel_offset_reg, raw, sizeof(raw))) return false;
+        } else {
+            for (int axis = 0; axis < 3; axis++) {
+                if (!write_registers(Traits::accel_offset_reg + axis * Traits::accel_offset_stride, &raw[axis * 2], 2)) {
+                    return false;
+                }
+            }
+        }
+        for (int axis = 0; axis < 3; axis++) put_be16(&raw[axis * 2], offsets.gyro[axis]);
+        if (!write_registers(MPU6050_REG_XG_OFFS_USRH, raw, sizeof(raw))) return false;
+        offsets_ = offsets;
+        return true;
+    }
+
+    // Reads the offset registers of the running chip
+    bool read_offsets(Mpu6050Offsets* offsets) {
+        uint8_t raw[6];
+        for (int axis = 0; axis < 3; axis++) {
+            uint8_t reg = Traits::accel_offset_reg + axis * Traits::accel_offset_stride;
+            if (!read_register(reg, &raw[axis * 2], 2)) return false;
+        }
+        for (int axis = 0; axis < 3; axis++) offsets->accel[axis] = be16(&raw[axis * 2]);
+        if (!read_register(MPU6050_REG_XG_OFFS_USRH, raw, sizeof(raw))) return false;
+        for (int axis = 0; axis < 3; axis++) offsets->gyro[axis] = be16(&raw[axis * 2]);
+        return true;
+    }
+
+    // Offsets in the chip since the last init() or write_offsets()
+    const Mpu6050Offsets& offsets() const {
+        return offsets_;
+    }
 
     // Odczytuje 14 bajtów danych z czujnika i wypełnia strukturę
-    bool read_data(Mpu6050Data& data);
+    bool read_data(Mpu6050Data& data) {
+        uint8_t raw[MPU6050_FRAME_SIZE];
+        if (!read_register(MPU6050_REG_ACCEL_XOUT_H, raw, sizeof(raw))) return false;
+        data.acc_x = be16(&raw[0]);
+        data.acc_y = be16(&raw[2]);
+        data.acc_z = be16(&raw[4]);
+        data.temp_c = static_cast<float>(be16(&raw[6])) / Traits::temp_lsb_per_c + Traits::temp_offset_c;
+        data.gyro_x = be16(&raw[8]);
+        data.gyro_y = be16(&raw[10]);
+        data.gyro_z = be16(&raw[12]);
+        return true;
+    }
+
+    // Drains queued FIFO frames, see mpu6050_fifo_read()
+    Mpu6050FifoStatus read_fifo(uint8_t* frames, size_t max_frames, size_t* frames_read) {
+        return mpu6050_fifo_read(&fifo_, frames, max_frames, frames_read);
+    }
+
+    // Complete frames waiting in the FIFO
+    bool fifo_queued(size_t* frames) {
+        return mpu6050_fifo_queued(&fifo_, frames);
+    }
+
+    // True when WHO_AM_I matched this part at the last begin_init()
+    bool is_expected_part() const {
+        return who_am_i_ == Traits::who_am_i;
+    }
+    uint8_t who_am_i() const {
+        return who_am_i_;
+    }
+    const Mpu6050Config& config() const {
+        return config_;
+    }
+    const Mpu6050Fifo& fifo() const {
+        return fifo_;
+    }
+    // The FIFO engine itself, for schedulers that drive several devices' reads
+    Mpu6050Fifo& fifo() {
+        return fifo_;
+    }
+    uint32_t full_inits() const {
+        return full_inits_;
+    }
+    uint32_t partial_writes() const {
+        return partial_writes_;
+    }
+    uint32_t reattaches() const {
+        return reattaches_;
+    }
+    uint32_t warm_starts() const {
+        return warm_starts_;
+    }
 
-private:
     // Odczyt pojedynczego rejestru
-    bool read_register(uint8_t reg_addr, uint8_t* data, size_t size);
-    
+    bool read_register(uint8_t reg_addr, uint8_t* data, size_t size) {
+        return bus_->read(bus_->context, config_.address, reg_addr, data, size);
+    }
+
     // Zapis do rejestru
-    bool write_register(uint8_t reg_addr, uint8_t data);
+    bool write_register(uint8_t reg_addr, uint8_t data) {
+        return bus_->write(bus_->context, config_.address, reg_addr, &data, 1);
+    }
+
+    // Zapis kilku kolejnych rejestrów w jednej transakcji
+    bool write_registers(uint8_t reg_addr, const uint8_t* data, size_t size) {
+        return bus_->write(bus_->context, config_.address, reg_addr, data, size);
+    }
+
+    // Sensitivity of the active configuration
+    uint16_t accel_lsb_per_g() const {
+        return mpu6050_accel_lsb_per_g[config_.accel_fsr & 0x03];
+    }
+    uint16_t gyro_lsb_per_dps_x10() const {
+        return mpu6050_gyro_lsb_per_dps_x10[config_.gyro_fsr & 0x03];
+    }
+
+private:
+    // WHO_AM_I must read `who_am_i`, this driver's part, and one burst of
+    // SMPLRT_DIV..PWR_MGMT_1 must hold config_, the FIFO setup and the gyro
+    // clock; `asleep` tells whether SLEEP is set on top
+    Mpu6050ReattachStatus read_back(uint8_t who_am_i, bool* asleep) {
+        uint8_t part;
+        if (!read_register(MPU6050_REG_WHO_AM_I, &part, 1)) return Mpu6050ReattachStatus_NoAnswer;
+        if (part != who_am_i || part != Traits::who_am_i) return Mpu6050ReattachStatus_Changed;
+
+        uint8_t image[MPU6050_RESUME_SPAN];
+        if (!read_register(MPU6050_REG_SMPLRT_DIV, image, sizeof(image))) return Mpu6050ReattachStatus_NoAnswer;
+        uint8_t wanted[MPU6050_CONFIG_BLOCK_SIZE];
+        config_.config_block(wanted);
+        const uint8_t base = MPU6050_REG_SMPLRT_DIV;
+        if (memcmp(image, wanted, sizeof(wanted)) != 0 ||
+            image[MPU6050_REG_FIFO_EN - base] != MPU6050_FIFO_EN_ALL ||
+            image[MPU6050_REG_INT_ENABLE - base] != MPU6050_INT_FIFO_OFLOW ||
+            !(image[MPU6050_REG_USER_CTRL - base] & MPU6050_USER_CTRL_FIFO_EN) ||
+            (image[MPU6050_REG_PWR_MGMT_1 - base] & ~MPU6050_SLEEP) != MPU6050_CLOCK_SEL_PLL_XG) {
+            return Mpu6050ReattachStatus_Changed;
+        }
+        *asleep = (image[MPU6050_REG_PWR_MGMT_1 - base] & MPU6050_SLEEP) != 0;
+        return Mpu6050ReattachStatus_Done;
+    }
+
+    static int16_t be16(const uint8_t* data) {
+        return static_cast<int16_t>((data[0] << 8) | data[1]);
+    }
+    static void put_be16(uint8_t* data, int16_t value) {
+        data[0] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+        data[1] = static_cast<uint8_t>(value);
+    }
+
+    const Mpu6050Bus* bus_;
+    Mpu6050Config config_;
+    Mpu6050Fifo fifo_;
+    uint8_t who_am_i_;
+
+    Mpu6050Offsets offsets_;        // In the chip
+    Mpu6050Offsets stored_offsets_; // Restored by init()
+    bool has_stored_offsets_;
+
+    // Last values written to SMPLRT_DIV..ACCEL_CONFIG
+    uint8_t shadow_[MPU6050_CONFIG_BLOCK_SIZE];
+    bool shadow_valid_;
+    bool motion_wake_; // Between enter_motion_wake() and leave_motion_wake()
+    uint32_t full_inits_;
+    uint32_t partial_writes_;
+    uint32_t warm_starts_;
+    uint32_t reattaches_;
 };
@@ -0,0 +1,58 @@
+#include "mpu6050_block.h"
+
+#if defined(__ARM_ARCH_7EM__)
+// Cortex-M4: REV16 byte-swaps both halfwords of a word in one cycle and LDR
+// accepts unaligned addresses, so a frame is four loads and four swaps instead
+// of fourteen byte loads, shifts and ORs.
+static inline uint32_t load_rev16(const uint8_t* data) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word)); // Compiles to a single unaligned LDR
+    uint32_t swapped;
+    __asm__("rev16 %0, %1" : "=r"(swapped) : "r"(word));
+    return swapped;
+}
+
+static void decode_channels(const uint8_t* frames, size_t count, Mpu6050SampleBlock* block) {
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* frame = &frames[i * MPU6050_FRAME_SIZE];
+        uint32_t acc_xy = load_rev16(&frame[0]);
+        uint32_t acc_z_temp = load_rev16(&frame[4]);
+        uint32_t gyro_xy = load_rev16(&frame[8]);
+
+        block->acc[0][i] = static_cast<int16_t>(acc_xy);
+        block->acc[1][i] = static_cast<int16_t>(acc_xy >> 16);
+        block->acc[2][i] = static_cast<int16_t>(acc_z_temp);
+        block->temp[i] = static_cast<int16_t>(acc_z_temp >> 16);
+        block->gyro[0][i] = static_cast<int16_t>(gyro_xy);
+        block->gyro[1][i] = static_cast<int16_t>(gyro_xy >> 16);
+        block->gyro[2][i] = static_cast<int16_t>((frame[12] << 8) | frame[13]);
+    }
+}
+#else
+// Portable path: one pass per channel with a fixed stride and no branches, which
+// GCC and Clang vectorise on the host.
+static inline void decode_channel(const uint8_t* frames, size_t count, size_t offset, int16_t* out) {
+    const uint8_t* source = frames + offset;
+    for (size_t i = 0; i < count; i++) {
+        uint16_t word;
+        memcpy(&word, &source[i * MPU6050_FRAME_SIZE], sizeof(word));
+        out[i] = static_cast<int16_t>(__builtin_bswap16(word));
+    }
+}
+
+static void decode_channels(const uint8_t* frames, size_t count, Mpu6050SampleBlock* block) {
+    decode_channel(frames, count, 0, block->acc[0]);
+    decode_channel(frames, count, 2, block->acc[1]);
+    decode_channel(frames, count, 4, block->acc[2]);
+    decode_channel(frames, count, 6, block->temp);
+    decode_channel(frames, count, 8, block->gyro[0]);
+    decode_channel(frames, count, 10, block->gyro[1]);
+    decode_channel(frames, count, 12, block->gyro[2]);
+}
+#endif
+
+void mpu6050_decode_block(const uint8_t* frames, size_t count, Mpu6050SampleBlock* block) {
+    if (count > MPU6050_BLOCK_SIZE) count = MPU6050_BLOCK_SIZE;
+    decode_channels(frames, count, block);
+    block->count = static_cast<uint32_t>(count);
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "mpu6050_fifo.h"
+
+// Samples per block: holds a full FIFO drain and is a multiple of 16 so every
+// channel row stays 16-byte aligned for the vector units
+#define MPU6050_BLOCK_SIZE 80
+
+static_assert(MPU6050_BLOCK_SIZE >= MPU6050_FIFO_MAX_FRAMES, "a block must hold a full FIFO");
+static_assert((MPU6050_BLOCK_SIZE % 16) == 0, "block rows must stay 16-byte aligned");
+
+// Struct-of-arrays sample block. Each channel is a contiguous int16 row, so
+// filters, statistics and plots run over plain arrays instead of strided records.
+typedef struct alignas(16) {
+    int16_t acc[3][MPU6050_BLOCK_SIZE];  // Raw accelerometer counts X, Y, Z
+    int16_t gyro[3][MPU6050_BLOCK_SIZE]; // Raw gyroscope counts X, Y, Z
+    int16_t temp[MPU6050_BLOCK_SIZE];    // Raw temperature counts
+    uint32_t timestamp[MPU6050_BLOCK_SIZE]; // Sample time, microseconds
+    uint32_t count;                      // Valid samples
+    uint8_t accel_fsr;                   // Mpu6050AccelFsr of every sample in the block
+    uint8_t gyro_fsr;                    // Mpu6050GyroFsr of every sample in the block
+} Mpu6050SampleBlock;
+
+// Decodes `count` big-endian 14-byte FIFO/burst frames into `block`. The
+// timestamps are left to the caller (see mpu6050_timebase.h).
+void mpu6050_decode_block(const uint8_t* frames, size_t count, Mpu6050SampleBlock* block);
+
+// Single-producer/single-consumer ring with struct-of-arrays storage. Blocks go in
+// and out by channel row (at most two memcpy per row), the producer never blocks
+// and samples that do not fit are counted as overruns. pop() never mixes samples
+// captured with different FSRs in one block.
+template <uint32_t Capacity>
+class Mpu6050BlockRing {
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    Mpu6050BlockRing()
+        : head_(0)
+        , tail_(0)
+        , overruns_(0)
+        , high_watermark_(0) {
+    }
+
+    // Producer: appends as much of `block` as fits, returns the number stored
+    uint32_t push(const Mpu6050SampleBlock& block) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t used = head - tail_.load(std::memory_order_acquire);
+        uint32_t space = Capacity - used;
+        uint32_t n = block.count < space ? block.count : space;
+
+        for (int axis = 0; axis < 3; axis++) {
+            copy_in(acc_[axis], block.acc[axis], head, n);
+            copy_in(gyro_[axis], block.gyro[axis], head, n);
+        }
+        copy_in(temp_, block.temp, head, n);
+        copy_in(timestamp_, block.timestamp, head, n);
+        uint8_t fsr = static_cast<uint8_t>((block.accel_fsr << 4) | block.gyro_fsr);
+        for (uint32_t i = 0; i < n; i++) fsr_[(head + i) & (Capacity - 1)] = fsr;
+
+        head_.store(head + n, std::memory_order_release);
+        if (n < block.count) overruns_.fetch_add(block.count - n, std::memory_order_relaxed);
+        if (used + n > high_watermark_.load(std::memory_order_relaxed)) {
+            high_watermark_.store(used + n, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // Consumer: moves up to `max` (and at most MPU6050_BLOCK_SIZE) of the oldest
+    // samples into `block`, stopping early where the FSR changes
+    uint32_t pop(Mpu6050SampleBlock& block, uint32_t max = MPU6050_BLOCK_SIZE) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t available = head_.load(std::memory_order_acquire) - tail;
+        if (max > MPU6050_BLOCK_SIZE) max = MPU6050_BLOCK_SIZE;
+        uint32_t n = available < max ? available : max;
+
+        uint8_t fsr = n ? fsr_[tail & (Capacity - 1)] : 0;
+        for (uint32_t i = 1; i < n; i++) {
+            if (fsr_[(tail + i) & (Capacity - 1)] != fsr) {
+                n = i;
+                break;
+            }
+        }
+
+        for (int axis = 0; axis < 3; axis++) {
+            copy_out(block.acc[axis], acc_[axis], tail, n);
+            copy_out(block.gyro[axis], gyro_[axis], tail, n);
+        }
+        copy_out(block.temp, temp_, tail, n);
+        copy_out(block.timestamp, timestamp_, tail, n);
+        block.count = n;
+        block.accel_fsr = fsr >> 4;
+        block.gyro_fsr = fsr & 0x0F;
+
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer: drops everything queued so far
+    void clear() {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Counters, safe to read from either side
+    uint32_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    static constexpr uint32_t capacity() {
+        return Capacity;
+    }
+    uint32_t overruns() const {
+        return overruns_.load(std::memory_order_relaxed);
+    }
+    uint32_t high_watermark() const {
+        return high_watermark_.load(std::memory_order_relaxed);
+    }
+    uint32_t total_pushed() const {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+private:
+    template <typename T>
+    static void copy_in(T* row, const T* source, uint32_t head, uint32_t n) {
+        uint32_t start = head & (Capacity - 1);
+        uint32_t first = (Capacity - start) < n ? (Capacity - start) : n;
+        memcpy(&row[start], source, first * sizeof(T));
+        memcpy(&row[0], source + first, (n - first) * sizeof(T));
+    }
+
+    template <typename T>
+    static void copy_out(T* destination, const T* row, uint32_t tail, uint32_t n) {
+        uint32_t start = tail & (Capacity - 1);
+        uint32_t first = (Capacity - start) < n ? (Capacity - start) : n;
+        memcpy(destination, &row[start], first * sizeof(T));
+        memcpy(destination + first, &row[0], (n - first) * sizeof(T));
+    }
+
+    int16_t acc_[3][Capacity];
+    int16_t gyro_[3][Capacity];
+    int16_t temp_[Capacity];
+    uint32_t timestamp_[Capacity];
+    uint8_t fsr_[Capacity]; // accel_fsr << 4 | gyro_fsr
+    std::atomic<uint32_t> head_; // Written by the producer only
+    std::atomic<uint32_t> tail_; // Written by the consumer only
+    std::atomic<uint32_t> overruns_;
+    std::atomic<uint32_t> high_watermark_;
+};
@@ -0,0 +1,183 @@
+#include "mpu6050_calibration.h"
+#include "mpu6050_logger.h"
+#include "mpu6050_record.h"
+#include "mpu6050_units.h"
+
+// Axis facing up or down in each pose, and which way
+static const uint8_t calibration_pose_axis[Mpu6050CalPose_Count] = {2, 2, 0, 0, 1, 1};
+static const int8_t calibration_pose_sign[Mpu6050CalPose_Count] = {1, -1, 1, -1, 1, -1};
+
+// Calibration file payload: address, then accel and gyro offsets
+#define MPU6050_CAL_MAGIC 0x4C43 // "CL"
+#define MPU6050_CAL_VERSION 1
+#define MPU6050_CAL_PAYLOAD_SIZE 13
+
+static void calibration_clear_pose(Mpu6050Calibration* calibration) {
+    calibration->samples = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        calibration->acc_sum[axis] = 0;
+        calibration->gyro_sum[axis] = 0;
+        calibration->acc_min[axis] = INT16_MAX;
+        calibration->acc_max[axis] = INT16_MIN;
+    }
+}
+
+void mpu6050_calibration_init(Mpu6050Calibration* calibration, uint32_t sample_rate_hz) {
+    calibration->state = Mpu6050CalState_Waiting;
+    calibration->pose = Mpu6050CalPose_ZUp;
+    calibration->skip = 0;
+    calibration->settle_samples = sample_rate_hz * MPU6050_CAL_SETTLE_MS / 1000;
+    calibration_clear_pose(calibration);
+}
+
+void mpu6050_calibration_measure(Mpu6050Calibration* calibration) {
+    if (calibration->state == Mpu6050CalState_Done) return;
+    calibration_clear_pose(calibration);
+    calibration->skip = calibration->settle_samples;
+    calibration->state = Mpu6050CalState_Settling;
+}
+
+// Checks the pose that just filled and keeps its means
+static void calibration_finish_pose(Mpu6050Calibration* calibration) {
+    uint8_t pose = calibration->pose;
+    bool still = true;
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t mean = static_cast<int32_t>(calibration->acc_sum[axis] / calibration->samples);
+        calibration->acc_mean_mg[pose][axis] = mpu6050_accel_counts_to_mg(mean, calibration->accel_fsr);
+        mean = static_cast<int32_t>(calibration->gyro_sum[axis] / calibration->samples);
+        calibration->gyro_mean_mdps[pose][axis] = mpu6050_gyro_counts_to_mdps(mean, calibration->gyro_fsr);
+        int32_t range = calibration->acc_max[axis] - calibration->acc_min[axis];
+        if (mpu6050_accel_counts_to_mg(range, calibration->accel_fsr) > MPU6050_CAL_MAX_RANGE_MG) still = false;
+    }
+    int32_t gravity = calibration->acc_mean_mg[pose][calibration_pose_axis[pose]] * calibration_pose_sign[pose];
+
+    if (!still || gravity < MPU6050_CAL_MIN_GRAVITY_MG) {
+        calibration->state = Mpu6050CalState_Rejected;
+    } else if (++calibration->pose == Mpu6050CalPose_Count) {
+        calibration->state = Mpu6050CalState_Done;
+    } else {
+        calibration->state = Mpu6050CalState_Waiting;
+    }
+}
+
+bool mpu6050_calibration_push(Mpu6050Calibration* calibration, const Mpu6050SampleBlock* block) {
+    uint32_t first = 0;
+    if (calibration->state == Mpu6050CalState_Settling) {
+        first = block->count < calibration->skip ? block->count : calibration->skip;
+        calibration->skip -= first;
+        if (calibration->skip) return false;
+        calibration->state = Mpu6050CalState_Measuring;
+    }
+    if (calibration->state != Mpu6050CalState_Measuring) return false;
+
+    // An FSR change mid-pose would mix scales; start the pose over
+    if (calibration->samples &&
+        (block->accel_fsr != calibration->accel_fsr || block->gyro_fsr != calibration->gyro_fsr)) {
+        calibration_clear_pose(calibration);
+    }
+    calibration->accel_fsr = block->accel_fsr;
+    calibration->gyro_fsr = block->gyro_fsr;
+
+    uint32_t wanted = MPU6050_CAL_SAMPLES - calibration->samples;
+    uint32_t last = block->count - first < wanted ? block->count : first + wanted;
+    for (int axis = 0; axis < 3; axis++) {
+        const int16_t* acc = block->acc[axis];
+        const int16_t* gyro = block->gyro[axis];
+        int64_t acc_sum = 0;
+        int64_t gyro_sum = 0;
+        for (uint32_t i = first; i < last; i++) {
+            acc_sum += acc[i];
+            gyro_sum += gyro[i];
+        }
+        int16_t lo;
+        int16_t hi;
+        mpu6050_row_range(&acc[first], last - first, &lo, &hi);
+        if (lo < calibration->acc_min[axis]) calibration->acc_min[axis] = lo;
+        if (hi > calibration->acc_max[axis]) calibration->acc_max[axis] = hi;
+        calibration->acc_sum[axis] += acc_sum;
+        calibration->gyro_sum[axis] += gyro_sum;
+    }
+    calibration->samples += last - first;
+
+    if (calibration->samples < MPU6050_CAL_SAMPLES) return false;
+    calibration_finish_pose(calibration);
+    return true;
+}
+
+uint8_t mpu6050_calibration_progress(const Mpu6050Calibration* calibration) {
+    return static_cast<uint8_t>(calibration->samples * 100 / MPU6050_CAL_SAMPLES);
+}
+
+void mpu6050_calibration_solve(const Mpu6050Calibration* calibration, Mpu6050CalResult* result) {
+    for (int axis = 0; axis < 3; axis++) {
+        // The up and down poses of this axis read +1 g and -1 g plus the offset
+        int32_t up = 0;
+        int32_t down = 0;
+        int64_t gyro = 0;
+        for (uint8_t pose = 0; pose < Mpu6050CalPose_Count; pose++) {
+            if (calibration_pose_axis[pose] == axis) {
+                if (calibration_pose_sign[pose] > 0) {
+                    up = calibration->acc_mean_mg[pose][axis];
+                } else {
+                    down = calibration->acc_mean_mg[pose][axis];
+                }
+            }
+            gyro += calibration->gyro_mean_mdps[pose][axis];
+        }
+        result->accel_mg[axis] = (up + down) / 2;
+        result->gyro_mdps[axis] = static_cast<int32_t>(gyro / Mpu6050CalPose_Count);
+    }
+}
+
+static int16_t calibration_clamp16(int32_t value) {
+    return static_cast<int16_t>(value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : value);
+}
+
+// Rounds value / divisor to the nearest integer, halves away from zero
+static int32_t calibration_round_div(int64_t value, int64_t divisor) {
+    return static_cast<int32_t>(value >= 0 ? (value + divisor / 2) / divisor : (value - divisor / 2) / divisor);
+}
+
+void mpu6050_offsets_correct(const Mpu6050Offsets* current, const Mpu6050CalResult* result, Mpu6050Offsets* corrected) {
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t delta = calibration_round_div(
+            -static_cast<int64_t>(result->accel_mg[axis]) * MPU6050_ACCEL_OFFSET_LSB_PER_G, 1000);
+        // Bit 0 is reserved: move in steps of two and keep the chip's bit
+        int32_t accel = (current->accel[axis] + delta) & ~1;
+        corrected->accel[axis] = calibration_clamp16(accel | (current->accel[axis] & 1));
+
+        delta = calibration_round_div(
+            -static_cast<int64_t>(result->gyro_mdps[axis]) * MPU6050_GYRO_OFFSET_LSB_PER_DPS_X10, 10000);
+        corrected->gyro[axis] = calibration_clamp16(current->gyro[axis] + delta);
+    }
+}
+
+static void calibration_path(uint8_t address, char* path, size_t size) {
+    snprintf(path, size, MPU6050_LOG_DIR "/calibration_%02x.bin", address);
+}
+
+bool mpu6050_offsets_save(uint8_t address, const Mpu6050Offsets* offsets) {
+    uint8_t data[MPU6050_CAL_PAYLOAD_SIZE];
+    uint8_t* out = data;
+    *out++ = address;
+    for (int axis = 0; axis < 3; axis++) out = mpu6050_record_put16(out, offsets->accel[axis]);
+    for (int axis = 0; axis < 3; axis++) out = mpu6050_record_put16(out, offsets->gyro[axis]);
+
+    char path[64];
+    calibration_path(address, path, sizeof(path));
+    return mpu6050_record_save(path, MPU6050_CAL_MAGIC, MPU6050_CAL_VERSION, data, sizeof(data));
+}
+
+bool mpu6050_offsets_load(uint8_t address, Mpu6050Offsets* offsets) {
+    uint8_t data[MPU6050_CAL_PAYLOAD_SIZE];
+    char path[64];
+    calibration_path(address, path, sizeof(path));
+    if (!mpu6050_record_load(path, MPU6050_CAL_MAGIC, MPU6050_CAL_VERSION, data, sizeof(data)) ||
+        data[0] != address) {
+        return false;
+    }
+    const uint8_t* in = data + 1;
+    for (int axis = 0; axis < 3; axis++) in = mpu6050_record_get16(in, &offsets->accel[axis]);
+    for (int axis = 0; axis < 3; axis++) in = mpu6050_record_get16(in, &offsets->gyro[axis]);
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050.h"
+#include "mpu6050_block.h"
+
+// Six-position calibration.
+//
+// The sensor rests in six orientations, each axis pointing up and then down, and
+// every orientation averages MPU6050_CAL_SAMPLES samples at the full rate. An
+// axis' accel offset is the middle of its up and down readings, which cancels
+// gravity whatever the scale error; the gyro bias is the mean over all six rests.
+// The corrections go into the chip's offset registers, so corrected samples cost
+// nothing per sample, and are saved per address for init() to restore.
+
+#define MPU6050_CAL_SAMPLES 2000       // Averaged per orientation
+#define MPU6050_CAL_SETTLE_MS 300      // Dropped after each button press
+#define MPU6050_CAL_MAX_RANGE_MG 150   // A wider spread on any axis means it moved
+#define MPU6050_CAL_MIN_GRAVITY_MG 700 // Gravity expected on the axis facing up or down
+
+typedef enum {
+    Mpu6050CalPose_ZUp,
+    Mpu6050CalPose_ZDown,
+    Mpu6050CalPose_XUp,
+    Mpu6050CalPose_XDown,
+    Mpu6050CalPose_YUp,
+    Mpu6050CalPose_YDown,
+    Mpu6050CalPose_Count
+} Mpu6050CalPose;
+
+typedef enum {
+    Mpu6050CalState_Waiting,   // For the sensor to be placed in `pose`
+    Mpu6050CalState_Settling,  // Dropping the samples shaken by the button press
+    Mpu6050CalState_Measuring,
+    Mpu6050CalState_Rejected,  // Moved or wrong way up; `pose` is measured again
+    Mpu6050CalState_Done,      // Every pose measured
+} Mpu6050CalState;
+
+typedef struct {
+    uint8_t state; // Mpu6050CalState
+    uint8_t pose;  // Mpu6050CalPose
+    uint32_t skip; // Samples left to drop while settling
+    uint32_t settle_samples;
+
+    // Current pose, in counts at `accel_fsr` / `gyro_fsr`
+    uint8_t accel_fsr;
+    uint8_t gyro_fsr;
+    uint32_t samples;
+    int64_t acc_sum[3];
+    int64_t gyro_sum[3];
+    int16_t acc_min[3];
+    int16_t acc_max[3];
+
+    // Measured poses
+    int32_t acc_mean_mg[Mpu6050CalPose_Count][3];
+    int32_t gyro_mean_mdps[Mpu6050CalPose_Count][3];
+} Mpu6050Calibration;
+
+// Errors the offsets should cancel, in mg and milli-deg/s
+typedef struct {
+    int32_t accel_mg[3];
+    int32_t gyro_mdps[3];
+} Mpu6050CalResult;
+
+void mpu6050_calibration_init(Mpu6050Calibration* calibration, uint32_t sample_rate_hz);
+
+// Starts measuring the current pose (the user confirmed the sensor is in place)
+void mpu6050_calibration_measure(Mpu6050Calibration* calibration);
+
+// Feeds samples; returns true when the pose just finished, accepted or rejected
+bool mpu6050_calibration_push(Mpu6050Calibration* calibration, const Mpu6050SampleBlock* block);
+
+// Progress of the current pose, 0..100
+uint8_t mpu6050_calibration_progress(const Mpu6050Calibration* calibration);
+
+// Errors from the six poses; only valid in Mpu6050CalState_Done
+void mpu6050_calibration_solve(const Mpu6050Calibration* calibration, Mpu6050CalResult* result);
+
+// Offset registers that cancel `result` on a chip currently holding `current`
+void mpu6050_offsets_correct(const Mpu6050Offsets* current, const Mpu6050CalResult* result, Mpu6050Offsets* corrected);
+
+// Stored calibration of the sensor at `address`
+bool mpu6050_offsets_save(uint8_t address, const Mpu6050Offsets* offsets);
+bool mpu6050_offsets_load(uint8_t address, Mpu6050Offsets* offsets);
@@ -0,0 +1,57 @@
+#include "mpu6050_decimator.h"
+
+static void decimator_open_column(Mpu6050Decimator* decimator) {
+    decimator->fill = 0;
+    for (int channel = 0; channel < MPU6050_DECIMATOR_CHANNELS; channel++) {
+        decimator->open_min[channel] = INT16_MAX;
+        decimator->open_max[channel] = INT16_MIN;
+    }
+}
+
+void mpu6050_decimator_init(Mpu6050Decimator* decimator, uint32_t samples_per_column) {
+    decimator->samples_per_column = samples_per_column ? samples_per_column : 1;
+    decimator->tag = 0;
+    mpu6050_decimator_reset(decimator);
+}
+
+void mpu6050_decimator_reset(Mpu6050Decimator* decimator) {
+    decimator->columns = 0;
+    decimator->generation++;
+    decimator_open_column(decimator);
+}
+
+void mpu6050_decimator_push(
+    Mpu6050Decimator* decimator,
+    const int16_t* const rows[MPU6050_DECIMATOR_CHANNELS],
+    uint32_t count,
+    uint32_t tag) {
+    if (tag != decimator->tag) {
+        mpu6050_decimator_reset(decimator);
+        decimator->tag = tag;
+    }
+
+    // Whole runs of each row go through the vectorised range reduction
+    uint32_t done = 0;
+    while (done < count) {
+        uint32_t space = decimator->samples_per_column - decimator->fill;
+        uint32_t n = count - done < space ? count - done : space;
+        for (int channel = 0; channel < MPU6050_DECIMATOR_CHANNELS; channel++) {
+            int16_t lo;
+            int16_t hi;
+            mpu6050_row_range(&rows[channel][done], n, &lo, &hi);
+            if (lo < decimator->open_min[channel]) decimator->open_min[channel] = lo;
+            if (hi > decimator->open_max[channel]) decimator->open_max[channel] = hi;
+        }
+        decimator->fill += n;
+        done += n;
+
+        if (decimator->fill == decimator->samples_per_column) {
+            uint32_t slot = mpu6050_decimator_slot(decimator->columns++);
+            for (int channel = 0; channel < MPU6050_DECIMATOR_CHANNELS; channel++) {
+                decimator->min[channel][slot] = decimator->open_min[channel];
+                decimator->max[channel][slot] = decimator->open_max[channel];
+            }
+            decimator_open_column(decimator);
+        }
+    }
+}
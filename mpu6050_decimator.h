@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_units.h"
+
+// Min/max decimation for plots.
+//
+// Every `samples_per_column` samples of each channel collapse into one column
+// holding their smallest and largest value, so a one-sample spike still shows up
+// however many samples a pixel column covers. Completed columns go into a ring
+// of the last MPU6050_DECIMATOR_COLUMNS, one per screen column.
+
+#define MPU6050_DECIMATOR_CHANNELS 6 // Accel X, Y, Z, gyro X, Y, Z
+#define MPU6050_DECIMATOR_COLUMNS 128 // Screen width; power of two
+
+static_assert(
+    (MPU6050_DECIMATOR_COLUMNS & (MPU6050_DECIMATOR_COLUMNS - 1)) == 0,
+    "column ring size must be a power of two");
+
+typedef struct {
+    uint32_t samples_per_column;
+    uint32_t tag;        // Caller's tag of the samples in the history (e.g. FSRs)
+    uint32_t generation; // Bumped by every reset so views can tell history was dropped
+
+    // Column being built
+    uint32_t fill;
+    int16_t open_min[MPU6050_DECIMATOR_CHANNELS];
+    int16_t open_max[MPU6050_DECIMATOR_CHANNELS];
+
+    // Completed columns, ring indexed by column number
+    int16_t min[MPU6050_DECIMATOR_CHANNELS][MPU6050_DECIMATOR_COLUMNS];
+    int16_t max[MPU6050_DECIMATOR_CHANNELS][MPU6050_DECIMATOR_COLUMNS];
+    uint32_t columns; // Columns completed since the last reset
+} Mpu6050Decimator;
+
+void mpu6050_decimator_init(Mpu6050Decimator* decimator, uint32_t samples_per_column);
+
+// Drops the history and the open column
+void mpu6050_decimator_reset(Mpu6050Decimator* decimator);
+
+// Appends `count` samples of each channel (rows[channel][0..count)); samples with
+// a different `tag` than the history restart it
+void mpu6050_decimator_push(
+    Mpu6050Decimator* decimator,
+    const int16_t* const rows[MPU6050_DECIMATOR_CHANNELS],
+    uint32_t count,
+    uint32_t tag);
+
+// Completed columns still in the ring
+static inline uint32_t mpu6050_decimator_available(const Mpu6050Decimator* decimator) {
+    return decimator->columns < MPU6050_DECIMATOR_COLUMNS ? decimator->columns : MPU6050_DECIMATOR_COLUMNS;
+}
+
+// Ring slot of column number `column`
+static inline uint32_t mpu6050_decimator_slot(uint32_t column) {
+    return column & (MPU6050_DECIMATOR_COLUMNS - 1);
+}
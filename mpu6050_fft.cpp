@@ -0,0 +1,235 @@
+#include "mpu6050_fft.h"
+#include <string.h>
+
+// One full turn of the sine table; angles are indices into it
+#define MPU6050_FFT_TABLE_SIZE 1024
+#define MPU6050_FFT_QUARTER (MPU6050_FFT_TABLE_SIZE / 4)
+
+static_assert(MPU6050_FFT_TABLE_SIZE >= MPU6050_FFT_MAX_SIZE, "table must resolve the largest FFT");
+
+// Three quarters of a turn cover sin() for [0, pi] and cos() = sin(x + pi/2)
+// for [0, pi], which is every twiddle a real FFT of up to TABLE_SIZE needs
+typedef struct {
+    int16_t sine[MPU6050_FFT_QUARTER * 3 + 1];
+} Mpu6050FftTables;
+
+static constexpr double fft_pi = 3.14159265358979323846;
+
+// Taylor series on [-pi/2, pi/2]; good to well below one Q15 LSB
+static constexpr double fft_constexpr_sin(double x) {
+    if (x > fft_pi / 2) x = fft_pi - x;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+static constexpr Mpu6050FftTables fft_make_tables() {
+    Mpu6050FftTables tables = {};
+    for (int i = 0; i <= MPU6050_FFT_QUARTER * 3; i++) {
+        double angle = 2 * fft_pi * i / MPU6050_FFT_TABLE_SIZE;
+        double x = angle <= fft_pi ? fft_constexpr_sin(angle) : -fft_constexpr_sin(angle - fft_pi);
+        double scaled = x * 32767.0;
+        tables.sine[i] = static_cast<int16_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    }
+    return tables;
+}
+
+static constexpr Mpu6050FftTables fft_tables = fft_make_tables();
+
+static_assert(fft_tables.sine[0] == 0, "sin(0)");
+static_assert(fft_tables.sine[MPU6050_FFT_QUARTER] == 32767, "sin(pi/2)");
+static_assert(fft_tables.sine[MPU6050_FFT_QUARTER * 2] == 0, "sin(pi)");
+static_assert(fft_tables.sine[MPU6050_FFT_QUARTER * 3] == -32767, "sin(3pi/2)");
+
+// Angle index in [0, TABLE_SIZE / 2]
+static inline int32_t fft_sin(uint32_t index) {
+    return fft_tables.sine[index];
+}
+
+// Angle index in [0, TABLE_SIZE)
+static inline int32_t fft_cos(uint32_t index) {
+    if (index > MPU6050_FFT_TABLE_SIZE / 2) index = MPU6050_FFT_TABLE_SIZE - index;
+    return fft_tables.sine[index + MPU6050_FFT_QUARTER];
+}
+
+static inline uint32_t fft_bit_reverse(uint32_t value, uint8_t bits) {
+#if defined(__ARM_ARCH_7EM__)
+    uint32_t reversed;
+    __asm__("rbit %0, %1" : "=r"(reversed) : "r"(value));
+    return reversed >> (32 - bits);
+#else
+    uint32_t reversed = 0;
+    for (uint8_t i = 0; i < bits; i++) {
+        reversed = (reversed << 1) | (value & 1);
+        value >>= 1;
+    }
+    return reversed;
+#endif
+}
+
+// Removes the frame mean (gravity), applies the Hann window and packs the real
+// samples pairwise into complex points in bit-reversed order
+static void spectrum_window(Mpu6050Spectrum* spectrum) {
+    uint32_t size = spectrum->size;
+    uint32_t stride = MPU6050_FFT_TABLE_SIZE / size;
+    uint8_t complex_bits = spectrum->log2_size - 1;
+
+    int32_t sum = 0;
+    for (uint32_t n = 0; n < size; n++) sum += spectrum->input[n];
+    int32_t mean = sum >> spectrum->log2_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        int32_t hann = (32768 - fft_cos(n * stride)) >> 1; // Q15, 0.5 - 0.5 cos
+        int32_t value = ((spectrum->input[n] - mean) * hann) >> 15;
+        uint32_t point = fft_bit_reverse(n >> 1, complex_bits);
+        spectrum->work[2 * point + (n & 1)] = value;
+    }
+
+    // 50% overlap: the second half starts the next frame
+    memmove(spectrum->input, &spectrum->input[size / 2], (size / 2) * sizeof(spectrum->input[0]));
+    spectrum->input_fill = static_cast<uint16_t>(size / 2);
+}
+
+// One radix-2 decimation-in-time stage over `points` complex values
+static void fft_stage(int32_t* data, uint32_t points, uint32_t half) {
+    uint32_t stride = MPU6050_FFT_TABLE_SIZE / (2 * half);
+    for (uint32_t k = 0; k < half; k++) {
+        int64_t wr = fft_cos(k * stride);
+        int64_t wi = -fft_sin(k * stride);
+        for (uint32_t i = k; i < points; i += 2 * half) {
+            int32_t* a = &data[2 * i];
+            int32_t* b = &data[2 * (i + half)];
+            int32_t tr = static_cast<int32_t>((b[0] * wr - b[1] * wi) >> 15);
+            int32_t ti = static_cast<int32_t>((b[0] * wi + b[1] * wr) >> 15);
+            b[0] = a[0] - tr;
+            b[1] = a[1] - ti;
+            a[0] += tr;
+            a[1] += ti;
+        }
+    }
+}
+
+// Windows a full input frame and queues its FFT stages if the transform is idle
+static bool spectrum_start(Mpu6050Spectrum* spectrum) {
+    if (spectrum->step || spectrum->ready) return false;
+    spectrum_window(spectrum);
+    spectrum->step = 1;
+    return true;
+}
+
+uint16_t mpu6050_fft_size(Mpu6050FftSize size) {
+    return static_cast<uint16_t>(256U << size);
+}
+
+void mpu6050_spectrum_init(Mpu6050Spectrum* spectrum, Mpu6050FftSize size, uint16_t sample_rate_hz) {
+    spectrum->size = mpu6050_fft_size(size);
+    spectrum->log2_size = static_cast<uint8_t>(8 + size);
+    spectrum->sample_rate_hz = sample_rate_hz;
+    mpu6050_spectrum_reset(spectrum);
+}
+
+void mpu6050_spectrum_reset(Mpu6050Spectrum* spectrum) {
+    spectrum->input_fill = 0;
+    spectrum->step = 0;
+    spectrum->ready = false;
+    memset(spectrum->power, 0, sizeof(spectrum->power));
+    spectrum->frames = 0;
+    spectrum->frames_total = 0;
+    spectrum->frames_skipped = 0;
+}
+
+void mpu6050_spectrum_push(Mpu6050Spectrum* spectrum, const int16_t* samples, uint32_t count, uint8_t accel_fsr) {
+    if (accel_fsr != spectrum->accel_fsr) {
+        mpu6050_spectrum_reset(spectrum);
+        spectrum->accel_fsr = accel_fsr;
+    }
+
+    while (count) {
+        uint32_t space = spectrum->size - spectrum->input_fill;
+        uint32_t n = count < space ? count : space;
+        memcpy(&spectrum->input[spectrum->input_fill], samples, n * sizeof(samples[0]));
+        spectrum->input_fill = static_cast<uint16_t>(spectrum->input_fill + n);
+        samples += n;
+        count -= n;
+
+        if (spectrum->input_fill == spectrum->size && !spectrum_start(spectrum) && count) {
+            // Still transforming the previous frame: drop this one's older half
+            uint32_t half = spectrum->size / 2;
+            memmove(spectrum->input, &spectrum->input[half], half * sizeof(spectrum->input[0]));
+            spectrum->input_fill = static_cast<uint16_t>(half);
+            spectrum->frames_skipped++;
+        }
+    }
+}
+
+bool mpu6050_spectrum_process(Mpu6050Spectrum* spectrum, uint32_t budget) {
+    uint32_t spent = 0;
+    uint32_t points = spectrum->size / 2;
+
+    // A frame that filled up while the previous one was in flight
+    if (spectrum->input_fill == spectrum->size) spectrum_start(spectrum);
+
+    while (spectrum->step && (spent == 0 || spent < budget)) {
+        fft_stage(spectrum->work, points, 1U << (spectrum->step - 1));
+        spent += points / 2;
+        // Steps 1..log2(N/2) are the FFT stages
+        if (++spectrum->step >= spectrum->log2_size) {
+            spectrum->step = 0;
+            spectrum->ready = true;
+        }
+    }
+    return spectrum->ready;
+}
+
+void mpu6050_spectrum_accumulate(Mpu6050Spectrum* spectrum) {
+    if (!spectrum->ready) return;
+
+    uint32_t points = spectrum->size / 2;
+    uint32_t stride = MPU6050_FFT_TABLE_SIZE / spectrum->size;
+    // |X| of a full-scale sine is A * N / 4 after the Hann window; scale to A << 4
+    uint8_t shift = spectrum->log2_size - 2 - MPU6050_SPECTRUM_AMPLITUDE_SHIFT;
+    uint16_t depth = spectrum->frames < MPU6050_SPECTRUM_AVERAGES ? spectrum->frames + 1 : MPU6050_SPECTRUM_AVERAGES;
+    const int32_t* z = spectrum->work;
+
+    for (uint32_t k = 0; k <= points; k++) {
+        // Separate the even/odd half-length spectra, then combine with W_N^k
+        uint32_t a = k == points ? 0 : k;
+        uint32_t b = k == 0 ? 0 : points - k;
+        int64_t even_r = (static_cast<int64_t>(z[2 * a]) + z[2 * b]) >> 1;
+        int64_t even_i = (static_cast<int64_t>(z[2 * a + 1]) - z[2 * b + 1]) >> 1;
+        int64_t odd_r = (static_cast<int64_t>(z[2 * a + 1]) + z[2 * b + 1]) >> 1;
+        int64_t odd_i = (static_cast<int64_t>(z[2 * b]) - z[2 * a]) >> 1;
+        int64_t c = fft_cos(k * stride);
+        int64_t s = fft_sin(k * stride);
+        int64_t re = (even_r + ((c * odd_r + s * odd_i) >> 15)) >> shift;
+        int64_t im = (even_i + ((c * odd_i - s * odd_r) >> 15)) >> shift;
+
+        int64_t power = re * re + im * im;
+        int64_t average = static_cast<int64_t>(spectrum->power[k]);
+        spectrum->power[k] = static_cast<uint64_t>(average + (power - average) / depth);
+    }
+
+    spectrum->frames = depth;
+    spectrum->frames_total++;
+    spectrum->ready = false;
+}
+
+uint32_t mpu6050_spectrum_amplitude(const Mpu6050Spectrum* spectrum, uint32_t bin) {
+    return mpu6050_isqrt64(spectrum->power[bin]);
+}
+
+uint32_t mpu6050_spectrum_peak_bin(const Mpu6050Spectrum* spectrum) {
+    uint32_t peak = 1;
+    for (uint32_t k = 2; k <= spectrum->size / 2u; k++) {
+        if (spectrum->power[k] > spectrum->power[peak]) peak = k;
+    }
+    return peak;
+}
+
+uint32_t mpu6050_spectrum_bin_centi_hz(const Mpu6050Spectrum* spectrum, uint32_t bin) {
+    return bin * spectrum->sample_rate_hz * 100U / spectrum->size;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "mpu6050_units.h"
+
+// Fixed-point spectrum analyser for one accelerometer channel.
+//
+// Samples are Hann-windowed into frames of 256/512/1024 with 50% overlap and
+// run through a radix-2 real FFT (an N/2-point complex FFT plus a split pass).
+// Twiddles and the window come from a Q15 sine table built at compile time;
+// data is int32 so 16-bit input plus log2(N) bits of growth never needs
+// per-stage scaling. Periodograms are Welch-averaged (a plain mean over the
+// first MPU6050_SPECTRUM_AVERAGES frames, then an exponential mean of the same
+// depth so the display keeps following the signal).
+//
+// A full input frame is windowed as it is pushed; the FFT stages then run a few
+// at a time from mpu6050_spectrum_process() so the caller can spread one frame
+// over several display frames.
+
+#define MPU6050_FFT_MAX_SIZE 1024
+#define MPU6050_FFT_MAX_BINS (MPU6050_FFT_MAX_SIZE / 2 + 1)
+#define MPU6050_SPECTRUM_AVERAGES 8
+
+// Amplitudes are reported in raw counts with 4 fractional bits
+#define MPU6050_SPECTRUM_AMPLITUDE_SHIFT 4
+
+typedef enum {
+    Mpu6050FftSize_256,
+    Mpu6050FftSize_512,
+    Mpu6050FftSize_1024,
+    Mpu6050FftSize_Count
+} Mpu6050FftSize;
+
+typedef struct {
+    // Configuration
+    uint16_t size;      // FFT length N
+    uint8_t log2_size;
+    uint8_t accel_fsr;  // FSR of the samples being averaged
+    uint16_t sample_rate_hz;
+
+    // Input frame, filled by mpu6050_spectrum_push()
+    int16_t input[MPU6050_FFT_MAX_SIZE];
+    uint16_t input_fill;
+
+    // Transform in progress: N/2 complex points, interleaved re/im
+    int32_t work[MPU6050_FFT_MAX_SIZE];
+    uint8_t step;       // Next FFT stage + 1, 0 = idle
+    bool ready;         // Transform done, waiting for mpu6050_spectrum_accumulate()
+
+    // Welch-averaged power per bin, (counts << AMPLITUDE_SHIFT)^2
+    uint64_t power[MPU6050_FFT_MAX_BINS];
+    uint16_t frames;         // Periodograms in the average (saturates at AVERAGES)
+    uint32_t frames_total;
+    uint32_t frames_skipped; // Input frames dropped because the transform lagged
+} Mpu6050Spectrum;
+
+uint16_t mpu6050_fft_size(Mpu6050FftSize size);
+
+// Resets the analyser for a new size or sample rate
+void mpu6050_spectrum_init(Mpu6050Spectrum* spectrum, Mpu6050FftSize size, uint16_t sample_rate_hz);
+
+// Clears the average but keeps the configuration
+void mpu6050_spectrum_reset(Mpu6050Spectrum* spectrum);
+
+// Appends samples of one channel and windows each completed frame; an FSR
+// change restarts the average
+void mpu6050_spectrum_push(Mpu6050Spectrum* spectrum, const int16_t* samples, uint32_t count, uint8_t accel_fsr);
+
+// Runs FFT stages until about `budget` butterflies' worth of work is done (at
+// least one stage). Returns true once a transformed frame is waiting for
+// mpu6050_spectrum_accumulate().
+bool mpu6050_spectrum_process(Mpu6050Spectrum* spectrum, uint32_t budget);
+
+// Splits the finished transform into real-FFT bins and folds it into the average
+void mpu6050_spectrum_accumulate(Mpu6050Spectrum* spectrum);
+
+// Averaged amplitude of `bin` in counts << MPU6050_SPECTRUM_AMPLITUDE_SHIFT
+uint32_t mpu6050_spectrum_amplitude(const Mpu6050Spectrum* spectrum, uint32_t bin);
+
+// Strongest bin above DC
+uint32_t mpu6050_spectrum_peak_bin(const Mpu6050Spectrum* spectrum);
+
+// Centre frequency of `bin` in centi-Hz
+uint32_t mpu6050_spectrum_bin_centi_hz(const Mpu6050Spectrum* spectrum, uint32_t bin);
@@ -0,0 +1,115 @@
+#include "mpu6050_fifo.h"
+
+static bool fifo_write_reg(Mpu6050Fifo* fifo, uint8_t reg, uint8_t value) {
+    fifo->transactions++;
+    return fifo->bus->write(fifo->bus->context, fifo->address, reg, &value, 1);
+}
+
+bool mpu6050_fifo_flush(Mpu6050Fifo* fifo) {
+    // FIFO_RESET clears the buffer and self-clears; keep FIFO_EN set so filling restarts
+    return fifo_write_reg(
+        fifo, MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN | MPU6050_USER_CTRL_FIFO_RESET);
+}
+
+void mpu6050_fifo_init(Mpu6050Fifo* fifo, const Mpu6050Bus* bus, uint8_t address) {
+    fifo->bus = bus;
+    fifo->address = address;
+    fifo->frames = 0;
+    fifo->overflows = 0;
+    fifo->frames_lost = 0;
+    fifo->transactions = 0;
+    fifo->bytes = 0;
+}
+
+bool mpu6050_fifo_start(Mpu6050Fifo* fifo) {
+    // Disable and flush first so no stale or partial frame survives a restart
+    if (!fifo_write_reg(fifo, MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RESET)) return false;
+    if (!fifo_write_reg(fifo, MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_ALL)) return false;
+    if (!fifo_write_reg(fifo, MPU6050_REG_INT_ENABLE, MPU6050_INT_FIFO_OFLOW)) return false;
+    return mpu6050_fifo_flush(fifo);
+}
+
+bool mpu6050_fifo_stop(Mpu6050Fifo* fifo) {
+    if (!fifo_write_reg(fifo, MPU6050_REG_FIFO_EN, 0x00)) return false;
+    return fifo_write_reg(fifo, MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RESET);
+}
+
+bool mpu6050_fifo_queued(Mpu6050Fifo* fifo, size_t* frames) {
+    uint8_t count_raw[2];
+    fifo->transactions++;
+    if (!fifo->bus->read(
+            fifo->bus->context, fifo->address, MPU6050_REG_FIFO_COUNTH, count_raw, sizeof(count_raw))) {
+        return false;
+    }
+    fifo->bytes += sizeof(count_raw);
+    *frames = ((static_cast<uint16_t>(count_raw[0]) << 8) | count_raw[1]) / MPU6050_FRAME_SIZE;
+    return true;
+}
+
+Mpu6050FifoStatus mpu6050_fifo_begin(Mpu6050Fifo* fifo, size_t max_frames, size_t* pending) {
+    *pending = 0;
+
+    // 1. How many bytes are queued
+    uint8_t count_raw[2];
+    fifo->transactions++;
+    if (!fifo->bus->read(
+            fifo->bus->context, fifo->address, MPU6050_REG_FIFO_COUNTH, count_raw, sizeof(count_raw))) {
+        return Mpu6050FifoStatus_BusError;
+    }
+    fifo->bytes += sizeof(count_raw);
+    uint16_t count = (static_cast<uint16_t>(count_raw[0]) << 8) | count_raw[1];
+
+    // 2. A full FIFO has started overwriting old bytes, and a count that is not a
+    // multiple of the frame size means we are no longer on a frame boundary. Either
+    // way the queued data cannot be trusted: drop it and start over.
+    if (count >= MPU6050_FIFO_SIZE || (count % MPU6050_FRAME_SIZE) != 0) {
+        fifo->overflows++;
+        fifo->frames_lost += count / MPU6050_FRAME_SIZE;
+        if (!mpu6050_fifo_flush(fifo)) return Mpu6050FifoStatus_BusError;
+        return Mpu6050FifoStatus_Overflow;
+    }
+
+    size_t available = count / MPU6050_FRAME_SIZE;
+    *pending = available < max_frames ? available : max_frames;
+    return Mpu6050FifoStatus_Ok;
+}
+
+bool mpu6050_fifo_burst(Mpu6050Fifo* fifo, uint8_t* frames, size_t count) {
+    if (count > MPU6050_FIFO_BURST_FRAMES) count = MPU6050_FIFO_BURST_FRAMES;
+    size_t bytes = count * MPU6050_FRAME_SIZE;
+
+    // FIFO_R_W does not auto-increment
+    fifo->transactions++;
+    if (!fifo->bus->read(fifo->bus->context, fifo->address, MPU6050_REG_FIFO_R_W, frames, bytes)) {
+        // A partial read leaves the FIFO misaligned; resync on the next call
+        mpu6050_fifo_flush(fifo);
+        return false;
+    }
+    fifo->bytes += bytes;
+    fifo->frames += count;
+    return true;
+}
+
+Mpu6050FifoStatus
+    mpu6050_fifo_read(Mpu6050Fifo* fifo, uint8_t* frames, size_t max_frames, size_t* frames_read) {
+    *frames_read = 0;
+
+    size_t to_read = 0;
+    Mpu6050FifoStatus status = mpu6050_fifo_begin(fifo, max_frames, &to_read);
+    if (status != Mpu6050FifoStatus_Ok) return status;
+
+    // Pull whole frames in bursts
+    size_t done = 0;
+    while (done < to_read) {
+        size_t burst = to_read - done;
+        if (burst > MPU6050_FIFO_BURST_FRAMES) burst = MPU6050_FIFO_BURST_FRAMES;
+        if (!mpu6050_fifo_burst(fifo, frames + done * MPU6050_FRAME_SIZE, burst)) {
+            *frames_read = done;
+            return Mpu6050FifoStatus_BusError;
+        }
+        done += burst;
+    }
+
+    *frames_read = done;
+    return Mpu6050FifoStatus_Ok;
+}
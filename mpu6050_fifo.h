@@ -0,0 +1,95 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// MPU-6050 FIFO registers
+#define MPU6050_REG_FIFO_EN 0x23     // Selects which sensor outputs go into the FIFO
+#define MPU6050_REG_INT_ENABLE 0x38  // Interrupt Enable
+#define MPU6050_REG_INT_STATUS 0x3A  // Interrupt Status
+#define MPU6050_REG_USER_CTRL 0x6A   // User Control
+#define MPU6050_REG_FIFO_COUNTH 0x72 // High byte of FIFO byte count
+#define MPU6050_REG_FIFO_R_W 0x74    // FIFO data port
+
+// FIFO_EN bits
+#define MPU6050_FIFO_EN_TEMP 0x80
+#define MPU6050_FIFO_EN_XG 0x40
+#define MPU6050_FIFO_EN_YG 0x20
+#define MPU6050_FIFO_EN_ZG 0x10
+#define MPU6050_FIFO_EN_ACCEL 0x08
+#define MPU6050_FIFO_EN_ALL 0xF8 // TEMP | XG | YG | ZG | ACCEL
+
+// USER_CTRL bits
+#define MPU6050_USER_CTRL_FIFO_EN 0x40
+#define MPU6050_USER_CTRL_FIFO_RESET 0x04
+
+// INT_ENABLE / INT_STATUS bits
+#define MPU6050_INT_FIFO_OFLOW 0x10
+#define MPU6050_INT_MOT 0x40 // Motion detected
+
+// The FIFO holds 1024 bytes; with all sensors enabled every sample is a 14-byte
+// frame laid out exactly like ACCEL_XOUT_H..GYRO_ZOUT_L (accel, temp, gyro).
+#define MPU6050_FIFO_SIZE 1024
+#define MPU6050_FRAME_SIZE 14
+#define MPU6050_FIFO_MAX_FRAMES (MPU6050_FIFO_SIZE / MPU6050_FRAME_SIZE)
+
+// Frames fetched per I2C read transaction (252 bytes fits one I2C NBYTES transfer)
+#define MPU6050_FIFO_BURST_FRAMES 18
+
+// I2C transport used by the acquisition code. The app binds it to furi_hal_i2c,
+// the host simulator binds it to a register model.
+typedef struct {
+    void* context;
+    // Writes `size` bytes starting at register `reg` (auto-increment)
+    bool (*write)(void* context, uint8_t address, uint8_t reg, const uint8_t* data, size_t size);
+    // Reads `size` bytes starting at register `reg`
+    bool (*read)(void* context, uint8_t address, uint8_t reg, uint8_t* data, size_t size);
+    // Frees a bus a slave holds SDA low on; NULL where the bus cannot be recovered
+    bool (*recover)(void* context);
+} Mpu6050Bus;
+
+typedef enum {
+    Mpu6050FifoStatus_Ok,
+    Mpu6050FifoStatus_Overflow, // FIFO overflowed or lost frame alignment; it was reset
+    Mpu6050FifoStatus_BusError,
+} Mpu6050FifoStatus;
+
+// FIFO acquisition state and counters
+typedef struct {
+    const Mpu6050Bus* bus;
+    uint8_t address;
+
+    uint32_t frames;       // Frames delivered to the caller
+    uint32_t overflows;    // Overflow / misalignment events
+    uint32_t frames_lost;  // Frames discarded by resyncs (lower bound)
+    uint32_t transactions; // I2C transactions issued by the FIFO engine
+    uint32_t bytes;        // Payload bytes moved over the bus
+} Mpu6050Fifo;
+
+// Binds the engine to a bus and device address and clears the counters
+void mpu6050_fifo_init(Mpu6050Fifo* fifo, const Mpu6050Bus* bus, uint8_t address);
+
+// Resets the FIFO, selects accel+temp+gyro and starts filling it
+bool mpu6050_fifo_start(Mpu6050Fifo* fifo);
+
+// Reads how many complete frames are queued without draining them
+bool mpu6050_fifo_queued(Mpu6050Fifo* fifo, size_t* frames);
+
+// Discards everything queued; capture continues from the next sample
+bool mpu6050_fifo_flush(Mpu6050Fifo* fifo);
+
+// Stops filling the FIFO
+bool mpu6050_fifo_stop(Mpu6050Fifo* fifo);
+
+// Drains up to `max_frames` complete frames into `frames` using one FIFO_COUNT read
+// and MPU6050_FIFO_BURST_FRAMES-sized burst reads. On overflow the FIFO is reset so
+// the next call starts on a frame boundary again.
+Mpu6050FifoStatus
+    mpu6050_fifo_read(Mpu6050Fifo* fifo, uint8_t* frames, size_t max_frames, size_t* frames_read);
+
+// Split form of mpu6050_fifo_read() for schedulers that interleave several devices.
+// mpu6050_fifo_begin() reads FIFO_COUNT, handles an overflow the same way and
+// reports how many frames to fetch; each mpu6050_fifo_burst() then fetches up to
+// MPU6050_FIFO_BURST_FRAMES of them and returns false (FIFO reset) on a bus error.
+Mpu6050FifoStatus mpu6050_fifo_begin(Mpu6050Fifo* fifo, size_t max_frames, size_t* pending);
+bool mpu6050_fifo_burst(Mpu6050Fifo* fifo, uint8_t* frames, size_t count);
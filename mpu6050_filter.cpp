@@ -0,0 +1,216 @@
+#include "mpu6050_filter.h"
+#include <math.h>
+
+#define FILTER_PI 3.14159265358979
+
+static_assert((MPU6050_FIR_TAPS_PER_PHASE % 8) == 0, "FIR dot products work in chunks of eight taps");
+
+// Coefficients are designed in double: it runs once per settings change and a
+// low corner needs the precision, 1 - cos(w) of a 1 Hz corner is about 2e-5
+static int32_t filter_q30(double value) {
+    double scaled = value * (1 << MPU6050_FILTER_COEFF_SHIFT);
+    if (scaled > INT32_MAX) return INT32_MAX;
+    if (scaled < INT32_MIN) return INT32_MIN;
+    return static_cast<int32_t>(lrint(scaled));
+}
+
+static void biquad_design(Mpu6050Biquad* biquad, uint8_t type, double w0, double quality) {
+    double c = cos(w0);
+    double alpha = sin(w0) / (2.0 * quality);
+    double b[3];
+    switch (type) {
+        case Mpu6050FilterType_LowPass:
+            b[0] = (1.0 - c) / 2.0;
+            b[1] = 1.0 - c;
+            b[2] = (1.0 - c) / 2.0;
+            break;
+        case Mpu6050FilterType_HighPass:
+            b[0] = (1.0 + c) / 2.0;
+            b[1] = -(1.0 + c);
+            b[2] = (1.0 + c) / 2.0;
+            break;
+        case Mpu6050FilterType_BandPass: // 0 dB at the centre
+            b[0] = alpha;
+            b[1] = 0.0;
+            b[2] = -alpha;
+            break;
+        default: // Notch
+            b[0] = 1.0;
+            b[1] = -2.0 * c;
+            b[2] = 1.0;
+            break;
+    }
+    double a0 = 1.0 + alpha;
+    for (int i = 0; i < 3; i++) biquad->b[i] = filter_q30(b[i] / a0);
+    biquad->a[0] = filter_q30(2.0 * c / a0);
+    biquad->a[1] = filter_q30(-(1.0 - alpha) / a0);
+}
+
+void mpu6050_filter_init(Mpu6050FilterChain* chain, const Mpu6050FilterConfig* config, uint32_t sample_rate_hz) {
+    chain->stages = 0;
+    if (config->type != Mpu6050FilterType_Off && config->type < Mpu6050FilterType_Count && sample_rate_hz) {
+        uint8_t stages = config->stages;
+        if (stages < 1) stages = 1;
+        if (stages > MPU6050_FILTER_MAX_STAGES) stages = MPU6050_FILTER_MAX_STAGES;
+        double corner = config->corner_hz < 0.45 * sample_rate_hz ? config->corner_hz : 0.45 * sample_rate_hz;
+        double w0 = 2.0 * FILTER_PI * corner / sample_rate_hz;
+        bool butterworth = config->type == Mpu6050FilterType_LowPass || config->type == Mpu6050FilterType_HighPass;
+        for (uint8_t k = 0; k < stages; k++) {
+            // Pole pair k of an order 2 x stages Butterworth filter
+            double quality = butterworth ? 1.0 / (2.0 * cos((2 * k + 1) * FILTER_PI / (4.0 * stages))) :
+                                           MPU6050_FILTER_BAND_Q;
+            biquad_design(&chain->biquads[k], config->type, w0, quality);
+        }
+        chain->stages = stages;
+    }
+    mpu6050_filter_reset(chain);
+}
+
+void mpu6050_filter_reset(Mpu6050FilterChain* chain) {
+    memset(chain->state, 0, sizeof(chain->state));
+    chain->accel_fsr = 0xFF;
+}
+
+void mpu6050_biquad_run(
+    const Mpu6050Biquad* biquad,
+    Mpu6050BiquadState* state,
+    const int16_t* in,
+    int16_t* out,
+    uint32_t count) {
+    const int64_t b0 = biquad->b[0];
+    const int64_t b1 = biquad->b[1];
+    const int64_t b2 = biquad->b[2];
+    const int64_t a1 = biquad->a[0];
+    const int64_t a2 = biquad->a[1];
+    int32_t x1 = state->x[0];
+    int32_t x2 = state->x[1];
+    int32_t y1 = state->y[0];
+    int32_t y2 = state->y[1];
+    int64_t error = state->error;
+
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t x0 = in[i];
+        int64_t acc = error + b0 * x0 + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+        int64_t y = acc >> MPU6050_FILTER_COEFF_SHIFT;
+        error = acc - (y << MPU6050_FILTER_COEFF_SHIFT);
+        if (y > INT16_MAX) y = INT16_MAX;
+        if (y < INT16_MIN) y = INT16_MIN;
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = static_cast<int32_t>(y);
+        out[i] = static_cast<int16_t>(y);
+    }
+
+    state->x[0] = static_cast<int16_t>(x1);
+    state->x[1] = static_cast<int16_t>(x2);
+    state->y[0] = static_cast<int16_t>(y1);
+    state->y[1] = static_cast<int16_t>(y2);
+    state->error = static_cast<int32_t>(error);
+}
+
+const Mpu6050SampleBlock*
+    mpu6050_filter_run(Mpu6050FilterChain* chain, const Mpu6050SampleBlock* block, Mpu6050SampleBlock* out) {
+    if (!chain->stages) return block;
+    if (chain->accel_fsr != block->accel_fsr) {
+        mpu6050_filter_reset(chain);
+        chain->accel_fsr = block->accel_fsr;
+    }
+
+    uint32_t count = block->count;
+    for (int axis = 0; axis < MPU6050_FILTER_CHANNELS; axis++) {
+        const int16_t* in = block->acc[axis];
+        for (uint8_t stage = 0; stage < chain->stages; stage++) {
+            mpu6050_biquad_run(&chain->biquads[stage], &chain->state[stage][axis], in, out->acc[axis], count);
+            in = out->acc[axis];
+        }
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        memcpy(out->gyro[axis], block->gyro[axis], count * sizeof(int16_t));
+    }
+    memcpy(out->temp, block->temp, count * sizeof(int16_t));
+    memcpy(out->timestamp, block->timestamp, count * sizeof(uint32_t));
+    out->count = count;
+    out->accel_fsr = block->accel_fsr;
+    out->gyro_fsr = block->gyro_fsr;
+    return out;
+}
+
+void mpu6050_fir_init(Mpu6050Fir* fir, uint8_t decimation) {
+    if (decimation < 1) decimation = 1;
+    if (decimation > MPU6050_FIR_MAX_DECIMATION) decimation = MPU6050_FIR_MAX_DECIMATION;
+    fir->decimation = decimation;
+    fir->taps = decimation * MPU6050_FIR_TAPS_PER_PHASE;
+
+    // Windowed sinc cut at 0.4 of the output rate, scaled to unity gain at DC
+    double cutoff = 0.4 / decimation; // Of the input rate
+    double taps[MPU6050_FIR_MAX_TAPS];
+    double sum = 0.0;
+    double middle = (fir->taps - 1) / 2.0;
+    for (uint8_t k = 0; k < fir->taps; k++) {
+        double t = k - middle;
+        double phase = 2.0 * FILTER_PI * cutoff * t;
+        double sinc = 2.0 * cutoff * (t == 0.0 ? 1.0 : sin(phase) / phase);
+        double hamming = 0.54 - 0.46 * cos(2.0 * FILTER_PI * k / (fir->taps - 1));
+        taps[k] = sinc * hamming;
+        sum += taps[k];
+    }
+    for (uint8_t k = 0; k < fir->taps; k++) {
+        fir->coeffs[k] = static_cast<int16_t>(lrint(taps[k] / sum * 32768.0));
+    }
+    mpu6050_fir_reset(fir);
+}
+
+void mpu6050_fir_reset(Mpu6050Fir* fir) {
+    memset(fir->line, 0, sizeof(fir->line));
+    fir->phase = 0;
+}
+
+#if defined(__ARM_ARCH_7EM__)
+// Cortex-M4: SMLAD multiplies both halfwords of two words and adds both
+// products in one cycle; LDR takes the odd-aligned sample pairs as they come
+static inline int32_t fir_dot(const int16_t* samples, const int16_t* coeffs, uint32_t taps) {
+    int32_t acc = 0;
+    for (uint32_t k = 0; k < taps; k += 2) {
+        uint32_t pair;
+        uint32_t coeff_pair;
+        memcpy(&pair, &samples[k], sizeof(pair));
+        memcpy(&coeff_pair, &coeffs[k], sizeof(coeff_pair));
+        __asm__("smlad %0, %1, %2, %0" : "+r"(acc) : "r"(pair), "r"(coeff_pair));
+    }
+    return acc;
+}
+#else
+// Portable path: eight-tap multiply-add chunks (taps are a multiple of eight),
+// which GCC and Clang turn into vector multiply-adds on the host
+static inline int32_t fir_dot(const int16_t* samples, const int16_t* coeffs, uint32_t taps) {
+    int32_t lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (uint32_t k = 0; k < taps; k += 8) {
+        for (uint32_t j = 0; j < 8; j++) lanes[j] += samples[k + j] * coeffs[k + j];
+    }
+    int32_t acc = 0;
+    for (uint32_t j = 0; j < 8; j++) acc += lanes[j];
+    return acc;
+}
+#endif
+
+uint32_t mpu6050_fir_decimate(Mpu6050Fir* fir, const int16_t* in, uint32_t count, int16_t* out) {
+    if (fir->decimation == 1) {
+        memcpy(out, in, count * sizeof(int16_t));
+        return count;
+    }
+
+    // line[n .. n + taps) ends with in[n]
+    uint32_t history = fir->taps - 1;
+    memcpy(&fir->line[history], in, count * sizeof(int16_t));
+    uint32_t produced = 0;
+    uint32_t n = fir->phase;
+    for (; n < count; n += fir->decimation) {
+        int32_t acc = fir_dot(&fir->line[n], fir->coeffs, fir->taps) + (1 << 14);
+        acc >>= 15;
+        out[produced++] = static_cast<int16_t>(acc > INT16_MAX ? INT16_MAX : acc < INT16_MIN ? INT16_MIN : acc);
+    }
+    fir->phase = static_cast<uint8_t>(n - count);
+    memmove(fir->line, &fir->line[count], history * sizeof(int16_t));
+    return produced;
+}
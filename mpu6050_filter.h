@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_block.h"
+
+// Digital filters for the accelerometer rows of sample blocks.
+//
+// The chain is up to MPU6050_FILTER_MAX_STAGES biquads (second-order IIR
+// sections, RBJ cookbook designs) run over every sample at the full rate. Low-
+// and high-pass chains are Butterworth: each stage gets the Q of one pole pair,
+// so 1 to 4 stages give order 2 to 8. Band-pass and notch stages all share
+// MPU6050_FILTER_BAND_Q. Coefficients are Q30, fine enough for a 1 Hz corner at
+// 1 kHz, and the products add up in 64 bits (one SMLAL each on the Cortex-M4).
+// Samples stay int16 between stages; each stage carries its rounding error into
+// the next sample, so a quiet input does not leave the output stuck off zero.
+//
+// The decimating FIR (Hamming-windowed sinc, Q15 taps, cut at 0.4 of the output
+// rate) lowers the rate of one row by 2, 4 or 8 and only computes the samples
+// it keeps. Its dot products take two taps per SMLAD on the Cortex-M4 and are
+// plain loops the compiler vectorises on the host.
+
+#define MPU6050_FILTER_MAX_STAGES 4
+#define MPU6050_FILTER_CHANNELS 3     // Accel X, Y, Z
+#define MPU6050_FILTER_BAND_Q 2.0     // Band-pass and notch sharpness
+#define MPU6050_FILTER_COEFF_SHIFT 30 // Biquad coefficients are Q30
+
+#define MPU6050_FIR_MAX_DECIMATION 8
+#define MPU6050_FIR_TAPS_PER_PHASE 8 // Taps = decimation x this
+#define MPU6050_FIR_MAX_TAPS (MPU6050_FIR_MAX_DECIMATION * MPU6050_FIR_TAPS_PER_PHASE)
+
+typedef enum {
+    Mpu6050FilterType_Off,
+    Mpu6050FilterType_LowPass,
+    Mpu6050FilterType_HighPass,
+    Mpu6050FilterType_BandPass,
+    Mpu6050FilterType_Notch,
+    Mpu6050FilterType_Count
+} Mpu6050FilterType;
+
+typedef struct {
+    uint8_t type;       // Mpu6050FilterType
+    uint8_t stages;     // Biquads in the chain, 1..MPU6050_FILTER_MAX_STAGES
+    uint16_t corner_hz; // Cut-off, or centre for band-pass and notch
+} Mpu6050FilterConfig;
+
+// y = b0 x + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2], all Q30; a1 and a2
+// are stored negated so every term is a multiply-accumulate
+typedef struct {
+    int32_t b[3];
+    int32_t a[2];
+} Mpu6050Biquad;
+
+typedef struct {
+    int16_t x[2];  // x[n-1], x[n-2]
+    int16_t y[2];  // y[n-1], y[n-2]
+    int32_t error; // Bits below the output LSB, added to the next sample
+} Mpu6050BiquadState;
+
+typedef struct {
+    Mpu6050Biquad biquads[MPU6050_FILTER_MAX_STAGES];
+    Mpu6050BiquadState state[MPU6050_FILTER_MAX_STAGES][MPU6050_FILTER_CHANNELS];
+    uint8_t stages;    // 0 = samples pass through untouched
+    uint8_t accel_fsr; // FSR of the samples the state holds, 0xFF = none yet
+} Mpu6050FilterChain;
+
+typedef struct {
+    uint8_t decimation; // 1 = samples pass through untouched
+    uint8_t taps;
+    uint8_t phase;      // Index of the next kept sample in the next input
+    int16_t coeffs[MPU6050_FIR_MAX_TAPS]; // Q15
+    // The last taps - 1 inputs, then room for one block
+    int16_t line[MPU6050_FIR_MAX_TAPS - 1 + MPU6050_BLOCK_SIZE];
+} Mpu6050Fir;
+
+// Designs the chain for `sample_rate_hz`; corners at or above 0.45 of the rate
+// are pulled down to it
+void mpu6050_filter_init(Mpu6050FilterChain* chain, const Mpu6050FilterConfig* config, uint32_t sample_rate_hz);
+
+// Clears the history but keeps the design
+void mpu6050_filter_reset(Mpu6050FilterChain* chain);
+
+// Runs one biquad over `count` samples of one row with its state; `in` and
+// `out` may be the same row
+void mpu6050_biquad_run(
+    const Mpu6050Biquad* biquad,
+    Mpu6050BiquadState* state,
+    const int16_t* in,
+    int16_t* out,
+    uint32_t count);
+
+// Filters the accelerometer rows of `block` into `out` and copies the rest.
+// Returns `out`, or `block` itself when the chain is empty. An FSR change starts
+// the history over, since the counts changed scale.
+const Mpu6050SampleBlock*
+    mpu6050_filter_run(Mpu6050FilterChain* chain, const Mpu6050SampleBlock* block, Mpu6050SampleBlock* out);
+
+void mpu6050_fir_init(Mpu6050Fir* fir, uint8_t decimation);
+
+void mpu6050_fir_reset(Mpu6050Fir* fir);
+
+// Feeds `count` (at most MPU6050_BLOCK_SIZE) samples and writes every
+// decimation-th filtered one to `out`. Returns the samples written.
+uint32_t mpu6050_fir_decimate(Mpu6050Fir* fir, const int16_t* in, uint32_t count, int16_t* out);
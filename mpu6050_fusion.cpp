@@ -0,0 +1,164 @@
+#include "mpu6050_fusion.h"
+#include <math.h>
+
+#define FUSION_PI 3.14159265f
+#define FUSION_DEG_PER_RAD (180.0f / FUSION_PI)
+
+// Gyro counts to rad/s at each FSR
+static const float fusion_gyro_rad_per_count[Mpu6050GyroFsr_Count] = {
+    FUSION_PI / 180.0f * 10.0f / mpu6050_gyro_lsb_per_dps_x10[Mpu6050GyroFsr_250],
+    FUSION_PI / 180.0f * 10.0f / mpu6050_gyro_lsb_per_dps_x10[Mpu6050GyroFsr_500],
+    FUSION_PI / 180.0f * 10.0f / mpu6050_gyro_lsb_per_dps_x10[Mpu6050GyroFsr_1000],
+    FUSION_PI / 180.0f * 10.0f / mpu6050_gyro_lsb_per_dps_x10[Mpu6050GyroFsr_2000],
+};
+
+static inline void fusion_normalize(float q[4]) {
+    float norm = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    q[0] *= norm;
+    q[1] *= norm;
+    q[2] *= norm;
+    q[3] *= norm;
+}
+
+// Roll and pitch from gravity alone, yaw zero
+static void fusion_align(Mpu6050Fusion* fusion, float ax, float ay, float az) {
+    float half_roll = 0.5f * atan2f(ay, az);
+    float half_pitch = 0.5f * atan2f(-ax, sqrtf(ay * ay + az * az));
+    float cr = cosf(half_roll);
+    float sr = sinf(half_roll);
+    float cp = cosf(half_pitch);
+    float sp = sinf(half_pitch);
+    fusion->q[0] = cr * cp;
+    fusion->q[1] = sr * cp;
+    fusion->q[2] = cr * sp;
+    fusion->q[3] = -sr * sp;
+    fusion->aligned = true;
+}
+
+// q += dt * (q * (0, g) / 2 - correction)
+static inline void fusion_integrate(float q[4], float gx, float gy, float gz, const float s[4], float dt) {
+    float half_dt = 0.5f * dt;
+    float q0 = q[0];
+    float q1 = q[1];
+    float q2 = q[2];
+    float q3 = q[3];
+    q[0] += (-q1 * gx - q2 * gy - q3 * gz) * half_dt - s[0] * dt;
+    q[1] += (q0 * gx + q2 * gz - q3 * gy) * half_dt - s[1] * dt;
+    q[2] += (q0 * gy - q1 * gz + q3 * gx) * half_dt - s[2] * dt;
+    q[3] += (q0 * gz + q1 * gy - q2 * gx) * half_dt - s[3] * dt;
+    fusion_normalize(q);
+}
+
+static void fusion_complementary(float q[4], float ax, float ay, float az, float gx, float gy, float gz, float dt) {
+    float norm_sq = ax * ax + ay * ay + az * az;
+    if (norm_sq > 0.0f) {
+        float norm = 1.0f / sqrtf(norm_sq);
+        ax *= norm;
+        ay *= norm;
+        az *= norm;
+        // Gravity where the estimate expects it
+        float vx = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+        float vy = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+        float vz = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+        // Rotating the estimate about measured x estimated brings them together
+        gx += MPU6050_FUSION_COMPLEMENTARY_GAIN * (ay * vz - az * vy);
+        gy += MPU6050_FUSION_COMPLEMENTARY_GAIN * (az * vx - ax * vz);
+        gz += MPU6050_FUSION_COMPLEMENTARY_GAIN * (ax * vy - ay * vx);
+    }
+    static const float none[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    fusion_integrate(q, gx, gy, gz, none, dt);
+}
+
+static void fusion_madgwick(float q[4], float ax, float ay, float az, float gx, float gy, float gz, float dt) {
+    float s[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float norm_sq = ax * ax + ay * ay + az * az;
+    if (norm_sq > 0.0f) {
+        float norm = 1.0f / sqrtf(norm_sq);
+        ax *= norm;
+        ay *= norm;
+        az *= norm;
+        float q0 = q[0];
+        float q1 = q[1];
+        float q2 = q[2];
+        float q3 = q[3];
+        // Gradient of |estimated gravity - measured|^2 with respect to q
+        float f1 = 2.0f * (q1 * q3 - q0 * q2) - ax;
+        float f2 = 2.0f * (q0 * q1 + q2 * q3) - ay;
+        float f3 = 1.0f - 2.0f * (q1 * q1 + q2 * q2) - az;
+        s[0] = -2.0f * q2 * f1 + 2.0f * q1 * f2;
+        s[1] = 2.0f * q3 * f1 + 2.0f * q0 * f2 - 4.0f * q1 * f3;
+        s[2] = -2.0f * q0 * f1 + 2.0f * q3 * f2 - 4.0f * q2 * f3;
+        s[3] = 2.0f * q1 * f1 + 2.0f * q2 * f2;
+        float step_sq = s[0] * s[0] + s[1] * s[1] + s[2] * s[2] + s[3] * s[3];
+        if (step_sq > 0.0f) {
+            float step = MPU6050_FUSION_MADGWICK_BETA / sqrtf(step_sq);
+            s[0] *= step;
+            s[1] *= step;
+            s[2] *= step;
+            s[3] *= step;
+        }
+    }
+    fusion_integrate(q, gx, gy, gz, s, dt);
+}
+
+void mpu6050_fusion_init(Mpu6050Fusion* fusion, Mpu6050FusionFilter filter, uint16_t sample_rate_hz) {
+    fusion->filter = filter;
+    fusion->dt = 1.0f / sample_rate_hz;
+    fusion->q[0] = 1.0f;
+    fusion->q[1] = 0.0f;
+    fusion->q[2] = 0.0f;
+    fusion->q[3] = 0.0f;
+    fusion->aligned = false;
+    fusion->updates = 0;
+}
+
+void mpu6050_fusion_push(Mpu6050Fusion* fusion, const Mpu6050SampleBlock* block) {
+    if (!block->count) return;
+    // Accelerometer scale cancels out in the normalisation, so it stays in counts
+    float gyro_scale = fusion_gyro_rad_per_count[block->gyro_fsr & 0x03];
+    uint32_t i = 0;
+    if (!fusion->aligned) {
+        fusion_align(fusion, block->acc[0][0], block->acc[1][0], block->acc[2][0]);
+        i = 1;
+    }
+
+    float* q = fusion->q;
+    float dt = fusion->dt;
+    if (fusion->filter == Mpu6050FusionFilter_Madgwick) {
+        for (; i < block->count; i++) {
+            fusion_madgwick(
+                q,
+                block->acc[0][i],
+                block->acc[1][i],
+                block->acc[2][i],
+                block->gyro[0][i] * gyro_scale,
+                block->gyro[1][i] * gyro_scale,
+                block->gyro[2][i] * gyro_scale,
+                dt);
+        }
+    } else {
+        for (; i < block->count; i++) {
+            fusion_complementary(
+                q,
+                block->acc[0][i],
+                block->acc[1][i],
+                block->acc[2][i],
+                block->gyro[0][i] * gyro_scale,
+                block->gyro[1][i] * gyro_scale,
+                block->gyro[2][i] * gyro_scale,
+                dt);
+        }
+    }
+    fusion->updates += block->count;
+}
+
+void mpu6050_fusion_euler(const Mpu6050Fusion* fusion, Mpu6050Euler* euler) {
+    const float* q = fusion->q;
+    float roll = atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]), 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]));
+    float sin_pitch = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+    float pitch = asinf(sin_pitch > 1.0f ? 1.0f : sin_pitch < -1.0f ? -1.0f : sin_pitch);
+    float yaw = atan2f(2.0f * (q[0] * q[3] + q[1] * q[2]), 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]));
+    euler->roll = static_cast<int32_t>(lrintf(roll * FUSION_DEG_PER_RAD * 1000.0f));
+    euler->pitch = static_cast<int32_t>(lrintf(pitch * FUSION_DEG_PER_RAD * 1000.0f));
+    euler->yaw = static_cast<int32_t>(lrintf(yaw * FUSION_DEG_PER_RAD * 1000.0f));
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_block.h"
+#include "mpu6050_units.h"
+
+// Orientation from the accelerometer and the gyro, updated on every sample.
+//
+// The orientation is a unit quaternion, integrated from the gyro and pulled
+// towards the tilt the accelerometer sees as gravity, in single precision (the
+// Cortex-M4 has an FPU; nothing here allocates). Two filters share that:
+//
+// - Complementary: the correction is the cross product of the measured and the
+//   estimated gravity direction, times a fixed gain, added to the gyro rate.
+// - Madgwick: one gradient-descent step per sample on the same error, scaled by
+//   beta, subtracted from the quaternion's rate of change.
+//
+// Gravity fixes roll and pitch only: without a magnetometer, yaw is the
+// integrated gyro and drifts. The first sample sets roll and pitch from the
+// accelerometer alone and yaw to zero, so the estimate needs no settling time.
+
+#define MPU6050_FUSION_COMPLEMENTARY_GAIN 1.0f // rad/s of correction per unit of error
+#define MPU6050_FUSION_MADGWICK_BETA 0.1f
+
+typedef enum {
+    Mpu6050FusionFilter_Complementary,
+    Mpu6050FusionFilter_Madgwick,
+    Mpu6050FusionFilter_Count
+} Mpu6050FusionFilter;
+
+typedef struct {
+    uint8_t filter; // Mpu6050FusionFilter
+    float dt;       // Sample period, s
+    float q[4];     // w, x, y, z: sensor frame relative to the earth frame
+    bool aligned;   // q holds an estimate
+    uint32_t updates;
+} Mpu6050Fusion;
+
+// Roll, pitch and yaw (Z-Y-X), in milli-degrees
+typedef struct {
+    int32_t roll;
+    int32_t pitch;
+    int32_t yaw;
+} Mpu6050Euler;
+
+void mpu6050_fusion_init(Mpu6050Fusion* fusion, Mpu6050FusionFilter filter, uint16_t sample_rate_hz);
+
+// Runs the filter over every sample of `block`
+void mpu6050_fusion_push(Mpu6050Fusion* fusion, const Mpu6050SampleBlock* block);
+
+void mpu6050_fusion_euler(const Mpu6050Fusion* fusion, Mpu6050Euler* euler);
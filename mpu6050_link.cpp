@@ -0,0 +1,99 @@
+#include "mpu6050_link.h"
+
+void mpu6050_link_init(Mpu6050Link* link, uint32_t backoff_max_ms, uint32_t now_ms) {
+    link->backoff_max_ms = backoff_max_ms;
+    link->retry_at_ms = now_ms;
+    link->backoff_ms = MPU6050_LINK_BACKOFF_MIN_MS;
+    link->reset_at_ms = 0;
+    link->lost_at_ms = 0;
+    link->recovering = false;
+    link->failures_in_a_row = 0;
+    link->state = Mpu6050LinkState_Down;
+    link->attempts = 0;
+    link->failures = 0;
+    link->losses = 0;
+    link->recoveries = 0;
+    link->recover_ms_last = 0;
+    link->recover_ms_max = 0;
+    link->bus_recoveries = 0;
+}
+
+bool mpu6050_link_due(const Mpu6050Link* link, uint32_t now_ms) {
+    // Signed difference, so the tick counter may wrap
+    return link->state.load(std::memory_order_relaxed) == Mpu6050LinkState_Down &&
+           static_cast<int32_t>(now_ms - link->retry_at_ms) >= 0;
+}
+
+void mpu6050_link_resetting(Mpu6050Link* link, uint32_t now_ms) {
+    link->attempts.fetch_add(1, std::memory_order_relaxed);
+    link->reset_at_ms = now_ms;
+    link->state.store(Mpu6050LinkState_Resetting, std::memory_order_relaxed);
+}
+
+void mpu6050_link_resumed(Mpu6050Link* link, uint32_t now_ms) {
+    link->attempts.fetch_add(1, std::memory_order_relaxed);
+    mpu6050_link_up(link, now_ms);
+}
+
+bool mpu6050_link_reset_expired(const Mpu6050Link* link, uint32_t now_ms, uint32_t timeout_ms) {
+    return now_ms - link->reset_at_ms > timeout_ms;
+}
+
+void mpu6050_link_up(Mpu6050Link* link, uint32_t now_ms) {
+    link->failures_in_a_row = 0;
+    link->backoff_ms = MPU6050_LINK_BACKOFF_MIN_MS;
+    if (link->recovering) {
+        uint32_t took = now_ms - link->lost_at_ms;
+        link->recovering = false;
+        link->recoveries.fetch_add(1, std::memory_order_relaxed);
+        link->recover_ms_last.store(took, std::memory_order_relaxed);
+        if (took > link->recover_ms_max.load(std::memory_order_relaxed)) {
+            link->recover_ms_max.store(took, std::memory_order_relaxed);
+        }
+    }
+    link->state.store(Mpu6050LinkState_Up, std::memory_order_relaxed);
+}
+
+bool mpu6050_link_failed(Mpu6050Link* link, uint32_t now_ms) {
+    // An attempt that failed before the reset was never counted as started
+    if (link->state.load(std::memory_order_relaxed) == Mpu6050LinkState_Down) {
+        link->attempts.fetch_add(1, std::memory_order_relaxed);
+    }
+    link->failures.fetch_add(1, std::memory_order_relaxed);
+    link->state.store(Mpu6050LinkState_Down, std::memory_order_relaxed);
+    link->retry_at_ms = now_ms + link->backoff_ms;
+    link->backoff_ms = link->backoff_ms * 2 < link->backoff_max_ms ? link->backoff_ms * 2 : link->backoff_max_ms;
+
+    link->failures_in_a_row++;
+    bool recover = link->failures_in_a_row % MPU6050_LINK_RECOVERY_FAILURES == 0;
+    if (recover) link->bus_recoveries.fetch_add(1, std::memory_order_relaxed);
+    return recover;
+}
+
+void mpu6050_link_lost(Mpu6050Link* link, uint32_t now_ms) {
+    link->losses.fetch_add(1, std::memory_order_relaxed);
+    if (!link->recovering) {
+        link->recovering = true;
+        link->lost_at_ms = now_ms;
+    }
+    mpu6050_link_restart(link, now_ms);
+    // The transfer that lost it was the first failure
+    link->failures_in_a_row = 1;
+}
+
+void mpu6050_link_restart(Mpu6050Link* link, uint32_t now_ms) {
+    link->retry_at_ms = now_ms;
+    link->backoff_ms = MPU6050_LINK_BACKOFF_MIN_MS;
+    link->failures_in_a_row = 0;
+    link->state.store(Mpu6050LinkState_Down, std::memory_order_relaxed);
+}
+
+void mpu6050_link_get_stats(const Mpu6050Link* link, Mpu6050LinkStats* stats) {
+    stats->attempts = link->attempts.load(std::memory_order_relaxed);
+    stats->failures = link->failures.load(std::memory_order_relaxed);
+    stats->losses = link->losses.load(std::memory_order_relaxed);
+    stats->recoveries = link->recoveries.load(std::memory_order_relaxed);
+    stats->recover_ms_last = link->recover_ms_last.load(std::memory_order_relaxed);
+    stats->recover_ms_max = link->recover_ms_max.load(std::memory_order_relaxed);
+    stats->bus_recoveries = link->bus_recoveries.load(std::memory_order_relaxed);
+}
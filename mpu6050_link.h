@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+
+// Sensor bring-up and fault recovery, one state machine per device.
+//
+// A sensor that is missing or has just failed is Down. Bring-up is split
+// around the chip's reset time so the sampler never sleeps on it: an attempt
+// reads WHO_AM_I and issues the reset (Down -> Resetting), and every later poll
+// checks whether the reset has finished and, once it has, configures the chip
+// and starts its FIFO (Resetting -> Up). The other sensors keep being polled
+// in between.
+//
+// Failed attempts back off exponentially, so an absent sensor costs little bus
+// time, but a sensor that was up and is lost is retried at once and from the
+// shortest backoff: a glitch or a loose cable is back in a few polls. Every
+// MPU6050_LINK_RECOVERY_FAILURES failures in a row the caller is asked to
+// recover the bus, in case a slave is holding SDA low.
+
+// Backoff after the first failed attempt; doubles up to the link's maximum
+#define MPU6050_LINK_BACKOFF_MIN_MS 10
+// Failed attempts in a row between bus recoveries
+#define MPU6050_LINK_RECOVERY_FAILURES 2
+
+typedef enum {
+    Mpu6050LinkState_Down,
+    Mpu6050LinkState_Resetting, // Reset issued, waiting for the chip
+    Mpu6050LinkState_Up,
+} Mpu6050LinkState;
+
+typedef struct {
+    uint32_t attempts;        // Bring-ups started, including ones that failed at once
+    uint32_t failures;        // Attempts that failed
+    uint32_t losses;          // Times a running sensor was lost
+    uint32_t recoveries;      // Times it came back
+    uint32_t recover_ms_last; // From the loss to the sensor being up again
+    uint32_t recover_ms_max;
+    uint32_t bus_recoveries;  // Bus recoveries this link asked for
+} Mpu6050LinkStats;
+
+typedef struct {
+    uint32_t backoff_max_ms;
+
+    // Sampler only
+    uint32_t retry_at_ms;  // Down: next attempt
+    uint32_t backoff_ms;   // Wait after the next failed attempt
+    uint32_t reset_at_ms;  // Resetting: when the reset was issued
+    uint32_t lost_at_ms;   // When a running sensor was lost
+    bool recovering;       // Lost and not up again yet
+    uint32_t failures_in_a_row;
+
+    // Written by the sampler, read by the GUI
+    std::atomic<uint8_t> state; // Mpu6050LinkState
+    std::atomic<uint32_t> attempts;
+    std::atomic<uint32_t> failures;
+    std::atomic<uint32_t> losses;
+    std::atomic<uint32_t> recoveries;
+    std::atomic<uint32_t> recover_ms_last;
+    std::atomic<uint32_t> recover_ms_max;
+    std::atomic<uint32_t> bus_recoveries;
+} Mpu6050Link;
+
+// Down, with the first attempt due at `now_ms`
+void mpu6050_link_init(Mpu6050Link* link, uint32_t backoff_max_ms, uint32_t now_ms);
+
+// Down and its backoff has run out
+bool mpu6050_link_due(const Mpu6050Link* link, uint32_t now_ms);
+
+// An attempt identified the chip and reset it
+void mpu6050_link_resetting(Mpu6050Link* link, uint32_t now_ms);
+
+// An attempt took over a chip that was still running as configured, without a
+// reset; it is up at once
+void mpu6050_link_resumed(Mpu6050Link* link, uint32_t now_ms);
+
+// Resetting for longer than `timeout_ms`
+bool mpu6050_link_reset_expired(const Mpu6050Link* link, uint32_t now_ms, uint32_t timeout_ms);
+
+// The chip is configured and sampling
+void mpu6050_link_up(Mpu6050Link* link, uint32_t now_ms);
+
+// An attempt failed; backs off. Returns true when the bus should be recovered
+// before the next one.
+bool mpu6050_link_failed(Mpu6050Link* link, uint32_t now_ms);
+
+// A running sensor stopped answering; it is retried at once
+void mpu6050_link_lost(Mpu6050Link* link, uint32_t now_ms);
+
+// Starts over at once, e.g. for a new address, without counting a fault
+void mpu6050_link_restart(Mpu6050Link* link, uint32_t now_ms);
+
+static inline bool mpu6050_link_is_up(const Mpu6050Link* link) {
+    return link->state.load(std::memory_order_relaxed) == Mpu6050LinkState_Up;
+}
+
+// Any thread
+void mpu6050_link_get_stats(const Mpu6050Link* link, Mpu6050LinkStats* stats);
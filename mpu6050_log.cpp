@@ -0,0 +1,90 @@
+#include "mpu6050_log.h"
+#include <string.h>
+
+// Channel order of the payload: acc X/Y/Z, gyro X/Y/Z, temp
+static inline const int16_t* block_channel(const Mpu6050SampleBlock* block, int channel) {
+    if (channel < 3) return block->acc[channel];
+    if (channel < 6) return block->gyro[channel - 3];
+    return block->temp;
+}
+
+static inline int16_t* block_channel(Mpu6050SampleBlock* block, int channel) {
+    return const_cast<int16_t*>(block_channel(static_cast<const Mpu6050SampleBlock*>(block), channel));
+}
+
+void mpu6050_log_header_init(Mpu6050LogHeader* header, const Mpu6050Config& config, uint32_t start_tick) {
+    memset(header, 0, sizeof(*header));
+    header->magic = MPU6050_LOG_MAGIC;
+    header->version = MPU6050_LOG_VERSION;
+    header->address = config.address;
+    header->accel_fsr = config.accel_fsr;
+    header->gyro_fsr = config.gyro_fsr;
+    header->dlpf = config.dlpf;
+    header->sample_rate_div = config.sample_rate_div;
+    header->sample_rate_hz = static_cast<uint16_t>(config.sample_rate_hz());
+    header->start_tick = start_tick;
+}
+
+bool mpu6050_log_header_valid(const Mpu6050LogHeader* header) {
+    return header->magic == MPU6050_LOG_MAGIC && header->version == MPU6050_LOG_VERSION &&
+           header->accel_fsr < Mpu6050AccelFsr_Count && header->gyro_fsr < Mpu6050GyroFsr_Count;
+}
+
+size_t mpu6050_log_encode_chunk(const Mpu6050SampleBlock* block, uint32_t sequence, uint8_t* out) {
+    uint32_t count = block->count;
+    uint8_t* cursor = out + sizeof(Mpu6050LogChunkHeader);
+
+    for (int channel = 0; channel < MPU6050_LOG_CHANNELS; channel++) {
+        const int16_t* row = block_channel(block, channel);
+        int32_t previous = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            cursor = put_varint(cursor, zigzag_encode(row[i] - previous));
+            previous = row[i];
+        }
+    }
+
+    Mpu6050LogChunkHeader header;
+    header.sync = MPU6050_LOG_SYNC;
+    header.sequence = sequence;
+    header.timestamp_us = count ? block->timestamp[0] : 0;
+    header.period_us = count > 1 ? (block->timestamp[count - 1] - block->timestamp[0]) / (count - 1) : 0;
+    header.payload_size = static_cast<uint16_t>(cursor - out - sizeof(header));
+    header.count = static_cast<uint8_t>(count);
+    header.fsr = static_cast<uint8_t>((block->accel_fsr << 4) | block->gyro_fsr);
+    memcpy(out, &header, sizeof(header));
+    return cursor - out;
+}
+
+size_t mpu6050_log_decode_chunk(
+    const uint8_t* data,
+    size_t size,
+    Mpu6050LogChunkHeader* header,
+    Mpu6050SampleBlock* block) {
+    if (size < sizeof(*header)) return 0;
+    memcpy(header, data, sizeof(*header));
+    if (header->sync != MPU6050_LOG_SYNC || header->count > MPU6050_BLOCK_SIZE) return 0;
+    if (size - sizeof(*header) < header->payload_size) return 0;
+
+    const uint8_t* cursor = data + sizeof(*header);
+    const uint8_t* end = cursor + header->payload_size;
+    for (int channel = 0; channel < MPU6050_LOG_CHANNELS; channel++) {
+        int16_t* row = block_channel(block, channel);
+        int32_t previous = 0;
+        for (uint32_t i = 0; i < header->count; i++) {
+            uint32_t value;
+            cursor = get_varint(cursor, end, &value);
+            if (!cursor) return 0;
+            previous += zigzag_decode(value);
+            row[i] = static_cast<int16_t>(previous);
+        }
+    }
+    if (cursor != end) return 0;
+
+    for (uint32_t i = 0; i < header->count; i++) {
+        block->timestamp[i] = header->timestamp_us + i * header->period_us;
+    }
+    block->count = header->count;
+    block->accel_fsr = header->fsr >> 4;
+    block->gyro_fsr = header->fsr & 0x0F;
+    return sizeof(*header) + header->payload_size;
+}
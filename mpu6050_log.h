@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "mpu6050.h"
+#include "mpu6050_block.h"
+#include "mpu6050_varint.h"
+
+// Binary recording format. A file is one Mpu6050LogHeader followed by chunks;
+// every chunk starts with a sync marker and the timestamp of its first sample,
+// so a reader can pick up again after a damaged or missing chunk. All fields are
+// little-endian (both the STM32 and the host are).
+//
+// Chunk payload: the seven channels one after another (acc X/Y/Z, gyro X/Y/Z,
+// temp), each as `count` zigzag varints of the difference to the previous
+// sample of the same channel (the first one relative to zero). Slowly changing
+// signals take one or two bytes per value instead of two fixed ones.
+
+#define MPU6050_LOG_MAGIC 0x4C55504DU // "MPUL"
+#define MPU6050_LOG_VERSION 1
+#define MPU6050_LOG_SYNC 0xA5C35A3CU
+#define MPU6050_LOG_CHANNELS 7
+
+// A delta of an int16 channel fits in 17 bits, i.e. three varint bytes
+#define MPU6050_LOG_VARINT_MAX MPU6050_VARINT_MAX
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;         // MPU6050_LOG_MAGIC
+    uint8_t version;        // MPU6050_LOG_VERSION
+    uint8_t address;        // I2C address of the recorded sensor
+    uint8_t accel_fsr;      // Mpu6050AccelFsr at the start of the recording
+    uint8_t gyro_fsr;       // Mpu6050GyroFsr at the start of the recording
+    uint8_t dlpf;           // CONFIG.DLPF_CFG
+    uint8_t sample_rate_div; // SMPLRT_DIV
+    uint16_t sample_rate_hz;
+    uint32_t start_tick;    // furi_get_tick() when recording started
+} Mpu6050LogHeader;
+
+typedef struct __attribute__((packed)) {
+    uint32_t sync;          // MPU6050_LOG_SYNC
+    uint32_t sequence;      // Chunk number; a gap means chunks were dropped
+    uint32_t timestamp_us;  // First sample
+    uint32_t period_us;     // Spacing of the following samples, up to 256 ms at the lowest rate
+    uint16_t payload_size;  // Bytes after this header
+    uint8_t count;          // Samples in the chunk
+    uint8_t fsr;            // accel_fsr << 4 | gyro_fsr
+} Mpu6050LogChunkHeader;
+
+// Largest chunk `count` samples can produce
+#define MPU6050_LOG_CHUNK_BOUND(count) \
+    (sizeof(Mpu6050LogChunkHeader) + MPU6050_LOG_CHANNELS * (count) * MPU6050_LOG_VARINT_MAX)
+#define MPU6050_LOG_CHUNK_MAX MPU6050_LOG_CHUNK_BOUND(MPU6050_BLOCK_SIZE)
+
+void mpu6050_log_header_init(Mpu6050LogHeader* header, const Mpu6050Config& config, uint32_t start_tick);
+bool mpu6050_log_header_valid(const Mpu6050LogHeader* header);
+
+// Encodes `block` as chunk `sequence` into `out` (at least MPU6050_LOG_CHUNK_MAX
+// bytes) and returns the bytes written
+size_t mpu6050_log_encode_chunk(const Mpu6050SampleBlock* block, uint32_t sequence, uint8_t* out);
+
+// Decodes the chunk at `data`. Returns the bytes consumed, or 0 when `data` does
+// not start with a complete, well-formed chunk.
+size_t mpu6050_log_decode_chunk(
+    const uint8_t* data,
+    size_t size,
+    Mpu6050LogChunkHeader* header,
+    Mpu6050SampleBlock* block);
@@ -0,0 +1,148 @@
+#include "mpu6050_logger.h"
+
+// Writer thread flags
+#define MPU6050_LOGGER_FLAG_WRITE (1 << 0)
+#define MPU6050_LOGGER_FLAG_STOP (1 << 1)
+
+// Writer thread: writes whatever buffer the producer handed over
+static void logger_write_pending(Mpu6050Logger* logger) {
+    uint32_t size = logger->pending_size.load(std::memory_order_acquire);
+    if (!size) return;
+
+    if (logger->open_failed.load(std::memory_order_relaxed)) {
+        logger->pending_size.store(0, std::memory_order_release);
+        return;
+    }
+
+    // While a buffer is pending the producer only touches the other one
+    const uint8_t* buffer = logger->buffers[logger->active ^ 1];
+    uint32_t start = furi_get_tick();
+    size_t written = storage_file_write(logger->file, buffer, size);
+    uint32_t took = furi_get_tick() - start;
+
+    if (written != size) logger->write_errors.fetch_add(1, std::memory_order_relaxed);
+    logger->bytes.fetch_add(static_cast<uint32_t>(written), std::memory_order_relaxed);
+    if (took > logger->max_write_ms.load(std::memory_order_relaxed)) {
+        logger->max_write_ms.store(took, std::memory_order_relaxed);
+    }
+    logger->pending_size.store(0, std::memory_order_release);
+}
+
+// Writer thread: creates the first free log_NNN.bin. Probing up to
+// MPU6050_LOG_MAX_FILES names may take a while on a full card, so the producer
+// never does it.
+static bool logger_open(Mpu6050Logger* logger) {
+    storage_simply_mkdir(logger->storage, MPU6050_LOG_DIR);
+
+    bool named = false;
+    for (uint32_t i = 0; i < MPU6050_LOG_MAX_FILES && !named; i++) {
+        snprintf(logger->path, sizeof(logger->path), MPU6050_LOG_DIR "/log_%03lu.bin", (unsigned long)i);
+        named = !storage_file_exists(logger->storage, logger->path);
+    }
+    return named && storage_file_open(logger->file, logger->path, FSAM_WRITE, FSOM_CREATE_NEW);
+}
+
+static int32_t mpu6050_logger_thread(void* context) {
+    Mpu6050Logger* logger = static_cast<Mpu6050Logger*>(context);
+    if (!logger_open(logger)) logger->open_failed.store(true, std::memory_order_relaxed);
+    while (true) {
+        uint32_t flags = furi_thread_flags_wait(
+            MPU6050_LOGGER_FLAG_WRITE | MPU6050_LOGGER_FLAG_STOP, FuriFlagWaitAny, FuriWaitForever);
+        logger_write_pending(logger);
+        if (flags & MPU6050_LOGGER_FLAG_STOP) break;
+    }
+    return 0;
+}
+
+// Producer: hands the active buffer to the writer if it is free
+static bool logger_submit(Mpu6050Logger* logger) {
+    if (logger->pending_size.load(std::memory_order_acquire)) return false;
+    if (!logger->fill) return true;
+    logger->active ^= 1;
+    logger->pending_size.store(logger->fill, std::memory_order_release);
+    logger->fill = 0;
+    furi_thread_flags_set(furi_thread_get_id(logger->thread), MPU6050_LOGGER_FLAG_WRITE);
+    return true;
+}
+
+void mpu6050_logger_start(Mpu6050Logger* logger, const Mpu6050Config& config) {
+    if (logger->recording) return;
+
+    logger->storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    logger->file = storage_file_alloc(logger->storage);
+    logger->open_failed = false;
+    logger->active = 0;
+    logger->sequence = 0;
+    logger->start_tick = furi_get_tick();
+    logger->pending_size = 0;
+    logger->bytes = 0;
+    logger->samples = 0;
+    logger->chunks_dropped = 0;
+    logger->samples_dropped = 0;
+    logger->write_errors = 0;
+    logger->max_write_ms = 0;
+
+    // The header goes out with the first buffer
+    Mpu6050LogHeader header;
+    mpu6050_log_header_init(&header, config, logger->start_tick);
+    memcpy(logger->buffers[0], &header, sizeof(header));
+    logger->fill = sizeof(header);
+
+    logger->thread =
+        furi_thread_alloc_ex("Mpu6050Logger", MPU6050_LOGGER_STACK_SIZE, mpu6050_logger_thread, logger);
+    furi_thread_start(logger->thread);
+    logger->recording = true;
+}
+
+void mpu6050_logger_write(Mpu6050Logger* logger, const Mpu6050SampleBlock* block) {
+    if (!logger->recording || !block->count) return;
+
+    uint32_t sequence = logger->sequence++;
+    size_t bound = MPU6050_LOG_CHUNK_BOUND(block->count);
+    if (MPU6050_LOG_BUFFER_SIZE - logger->fill < bound && !logger_submit(logger)) {
+        logger->chunks_dropped.fetch_add(1, std::memory_order_relaxed);
+        logger->samples_dropped.fetch_add(block->count, std::memory_order_relaxed);
+        return;
+    }
+
+    logger->fill += mpu6050_log_encode_chunk(block, sequence, &logger->buffers[logger->active][logger->fill]);
+    logger->samples.fetch_add(block->count, std::memory_order_relaxed);
+}
+
+void mpu6050_logger_stop(Mpu6050Logger* logger) {
+    if (!logger->recording) return;
+
+    // Wait for the writer to take the previous buffer, then hand over the rest
+    while (!logger_submit(logger)) {
+        furi_delay_ms(1);
+    }
+    furi_thread_flags_set(furi_thread_get_id(logger->thread), MPU6050_LOGGER_FLAG_STOP);
+    furi_thread_join(logger->thread);
+    furi_thread_free(logger->thread);
+    logger->thread = NULL;
+
+    if (!logger->open_failed) storage_file_close(logger->file);
+    storage_file_free(logger->file);
+    logger->file = NULL;
+    furi_record_close(RECORD_STORAGE);
+    logger->stop_tick = furi_get_tick();
+    logger->recording = false;
+}
+
+bool mpu6050_logger_is_recording(const Mpu6050Logger* logger) {
+    return logger->recording;
+}
+
+bool mpu6050_logger_failed(const Mpu6050Logger* logger) {
+    return logger->recording && logger->open_failed.load(std::memory_order_relaxed);
+}
+
+void mpu6050_logger_get_stats(const Mpu6050Logger* logger, Mpu6050LoggerStats* stats) {
+    stats->bytes = logger->bytes.load(std::memory_order_relaxed);
+    stats->samples = logger->samples.load(std::memory_order_relaxed);
+    stats->chunks_dropped = logger->chunks_dropped.load(std::memory_order_relaxed);
+    stats->samples_dropped = logger->samples_dropped.load(std::memory_order_relaxed);
+    stats->write_errors = logger->write_errors.load(std::memory_order_relaxed);
+    stats->max_write_ms = logger->max_write_ms.load(std::memory_order_relaxed);
+    stats->elapsed_ms = (logger->recording ? furi_get_tick() : logger->stop_tick.load()) - logger->start_tick;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <furi.h>
+#include <storage/storage.h>
+#include "mpu6050_log.h"
+
+// Recordings go to /ext/apps_data/mpu6050/log_NNN.bin
+#define MPU6050_LOG_DIR EXT_PATH("apps_data/mpu6050")
+#define MPU6050_LOG_MAX_FILES 1000
+
+// Each write buffer holds a few hundred milliseconds of 1 kHz data, which covers
+// typical SD card write stalls; storage sees large, whole-buffer writes only
+#define MPU6050_LOG_BUFFER_SIZE 4096
+#define MPU6050_LOGGER_STACK_SIZE 1024
+
+static_assert(MPU6050_LOG_BUFFER_SIZE >= 2 * MPU6050_LOG_CHUNK_MAX, "a buffer must hold at least two chunks");
+
+typedef struct {
+    uint32_t bytes;           // Bytes written to the file
+    uint32_t samples;         // Samples encoded into the file
+    uint32_t chunks_dropped;  // Chunks lost because both buffers were still busy
+    uint32_t samples_dropped;
+    uint32_t write_errors;
+    uint32_t max_write_ms;    // Slowest single storage write
+    uint32_t elapsed_ms;      // Length of the current or last recording
+} Mpu6050LoggerStats;
+
+// Double-buffered recorder. The producer encodes sample blocks into the active
+// buffer and, once it is full, hands it to the writer thread and switches to the
+// other one. The producer never waits for storage: if the writer still holds the
+// other buffer, the chunk is dropped and counted, and the sequence gap shows up
+// in the file. Finding a free file name and creating the file happen on the
+// writer thread as well.
+typedef struct {
+    Storage* storage;
+    File* file;
+    FuriThread* thread;
+    char path[64];
+
+    uint8_t buffers[2][MPU6050_LOG_BUFFER_SIZE];
+    uint8_t active;          // Producer's buffer
+    uint32_t fill;           // Bytes used in the producer's buffer
+    uint32_t sequence;       // Next chunk number
+    uint32_t start_tick;
+    std::atomic<uint32_t> stop_tick;
+
+    std::atomic<uint32_t> pending_size; // Bytes of buffers[active ^ 1] queued for the writer
+    std::atomic<bool> recording;
+    std::atomic<bool> open_failed; // The writer could not create the file
+
+    std::atomic<uint32_t> bytes;
+    std::atomic<uint32_t> samples;
+    std::atomic<uint32_t> chunks_dropped;
+    std::atomic<uint32_t> samples_dropped;
+    std::atomic<uint32_t> write_errors;
+    std::atomic<uint32_t> max_write_ms;
+} Mpu6050Logger;
+
+// Starts the writer thread, which creates the next free log file; the header
+// goes out with the first buffer. Never blocks on storage.
+void mpu6050_logger_start(Mpu6050Logger* logger, const Mpu6050Config& config);
+
+// Producer: appends a block; never blocks on storage
+void mpu6050_logger_write(Mpu6050Logger* logger, const Mpu6050SampleBlock* block);
+
+// Producer: writes out what is buffered, stops the writer and closes the file
+void mpu6050_logger_stop(Mpu6050Logger* logger);
+
+bool mpu6050_logger_is_recording(const Mpu6050Logger* logger);
+
+// True while recording when the writer found no free name or could not create
+// the file; what was recorded is discarded until mpu6050_logger_stop()
+bool mpu6050_logger_failed(const Mpu6050Logger* logger);
+void mpu6050_logger_get_stats(const Mpu6050Logger* logger, Mpu6050LoggerStats* stats);
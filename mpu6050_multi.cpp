@@ -0,0 +1,102 @@
+#include "mpu6050_multi.h"
+#include <furi_hal.h>
+#include "mpu6050_units.h"
+
+static uint32_t multi_elapsed_us(uint32_t begin) {
+    return (DWT->CYCCNT - begin) / furi_hal_cortex_instructions_per_microsecond();
+}
+
+void mpu6050_multi_read(Mpu6050MultiDevice* devices, size_t count) {
+    size_t pending[MPU6050_MAX_DEVICES] = {};
+    if (count > MPU6050_MAX_DEVICES) count = MPU6050_MAX_DEVICES;
+
+    // 1. Every device's FIFO_COUNT first, so all are read against the same moment
+    for (size_t i = 0; i < count; i++) {
+        Mpu6050MultiDevice* device = &devices[i];
+        device->frames_read = 0;
+        if (!device->fifo) continue;
+        uint32_t begin = DWT->CYCCNT;
+        device->status = mpu6050_fifo_begin(device->fifo, device->max_frames, &pending[i]);
+        device->busy_us += multi_elapsed_us(begin);
+    }
+
+    // 2. One burst per device in turn until every FIFO is drained
+    bool more = true;
+    while (more) {
+        more = false;
+        for (size_t i = 0; i < count; i++) {
+            Mpu6050MultiDevice* device = &devices[i];
+            if (!device->fifo || device->status != Mpu6050FifoStatus_Ok) continue;
+            size_t burst = pending[i] - device->frames_read;
+            if (!burst) continue;
+            if (burst > MPU6050_FIFO_BURST_FRAMES) burst = MPU6050_FIFO_BURST_FRAMES;
+
+            uint32_t begin = DWT->CYCCNT;
+            if (mpu6050_fifo_burst(
+                   device->fifo, device->frames + device->frames_read * MPU6050_FRAME_SIZE, burst)) {
+                device->frames_read += burst;
+                more |= device->frames_read < pending[i];
+            } else {
+                device->status = Mpu6050FifoStatus_BusError;
+            }
+            device->busy_us += multi_elapsed_us(begin);
+        }
+    }
+}
+
+void mpu6050_align_reset(Mpu6050AlignStream* stream) {
+    stream->count = 0;
+}
+
+void mpu6050_align_push(Mpu6050AlignStream* stream, const Mpu6050SampleBlock* block) {
+    // Older samples of a long block would be overwritten straight away
+    uint32_t first = block->count > MPU6050_ALIGN_HISTORY ? block->count - MPU6050_ALIGN_HISTORY : 0;
+    for (uint32_t i = first; i < block->count; i++) {
+        uint32_t slot = stream->count++ & (MPU6050_ALIGN_HISTORY - 1);
+        stream->timestamp[slot] = block->timestamp[i];
+        for (int axis = 0; axis < 3; axis++) {
+            stream->acc_mg[axis][slot] = mpu6050_accel_counts_to_mg(block->acc[axis][i], block->accel_fsr);
+        }
+    }
+}
+
+// Interpolates `stream` at `timestamp`; false if it lies outside the history
+static bool align_at(const Mpu6050AlignStream* stream, uint32_t timestamp, int32_t mg[3]) {
+    uint32_t held = stream->count < MPU6050_ALIGN_HISTORY ? stream->count : MPU6050_ALIGN_HISTORY;
+    // Newest first: find the sample at or before `timestamp` (times wrap, so compare differences)
+    for (uint32_t age = 0; age < held; age++) {
+        uint32_t slot = (stream->count - 1 - age) & (MPU6050_ALIGN_HISTORY - 1);
+        int32_t before = static_cast<int32_t>(timestamp - stream->timestamp[slot]);
+        if (before < 0) continue;
+
+        if (age == 0 || before == 0) {
+            for (int axis = 0; axis < 3; axis++) mg[axis] = stream->acc_mg[axis][slot];
+            return true;
+        }
+        uint32_t next = (slot + 1) & (MPU6050_ALIGN_HISTORY - 1);
+        int32_t span = static_cast<int32_t>(stream->timestamp[next] - stream->timestamp[slot]);
+        for (int axis = 0; axis < 3; axis++) {
+            int32_t from = stream->acc_mg[axis][slot];
+            int32_t to = stream->acc_mg[axis][next];
+            mg[axis] = span > 0 ? from + static_cast<int32_t>(static_cast<int64_t>(to - from) * before / span) : from;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool mpu6050_align_sample(
+    const Mpu6050AlignStream* a,
+    const Mpu6050AlignStream* b,
+    int32_t a_mg[3],
+    int32_t b_mg[3],
+    uint32_t* timestamp) {
+    if (!a->count || !b->count) return false;
+    uint32_t newest_a = a->timestamp[(a->count - 1) & (MPU6050_ALIGN_HISTORY - 1)];
+    uint32_t newest_b = b->timestamp[(b->count - 1) & (MPU6050_ALIGN_HISTORY - 1)];
+    uint32_t common = static_cast<int32_t>(newest_a - newest_b) < 0 ? newest_a : newest_b;
+
+    if (!align_at(a, common, a_mg) || !align_at(b, common, b_mg)) return false;
+    *timestamp = common;
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_block.h"
+#include "mpu6050_fifo.h"
+
+// Several MPU-6050s on one bus.
+//
+// The two addresses (AD0 low / high) can share the external I2C bus. Instead of
+// draining one FIFO and then the other, a poll reads every FIFO_COUNT back to back
+// and then alternates bursts between the devices until all are drained. Transfers
+// follow each other with no gap, and both streams are read in the same short
+// window, so the newest frame of each was produced at nearly the same moment and
+// both can be stamped on one time base.
+
+#define MPU6050_MAX_DEVICES 2
+
+typedef struct {
+    Mpu6050Fifo* fifo; // Engine of a running device; NULL leaves the slot out
+    uint8_t* frames;   // Receives up to max_frames frames
+    size_t max_frames;
+
+    // Result of the last poll
+    Mpu6050FifoStatus status;
+    size_t frames_read;
+
+    uint32_t busy_us; // Time spent in this device's transfers, running total
+} Mpu6050MultiDevice;
+
+// One poll of every device with a FIFO engine
+void mpu6050_multi_read(Mpu6050MultiDevice* devices, size_t count);
+
+// Aligning two streams. Each side keeps its newest MPU6050_ALIGN_HISTORY
+// accelerometer samples in mg; the two are compared at the newest instant both
+// streams have reached, each interpolated linearly to that timestamp.
+
+#define MPU6050_ALIGN_HISTORY 32 // Power of two
+
+static_assert(
+    (MPU6050_ALIGN_HISTORY & (MPU6050_ALIGN_HISTORY - 1)) == 0, "alignment history must be a power of two");
+
+typedef struct {
+    uint32_t timestamp[MPU6050_ALIGN_HISTORY];
+    int32_t acc_mg[3][MPU6050_ALIGN_HISTORY];
+    uint32_t count; // Samples pushed so far
+} Mpu6050AlignStream;
+
+void mpu6050_align_reset(Mpu6050AlignStream* stream);
+
+// Keeps the tail of `block`
+void mpu6050_align_push(Mpu6050AlignStream* stream, const Mpu6050SampleBlock* block);
+
+// Both streams' acceleration at the newest common timestamp. False while either
+// stream is empty or their histories do not overlap.
+bool mpu6050_align_sample(
+    const Mpu6050AlignStream* a,
+    const Mpu6050AlignStream* b,
+    int32_t a_mg[3],
+    int32_t b_mg[3],
+    uint32_t* timestamp);
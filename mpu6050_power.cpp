@@ -0,0 +1,89 @@
+#include "mpu6050_power.h"
+#include "mpu6050_units.h"
+
+void mpu6050_power_init(Mpu6050Power* power, const Mpu6050PowerConfig* config, uint32_t now_ms) {
+    mpu6050_power_configure(power, config);
+    power->mode = Mpu6050PowerMode_Full;
+    power->mode_since_ms = now_ms;
+    for (int mode = 0; mode < Mpu6050PowerMode_Count; mode++) power->time_ms[mode] = 0;
+    power->wakeups = 0;
+    power->samples_captured = 0;
+    power->samples_skipped = 0;
+}
+
+void mpu6050_power_configure(Mpu6050Power* power, const Mpu6050PowerConfig* config) {
+    power->config = *config;
+    power->band_valid = false;
+}
+
+bool mpu6050_power_push(Mpu6050Power* power, const Mpu6050SampleBlock* block) {
+    if (!block->count) return false;
+    power->samples_captured.fetch_add(block->count, std::memory_order_relaxed);
+    if (!power->config.idle_ms) return false;
+
+    // Widen the band by this block; leaving it restarts the idle time here
+    int32_t band_counts =
+        static_cast<int32_t>(power->config.motion_mg / 2) * mpu6050_accel_lsb_per_g[block->accel_fsr & 0x03] / 1000;
+    bool moved = !power->band_valid || block->accel_fsr != power->band_fsr;
+    int16_t lo[3];
+    int16_t hi[3];
+    for (int axis = 0; axis < 3; axis++) {
+        mpu6050_row_range(block->acc[axis], block->count, &lo[axis], &hi[axis]);
+        if (moved) continue;
+        int32_t min = lo[axis] < power->band_min[axis] ? lo[axis] : power->band_min[axis];
+        int32_t max = hi[axis] > power->band_max[axis] ? hi[axis] : power->band_max[axis];
+        if (max - min > band_counts) moved = true;
+    }
+    if (moved) {
+        power->band_valid = true;
+        power->band_fsr = block->accel_fsr;
+        power->still_since_us = block->timestamp[0];
+        for (int axis = 0; axis < 3; axis++) {
+            power->band_min[axis] = lo[axis];
+            power->band_max[axis] = hi[axis];
+        }
+        return false;
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        if (lo[axis] < power->band_min[axis]) power->band_min[axis] = lo[axis];
+        if (hi[axis] > power->band_max[axis]) power->band_max[axis] = hi[axis];
+    }
+    uint32_t still_us = block->timestamp[block->count - 1] - power->still_since_us;
+    return still_us / 1000 >= power->config.idle_ms;
+}
+
+// Closes the current period and starts one in `mode`
+static uint32_t power_switch(Mpu6050Power* power, uint8_t mode, uint32_t now_ms) {
+    uint8_t previous = power->mode.load(std::memory_order_relaxed);
+    uint32_t elapsed = now_ms - power->mode_since_ms.load(std::memory_order_relaxed);
+    power->time_ms[previous].fetch_add(elapsed, std::memory_order_relaxed);
+    power->mode_since_ms.store(now_ms, std::memory_order_relaxed);
+    power->mode.store(mode, std::memory_order_relaxed);
+    return elapsed;
+}
+
+void mpu6050_power_sleep(Mpu6050Power* power, uint32_t now_ms) {
+    if (mpu6050_power_is_idle(power)) return;
+    power_switch(power, Mpu6050PowerMode_Idle, now_ms);
+}
+
+void mpu6050_power_wake(Mpu6050Power* power, uint32_t now_ms, uint32_t sample_rate_hz) {
+    if (!mpu6050_power_is_idle(power)) return;
+    uint32_t idle_ms = power_switch(power, Mpu6050PowerMode_Full, now_ms);
+    power->wakeups.fetch_add(1, std::memory_order_relaxed);
+    power->samples_skipped.fetch_add(
+        static_cast<uint32_t>(static_cast<uint64_t>(idle_ms) * sample_rate_hz / 1000), std::memory_order_relaxed);
+    // The idle time starts over at full rate
+    power->band_valid = false;
+}
+
+void mpu6050_power_get_stats(const Mpu6050Power* power, uint32_t now_ms, Mpu6050PowerStats* stats) {
+    stats->mode = power->mode.load(std::memory_order_relaxed);
+    for (int mode = 0; mode < Mpu6050PowerMode_Count; mode++) {
+        stats->time_ms[mode] = power->time_ms[mode].load(std::memory_order_relaxed);
+    }
+    stats->time_ms[stats->mode] += now_ms - power->mode_since_ms.load(std::memory_order_relaxed);
+    stats->wakeups = power->wakeups.load(std::memory_order_relaxed);
+    stats->samples_captured = power->samples_captured.load(std::memory_order_relaxed);
+    stats->samples_skipped = power->samples_skipped.load(std::memory_order_relaxed);
+}
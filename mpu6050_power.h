@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_block.h"
+
+// Adaptive acquisition: full-rate FIFO capture while something moves, the chip's
+// low-power motion wake while nothing does.
+//
+// At full rate every sample of the main sensor is checked against a band of
+// half the motion threshold around the accelerometer readings since the last
+// movement; once all three axes have stayed inside it for `idle_ms`, the sensors
+// drop to cycle mode with the motion interrupt armed at the full threshold. The
+// gap between the two thresholds, and the idle time that starts over on every
+// wake, keep a sensor at the edge from flapping between the modes. While idle
+// no samples are captured; the ones the full rate would have produced are
+// counted as skipped.
+
+typedef enum {
+    Mpu6050PowerMode_Full,
+    Mpu6050PowerMode_Idle, // Motion wake, no samples
+    Mpu6050PowerMode_Count
+} Mpu6050PowerMode;
+
+typedef struct {
+    uint32_t idle_ms;   // Still this long before going idle; 0 keeps the full rate
+    uint16_t motion_mg; // Wake threshold; stillness is staying within half of it
+} Mpu6050PowerConfig;
+
+typedef struct {
+    uint8_t mode; // Mpu6050PowerMode
+    uint32_t time_ms[Mpu6050PowerMode_Count];
+    uint32_t wakeups;
+    uint32_t samples_captured;
+    uint32_t samples_skipped;
+} Mpu6050PowerStats;
+
+typedef struct {
+    Mpu6050PowerConfig config;
+
+    // Accel band since the sensor last moved, in counts at `band_fsr`
+    bool band_valid;
+    uint8_t band_fsr;
+    int16_t band_min[3];
+    int16_t band_max[3];
+    uint32_t still_since_us;
+
+    // Written by the sampler, read by the GUI
+    std::atomic<uint8_t> mode;
+    std::atomic<uint32_t> mode_since_ms;
+    std::atomic<uint32_t> time_ms[Mpu6050PowerMode_Count]; // Closed periods
+    std::atomic<uint32_t> wakeups;
+    std::atomic<uint32_t> samples_captured;
+    std::atomic<uint32_t> samples_skipped;
+} Mpu6050Power;
+
+void mpu6050_power_init(Mpu6050Power* power, const Mpu6050PowerConfig* config, uint32_t now_ms);
+
+// New settings; stillness is measured again from the next sample
+void mpu6050_power_configure(Mpu6050Power* power, const Mpu6050PowerConfig* config);
+
+// Full rate: counts the main sensor's samples and tracks stillness; true when it
+// is time to go idle
+bool mpu6050_power_push(Mpu6050Power* power, const Mpu6050SampleBlock* block);
+
+// The sensors entered motion wake
+void mpu6050_power_sleep(Mpu6050Power* power, uint32_t now_ms);
+
+// The sensors are back at full rate, `sample_rate_hz`, after motion or a fault
+void mpu6050_power_wake(Mpu6050Power* power, uint32_t now_ms, uint32_t sample_rate_hz);
+
+static inline bool mpu6050_power_is_idle(const Mpu6050Power* power) {
+    return power->mode.load(std::memory_order_relaxed) == Mpu6050PowerMode_Idle;
+}
+
+// Any thread; the current period counts up to `now_ms`
+void mpu6050_power_get_stats(const Mpu6050Power* power, uint32_t now_ms, Mpu6050PowerStats* stats);
@@ -0,0 +1,216 @@
+#include "mpu6050_profile.h"
+#include <stdarg.h>
+#include <storage/storage.h>
+#include "mpu6050_logger.h"
+
+#ifdef MPU6050_PROFILE
+
+const char* const mpu6050_profile_stage_names[Mpu6050ProfileStage_Count] = {
+    "I2C", "Decode", "Filter", "Fusion", "Lock", "Process", "FFT", "Draw", "Smp dt", "Loop dt"};
+
+// Histogram bucket of a duration: exact below 4 us, then 4 per octave
+static uint32_t profile_bucket(uint32_t us) {
+    if (us < 4) return us;
+    uint32_t octave = 31 - __builtin_clz(us);
+    uint32_t bucket = (octave - 1) * 4 + ((us >> (octave - 2)) & 3);
+    return bucket < MPU6050_PROFILE_BUCKETS ? bucket : MPU6050_PROFILE_BUCKETS - 1;
+}
+
+// Largest duration that falls into `bucket`
+static uint32_t profile_bucket_top(uint32_t bucket) {
+    if (bucket < 4) return bucket;
+    uint32_t octave = bucket / 4 + 1;
+    return ((4 + bucket % 4 + 1) << (octave - 2)) - 1;
+}
+
+static void profile_clear(Mpu6050ProfileTimer* timer) {
+    timer->count.store(0, std::memory_order_relaxed);
+    timer->total_us.store(0, std::memory_order_relaxed);
+    timer->min_cycles.store(UINT32_MAX, std::memory_order_relaxed);
+    timer->max_cycles.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < MPU6050_PROFILE_BUCKETS; i++) {
+        timer->histogram[i].store(0, std::memory_order_relaxed);
+    }
+    timer->residue_cycles = 0;
+}
+
+void mpu6050_profile_init(Mpu6050Profile* profile) {
+    for (uint32_t stage = 0; stage < Mpu6050ProfileStage_Count; stage++) {
+        profile_clear(&profile->stages[stage]);
+        profile->stages[stage].reset_requested = false;
+    }
+    profile->bus_errors[0] = 0;
+    profile->bus_errors[1] = 0;
+    profile->reinits = 0;
+    profile->samples = 0;
+    profile->first_sample_ms = MPU6050_PROFILE_NONE;
+    profile->warm_start = false;
+    profile->inner_bus = NULL;
+}
+
+void mpu6050_profile_record(Mpu6050ProfileTimer* timer, uint32_t cycles) {
+    if (timer->reset_requested.load(std::memory_order_acquire)) {
+        profile_clear(timer);
+        timer->reset_requested.store(false, std::memory_order_release);
+    }
+
+    // Only this thread writes, so load + store instead of read-modify-write
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    uint32_t residue = timer->residue_cycles + cycles;
+    uint32_t us = residue / cycles_per_us;
+    timer->residue_cycles = residue - us * cycles_per_us;
+    timer->total_us.store(timer->total_us.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    timer->count.store(timer->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (cycles < timer->min_cycles.load(std::memory_order_relaxed)) {
+        timer->min_cycles.store(cycles, std::memory_order_relaxed);
+    }
+    if (cycles > timer->max_cycles.load(std::memory_order_relaxed)) {
+        timer->max_cycles.store(cycles, std::memory_order_relaxed);
+    }
+    std::atomic<uint32_t>& bucket = timer->histogram[profile_bucket(cycles / cycles_per_us)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void mpu6050_profile_reset_stage(Mpu6050Profile* profile, Mpu6050ProfileStage stage) {
+    profile->stages[stage].reset_requested.store(true, std::memory_order_release);
+}
+
+void mpu6050_profile_reset(Mpu6050Profile* profile) {
+    for (uint32_t stage = 0; stage < Mpu6050ProfileStage_Count; stage++) {
+        mpu6050_profile_reset_stage(profile, static_cast<Mpu6050ProfileStage>(stage));
+    }
+    profile->bus_errors[0] = 0;
+    profile->bus_errors[1] = 0;
+    profile->reinits = 0;
+    profile->samples = 0;
+}
+
+void mpu6050_profile_result(const Mpu6050ProfileTimer* timer, Mpu6050ProfileResult* result) {
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    result->count = timer->count.load(std::memory_order_relaxed);
+    if (result->count == 0 || timer->reset_requested.load(std::memory_order_relaxed)) {
+        result->count = 0;
+        result->min_us_x10 = result->avg_us_x10 = result->max_us_x10 = result->p99_us_x10 = 0;
+        return;
+    }
+    result->min_us_x10 = static_cast<uint32_t>(
+        static_cast<uint64_t>(timer->min_cycles.load(std::memory_order_relaxed)) * 10 / cycles_per_us);
+    result->max_us_x10 = static_cast<uint32_t>(
+        static_cast<uint64_t>(timer->max_cycles.load(std::memory_order_relaxed)) * 10 / cycles_per_us);
+    result->avg_us_x10 = static_cast<uint32_t>(
+        static_cast<uint64_t>(timer->total_us.load(std::memory_order_relaxed)) * 10 / result->count);
+
+    // Walk the histogram to the bucket holding the 99th percentile sample
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < MPU6050_PROFILE_BUCKETS; i++) {
+        total += timer->histogram[i].load(std::memory_order_relaxed);
+    }
+    uint32_t rank = total - total / 100;
+    uint32_t seen = 0;
+    uint32_t bucket = 0;
+    for (; bucket < MPU6050_PROFILE_BUCKETS - 1; bucket++) {
+        seen += timer->histogram[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) break;
+    }
+    // The bucket edge never reads above the largest sample actually seen
+    uint32_t p99 = (profile_bucket_top(bucket) + 1) * 10;
+    result->p99_us_x10 = p99 < result->max_us_x10 ? p99 : result->max_us_x10;
+}
+
+static bool profile_bus_write(void* context, uint8_t address, uint8_t reg, const uint8_t* data, size_t size) {
+    Mpu6050Profile* profile = static_cast<Mpu6050Profile*>(context);
+    const Mpu6050Bus* inner = profile->inner_bus;
+    bool ok = inner->write(inner->context, address, reg, data, size);
+    if (!ok) profile->bus_errors[address & 1].fetch_add(1, std::memory_order_relaxed);
+    return ok;
+}
+
+static bool profile_bus_read(void* context, uint8_t address, uint8_t reg, uint8_t* data, size_t size) {
+    Mpu6050Profile* profile = static_cast<Mpu6050Profile*>(context);
+    const Mpu6050Bus* inner = profile->inner_bus;
+    bool ok = inner->read(inner->context, address, reg, data, size);
+    if (!ok) profile->bus_errors[address & 1].fetch_add(1, std::memory_order_relaxed);
+    return ok;
+}
+
+static bool profile_bus_recover(void* context) {
+    Mpu6050Profile* profile = static_cast<Mpu6050Profile*>(context);
+    const Mpu6050Bus* inner = profile->inner_bus;
+    return inner->recover(inner->context);
+}
+
+void mpu6050_profile_bind_bus(Mpu6050Profile* profile, const Mpu6050Bus* inner, Mpu6050Bus* bus) {
+    profile->inner_bus = inner;
+    bus->context = profile;
+    bus->write = profile_bus_write;
+    bus->read = profile_bus_read;
+    bus->recover = inner->recover ? profile_bus_recover : NULL;
+}
+
+// One line of the dump. The dump runs on the GUI loop, whose 2 kB stack has no
+// room for the whole file, so each line is formatted and written on its own.
+static bool profile_write_line(File* file, const char* format, ...) {
+    char line[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length < 0) return false;
+    size_t size = static_cast<size_t>(length) < sizeof(line) ? static_cast<size_t>(length) : sizeof(line) - 1;
+    return storage_file_write(file, line, size) == size;
+}
+
+bool mpu6050_profile_dump(const Mpu6050Profile* profile, uint32_t sample_rate_hz, char* path, size_t path_size) {
+    Storage* storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    storage_simply_mkdir(storage, MPU6050_LOG_DIR);
+
+    bool named = false;
+    for (uint32_t i = 0; i < MPU6050_LOG_MAX_FILES && !named; i++) {
+        snprintf(path, path_size, MPU6050_LOG_DIR "/diag_%03lu.txt", (unsigned long)i);
+        named = !storage_file_exists(storage, path);
+    }
+
+    File* file = storage_file_alloc(storage);
+    bool ok = named && storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_NEW);
+    if (ok) {
+        ok = profile_write_line(file, "stage,count,min_us,avg_us,p99_us,max_us\n");
+        for (uint32_t stage = 0; stage < Mpu6050ProfileStage_Count && ok; stage++) {
+            Mpu6050ProfileResult result;
+            mpu6050_profile_result(&profile->stages[stage], &result);
+            ok = profile_write_line(
+                file,
+                "%s,%lu,%lu.%lu,%lu.%lu,%lu.%lu,%lu.%lu\n",
+                mpu6050_profile_stage_names[stage],
+                (unsigned long)result.count,
+                (unsigned long)(result.min_us_x10 / 10),
+                (unsigned long)(result.min_us_x10 % 10),
+                (unsigned long)(result.avg_us_x10 / 10),
+                (unsigned long)(result.avg_us_x10 % 10),
+                (unsigned long)(result.p99_us_x10 / 10),
+                (unsigned long)(result.p99_us_x10 % 10),
+                (unsigned long)(result.max_us_x10 / 10),
+                (unsigned long)(result.max_us_x10 % 10));
+        }
+        uint32_t first_sample_ms = profile->first_sample_ms.load(std::memory_order_relaxed);
+        ok = ok &&
+             profile_write_line(
+                 file,
+                 "i2c_errors_68,%lu\ni2c_errors_69,%lu\nreinits,%lu\n",
+                 (unsigned long)profile->bus_errors[0].load(std::memory_order_relaxed),
+                 (unsigned long)profile->bus_errors[1].load(std::memory_order_relaxed),
+                 (unsigned long)profile->reinits.load(std::memory_order_relaxed)) &&
+             profile_write_line(
+                 file,
+                 "samples,%lu\nsample_rate_hz,%lu\nfirst_sample_ms,%ld\nwarm_start,%d\n",
+                 (unsigned long)profile->samples.load(std::memory_order_relaxed),
+                 (unsigned long)sample_rate_hz,
+                 first_sample_ms == MPU6050_PROFILE_NONE ? -1L : (long)first_sample_ms,
+                 profile->warm_start.load(std::memory_order_relaxed) ? 1 : 0);
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+#endif // MPU6050_PROFILE
@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include <furi.h>
+#include <furi_hal.h>
+#include "mpu6050_fifo.h"
+
+// Hot-path instrumentation.
+//
+// Each stage of the pipeline is bracketed with the DWT cycle counter (the host
+// build maps it onto its monotonic clock) and folded into count, min, max, total
+// and a log-scale histogram for the 99th percentile. Each stage has a single
+// writer, so recording is a handful of relaxed stores; the diagnostics screen
+// reads the counters from another thread and a reset is only requested, the
+// writer clears the stage on its next sample.
+//
+// Built only with MPU6050_PROFILE defined; without it the macros below expand to
+// nothing and none of this is compiled into the app.
+
+typedef enum {
+    Mpu6050ProfileStage_BusPoll,   // FIFO counts and burst reads of every sensor
+    Mpu6050ProfileStage_Decode,    // Decoding a burst and pushing it to the ring
+    Mpu6050ProfileStage_Filter,    // Filter chain per block, before the lock (dump only)
+    Mpu6050ProfileStage_Fusion,    // Orientation filter per sample (dump and Tilt page)
+    Mpu6050ProfileStage_LockWait,  // GUI loop waiting for app->mutex
+    Mpu6050ProfileStage_Process,   // Statistics, trigger, fusion and plot per block
+    Mpu6050ProfileStage_Spectrum,  // FFT work per loop pass
+    Mpu6050ProfileStage_Draw,      // Draw callback
+    Mpu6050ProfileStage_SamplerPeriod, // Between sampler polls (nominal 10 ms)
+    Mpu6050ProfileStage_LoopPeriod,    // Between GUI loop passes (nominal 20 ms)
+    Mpu6050ProfileStage_Count
+} Mpu6050ProfileStage;
+
+#define MPU6050_PROFILE_NONE UINT32_MAX
+
+// Histogram: exact below 4 us, then four buckets per power of two up to ~1 s
+#define MPU6050_PROFILE_BUCKETS 80
+
+typedef struct {
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> total_us; // Wraps after ~70 minutes of stage time
+    std::atomic<uint32_t> min_cycles;
+    std::atomic<uint32_t> max_cycles;
+    std::atomic<uint32_t> histogram[MPU6050_PROFILE_BUCKETS];
+    std::atomic<bool> reset_requested;
+    uint32_t residue_cycles; // Writer only: cycles not yet counted into total_us
+} Mpu6050ProfileTimer;
+
+typedef struct {
+    Mpu6050ProfileTimer stages[Mpu6050ProfileStage_Count];
+
+    // Sampler-side counters
+    std::atomic<uint32_t> bus_errors[2]; // Failed transfers to 0x68 / 0x69
+    std::atomic<uint32_t> reinits;       // Main sensor re-initialised after a fault
+    std::atomic<uint32_t> samples;       // Main sensor samples published
+
+    // Launch to the main sensor's first sample, MPU6050_PROFILE_NONE until then;
+    // kept by resets
+    std::atomic<uint32_t> first_sample_ms;
+    std::atomic<bool> warm_start; // The main sensor was taken over without a reset
+
+    const Mpu6050Bus* inner_bus; // Bus the counting bus forwards to
+} Mpu6050Profile;
+
+// Values of one stage, in tenths of a microsecond
+typedef struct {
+    uint32_t count;
+    uint32_t min_us_x10;
+    uint32_t avg_us_x10;
+    uint32_t max_us_x10;
+    uint32_t p99_us_x10; // Upper edge of the bucket holding the 99th percentile
+} Mpu6050ProfileResult;
+
+extern const char* const mpu6050_profile_stage_names[Mpu6050ProfileStage_Count];
+
+void mpu6050_profile_init(Mpu6050Profile* profile);
+
+// Stage writer: one sample of `cycles`
+void mpu6050_profile_record(Mpu6050ProfileTimer* timer, uint32_t cycles);
+
+// Any thread: clears every stage and counter
+void mpu6050_profile_reset(Mpu6050Profile* profile);
+
+// Any thread: clears one stage
+void mpu6050_profile_reset_stage(Mpu6050Profile* profile, Mpu6050ProfileStage stage);
+
+void mpu6050_profile_result(const Mpu6050ProfileTimer* timer, Mpu6050ProfileResult* result);
+
+// Fills `bus` with a bus that forwards to `inner` and counts its failed transfers
+void mpu6050_profile_bind_bus(Mpu6050Profile* profile, const Mpu6050Bus* inner, Mpu6050Bus* bus);
+
+// Writes every stage and counter to the next free diag_NNN.txt in the log directory
+bool mpu6050_profile_dump(const Mpu6050Profile* profile, uint32_t sample_rate_hz, char* path, size_t path_size);
+
+#ifdef MPU6050_PROFILE
+// Starts timing into a new local `start`
+#define MPU6050_PROFILE_START(start) uint32_t start = DWT->CYCCNT
+// Records the cycles since `start` to `stage` of `profile`
+#define MPU6050_PROFILE_STOP(profile, stage, start) \
+    mpu6050_profile_record(&(profile)->stages[stage], DWT->CYCCNT - (start))
+// Records the cycles since `start` split over `n` items, for per-sample costs
+#define MPU6050_PROFILE_STOP_EACH(profile, stage, start, n) \
+    mpu6050_profile_record(&(profile)->stages[stage], (DWT->CYCCNT - (start)) / (n))
+// Records the cycles since `last` and restarts it, for loop periods
+#define MPU6050_PROFILE_PERIOD(profile, stage, last)                            \
+    do {                                                                        \
+        uint32_t now_ = DWT->CYCCNT;                                            \
+        mpu6050_profile_record(&(profile)->stages[stage], now_ - (last));       \
+        (last) = now_;                                                          \
+    } while (0)
+#define MPU6050_PROFILE_COUNT(counter, n) (counter).fetch_add((n), std::memory_order_relaxed)
+#else
+#define MPU6050_PROFILE_START(start)
+#define MPU6050_PROFILE_STOP(profile, stage, start) \
+    do {                                            \
+    } while (0)
+#define MPU6050_PROFILE_STOP_EACH(profile, stage, start, n) \
+    do {                                                    \
+    } while (0)
+#define MPU6050_PROFILE_PERIOD(profile, stage, last) \
+    do {                                             \
+    } while (0)
+#define MPU6050_PROFILE_COUNT(counter, n) \
+    do {                                  \
+    } while (0)
+#endif
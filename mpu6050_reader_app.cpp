@@ -7,28 +7,73 @@
 #include <furi_hal_gpio.h>
 #include <furi_hal_bus.h>
 #include <math.h> 
+#include <new>
+#include "mpu6050.h"
+#include "mpu6050_block.h"
+#include "mpu6050_calibration.h"
+#include "mpu6050_decimator.h"
+#include "mpu6050_fft.h"
+#include "mpu6050_filter.h"
+#include "mpu6050_fusion.h"
+#include "mpu6050_link.h"
+#include "mpu6050_logger.h"
+#include "mpu6050_multi.h"
+#include "mpu6050_power.h"
+#include "mpu6050_profile.h"
+#include "mpu6050_render.h"
+#include "mpu6050_replay.h"
+#include "mpu6050_settings.h"
+#include "mpu6050_stats.h"
+#include "mpu6050_streamer.h"
+#include "mpu6050_timebase.h"
+#include "mpu6050_trigger.h"
+#include "mpu6050_units.h"
 
-// MPU-6050 sensor I2C address (7-bit)
-// Default address is 0x68 (AD0 pulled low)
-#define MPU6050_I2C_ADDR 0x68
+// Acquisition loop period; at 1 kHz this queues 10 frames, well below FIFO capacity
+#define MPU6050_POLL_PERIOD_MS 10
+// GUI loop period: drains the ring and advances the spectrum between frames
+#define MPU6050_LOOP_PERIOD_MS 20
+// Display frame rate cap; unchanged frames are skipped below it
+#define MPU6050_MAX_FPS 25
+// Settings rows on screen at once; the list scrolls
+#define MPU6050_SETTINGS_ROWS 4
 
-// MPU-6050 registers
-#define MPU6050_REG_PWR_MGMT_1 0x6B // Power Management 1
-#define MPU6050_REG_SMPLRT_DIV 0x19 // Sample Rate Divider
-#define MPU6050_REG_CONFIG 0x1A    // Configuration
-#define MPU6050_REG_GYRO_CONFIG 0x1B // Gyroscope Configuration
-#define MPU6050_REG_ACCEL_CONFIG 0x1C // Accelerometer Configuration
-#define MPU6050_REG_ACCEL_XOUT_H 0x3B // High byte of Accel X-axis data
+// Sampler thread
+#define MPU6050_SAMPLER_STACK_SIZE (2 * 1024)
+// Longest backoff between bring-up attempts while no sensor answers: the main
+// address is looked at more often than the second one
+#define MPU6050_MAIN_BACKOFF_MAX_MS 250
+#define MPU6050_ALT_BACKOFF_MAX_MS 1000
+// While idle: how often the sampler checks for the motion interrupt, how often
+// the GUI loop runs, and how often the chip samples to detect motion
+#define MPU6050_IDLE_POLL_PERIOD_MS 100
+#define MPU6050_IDLE_LOOP_PERIOD_MS 100
+#define MPU6050_MOTION_WAKE_RATE Mpu6050WakeRate_20Hz
+// Samples buffered between the sampler and the GUI (~0.5 s at 1 kHz)
+#define MPU6050_RING_SIZE 512
 
-// Power Management 1 settings
-#define MPU6050_CLOCK_SEL_PLL_XG 0x01 // PLL with X axis gyroscope reference
-#define MPU6050_RESET 0x80            // Reset device
+// Spectrum: FFT work per GUI loop pass, in butterflies (a 1024 frame is 2.3k)
+#define MPU6050_SPECTRUM_BUDGET 1024
+// Spectrum bars across the screen, 2 px each
+#define MPU6050_SPECTRUM_BARS 64
 
-// Configuration settings (DLPF)
-#define MPU6050_DLPF_CFG_20HZ 0x04
+// Event capture: level step on the trigger screen
+#define MPU6050_TRIGGER_LEVEL_STEP_MG 100
+#define MPU6050_TRIGGER_LEVEL_MAX_MG 16000
 
-// I2C operation timeout
-#define MPU6050_I2C_TIMEOUT 100
+// Plot area of the event and waveform screens
+#define MPU6050_PLOT_TOP 11
+#define MPU6050_PLOT_HEIGHT 42
+// Waveform channel choices: X, Y, Z or all three, of the accel then the gyro
+#define MPU6050_PLOT_VIEWS 8
+
+// Sampler thread flags
+#define MPU6050_SAMPLER_FLAG_RECONFIGURE (1 << 0)
+#define MPU6050_SAMPLER_FLAG_CALIBRATE (1 << 1)
+#define MPU6050_SAMPLER_FLAG_REPLAY (1 << 2)
+
+typedef Mpu6050BlockRing<MPU6050_RING_SIZE> Mpu6050SampleRing;
+typedef Mpu6050<Mpu6050Variant::Mpu6050> Mpu6050Driver;
 
 // Enumeration for managing application states (screens)
 typedef enum {
@@ -36,424 +81,2365 @@ typedef enum {
     AppState_Settings,
     AppState_About,
     AppState_MaxG, // Added for max G submenu
+    AppState_Spectrum,
+    AppState_Events,
+    AppState_Plot,
+    AppState_Calibrate,
+#ifdef MPU6050_PROFILE
+    AppState_Diagnostics,
+#endif
 } AppState;
 
-// Enumeration for options in the settings menu
-typedef enum {
-    SettingsItem_Address,
-    SettingsItem_AccelFS,
-    SettingsItem_GyroFS,
-    SettingsItem_Count
-} SettingsItem;
+// Enumeration for options in the settings menu
+typedef enum {
+    SettingsItem_Address,
+    SettingsItem_AccelFS,
+    SettingsItem_GyroFS,
+    SettingsItem_Dlpf,
+    SettingsItem_Filter,
+    SettingsItem_FilterCorner,
+    SettingsItem_FilterOrder,
+    SettingsItem_SpectrumRate,
+    SettingsItem_LowPower,
+    SettingsItem_Motion,
+    SettingsItem_Replay,
+    SettingsItem_Calibrate,
+    SettingsItem_Count
+} SettingsItem;
+
+// Statistics (Max G) screen pages
+typedef enum {
+    StatsPage_Range,  // Min / max
+    StatsPage_Level,  // Mean / RMS
+    StatsPage_Spread, // Standard deviation / peak-to-peak
+    StatsPage_Count
+} StatsPage;
+
+// Main screen pages
+typedef enum {
+    MainPage_Accel,
+    MainPage_Gyro,
+    MainPage_Tilt,
+    MainPage_Record,
+    MainPage_Events,
+    MainPage_Plot,
+    MainPage_Dual,
+    MainPage_Stream,
+    MainPage_Power,
+    MainPage_Replay,
+    MainPage_Count
+} MainPage;
+
+#ifdef MPU6050_PROFILE
+// Diagnostics screen pages
+typedef enum {
+    DiagPage_Sampler, // Stages on the sampler thread
+    DiagPage_Gui,     // Stages on the GUI loop and draw
+    DiagPage_Counters,
+    DiagPage_Clock,   // Sample clocks of the sensors as the timestamps see them
+    DiagPage_Count
+} DiagPage;
+
+static const uint8_t diag_page_stages[2][4] = {
+    {Mpu6050ProfileStage_BusPoll, Mpu6050ProfileStage_Decode, Mpu6050ProfileStage_SamplerPeriod, 0xFF},
+    {Mpu6050ProfileStage_LockWait, Mpu6050ProfileStage_Process, Mpu6050ProfileStage_Spectrum, Mpu6050ProfileStage_Draw},
+};
+#endif
+
+// Calibration screen progress past the measurements
+typedef enum {
+    CalibrationStatus_Measuring,
+    CalibrationStatus_Applying,  // Waiting for the sampler to write the offsets
+    CalibrationStatus_Saved,
+    CalibrationStatus_Unsaved,   // In the chip, but the SD card write failed
+    CalibrationStatus_Failed,    // The sensor did not take the offsets
+} CalibrationStatus;
+
+static const char* const calibration_pose_names[Mpu6050CalPose_Count] = {
+    "Screen up", "Screen down", "X axis up", "X axis down", "Y axis up", "Y axis down"};
+
+// Rows of the trigger setup on the Events screen
+typedef enum {
+    TriggerItem_Mode,
+    TriggerItem_Source,
+    TriggerItem_Edge,
+    TriggerItem_Level,
+    TriggerItem_Pre,
+    TriggerItem_Holdoff,
+    TriggerItem_Count
+} TriggerItem;
+
+// Choices for the trigger's millisecond settings
+static const uint16_t trigger_pre_ms[] = {0, 20, 50, 100, 200};
+static const uint16_t trigger_holdoff_ms[] = {0, 100, 250, 500, 1000, 5000};
+
+// Shocks above 2 g on the magnitude, 50 ms of lead-in, at most one per 0.5 s
+static const Mpu6050TriggerConfig trigger_default_config = {
+    Mpu6050TriggerMode_Auto, Mpu6050TriggerSource_Magnitude, Mpu6050TriggerEdge_Rising, 2000, 50, 500};
+
+// Waveform timebases, in samples per pixel column (128 columns per screen)
+static const uint16_t plot_samples_per_column[] = {1, 2, 4, 8, 16, 40, 80, 160};
+
+// Screen-space cache of the waveform. Each decimated column is turned into pixel
+// rows once, when it arrives; the GUI redraws the canvas from scratch every
+// frame, so "scrolling" is just drawing the ring from its newest column. Only a
+// new scale, channel or history rasterises everything again.
+typedef struct {
+    uint8_t top[3][MPU6050_DECIMATOR_COLUMNS];    // Pixel row of each column's max
+    uint8_t bottom[3][MPU6050_DECIMATOR_COLUMNS]; // Pixel row of each column's min
+    uint32_t columns;    // Decimator columns rasterised so far
+    uint32_t generation; // Decimator history they came from
+    uint8_t view;        // Channel choice they were drawn for
+    int32_t lo;          // Scale, counts at the bottom and top row
+    int32_t hi;
+} PlotRaster;
+
+// Low power choices: stillness before sleeping, and the motion that wakes
+static const char* const power_idle_names[] = {"Off", "2 s", "10 s", "60 s"};
+static const uint32_t power_idle_ms[] = {0, 2000, 10000, 60000};
+static const uint16_t power_motion_mg[] = {40, 80, 160, 320};
+#define MPU6050_POWER_CHOICES 4
+
+// The chip's low-pass (CONFIG.DLPF_CFG 0..6). Off (260 Hz) the gyro clock runs
+// at 8 kHz, so the divider brings the rate back to 1 kHz.
+static const char* const dlpf_names[] = {"260 Hz", "188 Hz", "98 Hz", "42 Hz", "20 Hz", "10 Hz", "5 Hz"};
+#define MPU6050_DLPF_CHOICES 7
+
+// Filter chain choices: type, corner, and order 2, 4, 6 or 8 (1 to 4 biquads)
+static const char* const filter_type_names[Mpu6050FilterType_Count] = {
+    "Off", "Low-pass", "High-pass", "Band-pass", "Notch"};
+static const uint16_t filter_corner_hz[] = {1, 2, 5, 10, 20, 50, 100, 200};
+#define MPU6050_FILTER_CORNERS 8
+
+// Spectrum input rate: every sample, or every 2nd, 4th or 8th after the FIR
+static const uint8_t spectrum_decimation[] = {1, 2, 4, 8};
+#define MPU6050_SPECTRUM_RATES 4
+
+static const char* const fusion_filter_names[Mpu6050FusionFilter_Count] = {"Complementary", "Madgwick"};
+
+static const char* const replay_speed_names[Mpu6050ReplaySpeed_Count] = {"1x", "4x", "16x", "Max"};
+
+static const char* const trigger_mode_names[Mpu6050TriggerMode_Count] = {"Off", "Auto", "Single"};
+static const char* const trigger_source_names[Mpu6050TriggerSource_Count] = {"X", "Y", "Z", "|a|"};
+static const char* const trigger_edge_names[Mpu6050TriggerEdge_Count] = {"Rising", "Falling"};
+
+// Structure to store the newest sample for display, in raw counts
+typedef struct {
+    int16_t acc[3];
+    int16_t gyro[3];
+    int16_t temp;
+    uint8_t accel_fsr; // Mpu6050AccelFsr the sample was captured with
+    uint8_t gyro_fsr;  // Mpu6050GyroFsr the sample was captured with
+} Mpu6050DisplayData;
+
+// One sensor on the external bus and the samples it produced
+typedef struct {
+    // FIFO burst acquisition, owned by the sampler thread
+    Mpu6050Driver sensor;
+    uint8_t fifo_frames[MPU6050_FIFO_MAX_FRAMES * MPU6050_FRAME_SIZE];
+    Mpu6050SampleBlock sampler_block;
+    Mpu6050Link link;         // Bring-up and fault recovery
+    Mpu6050Timebase timebase; // Sample times; its statistics are readable from any thread
+
+    // Allocated by the sampler with the first samples, so a sensor that never
+    // answers costs no ring; NULL until then
+    std::atomic<Mpu6050SampleRing*> ring;
+    std::atomic<bool> initialized;
+    bool reattach; // Lost while sampling: the next attempt tries it without a reset, sampler only
+    std::atomic<uint8_t> foreign_part; // WHO_AM_I of a chip other than Mpu6050Driver's part, else 0
+    std::atomic<uint32_t> busy_us;     // Time spent in this sensor's transfers
+} Mpu6050Device;
+
+// Structure to store application state
+typedef struct {
+    Gui* gui;
+    ViewPort* view_port;
+    FuriMutex* mutex;
+    AppState current_state;
+    uint8_t main_page; // MainPage
+    std::atomic<bool> running;
+    Mpu6050DisplayData sensor_data;
+    Mpu6050Stats stats;    // Rolling statistics over every sample, guarded by mutex
+    uint8_t stats_window;  // Mpu6050StatsWindow shown on the Max G screen
+    uint8_t stats_page;    // StatsPage
+
+    // Variables for settings
+    uint8_t settings_cursor;
+    uint8_t i2c_address;
+    uint8_t accel_fsr_index; // 0=2g, 1=4g, 2=8g, 3=16g (Default 4g, index 1)
+    uint8_t gyro_fsr_index;  // 0=250, 1=500, 2=1000, 3=2000 deg/s (Default 500 deg/s, index 1)
+    uint8_t dlpf_index;      // DLPF_CFG
+    uint8_t power_idle_index;   // power_idle_ms, 0 = always full rate
+    uint8_t power_motion_index; // power_motion_mg
+
+    // Full rate or motion wake; decided and switched on the sampler thread
+    Mpu6050Power power;
+
+    // Sensors on the external bus: [0] at the address picked in Settings feeds
+    // every screen, [1] at the other address is sampled whenever one answers there
+    Mpu6050Bus bus;
+    Mpu6050Device devices[MPU6050_MAX_DEVICES];
+
+    // Sampler thread
+    FuriThread* sampler_thread;
+    std::atomic<bool> reconfigure_requested; // Set by the GUI, applied by the sampler
+    Mpu6050SampleBlock gui_block; // Consumer-side scratch block
+
+    // Dual page: both accelerometers on one time base
+    Mpu6050AlignStream align[MPU6050_MAX_DEVICES]; // Guarded by mutex
+    uint8_t bus_load_pct[MPU6050_MAX_DEVICES];     // Over the last second, written by the GUI loop
+    uint32_t bus_load_busy_us[MPU6050_MAX_DEVICES];
+    uint32_t bus_load_tick;
+
+    // Recording to SD card, fed from the GUI loop
+    Mpu6050Logger logger;
+    std::atomic<bool> record_toggle_requested; // Set by input, handled by the GUI loop
+    bool record_failed;                        // Last start could not create a file
+
+    // Live stream over USB, fed from the GUI loop
+    Mpu6050Streamer streamer;
+    std::atomic<bool> stream_toggle_requested; // Set by input, handled by the GUI loop
+    bool stream_failed;                        // Last start could not switch USB over
+
+    // Replay of the newest recording in place of the main sensor, read by the sampler
+    Mpu6050Replay replay;
+    uint8_t replay_speed;                      // Mpu6050ReplaySpeed, picked in Settings
+    std::atomic<bool> replay_toggle_requested; // Set by input, handled by the sampler
+    std::atomic<bool> replay_reset_requested;  // Set by the sampler, cleared by the GUI loop once reset
+    std::atomic<bool> replay_failed;           // Last start found no valid recording
+
+    // Filter chain in front of the statistics, events, waveform and spectrum; run
+    // and redesigned on the GUI loop only
+    Mpu6050FilterChain filter;
+    Mpu6050FilterConfig filter_config;   // Picked in Settings
+    uint8_t filter_corner_index;         // filter_corner_hz
+    Mpu6050SampleBlock filter_block;     // Filtered copy of gui_block
+    std::atomic<bool> filter_reset_requested;
+
+    // Vibration spectrum, processed on the GUI loop while its screen is open
+    Mpu6050Spectrum spectrum;
+    Mpu6050Fir spectrum_fir;       // Decimates the analysed axis, reset with the spectrum
+    uint8_t spectrum_rate_index;   // spectrum_decimation, picked in Settings
+    int16_t spectrum_input[MPU6050_BLOCK_SIZE];
+    uint8_t spectrum_size; // Mpu6050FftSize
+    uint8_t spectrum_axis; // 0=X, 1=Y, 2=Z
+    std::atomic<bool> spectrum_reset_requested;
+
+    // Event capture over every sample; the pool is only modified on the GUI loop
+    Mpu6050Trigger trigger;              // Guarded by mutex
+    Mpu6050TriggerConfig trigger_config; // Edited on the Events screen
+    std::atomic<bool> trigger_apply_requested;
+    std::atomic<int32_t> event_delete_requested; // Event index, -1 = none
+    std::atomic<bool> event_export_requested;
+    Mpu6050EventExport event_export; // Started and collected on the GUI loop
+    int8_t event_export_result; // 1 = saved, -1 = storage error, 0 = nothing yet
+    uint8_t trigger_cursor;     // TriggerItem
+    bool events_browsing;       // Event plots instead of the trigger setup
+    uint8_t event_index;        // Event shown while browsing, oldest first
+
+    // Orientation from every sample, shown on the Tilt page
+    Mpu6050Fusion fusion;  // Guarded by mutex
+    uint8_t fusion_filter; // Mpu6050FusionFilter
+    std::atomic<bool> fusion_reset_requested;
+
+    // Scrolling waveform: min/max columns decimated from every sample
+    Mpu6050Decimator decimator; // Guarded by mutex
+    PlotRaster plot_raster;     // Owned by the draw callback
+    uint8_t plot_view;          // 0..MPU6050_PLOT_VIEWS-1
+    uint8_t plot_timebase;      // Index into plot_samples_per_column
+    bool plot_auto_scale;       // Fit the visible data, else the full FSR
+    std::atomic<bool> plot_reset_requested;
+
+    // Display frames, requested by the GUI loop when the shown values change
+    Mpu6050FrameScheduler frames;
+    Mpu6050CachedText accel_text[3]; // Main screen rows, owned by the draw callback
+    Mpu6050CachedText gyro_text[3];
+    Mpu6050CachedText temp_text;
+
+    // Calibration of device 0, measured on the GUI loop and applied by the sampler
+    Mpu6050Calibration calibration; // Guarded by mutex
+    uint8_t calibration_status;     // CalibrationStatus
+    uint8_t calibration_address;    // Sensor being calibrated
+    Mpu6050CalResult calibration_result;  // Errors to cancel, handed to the sampler
+    Mpu6050Offsets calibration_offsets;   // Offsets the sampler wrote, handed back
+    std::atomic<bool> calibration_start_requested;
+    std::atomic<bool> calibration_apply_requested;
+    std::atomic<bool> calibrating; // On the calibration screen: the sampler holds full rate
+    std::atomic<int8_t> calibration_applied; // 1 = written, -1 = failed, 0 = pending
+    // Stored offsets per address (0x68, 0x69); init() writes them after every reset.
+    // Loaded before the sampler starts, then only touched by the sampler.
+    Mpu6050Offsets stored_offsets[2];
+    bool has_stored_offsets[2];
+    // Chips the last run left asleep, per address; loaded before the sampler
+    // starts, which tries each once for a warm start
+    Mpu6050DeviceProfile profiles[MPU6050_SETTINGS_PROFILES];
+
+#ifdef MPU6050_PROFILE
+    // Hot-path instrumentation; the sensors talk through a bus that counts failures
+    Mpu6050Profile profile;
+    Mpu6050Bus i2c_bus;
+    uint8_t diag_page; // DiagPage
+    uint32_t launch_ms; // Tick at launch, for the time to the first sample
+    uint32_t diag_rate_hz; // Main sensor samples over the last second, written by the GUI loop
+    uint32_t diag_samples;
+    uint32_t diag_tick;
+    std::atomic<bool> diag_dump_requested;
+    int8_t diag_dump_result; // 1 = saved, -1 = storage error, 0 = nothing yet
+#endif
+} MPU6050App;
+
+// Sensor configuration selected in Settings
+static Mpu6050Config settings_config(const MPU6050App* app) {
+    Mpu6050Config config = mpu6050_default_config;
+    config.address = app->i2c_address;
+    config.accel_fsr = app->accel_fsr_index;
+    config.gyro_fsr = app->gyro_fsr_index;
+    config.dlpf = app->dlpf_index;
+    config.sample_rate_div = app->dlpf_index == 0 ? 7 : 0;
+    return config;
+}
+
+// Low power policy of the Settings
+static Mpu6050PowerConfig settings_power_config(const MPU6050App* app) {
+    Mpu6050PowerConfig config;
+    config.idle_ms = power_idle_ms[app->power_idle_index];
+    config.motion_mg = power_motion_mg[app->power_motion_index];
+    return config;
+}
+
+// Milliseconds on the tick clock, for the power statistics and sensor recovery
+static uint32_t tick_now_ms(void) {
+    return furi_get_tick() / furi_ms_to_ticks(1);
+}
+
+// Sensor configuration of device `index`: the Settings, at that device's address
+static Mpu6050Config device_config(const MPU6050App* app, size_t index) {
+    Mpu6050Config config = settings_config(app);
+    if (index) config.address = config.address == MPU6050_I2C_ADDR ? MPU6050_I2C_ADDR_ALT : MPU6050_I2C_ADDR;
+    return config;
+}
+
+// Samples device `index` lost so far: dropped by its FIFO or overrunning its ring
+static uint32_t device_lost(const MPU6050App* app, size_t index) {
+    const Mpu6050Device* device = &app->devices[index];
+    const Mpu6050SampleRing* ring = device->ring;
+    return device->timebase.dropped + (ring ? ring->overruns() : 0);
+}
+
+// Recording page of the main screen: throughput and loss counters
+static void draw_record_page(Canvas* canvas, MPU6050App* app) {
+    Mpu6050LoggerStats stats;
+    mpu6050_logger_get_stats(&app->logger, &stats);
+    bool recording = mpu6050_logger_is_recording(&app->logger);
+
+    char text[32];
+    canvas_set_font(canvas, FontPrimary);
+    if (recording) {
+        snprintf(
+            text,
+            sizeof(text),
+            "REC %02lu:%02lu",
+            (unsigned long)(stats.elapsed_ms / 60000),
+            (unsigned long)(stats.elapsed_ms / 1000 % 60));
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, text);
+    } else {
+        const char* title = app->record_failed ? "SD card error" : "Record";
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, title);
+    }
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 5, 25, "Samples:");
+    snprintf(text, sizeof(text), "%lu", (unsigned long)stats.samples);
+    canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 35, "Rate:");
+    uint32_t rate = stats.elapsed_ms ? (uint32_t)((uint64_t)stats.bytes * 1000 / stats.elapsed_ms) : 0;
+    snprintf(text, sizeof(text), "%lu B/s", (unsigned long)rate);
+    canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 45, "Dropped:");
+    snprintf(
+        text, sizeof(text), "%lu blk  %lu ms", (unsigned long)stats.chunks_dropped, (unsigned long)stats.max_write_ms);
+    canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, text);
+
+    const char* hint = recording ? "[ok] Stop" : "[ok] Start recording";
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, hint);
+}
+
+// Stream page of the main screen: USB link state and loss counters
+static void draw_stream_page(Canvas* canvas, MPU6050App* app) {
+    Mpu6050StreamerStats stats;
+    mpu6050_streamer_get_stats(&app->streamer, &stats);
+    bool streaming = mpu6050_streamer_is_streaming(&app->streamer);
+
+    char text[32];
+    canvas_set_font(canvas, FontPrimary);
+    if (streaming) {
+        snprintf(text, sizeof(text), "USB %s", stats.connected ? (stats.delta ? "delta" : "raw") : "waiting");
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, text);
+    } else {
+        const char* title = app->stream_failed ? "USB error" : "Stream";
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, title);
+    }
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 5, 25, "Frames:");
+    snprintf(text, sizeof(text), "%lu", (unsigned long)stats.frames);
+    canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 35, "Rate:");
+    uint32_t rate = stats.elapsed_ms ? (uint32_t)((uint64_t)stats.bytes * 1000 / stats.elapsed_ms) : 0;
+    snprintf(text, sizeof(text), "%lu B/s", (unsigned long)rate);
+    canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 45, "Dropped:");
+    snprintf(text, sizeof(text), "%lu frm", (unsigned long)stats.frames_dropped);
+    canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, text);
+
+    const char* hint = streaming ? "[ok] Stop" : "[ok] Start streaming";
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, hint);
+}
+
+// Power page of the main screen: time in each mode and the samples it cost
+static void draw_power_page(Canvas* canvas, MPU6050App* app) {
+    Mpu6050PowerStats stats;
+    mpu6050_power_get_stats(&app->power, tick_now_ms(), &stats);
+
+    char text[48];
+    canvas_set_font(canvas, FontPrimary);
+    const char* title = stats.mode == Mpu6050PowerMode_Idle ? "Idle, wake on motion" :
+                        app->power_idle_index                ? "Full rate" :
+                                                               "Full rate, no sleep";
+    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, title);
+
+    canvas_set_font(canvas, FontSecondary);
+    const char* labels[Mpu6050PowerMode_Count] = {"Full rate:", "Idle:"};
+    for (int mode = 0; mode < Mpu6050PowerMode_Count; mode++) {
+        uint32_t seconds = stats.time_ms[mode] / 1000;
+        canvas_draw_str(canvas, 5, 25 + mode * 10, labels[mode]);
+        snprintf(
+            text,
+            sizeof(text),
+            "%lu:%02lu:%02lu",
+            (unsigned long)(seconds / 3600),
+            (unsigned long)(seconds / 60 % 60),
+            (unsigned long)(seconds % 60));
+        canvas_draw_str_aligned(canvas, 123, 20 + mode * 10, AlignRight, AlignTop, text);
+    }
+
+    canvas_draw_str(canvas, 5, 45, "Wakeups:");
+    snprintf(text, sizeof(text), "%lu", (unsigned long)stats.wakeups);
+    canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, text);
+
+    snprintf(
+        text,
+        sizeof(text),
+        "%lu kept, %lu skipped",
+        (unsigned long)stats.samples_captured,
+        (unsigned long)stats.samples_skipped);
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, text);
+}
+
+// Tilt page of the main screen: a bubble level, the fused angles and, with the
+// profiler built in, what one filter update costs
+static void draw_tilt_page(Canvas* canvas, MPU6050App* app) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    Mpu6050Euler euler;
+    mpu6050_fusion_euler(&app->fusion, &euler);
+    furi_mutex_release(app->mutex);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, fusion_filter_names[app->fusion_filter]);
+
+    // The bubble sits off centre by the tilt, 20 px at 45 degrees
+    const int32_t cx = 24;
+    const int32_t cy = 40;
+    canvas_draw_circle(canvas, cx, cy, 20);
+    canvas_draw_circle(canvas, cx, cy, 5);
+    canvas_draw_line(canvas, cx - 20, cy, cx + 20, cy);
+    canvas_draw_line(canvas, cx, cy - 20, cx, cy + 20);
+    int32_t dx = euler.roll * 20 / 45000;
+    int32_t dy = -euler.pitch * 20 / 45000;
+    dx = dx > 16 ? 16 : dx < -16 ? -16 : dx;
+    dy = dy > 16 ? 16 : dy < -16 ? -16 : dy;
+    canvas_draw_disc(canvas, cx + dx, cy + dy, 3);
+
+    char text[24];
+    canvas_set_font(canvas, FontSecondary);
+    const char* labels[3] = {"Roll:", "Pitch:", "Yaw:"};
+    const int32_t angles[3] = {euler.roll, euler.pitch, euler.yaw};
+    for (int row = 0; row < 3; row++) {
+        uint8_t y_pos = 25 + row * 10;
+        canvas_draw_str(canvas, 52, y_pos, labels[row]);
+        mpu6050_format_milli(text, sizeof(text), angles[row], 1);
+        canvas_draw_str_aligned(canvas, 126, y_pos - 5, AlignRight, AlignTop, text);
+    }
+#ifdef MPU6050_PROFILE
+    Mpu6050ProfileResult cost;
+    mpu6050_profile_result(&app->profile.stages[Mpu6050ProfileStage_Fusion], &cost);
+    snprintf(
+        text,
+        sizeof(text),
+        "%lu.%lu us/upd",
+        (unsigned long)(cost.avg_us_x10 / 10),
+        (unsigned long)(cost.avg_us_x10 % 10));
+    canvas_draw_str_aligned(canvas, 126, 60, AlignRight, AlignBottom, text);
+#endif
+}
+
+// Replay page of the main screen: progress and the rate the pipeline took samples at
+static void draw_replay_page(Canvas* canvas, MPU6050App* app) {
+    Mpu6050ReplayStats stats;
+    mpu6050_replay_get_stats(&app->replay, &stats);
+    bool playing = mpu6050_replay_is_playing(&app->replay);
+
+    char text[32];
+    canvas_set_font(canvas, FontPrimary);
+    if (playing) {
+        snprintf(text, sizeof(text), "Replay %s", replay_speed_names[app->replay.speed]);
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, text);
+    } else {
+        const char* title = app->replay_failed ? "No recording" : stats.samples ? "Replay done" : "Replay";
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, title);
+    }
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 5, 25, "File:");
+    canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, mpu6050_replay_file_name(&app->replay));
+
+    canvas_draw_str(canvas, 5, 35, "Samples:");
+    uint32_t pct = stats.file_size ? (uint32_t)((uint64_t)stats.bytes_read * 100 / stats.file_size) : 0;
+    snprintf(text, sizeof(text), "%lu  %lu%%", (unsigned long)stats.samples, (unsigned long)pct);
+    canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, text);
+
+    // At Max this is the throughput of everything behind the ring
+    canvas_draw_str(canvas, 5, 45, "Rate:");
+    uint32_t rate = stats.elapsed_ms ? (uint32_t)((uint64_t)stats.samples * 1000 / stats.elapsed_ms) : 0;
+    snprintf(text, sizeof(text), "%lu smp/s", (unsigned long)rate);
+    canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, text);
+
+    const char* hint = playing ? "[ok] Stop" : "[ok] Play latest";
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, hint);
+}
+
+// Events page of the main screen: trigger state and pool usage
+static void draw_events_page(Canvas* canvas, MPU6050App* app) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    const Mpu6050Trigger* trigger = &app->trigger;
+    bool armed = trigger->armed;
+    bool capturing = trigger->capture != NULL;
+    uint32_t events = mpu6050_trigger_event_count(trigger);
+    uint32_t missed = trigger->missed;
+    int32_t last_mg = 0;
+    if (events) {
+        const Mpu6050Event* last = mpu6050_trigger_event(trigger, events - 1);
+        last_mg = mpu6050_accel_counts_to_mg(mpu6050_event_peak(last), last->accel_fsr);
+    }
+    furi_mutex_release(app->mutex);
+    const Mpu6050TriggerConfig* config = &app->trigger_config;
+
+    char text[32];
+    char g[12];
+    canvas_set_font(canvas, FontPrimary);
+    const char* title = capturing ? "Capturing" : armed ? "Trigger armed" : "Trigger";
+    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, title);
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 5, 25, "Level:");
+    snprintf(
+        text,
+        sizeof(text),
+        "%s %s %s g",
+        trigger_source_names[config->source],
+        config->edge == Mpu6050TriggerEdge_Rising ? ">" : "<",
+        mpu6050_format_milli(g, sizeof(g), config->level_mg, 2));
+    canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 35, "Events:");
+    snprintf(text, sizeof(text), "%lu/%u  %lu missed", (unsigned long)events, MPU6050_EVENT_POOL, (unsigned long)missed);
+    canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 45, "Last peak:");
+    if (events) {
+        snprintf(text, sizeof(text), "%s g", mpu6050_format_milli(g, sizeof(g), last_mg, 2));
+        canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, text);
+    }
+
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "[ok] Events");
+}
+
+// Waveform page of the main screen: what the plot will show
+static void draw_plot_page(Canvas* canvas, MPU6050App* app) {
+    const char* sensors[2] = {"Accel", "Gyro"};
+    const char* axes[4] = {"X", "Y", "Z", "X Y Z"};
+    uint32_t screen_ms = (uint32_t)plot_samples_per_column[app->plot_timebase] * MPU6050_DECIMATOR_COLUMNS * 1000 /
+                         settings_config(app).sample_rate_hz();
+    char text[24];
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "Waveform");
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 5, 25, "Channel:");
+    snprintf(text, sizeof(text), "%s %s", sensors[app->plot_view / 4], axes[app->plot_view % 4]);
+    canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 35, "Screen:");
+    snprintf(text, sizeof(text), "%lu ms", (unsigned long)screen_ms);
+    canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, text);
+
+    canvas_draw_str(canvas, 5, 45, "Scale:");
+    canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, app->plot_auto_scale ? "Auto" : "Full scale");
+
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "[ok] Plot");
+}
+
+// Dual page of the main screen: both sensors and their difference at one instant,
+// with each sensor's bus load and lost samples
+static void draw_dual_page(Canvas* canvas, MPU6050App* app) {
+    int32_t mg[2][3];
+    uint32_t timestamp;
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    bool aligned = app->devices[0].initialized && app->devices[1].initialized &&
+                   mpu6050_align_sample(&app->align[0], &app->align[1], mg[0], mg[1], &timestamp);
+    furi_mutex_release(app->mutex);
+
+    char text[40];
+    char value[12];
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 1, 8, "Dual");
+    if (aligned) {
+        const char* heads[3] = {"A", "B", "A-B"};
+        const char* labels[3] = {"X", "Y", "Z"};
+        const uint8_t columns[3] = {62, 94, 127};
+        for (int column = 0; column < 3; column++) {
+            canvas_draw_str_aligned(canvas, columns[column], 8, AlignRight, AlignBottom, heads[column]);
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            uint8_t y_pos = 19 + axis * 10;
+            canvas_draw_str(canvas, 1, y_pos, labels[axis]);
+            const int32_t shown[3] = {mg[0][axis], mg[1][axis], mg[0][axis] - mg[1][axis]};
+            for (int column = 0; column < 3; column++) {
+                mpu6050_format_milli(value, sizeof(value), shown[column], 2);
+                canvas_draw_str_aligned(canvas, columns[column], y_pos, AlignRight, AlignBottom, value);
+            }
+        }
+    } else {
+        snprintf(text, sizeof(text), "No sensor at 0x%02X", device_config(app, 1).address);
+        canvas_draw_str_aligned(canvas, 64, 24, AlignCenter, AlignCenter, text);
+    }
+
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        const Mpu6050Device* device = &app->devices[i];
+        uint32_t lost = device_lost(app, i);
+        if (device->initialized) {
+            snprintf(
+                text,
+                sizeof(text),
+                "%c 0x%02X bus %u%% lost %lu",
+                'A' + static_cast<int>(i),
+                device_config(app, i).address,
+                app->bus_load_pct[i],
+                (unsigned long)lost);
+        } else {
+            snprintf(text, sizeof(text), "%c 0x%02X not found", 'A' + static_cast<int>(i), device_config(app, i).address);
+        }
+        canvas_draw_str(canvas, 1, 52 + i * 10, text);
+    }
+}
+
+// Function to draw the main screen
+static void draw_main_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    if (app->main_page == MainPage_Tilt) {
+        draw_tilt_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Record) {
+        draw_record_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Events) {
+        draw_events_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Plot) {
+        draw_plot_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Dual) {
+        draw_dual_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Stream) {
+        draw_stream_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Power) {
+        draw_power_page(canvas, app);
+        return;
+    }
+    if (app->main_page == MainPage_Replay) {
+        draw_replay_page(canvas, app);
+        return;
+    }
+
+    // Secure access to sensor data
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    bool replaying = mpu6050_replay_is_playing(&app->replay);
+    bool sensor_ok = app->devices[0].initialized || replaying;
+    uint8_t foreign_part = app->devices[0].foreign_part;
+    bool gyro_page = app->main_page == MainPage_Gyro;
+    Mpu6050DisplayData data = app->sensor_data;
+    furi_mutex_release(app->mutex);
+
+    // Display edge: raw counts become milli-g / milli-deg/s here and nowhere earlier
+    int32_t values[3];
+    for (int axis = 0; axis < 3; axis++) {
+        values[axis] = gyro_page ? mpu6050_gyro_counts_to_mdps(data.gyro[axis], data.gyro_fsr) :
+                                   mpu6050_accel_counts_to_mg(data.acc[axis], data.accel_fsr);
+    }
+    int32_t temp_centi_c = mpu6050_temp_counts_to_centi_c<Mpu6050Driver::Traits::variant>(data.temp);
+
+    canvas_set_font(canvas, FontPrimary);
+    if (gyro_page && sensor_ok) {
+        // Gyro page title carries the die temperature
+        canvas_draw_str_aligned(
+            canvas, 64, 5, AlignCenter, AlignTop, mpu6050_cached_milli(&app->temp_text, temp_centi_c * 10, 1, " C"));
+    } else {
+        canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "MPU-6050 ");
+    }
+    if (mpu6050_logger_is_recording(&app->logger)) {
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str(canvas, 1, 8, "REC");
+    }
+    if (replaying) {
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, "PLAY");
+    } else if (mpu6050_power_is_idle(&app->power)) {
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, "IDLE");
+    }
+
+    if (sensor_ok) {
+        canvas_set_font(canvas, FontSecondary);
+        const char* labels[3] = {"Acc X:", "Acc Y:", "Acc Z:"};
+        const char* gyro_labels[3] = {"Gyr X:", "Gyr Y:", "Gyr Z:"};
+
+        // Draw X, Y and Z rows
+        for (int axis = 0; axis < 3; axis++) {
+            uint8_t y_pos = 25 + axis * 10;
+            canvas_draw_str(canvas, 5, y_pos, gyro_page ? gyro_labels[axis] : labels[axis]);
+            // Each row is only re-printed when its displayed digits change
+            const char* value = gyro_page ? mpu6050_cached_milli(&app->gyro_text[axis], values[axis], 1, " dps") :
+                                            mpu6050_cached_milli(&app->accel_text[axis], values[axis], 2, " g");
+            canvas_draw_str_aligned(canvas, 123, y_pos - 5, AlignRight, AlignTop, value);
+        }
+    } else {
+        // Draw "sensor not connected" message, or which chip answered instead
+        canvas_set_font(canvas, FontPrimary);
+        char msg[24];
+        if (foreign_part) {
+            snprintf(msg, sizeof(msg), "Wrong chip 0x%02X", foreign_part);
+        } else {
+            snprintf(msg, sizeof(msg), "Connect sensor");
+        }
+        canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignTop, msg);
+    }
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "[<]set [>]about [^v]page [ok]max");
+}
+
+// Function to draw the settings screen
+// The list scrolls to keep the cursor on one of the MPU6050_SETTINGS_ROWS rows shown
+static void draw_settings_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "Settings");
+
+    char text[12];
+    canvas_set_font(canvas, FontSecondary);
+
+    const uint8_t row_height = 10; // Ustalona wysokość wiersza
+    const char* accel_fsr_values[] = {"+/- 2g", "+/- 4g", "+/- 8g", "+/- 16g"};
+    const char* gyro_fsr_values[] = {"+/- 250", "+/- 500", "+/- 1000", "+/- 2000"};
+    uint8_t first = app->settings_cursor < MPU6050_SETTINGS_ROWS ? 0 : app->settings_cursor - MPU6050_SETTINGS_ROWS + 1;
+
+    for (uint8_t row = 0; row < MPU6050_SETTINGS_ROWS && first + row < SettingsItem_Count; row++) {
+        uint8_t item = first + row;
+        uint8_t y_pos = 15 + row * row_height;
+        const char* label = "";
+        const char* value = text;
+        switch (item) {
+            case SettingsItem_Address:
+                label = "I2C Address:";
+                snprintf(text, sizeof(text), "0x%02X", app->i2c_address);
+                break;
+            case SettingsItem_AccelFS:
+                label = "Accel FSR:";
+                value = accel_fsr_values[app->accel_fsr_index];
+                break;
+            case SettingsItem_GyroFS:
+                label = "Gyro FSR:";
+                value = gyro_fsr_values[app->gyro_fsr_index];
+                break;
+            case SettingsItem_Dlpf:
+                label = "Chip low-pass:";
+                value = dlpf_names[app->dlpf_index];
+                break;
+            case SettingsItem_Filter:
+                label = "Filter:";
+                value = filter_type_names[app->filter_config.type];
+                break;
+            case SettingsItem_FilterCorner:
+                label = "Filter at:";
+                snprintf(text, sizeof(text), "%u Hz", filter_corner_hz[app->filter_corner_index]);
+                break;
+            case SettingsItem_FilterOrder:
+                label = "Filter order:";
+                snprintf(text, sizeof(text), "%u", app->filter_config.stages * 2);
+                break;
+            case SettingsItem_SpectrumRate:
+                label = "Spectrum rate:";
+                snprintf(
+                    text,
+                    sizeof(text),
+                    "%lu Hz",
+                    (unsigned long)(settings_config(app).sample_rate_hz() /
+                                    spectrum_decimation[app->spectrum_rate_index]));
+                break;
+            case SettingsItem_LowPower:
+                label = "Sleep when still:";
+                value = power_idle_names[app->power_idle_index];
+                break;
+            case SettingsItem_Motion:
+                label = "Wake on:";
+                snprintf(text, sizeof(text), "%u mg", power_motion_mg[app->power_motion_index]);
+                break;
+            case SettingsItem_Replay:
+                label = "Replay speed:";
+                value = replay_speed_names[app->replay_speed];
+                break;
+            case SettingsItem_Calibrate:
+                label = "Calibrate";
+                value = "[ok]";
+                break;
+        }
+
+        if (app->settings_cursor == item) {
+            canvas_draw_box(canvas, 0, y_pos - 1, 128, row_height); // Rysuj boks tła
+            canvas_set_color(canvas, ColorWhite);
+        } else {
+            canvas_set_color(canvas, ColorBlack);
+        }
+        canvas_draw_str(canvas, 5, y_pos + 7, label);
+        canvas_draw_str_aligned(canvas, 123, y_pos + 1, AlignRight, AlignTop, value);
+        if (app->settings_cursor == item) {
+            canvas_draw_str(canvas, 1, y_pos + 7, ">");
+        }
+        canvas_set_color(canvas, ColorBlack);
+    }
+
+    // Back button
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[Ok/Back] Back");
+}
+
+// Guided calibration: one pose after another, then the offsets written to the chip
+static void draw_calibrate_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    uint8_t state = app->calibration.state;
+    uint8_t pose = app->calibration.pose;
+    uint8_t progress = mpu6050_calibration_progress(&app->calibration);
+    furi_mutex_release(app->mutex);
+
+    char text[48];
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "Calibrate");
+    canvas_set_font(canvas, FontSecondary);
+
+    if (app->calibration_status != CalibrationStatus_Measuring) {
+        static const char* const status_names[] = {"", "Writing offsets...", "Saved", "Applied, SD error", "Sensor error"};
+        canvas_draw_str_aligned(canvas, 64, 14, AlignCenter, AlignTop, status_names[app->calibration_status]);
+        if (app->calibration_status == CalibrationStatus_Saved || app->calibration_status == CalibrationStatus_Unsaved) {
+            // Corrections that went in, then the registers that hold them
+            char values[3][10];
+            for (int axis = 0; axis < 3; axis++) {
+                mpu6050_format_milli(values[axis], sizeof(values[axis]), -app->calibration_result.accel_mg[axis], 0);
+            }
+            snprintf(text, sizeof(text), "A mg %s %s %s", values[0], values[1], values[2]);
+            canvas_draw_str(canvas, 2, 33, text);
+            for (int axis = 0; axis < 3; axis++) {
+                mpu6050_format_milli(values[axis], sizeof(values[axis]), -app->calibration_result.gyro_mdps[axis], 1);
+            }
+            snprintf(text, sizeof(text), "G dps %s %s %s", values[0], values[1], values[2]);
+            canvas_draw_str(canvas, 2, 43, text);
+            const Mpu6050Offsets* offsets = &app->calibration_offsets;
+            snprintf(
+                text,
+                sizeof(text),
+                "%d %d %d / %d %d %d",
+                offsets->accel[0],
+                offsets->accel[1],
+                offsets->accel[2],
+                offsets->gyro[0],
+                offsets->gyro[1],
+                offsets->gyro[2]);
+            canvas_draw_str(canvas, 2, 53, text);
+        }
+        canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[ok] Again [back] Exit");
+        return;
+    }
+
+    snprintf(text, sizeof(text), "%u/%u  %s", pose + 1, Mpu6050CalPose_Count, calibration_pose_names[pose]);
+    canvas_draw_str_aligned(canvas, 64, 16, AlignCenter, AlignTop, text);
+    if (state == Mpu6050CalState_Settling || state == Mpu6050CalState_Measuring) {
+        canvas_draw_str_aligned(canvas, 64, 28, AlignCenter, AlignTop, "Hold still");
+        canvas_draw_frame(canvas, 14, 40, 100, 8);
+        canvas_draw_box(canvas, 14, 40, progress, 8);
+    } else {
+        const char* hint = state == Mpu6050CalState_Rejected ? "Moved or wrong way up" : "Lay it flat that way";
+        canvas_draw_str_aligned(canvas, 64, 28, AlignCenter, AlignTop, hint);
+        canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[ok] Measure [back] Exit");
+    }
+}
+
+#ifdef MPU6050_PROFILE
+// Diagnostics: per-stage timings in microseconds, bus errors, sensor recovery and rates
+static void draw_diagnostics_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "Diagnostics");
+    canvas_set_font(canvas, FontSecondary);
+
+    char text[48];
+    if (app->diag_page == DiagPage_Counters) {
+        const Mpu6050Profile* profile = &app->profile;
+        Mpu6050LinkStats link;
+        mpu6050_link_get_stats(&app->devices[0].link, &link);
+        // Launch to the first sample; the sample rate is on the Clock page
+        uint32_t first_ms = profile->first_sample_ms.load();
+        if (first_ms == MPU6050_PROFILE_NONE) {
+            snprintf(text, sizeof(text), "Start -- rec %lu ms", (unsigned long)link.recover_ms_last);
+        } else {
+            snprintf(
+                text,
+                sizeof(text),
+                "Start %lu ms %s rec %lu ms",
+                (unsigned long)first_ms,
+                profile->warm_start.load() ? "warm" : "cold",
+                (unsigned long)link.recover_ms_last);
+        }
+        canvas_draw_str(canvas, 2, 22, text);
+        snprintf(
+            text,
+            sizeof(text),
+            "I2C err 68:%lu 69:%lu",
+            (unsigned long)profile->bus_errors[0].load(),
+            (unsigned long)profile->bus_errors[1].load());
+        canvas_draw_str(canvas, 2, 32, text);
+        snprintf(
+            text,
+            sizeof(text),
+            "Retry %lu bus %lu lost %lu",
+            (unsigned long)profile->reinits.load(),
+            (unsigned long)link.bus_recoveries,
+            (unsigned long)device_lost(app, 0));
+        canvas_draw_str(canvas, 2, 42, text);
+
+        // Jitter: how far the worst poll and loop pass ran past their average
+        Mpu6050ProfileResult sampler;
+        Mpu6050ProfileResult loop;
+        mpu6050_profile_result(&profile->stages[Mpu6050ProfileStage_SamplerPeriod], &sampler);
+        mpu6050_profile_result(&profile->stages[Mpu6050ProfileStage_LoopPeriod], &loop);
+        char sampler_ms[12];
+        char loop_ms[12];
+        int32_t sampler_us = static_cast<int32_t>(sampler.max_us_x10 - sampler.avg_us_x10) / 10;
+        int32_t loop_us = static_cast<int32_t>(loop.max_us_x10 - loop.avg_us_x10) / 10;
+        mpu6050_format_milli(sampler_ms, sizeof(sampler_ms), sampler_us, 1);
+        mpu6050_format_milli(loop_ms, sizeof(loop_ms), loop_us, 1);
+        snprintf(text, sizeof(text), "Jitter %s / %s ms", sampler_ms, loop_ms);
+        canvas_draw_str(canvas, 2, 52, text);
+    } else if (app->diag_page == DiagPage_Clock) {
+        // Both sensors' achieved rates, then how steady the main sensor's timestamps run
+        Mpu6050TimebaseStats clock[MPU6050_MAX_DEVICES];
+        for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+            mpu6050_timebase_get_stats(&app->devices[i].timebase, &clock[i]);
+            char rate[16];
+            mpu6050_format_milli(rate, sizeof(rate), static_cast<int32_t>(clock[i].rate_mhz), 2);
+            if (app->devices[i].initialized) {
+                snprintf(
+                    text,
+                    sizeof(text),
+                    "%c %s Hz %+ld ppm",
+                    'A' + static_cast<int>(i),
+                    rate,
+                    (long)clock[i].drift_ppm);
+            } else {
+                snprintf(text, sizeof(text), "%c not found", 'A' + static_cast<int>(i));
+            }
+            canvas_draw_str(canvas, 2, 22 + i * 10, text);
+        }
+        snprintf(
+            text,
+            sizeof(text),
+            "Anchor %lu us step %lu us",
+            (unsigned long)clock[0].anchor_error_us,
+            (unsigned long)clock[0].step_us);
+        canvas_draw_str(canvas, 2, 42, text);
+        snprintf(
+            text,
+            sizeof(text),
+            "Dropped %lu resync %lu",
+            (unsigned long)clock[0].dropped,
+            (unsigned long)clock[0].resyncs);
+        canvas_draw_str(canvas, 2, 52, text);
+    } else {
+        canvas_draw_str(canvas, 2, 20, "us");
+        canvas_draw_str_aligned(canvas, 68, 20, AlignRight, AlignBottom, "avg");
+        canvas_draw_str_aligned(canvas, 97, 20, AlignRight, AlignBottom, "p99");
+        canvas_draw_str_aligned(canvas, 126, 20, AlignRight, AlignBottom, "max");
+        for (uint8_t row = 0; row < 4; row++) {
+            uint8_t stage = diag_page_stages[app->diag_page][row];
+            if (stage == 0xFF) break;
+            Mpu6050ProfileResult result;
+            mpu6050_profile_result(&app->profile.stages[stage], &result);
+            uint8_t y = 30 + row * 9;
+            canvas_draw_str(canvas, 2, y, mpu6050_profile_stage_names[stage]);
+            const uint32_t shown[3] = {result.avg_us_x10, result.p99_us_x10, result.max_us_x10};
+            const uint8_t right[3] = {68, 97, 126};
+            for (int column = 0; column < 3; column++) {
+                // Tenths while they fit, whole microseconds above 100 us
+                int32_t milli = static_cast<int32_t>(shown[column] * 100);
+                mpu6050_format_milli(text, sizeof(text), milli, shown[column] < 1000 ? 1 : 0);
+                canvas_draw_str_aligned(canvas, right[column], y, AlignRight, AlignBottom, text);
+            }
+        }
+    }
+
+    const char* hint = app->diag_dump_result > 0  ? "Saved to SD" :
+                       app->diag_dump_result < 0  ? "SD card error" :
+                                                    "[<>] page [ok] reset";
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, hint);
+}
+#endif
+
+// Function to draw the about screen
+static void draw_about_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "About");
+
+    // Zmiana na FontSecondary i lepsze pozycjonowanie, aby zmieścić się na ekranie
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 64, 20, AlignCenter, AlignTop, "MPU-6050 Reader ");
+    canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignTop, "Accelerometer");
+    canvas_draw_str_aligned(canvas, 64, 40, AlignCenter, AlignTop, "by Dr Mosfet");
+
+    // Display pipeline counters: frames drawn / skipped as unchanged, draw time
+    Mpu6050FrameStats stats;
+    mpu6050_frame_get_stats(&app->frames, &stats);
+    char text[64];
+    snprintf(
+        text,
+        sizeof(text),
+        "%lu/%lu fr %lu/%lu us",
+        (unsigned long)stats.frames_drawn,
+        (unsigned long)stats.frames_skipped,
+        (unsigned long)stats.draw_us_average,
+        (unsigned long)stats.draw_us_max);
+    canvas_draw_str_aligned(canvas, 64, 50, AlignCenter, AlignTop, text);
+
+    // Back button
+#ifdef MPU6050_PROFILE
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[Ok/Back] Back [>] Diag");
+#else
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[Ok/Back] Back");
+#endif
+}
+
+// Function to draw the max G screen: a view over the rolling statistics of one window
+static void draw_max_g_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+
+    // Secure access to the statistics
+    Mpu6050StatsResult results[MPU6050_STATS_CHANNELS];
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    const Mpu6050RollingWindow& window = app->stats.window(static_cast<Mpu6050StatsWindow>(app->stats_window));
+    for (uint8_t channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+        window.result(channel, &results[channel]);
+    }
+    uint8_t fsr = app->stats.accel_fsr();
+    furi_mutex_release(app->mutex);
+
+    const char* titles[StatsPage_Count] = {"Min / Max", "Mean / RMS", "Std / P-P"};
+    const char* window_names[Mpu6050StatsWindow_Count] = {"100ms", "1s", "10s"};
+    char text[24];
+    canvas_set_font(canvas, FontPrimary);
+    snprintf(text, sizeof(text), "%s  %s", titles[app->stats_page], window_names[app->stats_window]);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, text);
+
+    canvas_set_font(canvas, FontSecondary);
+    const char* labels[MPU6050_STATS_CHANNELS] = {"X:", "Y:", "Z:", "|a|:"};
+    for (uint8_t channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+        const Mpu6050StatsResult* result = &results[channel];
+        int32_t left = 0;
+        int32_t right = 0;
+        switch (app->stats_page) {
+            case StatsPage_Range:
+                left = result->min;
+                right = result->max;
+                break;
+            case StatsPage_Level:
+                left = result->mean;
+                right = result->rms;
+                break;
+            default:
+                left = result->std_dev;
+                right = result->peak_to_peak;
+                break;
+        }
+
+        uint8_t y_pos = 22 + channel * 10;
+        canvas_draw_str(canvas, 5, y_pos, labels[channel]);
+        if (!result->samples) continue;
+        mpu6050_format_milli(text, sizeof(text), mpu6050_accel_counts_to_mg(left, fsr), 2);
+        canvas_draw_str_aligned(canvas, 80, y_pos - 5, AlignRight, AlignTop, text);
+        mpu6050_format_milli(text, sizeof(text), mpu6050_accel_counts_to_mg(right, fsr), 2);
+        canvas_draw_str_aligned(canvas, 123, y_pos - 5, AlignRight, AlignTop, text);
+    }
+
+    // Instructions
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[<>] view [^v] window [ok] rst");
+}
+
+// Function to draw the spectrum screen: one bar per group of bins, auto-scaled
+static void draw_spectrum_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    const Mpu6050Spectrum* spectrum = &app->spectrum;
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    uint32_t bins = spectrum->size / 2;
+    uint32_t group = bins / MPU6050_SPECTRUM_BARS;
+    uint32_t bars[MPU6050_SPECTRUM_BARS];
+    uint32_t highest = 1;
+    for (uint32_t bar = 0; bar < MPU6050_SPECTRUM_BARS; bar++) {
+        // Bin 0 (DC) is left out, the last bar ends on the Nyquist bin
+        uint64_t power = 0;
+        for (uint32_t k = 1 + bar * group; k <= (bar + 1) * group; k++) {
+            if (spectrum->power[k] > power) power = spectrum->power[k];
+        }
+        bars[bar] = mpu6050_isqrt64(power);
+        if (bars[bar] > highest) highest = bars[bar];
+    }
+    uint32_t peak = mpu6050_spectrum_peak_bin(spectrum);
+    uint32_t peak_centi_hz = mpu6050_spectrum_bin_centi_hz(spectrum, peak);
+    int32_t peak_mg = mpu6050_accel_counts_to_mg(mpu6050_spectrum_amplitude(spectrum, peak), spectrum->accel_fsr) >>
+                      MPU6050_SPECTRUM_AMPLITUDE_SHIFT;
+    uint16_t frames = spectrum->frames;
+    uint16_t size = spectrum->size;
+    uint16_t nyquist = spectrum->sample_rate_hz / 2;
+    furi_mutex_release(app->mutex);
+
+    char text[48];
+    canvas_set_font(canvas, FontSecondary);
+    const char* axis_names[3] = {"X", "Y", "Z"};
+    if (frames) {
+        snprintf(
+            text,
+            sizeof(text),
+            "%s %u  %lu.%luHz %ldmg",
+            axis_names[app->spectrum_axis],
+            size,
+            (unsigned long)(peak_centi_hz / 100),
+            (unsigned long)(peak_centi_hz / 10 % 10),
+            (long)peak_mg);
+    } else {
+        snprintf(text, sizeof(text), "%s %u  collecting...", axis_names[app->spectrum_axis], size);
+    }
+    canvas_draw_str(canvas, 1, 8, text);
+
+    // Bars from y=53 up to y=11
+    const uint8_t base = 53;
+    const uint8_t height = 42;
+    for (uint32_t bar = 0; bar < MPU6050_SPECTRUM_BARS; bar++) {
+        uint32_t h = frames ? bars[bar] * height / highest : 0;
+        if (h) canvas_draw_box(canvas, bar * 2, base + 1 - h, 2, h);
+    }
+    canvas_draw_line(canvas, 0, base + 1, 127, base + 1);
+
+    canvas_draw_str(canvas, 1, 63, "0");
+    snprintf(text, sizeof(text), "%uHz", nyquist);
+    canvas_draw_str_aligned(canvas, 127, 63, AlignRight, AlignBottom, text);
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[^v] N [<>] axis");
+}
+
+// Trigger setup half of the Events screen
+static void draw_trigger_setup(Canvas* canvas, MPU6050App* app) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    uint32_t events = mpu6050_trigger_event_count(&app->trigger);
+    furi_mutex_release(app->mutex);
+    const Mpu6050TriggerConfig* config = &app->trigger_config;
+
+    char text[16];
+    canvas_set_font(canvas, FontPrimary);
+    const char* title = app->event_export.thread      ? "Saving..." :
+                        app->event_export_result > 0 ? "Saved to SD" :
+                        app->event_export_result < 0 ? "SD card error" :
+                                                       "Trigger";
+    canvas_draw_str(canvas, 1, 10, title);
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(text, sizeof(text), "%lu/%u ev", (unsigned long)events, MPU6050_EVENT_POOL);
+    canvas_draw_str_aligned(canvas, 127, 10, AlignRight, AlignBottom, text);
+
+    const char* labels[TriggerItem_Count] = {"Mode:", "Source:", "Edge:", "Level (g):", "Pre-trigger:", "Holdoff:"};
+    for (uint8_t item = 0; item < TriggerItem_Count; item++) {
+        const char* value = text;
+        switch (item) {
+            case TriggerItem_Mode:
+                value = trigger_mode_names[config->mode];
+                break;
+            case TriggerItem_Source:
+                value = trigger_source_names[config->source];
+                break;
+            case TriggerItem_Edge:
+                value = trigger_edge_names[config->edge];
+                break;
+            case TriggerItem_Level:
+                mpu6050_format_milli(text, sizeof(text), config->level_mg, 2);
+                break;
+            case TriggerItem_Pre:
+                snprintf(text, sizeof(text), "%u ms", config->pre_ms);
+                break;
+            default:
+                snprintf(text, sizeof(text), "%u ms", config->holdoff_ms);
+                break;
+        }
+        uint8_t y_pos = 20 + item * 8;
+        if (item == app->trigger_cursor) canvas_draw_str(canvas, 1, y_pos, ">");
+        canvas_draw_str(canvas, 7, y_pos, labels[item]);
+        canvas_draw_str_aligned(canvas, 123, y_pos, AlignRight, AlignBottom, value);
+    }
+}
+
+// Event half of the Events screen: the trigger source over the captured window,
+// two samples per column drawn as a min/max bar, with the trigger point and level
+static void draw_event_plot(Canvas* canvas, MPU6050App* app) {
+    const uint8_t columns = 128;
+    const uint32_t per_column = (MPU6050_EVENT_SAMPLES + columns - 1) / columns;
+    uint8_t y_lo[columns];
+    uint8_t y_hi[columns];
+    uint32_t used = 0;
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    uint32_t events = mpu6050_trigger_event_count(&app->trigger);
+    uint32_t index = app->event_index < events ? app->event_index : events - 1;
+    const Mpu6050Event* event = events ? mpu6050_trigger_event(&app->trigger, index) : NULL;
+    uint32_t number = 0;
+    uint8_t source = 0;
+    int32_t peak_mg = 0;
+    int32_t level_y = -1;
+    uint32_t trigger_x = 0;
+    if (event) {
+        // Scale to the event's range, keeping the trigger level in view
+        int32_t lo = event->level;
+        int32_t hi = event->level;
+        for (uint32_t n = 0; n < event->count; n++) {
+            int32_t value = mpu6050_event_value(event, n);
+            if (value < lo) lo = value;
+            if (value > hi) hi = value;
+        }
+        int32_t span = hi > lo ? hi - lo : 1;
+        for (uint32_t n = 0; n < event->count; n++) {
+            int32_t value = mpu6050_event_value(event, n);
+            uint8_t y = static_cast<uint8_t>(
+                MPU6050_PLOT_TOP + (hi - value) * (MPU6050_PLOT_HEIGHT - 1) / span);
+            uint32_t column = n / per_column;
+            if (n % per_column == 0) {
+                y_lo[column] = y;
+                y_hi[column] = y;
+                used = column + 1;
+            }
+            if (y < y_hi[column]) y_hi[column] = y;
+            if (y > y_lo[column]) y_lo[column] = y;
+        }
+        level_y = MPU6050_PLOT_TOP + (hi - event->level) * (MPU6050_PLOT_HEIGHT - 1) / span;
+        trigger_x = event->pre_samples / per_column;
+        number = event->number;
+        source = event->source;
+        peak_mg = mpu6050_accel_counts_to_mg(mpu6050_event_peak(event), event->accel_fsr);
+    }
+    furi_mutex_release(app->mutex);
+
+    canvas_set_font(canvas, FontSecondary);
+    if (!events) {
+        canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignCenter, "No events yet");
+        canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[ok] setup");
+        return;
+    }
+
+    char text[40];
+    char g[12];
+    snprintf(
+        text,
+        sizeof(text),
+        "%lu/%lu #%lu %s pk %s g",
+        (unsigned long)index + 1,
+        (unsigned long)events,
+        (unsigned long)number,
+        trigger_source_names[source],
+        mpu6050_format_milli(g, sizeof(g), peak_mg, 2));
+    canvas_draw_str(canvas, 1, 8, text);
+
+    for (uint32_t x = 0; x < used; x++) {
+        canvas_draw_line(canvas, x, y_hi[x], x, y_lo[x]);
+    }
+    for (uint8_t x = 0; x < columns; x += 4) {
+        canvas_draw_dot(canvas, x, level_y);
+    }
+    for (uint8_t y = MPU6050_PLOT_TOP; y < MPU6050_PLOT_TOP + MPU6050_PLOT_HEIGHT; y += 2) {
+        canvas_draw_dot(canvas, trigger_x, y);
+    }
+
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[<>] event [v] del [ok] setup");
+}
+
+// Function to draw the events screen
+static void draw_events_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    if (app->events_browsing) {
+        draw_event_plot(canvas, app);
+    } else {
+        draw_trigger_setup(canvas, app);
+    }
+}
+
+// Converts plotted counts to milli-units (mg or mdps) for the scale labels
+static int32_t plot_counts_to_milli(uint8_t view, int32_t counts, uint32_t tag) {
+    return view < 4 ? mpu6050_accel_counts_to_mg(counts, tag >> 4) : mpu6050_gyro_counts_to_mdps(counts, tag & 0x0F);
+}
+
+// Brings the raster up to date with the decimator: new columns only, or all of
+// them when the scale, channel or history changed. Called with the mutex held.
+static void plot_rasterize(MPU6050App* app, const Mpu6050Decimator* decimator, int32_t lo, int32_t hi) {
+    PlotRaster* raster = &app->plot_raster;
+    uint8_t base = app->plot_view / 4 * 3; // Accel rows 0..2, gyro rows 3..5
+    uint32_t available = mpu6050_decimator_available(decimator);
+    uint32_t start = decimator->columns - available;
+
+    bool full = raster->generation != decimator->generation || raster->view != app->plot_view ||
+                raster->lo != lo || raster->hi != hi;
+    if (!full && raster->columns > start) start = raster->columns;
+
+    int32_t span = hi - lo;
+    for (uint32_t column = start; column < decimator->columns; column++) {
+        uint32_t slot = mpu6050_decimator_slot(column);
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            int32_t top = decimator->max[base + axis][slot];
+            int32_t bottom = decimator->min[base + axis][slot];
+            top = top > hi ? hi : top;
+            bottom = bottom < lo ? lo : bottom;
+            raster->top[axis][slot] = static_cast<uint8_t>(MPU6050_PLOT_TOP + (hi - top) * (MPU6050_PLOT_HEIGHT - 1) / span);
+            raster->bottom[axis][slot] =
+                static_cast<uint8_t>(MPU6050_PLOT_TOP + (hi - bottom) * (MPU6050_PLOT_HEIGHT - 1) / span);
+        }
+    }
+
+    raster->columns = decimator->columns;
+    raster->generation = decimator->generation;
+    raster->view = app->plot_view;
+    raster->lo = lo;
+    raster->hi = hi;
+}
+
+// Function to draw the scrolling waveform: newest column on the right edge
+static void draw_plot_screen(Canvas* canvas, MPU6050App* app) {
+    canvas_clear(canvas);
+    const PlotRaster* raster = &app->plot_raster;
+    uint8_t view = app->plot_view;
+    uint8_t first_axis = view % 4 == 3 ? 0 : view % 4;
+    uint8_t last_axis = view % 4 == 3 ? 2 : view % 4;
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    const Mpu6050Decimator* decimator = &app->decimator;
+    uint32_t columns = decimator->columns;
+    uint32_t available = mpu6050_decimator_available(decimator);
+    uint32_t tag = decimator->tag;
+    uint32_t samples_per_column = decimator->samples_per_column;
+
+    int32_t lo = INT16_MIN;
+    int32_t hi = INT16_MAX;
+    if (app->plot_auto_scale && available) {
+        // Fit the visible columns, snapped to a power-of-two grid so noise does
+        // not rescale (and re-rasterise) every frame
+        int32_t data_lo = INT16_MAX;
+        int32_t data_hi = INT16_MIN;
+        uint8_t base = view / 4 * 3;
+        for (uint8_t axis = first_axis; axis <= last_axis; axis++) {
+            int16_t row_lo;
+            int16_t row_hi;
+            mpu6050_row_range(decimator->min[base + axis], available, &row_lo, &row_hi);
+            if (row_lo < data_lo) data_lo = row_lo;
+            mpu6050_row_range(decimator->max[base + axis], available, &row_lo, &row_hi);
+            if (row_hi > data_hi) data_hi = row_hi;
+        }
+        int32_t step = 16;
+        while (step * 4 < data_hi - data_lo) step <<= 1;
+        lo = data_lo >= 0 ? data_lo / step * step : -((-data_lo + step - 1) / step * step);
+        hi = lo + ((data_hi - lo) / step + 1) * step;
+    }
+    plot_rasterize(app, decimator, lo, hi);
+    furi_mutex_release(app->mutex);
+
+    for (uint32_t column = columns - available; column < columns; column++) {
+        uint32_t slot = mpu6050_decimator_slot(column);
+        int32_t x = MPU6050_DECIMATOR_COLUMNS - (columns - column);
+        for (uint8_t axis = first_axis; axis <= last_axis; axis++) {
+            canvas_draw_line(canvas, x, raster->top[axis][slot], x, raster->bottom[axis][slot]);
+        }
+    }
+
+    // Header: channel and screen time on the left, scale on the right
+    const char* names[MPU6050_PLOT_VIEWS] = {"Acc X", "Acc Y", "Acc Z", "Acc XYZ", "Gyr X", "Gyr Y", "Gyr Z", "Gyr XYZ"};
+    uint32_t screen_ms = samples_per_column * MPU6050_DECIMATOR_COLUMNS * 1000 / settings_config(app).sample_rate_hz();
+    char text[32];
+    char low[12];
+    char high[12];
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(text, sizeof(text), "%s %lums", names[view], (unsigned long)screen_ms);
+    canvas_draw_str(canvas, 1, 8, text);
+    mpu6050_format_milli(low, sizeof(low), plot_counts_to_milli(view, lo, tag), 2);
+    mpu6050_format_milli(high, sizeof(high), plot_counts_to_milli(view, hi, tag), 2);
+    snprintf(text, sizeof(text), "%s..%s", low, high);
+    canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, text);
+
+    canvas_draw_line(canvas, 0, MPU6050_PLOT_TOP + MPU6050_PLOT_HEIGHT, 127, MPU6050_PLOT_TOP + MPU6050_PLOT_HEIGHT);
+    canvas_draw_str_aligned(
+        canvas,
+        64,
+        63,
+        AlignCenter,
+        AlignBottom,
+        app->plot_auto_scale ? "[^v] ch [<>] time [ok] full" : "[^v] ch [<>] time [ok] auto");
+}
+
+// Main drawing function that switches screens
+static void mpu6050_draw_callback(Canvas* canvas, void* context) {
+    furi_assert(context);
+    MPU6050App* app = static_cast<MPU6050App*>(context);
+    uint32_t frame_begin = mpu6050_frame_begin();
+
+    switch (app->current_state) {
+        case AppState_Main:
+            draw_main_screen(canvas, app);
+            break;
+        case AppState_Settings:
+            draw_settings_screen(canvas, app);
+            break;
+        case AppState_About:
+            draw_about_screen(canvas, app);
+            break;
+        case AppState_MaxG:
+            draw_max_g_screen(canvas, app);
+            break;
+        case AppState_Spectrum:
+            draw_spectrum_screen(canvas, app);
+            break;
+        case AppState_Events:
+            draw_events_screen(canvas, app);
+            break;
+        case AppState_Plot:
+            draw_plot_screen(canvas, app);
+            break;
+        case AppState_Calibrate:
+            draw_calibrate_screen(canvas, app);
+            break;
+#ifdef MPU6050_PROFILE
+        case AppState_Diagnostics:
+            draw_diagnostics_screen(canvas, app);
+            break;
+#endif
+    }
+    mpu6050_frame_end(&app->frames, frame_begin);
+    MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_Draw, frame_begin);
+}
+
+// Reduces what the current screen shows to a signature, quantised the way it is
+// printed, so the loop can skip frames that would look the same. Runs on the GUI
+// loop, the only writer of everything read here, so no lock is taken.
+static uint32_t frame_signature(MPU6050App* app) {
+    uint32_t sig = MPU6050_SIGNATURE_INIT;
+    sig = mpu6050_signature_add(sig, app->current_state);
+    sig = mpu6050_signature_add(sig, app->devices[0].initialized);
+    sig = mpu6050_signature_add(sig, app->devices[0].foreign_part);
+    sig = mpu6050_signature_add(sig, mpu6050_logger_is_recording(&app->logger));
+    sig = mpu6050_signature_add(sig, mpu6050_power_is_idle(&app->power));
+    sig = mpu6050_signature_add(sig, mpu6050_replay_is_playing(&app->replay));
+
+    switch (app->current_state) {
+        case AppState_Main:
+            sig = mpu6050_signature_add(sig, app->main_page);
+            if (app->main_page == MainPage_Accel || app->main_page == MainPage_Gyro) {
+                const Mpu6050DisplayData* data = &app->sensor_data;
+                for (int axis = 0; axis < 3; axis++) {
+                    int32_t value = app->main_page == MainPage_Gyro ?
+                                        mpu6050_quantize_milli(
+                                            mpu6050_gyro_counts_to_mdps(data->gyro[axis], data->gyro_fsr), 1) :
+                                        mpu6050_quantize_milli(
+                                            mpu6050_accel_counts_to_mg(data->acc[axis], data->accel_fsr), 2);
+                    sig = mpu6050_signature_add(sig, value);
+                }
+                if (app->main_page == MainPage_Gyro) {
+                    int32_t centi_c = mpu6050_temp_counts_to_centi_c<Mpu6050Driver::Traits::variant>(data->temp);
+                    sig = mpu6050_signature_add(sig, mpu6050_quantize_milli(centi_c * 10, 1));
+                }
+            } else if (app->main_page == MainPage_Tilt) {
+                Mpu6050Euler euler;
+                mpu6050_fusion_euler(&app->fusion, &euler);
+                sig = mpu6050_signature_add(sig, mpu6050_quantize_milli(euler.roll, 1));
+                sig = mpu6050_signature_add(sig, mpu6050_quantize_milli(euler.pitch, 1));
+                sig = mpu6050_signature_add(sig, mpu6050_quantize_milli(euler.yaw, 1));
+                sig = mpu6050_signature_add(sig, app->fusion_filter);
+            } else if (app->main_page == MainPage_Record) {
+                Mpu6050LoggerStats stats;
+                mpu6050_logger_get_stats(&app->logger, &stats);
+                sig = mpu6050_signature_add(sig, stats.elapsed_ms / 1000);
+                sig = mpu6050_signature_add(sig, stats.samples);
+                sig = mpu6050_signature_add(sig, stats.chunks_dropped);
+                sig = mpu6050_signature_add(sig, stats.max_write_ms);
+                sig = mpu6050_signature_add(sig, app->record_failed);
+            } else if (app->main_page == MainPage_Events) {
+                sig = mpu6050_signature_add(sig, app->trigger.armed);
+                sig = mpu6050_signature_add(sig, app->trigger.capture != NULL);
+                sig = mpu6050_signature_add(sig, app->trigger.triggers);
+                sig = mpu6050_signature_add(sig, app->trigger.missed);
+                sig = mpu6050_signature_add(sig, mpu6050_trigger_event_count(&app->trigger));
+            } else if (app->main_page == MainPage_Dual) {
+                int32_t mg[2][3];
+                uint32_t timestamp;
+                bool aligned = mpu6050_align_sample(&app->align[0], &app->align[1], mg[0], mg[1], &timestamp);
+                sig = mpu6050_signature_add(sig, aligned);
+                for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+                    const Mpu6050Device* device = &app->devices[i];
+                    sig = mpu6050_signature_add(sig, device->initialized);
+                    sig = mpu6050_signature_add(sig, app->bus_load_pct[i]);
+                    sig = mpu6050_signature_add(sig, device_lost(app, i));
+                    for (int axis = 0; aligned && axis < 3; axis++) {
+                        sig = mpu6050_signature_add(sig, mpu6050_quantize_milli(mg[i][axis], 2));
+                    }
+                }
+            } else if (app->main_page == MainPage_Stream) {
+                Mpu6050StreamerStats stats;
+                mpu6050_streamer_get_stats(&app->streamer, &stats);
+                sig = mpu6050_signature_add(sig, mpu6050_streamer_is_streaming(&app->streamer));
+                sig = mpu6050_signature_add(sig, stats.connected);
+                sig = mpu6050_signature_add(sig, stats.delta);
+                sig = mpu6050_signature_add(sig, stats.frames);
+                sig = mpu6050_signature_add(sig, stats.frames_dropped);
+                sig = mpu6050_signature_add(sig, stats.elapsed_ms / 1000);
+                sig = mpu6050_signature_add(sig, app->stream_failed);
+            } else if (app->main_page == MainPage_Power) {
+                Mpu6050PowerStats stats;
+                mpu6050_power_get_stats(&app->power, tick_now_ms(), &stats);
+                sig = mpu6050_signature_add(sig, stats.time_ms[Mpu6050PowerMode_Full] / 1000);
+                sig = mpu6050_signature_add(sig, stats.time_ms[Mpu6050PowerMode_Idle] / 1000);
+                sig = mpu6050_signature_add(sig, stats.wakeups);
+                sig = mpu6050_signature_add(sig, stats.samples_captured);
+                sig = mpu6050_signature_add(sig, stats.samples_skipped);
+            } else if (app->main_page == MainPage_Replay) {
+                Mpu6050ReplayStats stats;
+                mpu6050_replay_get_stats(&app->replay, &stats);
+                sig = mpu6050_signature_add(sig, stats.samples);
+                sig = mpu6050_signature_add(sig, stats.bytes_read);
+                sig = mpu6050_signature_add(sig, stats.elapsed_ms / 1000);
+                sig = mpu6050_signature_add(sig, app->replay_failed);
+            }
+            break;
+        case AppState_MaxG: {
+            const Mpu6050RollingWindow& window = app->stats.window(static_cast<Mpu6050StatsWindow>(app->stats_window));
+            uint8_t fsr = app->stats.accel_fsr();
+            for (uint8_t channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+                Mpu6050StatsResult result;
+                window.result(channel, &result);
+                const int32_t shown[6] = {
+                    result.min, result.max, result.mean, result.rms, result.std_dev, result.peak_to_peak};
+                for (int i = 0; i < 6; i++) {
+                    sig = mpu6050_signature_add(sig, mpu6050_quantize_milli(mpu6050_accel_counts_to_mg(shown[i], fsr), 2));
+                }
+                sig = mpu6050_signature_add(sig, result.samples != 0);
+            }
+            break;
+        }
+        case AppState_Spectrum:
+            // The bars only move when a periodogram is accumulated
+            sig = mpu6050_signature_add(sig, app->spectrum.frames_total);
+            sig = mpu6050_signature_add(sig, app->spectrum.size);
+            break;
+        case AppState_Events:
+            sig = mpu6050_signature_add(sig, app->trigger.triggers);
+            sig = mpu6050_signature_add(sig, mpu6050_trigger_event_count(&app->trigger));
+            sig = mpu6050_signature_add(sig, app->event_export_result);
+            sig = mpu6050_signature_add(sig, app->event_export.thread != NULL);
+            break;
+        case AppState_Plot:
+            // One new column scrolls the plot by a pixel
+            sig = mpu6050_signature_add(sig, app->decimator.columns);
+            sig = mpu6050_signature_add(sig, app->decimator.generation);
+            break;
+        case AppState_Calibrate:
+            sig = mpu6050_signature_add(sig, app->calibration.state);
+            sig = mpu6050_signature_add(sig, app->calibration.pose);
+            sig = mpu6050_signature_add(sig, mpu6050_calibration_progress(&app->calibration));
+            sig = mpu6050_signature_add(sig, app->calibration_status);
+            break;
+        case AppState_About:
+            // Refresh the frame counters once a second
+            sig = mpu6050_signature_add(sig, furi_get_tick() / furi_ms_to_ticks(1000));
+            break;
+#ifdef MPU6050_PROFILE
+        case AppState_Diagnostics:
+            sig = mpu6050_signature_add(sig, furi_get_tick() / furi_ms_to_ticks(1000));
+            sig = mpu6050_signature_add(sig, app->diag_page);
+            sig = mpu6050_signature_add(sig, app->diag_dump_result);
+            break;
+#endif
+        default:
+            // Settings only change on input, which forces a frame
+            break;
+    }
+    return sig;
+}
+
+// Drops a sensor that stopped answering; its link brings it back. The ring
+// keeps what it holds, so the consumers carry on where the samples stopped.
+static void lose_mpu6050(MPU6050App* app, size_t index) {
+    Mpu6050Device* device = &app->devices[index];
+    device->reattach = true;
+    device->sensor.invalidate();
+    device->initialized = false;
+    mpu6050_link_lost(&device->link, tick_now_ms());
+}
+
+// Function to configure the MPU-6050 sensor, one step per sampler pass so the
+// other sensor keeps being polled: an attempt identifies the chip and resets it,
+// later passes wait for the reset to finish and then configure it.
+// A reset restores the factory offsets, so the stored calibration of whichever
+// address the device is at goes back in after it.
+static void init_mpu6050(MPU6050App* app, size_t index) {
+    Mpu6050Device* device = &app->devices[index];
+    Mpu6050Link* link = &device->link;
+    uint32_t now = tick_now_ms();
+
+    if (mpu6050_link_due(link, now)) {
+        Mpu6050Config config = device_config(app, index);
+        // One failed transfer rarely means the chip lost its state: a sensor that
+        // still reads back as it was left carries on, FIFO and timing included.
+        // Until it answers it is retried like that, with the usual backoff; a
+        // chip that answers differently goes through the reset.
+        if (device->reattach) {
+            Mpu6050ReattachStatus status = device->sensor.reattach(config);
+            if (status == Mpu6050ReattachStatus_Done) {
+                device->reattach = false;
+                mpu6050_link_resumed(link, now);
+                device->initialized = true;
+                return;
+            }
+            if (status == Mpu6050ReattachStatus_NoAnswer) {
+                if (mpu6050_link_failed(link, now) && app->bus.recover) app->bus.recover(app->bus.context);
+                return;
+            }
+            device->reattach = false;
+        }
+        // Every attempt at the main sensor after the first is a retry
+        if (index == 0 && link->attempts) MPU6050_PROFILE_COUNT(app->profile.reinits, 1);
+        size_t slot = config.address - MPU6050_I2C_ADDR;
+        device->sensor.set_stored_offsets(app->has_stored_offsets[slot] ? &app->stored_offsets[slot] : NULL);
+        // A chip the last run left asleep as the Settings want it is woken and
+        // taken over as it is; any mismatch and it goes through the reset after all
+        Mpu6050DeviceProfile* profile = &app->profiles[slot];
+        uint8_t wanted[MPU6050_CONFIG_BLOCK_SIZE];
+        config.config_block(wanted);
+        bool warm = profile->valid && memcmp(profile->config, wanted, sizeof(wanted)) == 0;
+        profile->valid = false;
+        if (warm && device->sensor.resume(config, profile->who_am_i)) {
+            mpu6050_link_resumed(link, now);
+            mpu6050_timebase_restart(&device->timebase);
+            device->foreign_part = 0;
+            device->initialized = true;
+#ifdef MPU6050_PROFILE
+            if (index == 0) app->profile.warm_start = true;
+#endif
+            return;
+        }
+        // A different part answering is not driven: its offset registers and
+        // temperature scale are not this driver's
+        bool identified = device->sensor.begin_init(config);
+        device->foreign_part = device->sensor.is_expected_part() ? 0 : device->sensor.who_am_i();
+        if (identified) {
+            mpu6050_link_resetting(link, now);
+            return;
+        }
+    } else if (link->state == Mpu6050LinkState_Resetting) {
+        Mpu6050InitStatus status = device->sensor.continue_init();
+        if (status == Mpu6050InitStatus_Done) {
+            mpu6050_link_up(link, now);
+            mpu6050_timebase_restart(&device->timebase);
+            device->initialized = true;
+            return;
+        }
+        if (status == Mpu6050InitStatus_Pending && !mpu6050_link_reset_expired(link, now, MPU6050_RESET_DELAY_MS)) {
+            return;
+        }
+    } else {
+        return;
+    }
+
+    // The attempt failed; after a few in a row, free the bus in case a slave
+    // cut off mid-byte is holding SDA low
+    if (mpu6050_link_failed(link, now) && app->bus.recover) app->bus.recover(app->bus.context);
+}
+
+// Sampler time base shared by every device: the middle of the current tick,
+// the anchor of each burst
+static uint32_t sampler_now_us(void) {
+    uint32_t tick_us = 1000000 / furi_kernel_get_tick_frequency();
+    return furi_get_tick() * tick_us + tick_us / 2;
+}
+
+// The device's ring, allocated on first use; sampler thread only
+static Mpu6050SampleRing* sampler_ring(Mpu6050Device* device) {
+    Mpu6050SampleRing* ring = device->ring;
+    if (!ring) {
+        ring = new (malloc(sizeof(Mpu6050SampleRing))) Mpu6050SampleRing();
+        device->ring = ring;
+    }
+    return ring;
+}
+
+// Decodes `frame_count` frames from the device's FIFO buffer and publishes them to
+// its ring, tagged with the configuration they were captured under. The FIFO
+// count was read at `now_us`, after the FIFO dropped `lost` frames.
+static void publish_frames(
+    Mpu6050Device* device,
+    size_t frame_count,
+    const Mpu6050Config& config,
+    uint32_t now_us,
+    uint32_t lost) {
+    Mpu6050SampleBlock* block = &device->sampler_block;
+    mpu6050_decode_block(device->fifo_frames, frame_count, block);
+    mpu6050_timebase_stamp(&device->timebase, block, config.sample_rate_hz(), now_us, lost);
+    block->accel_fsr = config.accel_fsr;
+    block->gyro_fsr = config.gyro_fsr;
+    sampler_ring(device)->push(*block);
+}
+
+// Function to read up to `max_frames` queued samples from one sensor's FIFO and
+// publish them. Runs on the sampler thread only and never touches app->mutex.
+static bool read_mpu6050(Mpu6050Device* device, size_t max_frames, const Mpu6050Config& config) {
+    size_t frame_count = 0;
+    uint32_t lost = device->sensor.fifo().frames_lost;
+    uint32_t now_us = sampler_now_us();
+    Mpu6050FifoStatus status = device->sensor.read_fifo(device->fifo_frames, max_frames, &frame_count);
+    lost = device->sensor.fifo().frames_lost - lost;
+
+    if (status == Mpu6050FifoStatus_BusError && frame_count == 0) {
+        return false;
+    }
+    publish_frames(device, frame_count, config, now_us, lost);
+    return true;
+}
+
+// Applies the Settings to a sensor. Only registers that differ from the chip's
+// current state are written; a new address, or a sensor not running, starts
+// its bring-up over under the new settings.
+static void reconfigure_mpu6050(MPU6050App* app, size_t index) {
+    Mpu6050Device* device = &app->devices[index];
+    Mpu6050Config config = device_config(app, index);
+    if (!device->initialized || device->sensor.needs_init(config)) {
+        device->initialized = false;
+        mpu6050_link_restart(&device->link, tick_now_ms());
+        return;
+    }
+
+    // Switch first so the change lands at once, then drain the frames that
+    // were already queued under the old settings
+    size_t queued = 0;
+    Mpu6050Config previous = device->sensor.config();
+    bool counted = device->sensor.fifo_queued(&queued);
+    if (!device->sensor.apply(config)) {
+        lose_mpu6050(app, index);
+        return;
+    }
+    if (counted && queued) read_mpu6050(device, queued, previous);
+}
+
+// One poll of every running sensor, their bursts interleaved on the bus. Returns
+// true when the main sensor has been still long enough to go idle.
+static bool poll_mpu6050(MPU6050App* app) {
+    bool still = false;
+    Mpu6050MultiDevice slots[MPU6050_MAX_DEVICES];
+    uint32_t lost[MPU6050_MAX_DEVICES];
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        slots[i].fifo = device->initialized ? &device->sensor.fifo() : NULL;
+        slots[i].frames = device->fifo_frames;
+        slots[i].max_frames = MPU6050_FIFO_MAX_FRAMES;
+        slots[i].busy_us = 0;
+        lost[i] = device->sensor.fifo().frames_lost;
+    }
+
+    // The FIFO counts are read back to back, so one timestamp serves every stream
+    uint32_t now_us = sampler_now_us();
+    MPU6050_PROFILE_START(bus_start);
+    mpu6050_multi_read(slots, MPU6050_MAX_DEVICES);
+    MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_BusPoll, bus_start);
+
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (!slots[i].fifo) continue;
+        device->busy_us += slots[i].busy_us;
+        lost[i] = device->sensor.fifo().frames_lost - lost[i];
+        if (slots[i].status == Mpu6050FifoStatus_BusError && slots[i].frames_read == 0) {
+            lose_mpu6050(app, i);
+            continue;
+        }
+        MPU6050_PROFILE_START(decode_start);
+        publish_frames(device, slots[i].frames_read, device->sensor.config(), now_us, lost[i]);
+        MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_Decode, decode_start);
+        if (i == 0) {
+            MPU6050_PROFILE_COUNT(app->profile.samples, slots[i].frames_read);
+#ifdef MPU6050_PROFILE
+            if (slots[i].frames_read && app->profile.first_sample_ms == MPU6050_PROFILE_NONE) {
+                app->profile.first_sample_ms = tick_now_ms() - app->launch_ms;
+            }
+#endif
+            still = mpu6050_power_push(&app->power, &device->sampler_block);
+        }
+    }
+    return still;
+}
+
+// Back to full rate on every sensor in motion wake; one that fails goes back
+// through its bring-up
+static void wake_mpu6050(MPU6050App* app) {
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (!device->initialized || !device->sensor.in_motion_wake()) continue;
+        // The FIFO starts over, so the next burst sets the phase again
+        mpu6050_timebase_restart(&device->timebase);
+        if (!device->sensor.leave_motion_wake()) lose_mpu6050(app, i);
+    }
+    mpu6050_power_wake(&app->power, tick_now_ms(), app->devices[0].sensor.config().sample_rate_hz());
+}
+
+// Every running sensor to motion wake. Without the main sensor there is nothing
+// to wake on, so a failure there brings the others straight back.
+static void sleep_mpu6050(MPU6050App* app) {
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (device->initialized &&
+            !device->sensor.enter_motion_wake(app->power.config.motion_mg, MPU6050_MOTION_WAKE_RATE)) {
+            lose_mpu6050(app, i);
+        }
+    }
+    mpu6050_power_sleep(&app->power, tick_now_ms());
+    if (!app->devices[0].initialized) wake_mpu6050(app);
+}
+
+// While idle: wakes every sensor once any of them latched the motion interrupt,
+// or on a bus fault, so recovery runs at full rate
+static void watch_mpu6050(MPU6050App* app) {
+    bool wake = !app->devices[0].initialized;
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (!device->initialized || !device->sensor.in_motion_wake()) continue;
+        bool motion = false;
+        if (!device->sensor.motion_pending(&motion)) {
+            lose_mpu6050(app, i);
+            wake = true;
+        }
+        wake = wake || motion;
+    }
+    if (wake) wake_mpu6050(app);
+}
+
+// Writes the offsets that cancel the measured errors into the main sensor and
+// keeps them for its address, so every later init() restores them
+static void calibrate_mpu6050(MPU6050App* app) {
+    Mpu6050Device* device = &app->devices[0];
+    if (!device->initialized || device->sensor.config().address != app->calibration_address) {
+        app->calibration_applied = -1;
+        return;
+    }
+
+    Mpu6050Offsets offsets;
+    mpu6050_offsets_correct(&device->sensor.offsets(), &app->calibration_result, &offsets);
+    if (!device->sensor.write_offsets(offsets)) {
+        lose_mpu6050(app, 0);
+        app->calibration_applied = -1;
+        return;
+    }
+    size_t slot = app->calibration_address - MPU6050_I2C_ADDR;
+    app->stored_offsets[slot] = offsets;
+    app->has_stored_offsets[slot] = true;
+    app->calibration_offsets = offsets;
+    app->calibration_applied = 1;
+}
+
+// Back to the sensors after a replay. Their FIFOs kept filling meanwhile; what
+// they hold is stale, so it is dropped rather than published.
+static void end_replay(MPU6050App* app) {
+    mpu6050_replay_stop(&app->replay);
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (!device->initialized || device->sensor.in_motion_wake()) continue;
+        mpu6050_timebase_restart(&device->timebase);
+        if (!mpu6050_fifo_flush(&device->sensor.fifo())) lose_mpu6050(app, i);
+    }
+}
+
+// Starts or stops replaying the newest recording. A replay of a file that is
+// being recorded would feed itself, so it needs the recorder stopped.
+static void toggle_replay(MPU6050App* app) {
+    if (mpu6050_replay_is_playing(&app->replay)) {
+        end_replay(app);
+        return;
+    }
+    bool started = !mpu6050_logger_is_recording(&app->logger) &&
+                   mpu6050_replay_start(&app->replay, static_cast<Mpu6050ReplaySpeed>(app->replay_speed));
+    app->replay_failed = !started;
+    // The GUI loop empties the rings and restarts every consumer before the
+    // first block goes in, so two replays of one file end in the same state
+    if (started) app->replay_reset_requested = true;
+}
 
-// Structure to store sensor data
-typedef struct {
-    int16_t acc_x, acc_y, acc_z;
-    float acc_g_x, acc_g_y, acc_g_z;
-} Mpu6050Data;
+// Publishes the replay blocks that are due into the main sensor's ring, in place
+// of read_mpu6050(). A block waits for room rather than overrunning the ring, so
+// a replay is never lossy, however fast it runs.
+static void replay_mpu6050(MPU6050App* app) {
+    if (app->replay_reset_requested) return;
 
-// Structure to store application state
-typedef struct {
-    Gui* gui;
-    ViewPort* view_port;
-    FuriMutex* mutex;
-    AppState current_state;
-    bool running;
-    bool is_sensor_initialized;
-    Mpu6050Data sensor_data;
-    float max_g_x, max_g_y, max_g_z; // Added to store maximum G values for each axis
+    Mpu6050SampleRing* ring = sampler_ring(&app->devices[0]);
+    uint32_t now_us = sampler_now_us();
+    while (ring->size() + MPU6050_BLOCK_SIZE <= ring->capacity()) {
+        const Mpu6050SampleBlock* block = mpu6050_replay_next(&app->replay, now_us);
+        if (!block) break;
+        ring->push(*block);
+    }
+    // Done once the consumers have taken the last sample, so the elapsed time
+    // covers all of their work
+    if (mpu6050_replay_at_end(&app->replay) && ring->size() == 0) end_replay(app);
+}
 
-    // Variables for settings
-    uint8_t settings_cursor;
-    uint8_t i2c_address;
-    uint8_t accel_fsr_index; // 0=2g, 1=4g, 2=8g, 3=16g (Default 4g, index 1)
-    uint8_t gyro_fsr_index;  // 0=250, 1=500, 2=1000, 3=2000 deg/s (Default 500 deg/s, index 1)
-} MPU6050App;
+// Unpaced replay keeps both loops busy instead of sleeping between passes
+static bool replay_unpaced(const MPU6050App* app) {
+    return mpu6050_replay_is_playing(&app->replay) && app->replay.speed == Mpu6050ReplaySpeed_Max;
+}
 
-// Function to draw the main screen
-static void draw_main_screen(Canvas* canvas, MPU6050App* app) {
-    canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "MPU-6050 ");
+// High-priority acquisition loop: owns the bus, the FIFOs and the producer side of the rings
+static int32_t mpu6050_sampler_thread(void* context) {
+    MPU6050App* app = static_cast<MPU6050App*>(context);
+    MPU6050_PROFILE_START(last_poll);
 
-    // Secure access to sensor data
-    furi_mutex_acquire(app->mutex, FuriWaitForever);
-    bool sensor_ok = app->is_sensor_initialized;
-    float acc_g_x = app->sensor_data.acc_g_x;
-    float acc_g_y = app->sensor_data.acc_g_y;
-    float acc_g_z = app->sensor_data.acc_g_z;
-    furi_mutex_release(app->mutex);
+    while (app->running) {
+        MPU6050_PROFILE_PERIOD(&app->profile, Mpu6050ProfileStage_SamplerPeriod, last_poll);
+        if (app->replay_toggle_requested.exchange(false)) {
+            toggle_replay(app);
+        }
 
-    if (sensor_ok) {
-        canvas_set_font(canvas, FontSecondary);
-        FuriString* acc_str = furi_string_alloc();
-        
-        // Draw Accel X
-        canvas_draw_str(canvas, 5, 25, "Acc X:");
-        furi_string_printf(acc_str, "%.2f g", (double)acc_g_x);
-        canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, furi_string_get_cstr(acc_str));
-
-        // Draw Accel Y
-        canvas_draw_str(canvas, 5, 35, "Acc Y:");
-        furi_string_printf(acc_str, "%.2f g", (double)acc_g_y);
-        canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, furi_string_get_cstr(acc_str));
-
-        // Draw Accel Z
-        canvas_draw_str(canvas, 5, 45, "Acc Z:");
-        furi_string_printf(acc_str, "%.2f g", (double)acc_g_z);
-        canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, furi_string_get_cstr(acc_str));
-        
-        furi_string_free(acc_str);
-    } else {
-        // Draw "sensor not connected" message
-        canvas_set_font(canvas, FontPrimary);
-        const char* msg = "Connect sensor";
-        canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignTop, msg);
+        if (mpu6050_replay_is_playing(&app->replay)) {
+            // In place of the sensors, which are left alone until it ends;
+            // settings changes and calibration wait for it too
+            replay_mpu6050(app);
+        } else {
+            // Settings changes and calibration need the sensors at full rate
+            bool hold = app->calibrating;
+            if (mpu6050_power_is_idle(&app->power) &&
+                (hold || app->reconfigure_requested || app->calibration_apply_requested)) {
+                wake_mpu6050(app);
+            }
+            if (app->reconfigure_requested.exchange(false)) {
+                Mpu6050PowerConfig power_config = settings_power_config(app);
+                mpu6050_power_configure(&app->power, &power_config);
+                for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) reconfigure_mpu6050(app, i);
+            }
+            if (app->calibration_apply_requested.exchange(false)) {
+                calibrate_mpu6050(app);
+            }
+
+            if (mpu6050_power_is_idle(&app->power)) {
+                watch_mpu6050(app);
+            } else {
+                // Sensors being brought up take one step each; the running ones are
+                // polled meanwhile
+                for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+                    if (!app->devices[i].initialized) init_mpu6050(app, i);
+                }
+
+                if (poll_mpu6050(app) && !hold) sleep_mpu6050(app);
+            }
+        }
+
+        if (replay_unpaced(app)) {
+            furi_thread_yield();
+            continue;
+        }
+        // Sleep until the next poll, or wake at once for a settings change or a replay
+        bool idle = mpu6050_power_is_idle(&app->power) && !mpu6050_replay_is_playing(&app->replay);
+        furi_thread_flags_wait(
+            MPU6050_SAMPLER_FLAG_RECONFIGURE | MPU6050_SAMPLER_FLAG_CALIBRATE | MPU6050_SAMPLER_FLAG_REPLAY,
+            FuriFlagWaitAny,
+            idle ? MPU6050_IDLE_POLL_PERIOD_MS : MPU6050_POLL_PERIOD_MS);
     }
-    
-    canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "set.. [<] About [>] [ok] Max ");
+    return 0;
 }
 
-// Function to draw the settings screen
-static void draw_settings_screen(Canvas* canvas, MPU6050App* app) {
-    canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "Settings");
+// Drains the ring into the display state; runs on the GUI loop
+static void consume_samples(MPU6050App* app) {
+    Mpu6050SampleBlock* block = &app->gui_block;
+    Mpu6050SampleRing* ring = app->devices[0].ring;
 
-    FuriString* value_str = furi_string_alloc();
-    canvas_set_font(canvas, FontSecondary);
+    while (ring && ring->pop(*block) > 0) {
+        uint32_t last = block->count - 1;
+        mpu6050_logger_write(&app->logger, block);
+        mpu6050_streamer_write(&app->streamer, block);
+        // Recording, streaming, orientation and calibration keep the raw samples
+        MPU6050_PROFILE_START(filter_start);
+        const Mpu6050SampleBlock* filtered = mpu6050_filter_run(&app->filter, block, &app->filter_block);
+        MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_Filter, filter_start);
+        const int16_t* rows[MPU6050_DECIMATOR_CHANNELS] = {
+            filtered->acc[0], filtered->acc[1], filtered->acc[2], block->gyro[0], block->gyro[1], block->gyro[2]};
 
-    const uint8_t row_height = 13; // Ustalona wysokość wiersza
-    uint8_t y_pos;
-    
-    // --- I2C Address Option ---
-    y_pos = 20;
-    if (app->settings_cursor == SettingsItem_Address) {
-        canvas_draw_box(canvas, 0, y_pos - 1, 128, row_height); // Rysuj boks tła
-        canvas_set_color(canvas, ColorWhite);
-    } else {
-        canvas_set_color(canvas, ColorBlack);
+        MPU6050_PROFILE_START(lock_start);
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_LockWait, lock_start);
+        MPU6050_PROFILE_START(process_start);
+        // Every sample goes through the statistics and the trigger, not just the displayed ones
+        app->stats.push(*filtered);
+        mpu6050_trigger_push(&app->trigger, filtered);
+        MPU6050_PROFILE_START(fusion_start);
+        mpu6050_fusion_push(&app->fusion, block);
+        MPU6050_PROFILE_STOP_EACH(&app->profile, Mpu6050ProfileStage_Fusion, fusion_start, block->count);
+        mpu6050_align_push(&app->align[0], block);
+        // The waveform history fills all the time, so the plot opens with data on it
+        mpu6050_decimator_push(
+            &app->decimator, rows, block->count, static_cast<uint32_t>((block->accel_fsr << 4) | block->gyro_fsr));
+        for (int axis = 0; axis < 3; axis++) {
+            app->sensor_data.acc[axis] = block->acc[axis][last];
+            app->sensor_data.gyro[axis] = block->gyro[axis][last];
+        }
+        app->sensor_data.temp = block->temp[last];
+        app->sensor_data.accel_fsr = block->accel_fsr;
+        app->sensor_data.gyro_fsr = block->gyro_fsr;
+        if (app->current_state == AppState_Calibrate) {
+            mpu6050_calibration_push(&app->calibration, block);
+        }
+        MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_Process, process_start);
+        furi_mutex_release(app->mutex);
+
+        if (app->current_state == AppState_Spectrum) {
+            uint32_t count = mpu6050_fir_decimate(
+                &app->spectrum_fir, filtered->acc[app->spectrum_axis], filtered->count, app->spectrum_input);
+            mpu6050_spectrum_push(&app->spectrum, app->spectrum_input, count, filtered->accel_fsr);
+        }
     }
-    canvas_draw_str(canvas, 5, y_pos + 9, "I2C Address:");
-    furi_string_printf(value_str, "0x%02X", app->i2c_address);
-    canvas_draw_str_aligned(canvas, 123, y_pos + 3, AlignRight, AlignTop, furi_string_get_cstr(value_str));
-    if (app->settings_cursor == SettingsItem_Address) {
-        canvas_draw_str(canvas, 1, y_pos + 9, ">");
+
+    // The second sensor only feeds the Dual page
+    ring = app->devices[1].ring;
+    while (ring && ring->pop(*block) > 0) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_align_push(&app->align[1], block);
+        furi_mutex_release(app->mutex);
     }
-    canvas_set_color(canvas, ColorBlack);
+}
 
-    // --- Accel FSR Option ---
-    y_pos = 33;
-    if (app->settings_cursor == SettingsItem_AccelFS) {
-        canvas_draw_box(canvas, 0, y_pos - 1, 128, row_height);
-        canvas_set_color(canvas, ColorWhite);
-    } else {
-        canvas_set_color(canvas, ColorBlack);
+// Share of the last second each sensor's transfers held the bus, for the Dual page
+static void process_bus_load(MPU6050App* app) {
+    uint32_t now = furi_get_tick();
+    uint32_t elapsed_ms = (now - app->bus_load_tick) * 1000 / furi_kernel_get_tick_frequency();
+    if (elapsed_ms < 1000) return;
+
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        uint32_t busy_us = app->devices[i].busy_us;
+        uint32_t pct = (busy_us - app->bus_load_busy_us[i]) / (elapsed_ms * 10);
+        app->bus_load_pct[i] = static_cast<uint8_t>(pct < 100 ? pct : 100);
+        app->bus_load_busy_us[i] = busy_us;
     }
-    const char* accel_fsr_values[] = {"+/- 2g", "+/- 4g", "+/- 8g", "+/- 16g"};
-    canvas_draw_str(canvas, 5, y_pos + 9, "Accel FSR:");
-    canvas_draw_str_aligned(canvas, 123, y_pos + 3, AlignRight, AlignTop, accel_fsr_values[app->accel_fsr_index]);
-    if (app->settings_cursor == SettingsItem_AccelFS) {
-        canvas_draw_str(canvas, 1, y_pos + 9, ">");
+    app->bus_load_tick = now;
+}
+
+// Starts the spectrum over for samples at `sample_rate_hz`, decimated first if
+// Settings ask for it. Called with the mutex held.
+static void spectrum_start(MPU6050App* app, uint32_t sample_rate_hz) {
+    uint8_t decimation = spectrum_decimation[app->spectrum_rate_index];
+    mpu6050_fir_init(&app->spectrum_fir, decimation);
+    mpu6050_spectrum_init(
+        &app->spectrum, static_cast<Mpu6050FftSize>(app->spectrum_size), sample_rate_hz / decimation);
+}
+
+// Advances the spectrum by one loop pass worth of FFT work
+static void process_spectrum(MPU6050App* app) {
+    if (app->spectrum_reset_requested.exchange(false)) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        spectrum_start(app, settings_config(app).sample_rate_hz());
+        furi_mutex_release(app->mutex);
     }
-    canvas_set_color(canvas, ColorBlack);
+    if (app->current_state != AppState_Spectrum) return;
 
-    // --- Gyro FSR Option ---
-    y_pos = 46;
-    if (app->settings_cursor == SettingsItem_GyroFS) {
-        canvas_draw_box(canvas, 0, y_pos - 1, 128, row_height);
-        canvas_set_color(canvas, ColorWhite);
-    } else {
-        canvas_set_color(canvas, ColorBlack);
+    MPU6050_PROFILE_START(fft_start);
+    bool complete = mpu6050_spectrum_process(&app->spectrum, MPU6050_SPECTRUM_BUDGET);
+    MPU6050_PROFILE_STOP(&app->profile, Mpu6050ProfileStage_Spectrum, fft_start);
+    if (complete) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_spectrum_accumulate(&app->spectrum);
+        furi_mutex_release(app->mutex);
     }
-    const char* gyro_fsr_values[] = {"+/- 250", "+/- 500", "+/- 1000", "+/- 2000"};
-    canvas_draw_str(canvas, 5, y_pos + 9, "Gyro FSR:");
-    canvas_draw_str_aligned(canvas, 123, y_pos + 3, AlignRight, AlignTop, gyro_fsr_values[app->gyro_fsr_index]);
-    if (app->settings_cursor == SettingsItem_GyroFS) {
-        canvas_draw_str(canvas, 1, y_pos + 9, ">");
+}
+
+// Runs the calibration screen: restarts it on request, hands the finished
+// measurement to the sampler and saves what the sampler wrote into the chip
+static void process_calibration(MPU6050App* app) {
+    if (app->calibration_start_requested.exchange(false)) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_calibration_init(&app->calibration, settings_config(app).sample_rate_hz());
+        furi_mutex_release(app->mutex);
+        app->calibration_status = CalibrationStatus_Measuring;
+        app->calibration_applied = 0;
     }
-    canvas_set_color(canvas, ColorBlack);
-    
-    furi_string_free(value_str);
+    if (app->current_state != AppState_Calibrate) return;
 
-    // Back button
-    canvas_set_color(canvas, ColorBlack);
-    canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[Ok/Back] Back");
-}
+    if (app->calibration_status == CalibrationStatus_Measuring) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        bool done = app->calibration.state == Mpu6050CalState_Done;
+        if (done) mpu6050_calibration_solve(&app->calibration, &app->calibration_result);
+        furi_mutex_release(app->mutex);
+        if (done) {
+            app->calibration_address = settings_config(app).address;
+            app->calibration_status = CalibrationStatus_Applying;
+            app->calibration_apply_requested = true;
+            furi_thread_flags_set(furi_thread_get_id(app->sampler_thread), MPU6050_SAMPLER_FLAG_CALIBRATE);
+        }
+    }
 
-// Function to draw the about screen
-static void draw_about_screen(Canvas* canvas, MPU6050App* app) {
-    UNUSED(app); 
-    canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "About");
+    int8_t applied = app->calibration_applied.exchange(0);
+    if (applied > 0) {
+        bool saved = mpu6050_offsets_save(app->calibration_address, &app->calibration_offsets);
+        app->calibration_status = saved ? CalibrationStatus_Saved : CalibrationStatus_Unsaved;
+    } else if (applied < 0) {
+        app->calibration_status = CalibrationStatus_Failed;
+    }
+}
 
-    // Zmiana na FontSecondary i lepsze pozycjonowanie, aby zmieścić się na ekranie
-    canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str_aligned(canvas, 64, 20, AlignCenter, AlignTop, "MPU-6050 Reader ");
-    canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignTop, "Accelerometer");
-    canvas_draw_str_aligned(canvas, 64, 40, AlignCenter, AlignTop, "by Dr Mosfet");
-    
-    // Back button
-    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "[Ok/Back] Back");
+#ifdef MPU6050_PROFILE
+// Effective sample rate over the last second and diagnostics dumps; runs on the GUI loop
+static void process_diagnostics(MPU6050App* app) {
+    uint32_t now = furi_get_tick();
+    uint32_t elapsed_ms = (now - app->diag_tick) * 1000 / furi_kernel_get_tick_frequency();
+    if (elapsed_ms >= 1000) {
+        uint32_t samples = app->profile.samples;
+        app->diag_rate_hz = (samples - app->diag_samples) * 1000 / elapsed_ms;
+        app->diag_samples = samples;
+        app->diag_tick = now;
+    }
+    if (app->diag_dump_requested.exchange(false)) {
+        char path[64];
+        app->diag_dump_result = mpu6050_profile_dump(&app->profile, app->diag_rate_hz, path, sizeof(path)) ? 1 : -1;
+    }
 }
+#endif
 
-// Function to draw the max G screen
-static void draw_max_g_screen(Canvas* canvas, MPU6050App* app) {
-    canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str_aligned(canvas, 64, 5, AlignCenter, AlignTop, "Max G Values");
+// Clears the pipeline for a replay that is about to start: the rings lose what
+// the sensors left in them and every consumer starts over at the recording's
+// sample rate. The sampler holds the first block back until this is done.
+static void process_replay(MPU6050App* app) {
+    if (!app->replay_reset_requested) return;
 
-    // Secure access to max G data
+    uint16_t rate = app->replay.header.sample_rate_hz;
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050SampleRing* ring = app->devices[i].ring;
+        if (ring) ring->clear();
+    }
     furi_mutex_acquire(app->mutex, FuriWaitForever);
-    float max_g_x = app->max_g_x;
-    float max_g_y = app->max_g_y;
-    float max_g_z = app->max_g_z;
+    app->stats.init(rate);
+    mpu6050_trigger_init(&app->trigger, app->trigger_config, rate);
+    mpu6050_decimator_reset(&app->decimator);
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) mpu6050_align_reset(&app->align[i]);
+    spectrum_start(app, rate);
+    mpu6050_fusion_init(&app->fusion, static_cast<Mpu6050FusionFilter>(app->fusion_filter), rate);
     furi_mutex_release(app->mutex);
+#ifdef MPU6050_PROFILE
+    mpu6050_profile_reset_stage(&app->profile, Mpu6050ProfileStage_Fusion);
+#endif
+    mpu6050_filter_init(&app->filter, &app->filter_config, rate);
+    app->replay_reset_requested = false;
+}
 
-    canvas_set_font(canvas, FontSecondary);
-    FuriString* g_str = furi_string_alloc();
-    
-    // Draw Max G X
-    canvas_draw_str(canvas, 5, 25, "Max X:");
-    furi_string_printf(g_str, "%.2f g", (double)max_g_x);
-    canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignTop, furi_string_get_cstr(g_str));
-
-    // Draw Max G Y
-    canvas_draw_str(canvas, 5, 35, "Max Y:");
-    furi_string_printf(g_str, "%.2f g", (double)max_g_y);
-    canvas_draw_str_aligned(canvas, 123, 30, AlignRight, AlignTop, furi_string_get_cstr(g_str));
-
-    // Draw Max G Z
-    canvas_draw_str(canvas, 5, 45, "Max Z:");
-    furi_string_printf(g_str, "%.2f g", (double)max_g_z);
-    canvas_draw_str_aligned(canvas, 123, 40, AlignRight, AlignTop, furi_string_get_cstr(g_str));
-    
-    furi_string_free(g_str);
+// Redesigns the filter chain after a Settings change
+static void process_filter(MPU6050App* app) {
+    if (app->filter_reset_requested.exchange(false)) {
+        app->filter_config.corner_hz = filter_corner_hz[app->filter_corner_index];
+        mpu6050_filter_init(&app->filter, &app->filter_config, settings_config(app).sample_rate_hz());
+    }
+}
 
-    // Instructions
-    canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "[Ok] Reset [<] Back");
+// Restarts the orientation under the filter picked on the Tilt page
+static void process_fusion(MPU6050App* app) {
+    if (app->fusion_reset_requested.exchange(false)) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_fusion_init(
+            &app->fusion, static_cast<Mpu6050FusionFilter>(app->fusion_filter), settings_config(app).sample_rate_hz());
+        furi_mutex_release(app->mutex);
+#ifdef MPU6050_PROFILE
+        mpu6050_profile_reset_stage(&app->profile, Mpu6050ProfileStage_Fusion);
+#endif
+    }
 }
 
-// Main drawing function that switches screens
-static void mpu6050_draw_callback(Canvas* canvas, void* context) {
-    furi_assert(context);
-    MPU6050App* app = static_cast<MPU6050App*>(context);
+// Restarts the waveform history after a timebase change
+static void process_plot(MPU6050App* app) {
+    if (app->plot_reset_requested.exchange(false)) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_decimator_init(&app->decimator, plot_samples_per_column[app->plot_timebase]);
+        furi_mutex_release(app->mutex);
+    }
+}
 
-    switch (app->current_state) {
-        case AppState_Main:
-            draw_main_screen(canvas, app);
+// Applies trigger changes and handles event deletion and export; runs on the GUI
+// loop, the only place the event pool is modified
+static void process_events(MPU6050App* app) {
+    if (app->trigger_apply_requested.exchange(false)) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_trigger_configure(&app->trigger, app->trigger_config);
+        furi_mutex_release(app->mutex);
+    }
+
+    int32_t index = app->event_delete_requested.exchange(-1);
+    if (index >= 0) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        mpu6050_trigger_delete(&app->trigger, index);
+        furi_mutex_release(app->mutex);
+    }
+
+    int8_t exported = mpu6050_event_export_poll(&app->event_export);
+    if (exported) app->event_export_result = exported;
+    // Nothing else writes the pool, so it is copied without the mutex held; a
+    // request during an export waits for it to finish
+    if (app->event_export_requested && mpu6050_event_export_start(&app->event_export, &app->trigger)) {
+        app->event_export_requested = false;
+    }
+}
+
+// Steps the selected trigger setting; the GUI loop applies it
+static void trigger_setting_step(MPU6050App* app, int8_t direction) {
+    Mpu6050TriggerConfig* config = &app->trigger_config;
+    const uint16_t* options = NULL;
+    uint8_t option_count = 0;
+    uint16_t* value = NULL;
+
+    switch (app->trigger_cursor) {
+        case TriggerItem_Mode:
+            config->mode = (config->mode + Mpu6050TriggerMode_Count + direction) % Mpu6050TriggerMode_Count;
             break;
-        case AppState_Settings:
-            draw_settings_screen(canvas, app);
+        case TriggerItem_Source:
+            config->source = (config->source + Mpu6050TriggerSource_Count + direction) % Mpu6050TriggerSource_Count;
             break;
-        case AppState_About:
-            draw_about_screen(canvas, app);
+        case TriggerItem_Edge:
+            config->edge = (config->edge + 1) % Mpu6050TriggerEdge_Count;
             break;
-        case AppState_MaxG:
-            draw_max_g_screen(canvas, app);
+        case TriggerItem_Level:
+            config->level_mg += direction * MPU6050_TRIGGER_LEVEL_STEP_MG;
+            if (config->level_mg > MPU6050_TRIGGER_LEVEL_MAX_MG) config->level_mg = MPU6050_TRIGGER_LEVEL_MAX_MG;
+            if (config->level_mg < -MPU6050_TRIGGER_LEVEL_MAX_MG) config->level_mg = -MPU6050_TRIGGER_LEVEL_MAX_MG;
+            break;
+        case TriggerItem_Pre:
+            options = trigger_pre_ms;
+            option_count = COUNT_OF(trigger_pre_ms);
+            value = &config->pre_ms;
+            break;
+        default:
+            options = trigger_holdoff_ms;
+            option_count = COUNT_OF(trigger_holdoff_ms);
+            value = &config->holdoff_ms;
             break;
     }
+    if (options) {
+        uint8_t current = 0;
+        while (current < option_count - 1 && options[current] < *value) current++;
+        *value = options[(current + option_count + direction) % option_count];
+    }
+    app->trigger_apply_requested = true;
 }
 
-// Function to configure the MPU-6050 sensor
-static bool init_mpu6050(MPU6050App* app) {
-    // 1. Reset the device
-    uint8_t reset_cmd[] = {MPU6050_REG_PWR_MGMT_1, MPU6050_RESET};
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-    bool success = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        reset_cmd,
-        sizeof(reset_cmd),
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndStop,
-        MPU6050_I2C_TIMEOUT);
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    if (!success) return false;
-    furi_delay_ms(100); // Wait for reset to complete
-
-    // 2. Wake up and set clock source
-    uint8_t pwr_mgmt_cmd[] = {MPU6050_REG_PWR_MGMT_1, MPU6050_CLOCK_SEL_PLL_XG};
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-    success = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        pwr_mgmt_cmd,
-        sizeof(pwr_mgmt_cmd),
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndStop,
-        MPU6050_I2C_TIMEOUT);
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    if (!success) return false;
-
-    // 3. Set Sample Rate Divider to 0 (1kHz sample rate)
-    uint8_t smplrt_cmd[] = {MPU6050_REG_SMPLRT_DIV, 0x00};
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-    success = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        smplrt_cmd,
-        sizeof(smplrt_cmd),
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndStop,
-        MPU6050_I2C_TIMEOUT);
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    if (!success) return false;
-
-    // 4. Set Configuration (DLPF)
-    uint8_t config_cmd[] = {MPU6050_REG_CONFIG, MPU6050_DLPF_CFG_20HZ};
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-    success = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        config_cmd,
-        sizeof(config_cmd),
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndStop,
-        MPU6050_I2C_TIMEOUT);
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    if (!success) return false;
-
-    // 5. Set Accelerometer Configuration (FSR)
-    uint8_t accel_fsr = app->accel_fsr_index << 3; // Shift index to the correct bit position
-    uint8_t accel_config_cmd[] = {MPU6050_REG_ACCEL_CONFIG, accel_fsr};
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-    success = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        accel_config_cmd,
-        sizeof(accel_config_cmd),
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndStop,
-        MPU6050_I2C_TIMEOUT);
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    if (!success) return false;
-
-    // 6. Set Gyroscope Configuration (FSR)
-    uint8_t gyro_fsr = app->gyro_fsr_index << 3; // Shift index to the correct bit position
-    uint8_t gyro_config_cmd[] = {MPU6050_REG_GYRO_CONFIG, gyro_fsr};
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-    success = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        gyro_config_cmd,
-        sizeof(gyro_config_cmd),
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndStop,
-        MPU6050_I2C_TIMEOUT);
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    return success;
-}
-
-// Function to calculate the accelerometer sensitivity scale factor (LSB/g)
-static float get_accel_sensitivity(uint8_t accel_fsr_index) {
-    // FSR values: 0=+/-2g, 1=+/-4g, 2=+/-8g, 3=+/-16g
-    float sensitivity[] = {16384.0f, 8192.0f, 4096.0f, 2048.0f};
-    if (accel_fsr_index < sizeof(sensitivity) / sizeof(sensitivity[0])) {
-        return sensitivity[accel_fsr_index];
-    }
-    return 8192.0f; // Default for +/- 4g (index 1)
-}
-
-// Function to read data from the sensor
-static bool read_mpu6050(MPU6050App* app) {
-    uint8_t raw_data[14]; // Accel X, Y, Z, Temp, Gyro X, Y, Z (2 bytes each)
-    uint8_t reg_addr = MPU6050_REG_ACCEL_XOUT_H;
-
-    // Acquire I2C bus access
-    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
-
-    // Send register address to start reading from
-    bool success_tx = furi_hal_i2c_tx_ext(
-        &furi_hal_i2c_handle_external,
-        app->i2c_address << 1,
-        false,
-        &reg_addr,
-        1,
-        FuriHalI2cBeginStart,
-        FuriHalI2cEndAwaitRestart,
-        MPU6050_I2C_TIMEOUT);
-
-    // Read 14 bytes (Accel, Temp, Gyro)
-    bool success_rx = false;
-    if (success_tx) {
-        success_rx = furi_hal_i2c_rx_ext(
-            &furi_hal_i2c_handle_external,
-            app->i2c_address << 1,
-            false,
-            raw_data,
-            14,
-            FuriHalI2cBeginRestart,
-            FuriHalI2cEndStop,
-            MPU6050_I2C_TIMEOUT);
-    }
-
-    // Release I2C bus
-    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
-
-    if (success_tx && success_rx) {
-        // Data is received as MSB first
-        int16_t raw_acc_x = (static_cast<int16_t>(raw_data[0]) << 8) | raw_data[1];
-        int16_t raw_acc_y = (static_cast<int16_t>(raw_data[2]) << 8) | raw_data[3];
-        int16_t raw_acc_z = (static_cast<int16_t>(raw_data[4]) << 8) | raw_data[5]; 
-        
-        furi_mutex_acquire(app->mutex, FuriWaitForever);
-        app->sensor_data.acc_x = raw_acc_x;
-        app->sensor_data.acc_y = raw_acc_y;
-        app->sensor_data.acc_z = raw_acc_z;
-        
-        // Calculate G values
-        float sensitivity = get_accel_sensitivity(app->accel_fsr_index);
-        app->sensor_data.acc_g_x = (float)raw_acc_x / sensitivity;
-        app->sensor_data.acc_g_y = (float)raw_acc_y / sensitivity;
-        app->sensor_data.acc_g_z = (float)raw_acc_z / sensitivity;
-
-        // Update max G values for each axis (using absolute values)
-        if (fabsf(app->sensor_data.acc_g_x) > app->max_g_x) {
-            app->max_g_x = fabsf(app->sensor_data.acc_g_x);
-        }
-        if (fabsf(app->sensor_data.acc_g_y) > app->max_g_y) {
-            app->max_g_y = fabsf(app->sensor_data.acc_g_y);
-        }
-        if (fabsf(app->sensor_data.acc_g_z) > app->max_g_z) {
-            app->max_g_z = fabsf(app->sensor_data.acc_g_z);
-        }
-
-        app->is_sensor_initialized = true;
-        furi_mutex_release(app->mutex);
-        return true;
+// Starts or stops recording; file creation may block, so this runs on the GUI loop
+static void toggle_recording(MPU6050App* app) {
+    if (mpu6050_logger_is_recording(&app->logger)) {
+        mpu6050_logger_stop(&app->logger);
+    } else {
+        mpu6050_logger_start(&app->logger, settings_config(app));
+        app->record_failed = false;
     }
+}
 
-    furi_mutex_acquire(app->mutex, FuriWaitForever);
-    app->is_sensor_initialized = false;
-    furi_mutex_release(app->mutex);
-    return false;
+// Starts or stops the USB stream; switching the USB configuration may block, so
+// this runs on the GUI loop
+static void toggle_streaming(MPU6050App* app) {
+    if (mpu6050_streamer_is_streaming(&app->streamer)) {
+        mpu6050_streamer_stop(&app->streamer);
+    } else {
+        app->stream_failed = !mpu6050_streamer_start(&app->streamer);
+    }
 }
 
 // Function to handle input events (keys)
 static void mpu6050_input_callback(InputEvent* input_event, void* context) {
     furi_assert(context);
     MPU6050App* app = static_cast<MPU6050App*>(context);
+    // Every key may change the screen; draw the next frame whatever it shows
+    mpu6050_frame_invalidate(&app->frames);
 
-    if (input_event->type == InputTypeShort) {
+    if (input_event->type == InputTypeLong && input_event->key == InputKeyOk &&
+        app->current_state == AppState_Main) {
+        // Long OK opens the vibration spectrum
+        app->current_state = AppState_Spectrum;
+        app->spectrum_reset_requested = true;
+#ifdef MPU6050_PROFILE
+    } else if (input_event->type == InputTypeLong && input_event->key == InputKeyOk &&
+               app->current_state == AppState_Diagnostics) {
+        // Long OK writes every stage and counter to the SD card
+        app->diag_dump_requested = true;
+#endif
+    } else if (input_event->type == InputTypeLong && input_event->key == InputKeyOk &&
+               app->current_state == AppState_Events) {
+        // Long OK saves every captured event to the SD card
+        app->event_export_requested = true;
+    } else if (input_event->type == InputTypeRepeat && app->current_state == AppState_Events &&
+               !app->events_browsing && (input_event->key == InputKeyLeft || input_event->key == InputKeyRight)) {
+        // Holding left/right sweeps the level
+        trigger_setting_step(app, input_event->key == InputKeyRight ? 1 : -1);
+    } else if (input_event->type == InputTypeShort) {
         switch (app->current_state) {
             case AppState_Main:
-                if (input_event->key == InputKeyOk) {
+                if (input_event->key == InputKeyOk && app->main_page == MainPage_Record) {
+                    app->record_toggle_requested = true;
+                } else if (input_event->key == InputKeyOk && app->main_page == MainPage_Stream) {
+                    app->stream_toggle_requested = true;
+                } else if (input_event->key == InputKeyOk && app->main_page == MainPage_Tilt) {
+                    // Other filter, started over from the accelerometer; also zeroes yaw
+                    app->fusion_filter = (app->fusion_filter + 1) % Mpu6050FusionFilter_Count;
+                    app->fusion_reset_requested = true;
+                } else if (input_event->key == InputKeyOk && app->main_page == MainPage_Replay) {
+                    app->replay_toggle_requested = true;
+                    furi_thread_flags_set(furi_thread_get_id(app->sampler_thread), MPU6050_SAMPLER_FLAG_REPLAY);
+                } else if (input_event->key == InputKeyOk && app->main_page == MainPage_Plot) {
+                    app->current_state = AppState_Plot;
+                } else if (input_event->key == InputKeyOk && app->main_page == MainPage_Events) {
+                    app->current_state = AppState_Events;
+                    app->events_browsing = false;
+                    app->event_export_result = 0;
+                } else if (input_event->key == InputKeyOk) {
                     app->current_state = AppState_MaxG; // Changed to Max G submenu
                 } else if (input_event->key == InputKeyBack) {
                     app->running = false;
@@ -461,6 +2447,10 @@ static void mpu6050_input_callback(InputEvent* input_event, void* context) {
                     app->current_state = AppState_About;
                 } else if (input_event->key == InputKeyLeft) {
                     app->current_state = AppState_Settings;
+                } else if (input_event->key == InputKeyDown) {
+                    app->main_page = (app->main_page + 1) % MainPage_Count;
+                } else if (input_event->key == InputKeyUp) {
+                    app->main_page = (app->main_page + MainPage_Count - 1) % MainPage_Count;
                 }
                 break;
             case AppState_Settings:
@@ -472,7 +2462,41 @@ static void mpu6050_input_callback(InputEvent* input_event, void* context) {
                     if (app->settings_cursor < SettingsItem_Count - 1) {
                         app->settings_cursor++;
                     }
+                } else if (input_event->key == InputKeyOk && app->settings_cursor == SettingsItem_Calibrate) {
+                    app->current_state = AppState_Calibrate;
+                    app->calibrating = true;
+                    app->calibration_start_requested = true;
                 } else if (input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                    if (app->settings_cursor == SettingsItem_Calibrate) break;
+                    if (app->settings_cursor == SettingsItem_Replay) {
+                        // Taken by the next replay; nothing to apply to the sensors
+                        int direction = input_event->key == InputKeyLeft ? -1 : 1;
+                        app->replay_speed =
+                            (app->replay_speed + Mpu6050ReplaySpeed_Count + direction) % Mpu6050ReplaySpeed_Count;
+                        break;
+                    }
+                    uint8_t cursor = app->settings_cursor;
+                    if (cursor >= SettingsItem_Filter && cursor <= SettingsItem_SpectrumRate) {
+                        // Processing on the GUI loop; nothing to apply to the sensors
+                        int direction = input_event->key == InputKeyLeft ? -1 : 1;
+                        if (cursor == SettingsItem_Filter) {
+                            uint8_t type = app->filter_config.type;
+                            app->filter_config.type = (type + Mpu6050FilterType_Count + direction) % Mpu6050FilterType_Count;
+                        } else if (cursor == SettingsItem_FilterCorner) {
+                            uint8_t index = app->filter_corner_index;
+                            app->filter_corner_index = (index + MPU6050_FILTER_CORNERS + direction) % MPU6050_FILTER_CORNERS;
+                        } else if (cursor == SettingsItem_FilterOrder) {
+                            uint8_t stage_index = app->filter_config.stages - 1;
+                            app->filter_config.stages =
+                                (stage_index + MPU6050_FILTER_MAX_STAGES + direction) % MPU6050_FILTER_MAX_STAGES + 1;
+                        } else {
+                            uint8_t index = app->spectrum_rate_index;
+                            app->spectrum_rate_index = (index + MPU6050_SPECTRUM_RATES + direction) % MPU6050_SPECTRUM_RATES;
+                            app->spectrum_reset_requested = true;
+                        }
+                        app->filter_reset_requested = true;
+                        break;
+                    }
                     if (app->settings_cursor == SettingsItem_Address) {
                         // Change I2C Address (typically 0x68 or 0x69)
                         if (input_event->key == InputKeyLeft) {
@@ -494,9 +2518,19 @@ static void mpu6050_input_callback(InputEvent* input_event, void* context) {
                         } else {
                             app->gyro_fsr_index = (app->gyro_fsr_index == 3) ? 0 : app->gyro_fsr_index + 1;
                         }
+                    } else if (app->settings_cursor == SettingsItem_Dlpf) {
+                        int direction = input_event->key == InputKeyLeft ? -1 : 1;
+                        app->dlpf_index = (app->dlpf_index + MPU6050_DLPF_CHOICES + direction) % MPU6050_DLPF_CHOICES;
+                    } else {
+                        uint8_t* index = app->settings_cursor == SettingsItem_LowPower ? &app->power_idle_index :
+                                                                                         &app->power_motion_index;
+                        int direction = input_event->key == InputKeyLeft ? -1 : 1;
+                        *index = (*index + MPU6050_POWER_CHOICES + direction) % MPU6050_POWER_CHOICES;
                     }
-                    // Apply new settings after changing a value
-                    init_mpu6050(app);
+                    // Apply new settings after changing a value (on the sampler thread)
+                    app->reconfigure_requested = true;
+                    furi_thread_flags_set(
+                        furi_thread_get_id(app->sampler_thread), MPU6050_SAMPLER_FLAG_RECONFIGURE);
                 } else if (input_event->key == InputKeyOk || input_event->key == InputKeyBack) {
                     app->current_state = AppState_Main;
                 }
@@ -504,16 +2538,129 @@ static void mpu6050_input_callback(InputEvent* input_event, void* context) {
             case AppState_About:
                 if (input_event->key == InputKeyOk || input_event->key == InputKeyBack) {
                     app->current_state = AppState_Main;
+#ifdef MPU6050_PROFILE
+                } else if (input_event->key == InputKeyRight) {
+                    app->current_state = AppState_Diagnostics;
+                    app->diag_dump_result = 0;
+#endif
+                }
+                break;
+#ifdef MPU6050_PROFILE
+            case AppState_Diagnostics:
+                if (input_event->key == InputKeyRight) {
+                    app->diag_page = (app->diag_page + 1) % DiagPage_Count;
+                } else if (input_event->key == InputKeyLeft) {
+                    app->diag_page = (app->diag_page + DiagPage_Count - 1) % DiagPage_Count;
+                } else if (input_event->key == InputKeyOk) {
+                    mpu6050_profile_reset(&app->profile);
+                    app->diag_dump_result = 0;
+                } else if (input_event->key == InputKeyBack) {
+                    app->current_state = AppState_About;
+                }
+                break;
+#endif
+            case AppState_Calibrate:
+                if (input_event->key == InputKeyBack) {
+                    app->current_state = AppState_Settings;
+                    app->calibrating = false;
+                } else if (input_event->key == InputKeyOk && app->calibration_status == CalibrationStatus_Measuring) {
+                    // The sensor is in place: measure this pose
+                    furi_mutex_acquire(app->mutex, FuriWaitForever);
+                    if (app->calibration.state == Mpu6050CalState_Waiting ||
+                        app->calibration.state == Mpu6050CalState_Rejected) {
+                        mpu6050_calibration_measure(&app->calibration);
+                    }
+                    furi_mutex_release(app->mutex);
+                } else if (input_event->key == InputKeyOk && app->calibration_status != CalibrationStatus_Applying) {
+                    app->calibration_start_requested = true;
                 }
                 break;
             case AppState_MaxG:
                 if (input_event->key == InputKeyOk) {
-                    // Reset max G values
+                    // Restart every window
+                    furi_mutex_acquire(app->mutex, FuriWaitForever);
+                    app->stats.reset();
+                    furi_mutex_release(app->mutex);
+                } else if (input_event->key == InputKeyRight) {
+                    app->stats_page = (app->stats_page + 1) % StatsPage_Count;
+                } else if (input_event->key == InputKeyLeft) {
+                    app->stats_page = (app->stats_page + StatsPage_Count - 1) % StatsPage_Count;
+                } else if (input_event->key == InputKeyUp) {
+                    app->stats_window = (app->stats_window + 1) % Mpu6050StatsWindow_Count;
+                } else if (input_event->key == InputKeyDown) {
+                    app->stats_window = (app->stats_window + Mpu6050StatsWindow_Count - 1) % Mpu6050StatsWindow_Count;
+                } else if (input_event->key == InputKeyBack) {
+                    app->current_state = AppState_Main;
+                }
+                break;
+            case AppState_Spectrum:
+                if (input_event->key == InputKeyUp) {
+                    app->spectrum_size = (app->spectrum_size + 1) % Mpu6050FftSize_Count;
+                } else if (input_event->key == InputKeyDown) {
+                    app->spectrum_size = (app->spectrum_size + Mpu6050FftSize_Count - 1) % Mpu6050FftSize_Count;
+                } else if (input_event->key == InputKeyRight) {
+                    app->spectrum_axis = (app->spectrum_axis + 1) % 3;
+                } else if (input_event->key == InputKeyLeft) {
+                    app->spectrum_axis = (app->spectrum_axis + 2) % 3;
+                } else if (input_event->key == InputKeyBack) {
+                    app->current_state = AppState_Main;
+                    break;
+                }
+                // Any change (or OK) restarts the average
+                app->spectrum_reset_requested = true;
+                break;
+            case AppState_Plot:
+                if (input_event->key == InputKeyUp) {
+                    app->plot_view = (app->plot_view + MPU6050_PLOT_VIEWS - 1) % MPU6050_PLOT_VIEWS;
+                } else if (input_event->key == InputKeyDown) {
+                    app->plot_view = (app->plot_view + 1) % MPU6050_PLOT_VIEWS;
+                } else if (input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                    if (input_event->key == InputKeyLeft && app->plot_timebase > 0) {
+                        app->plot_timebase--;
+                    } else if (input_event->key == InputKeyRight &&
+                               app->plot_timebase < COUNT_OF(plot_samples_per_column) - 1) {
+                        app->plot_timebase++;
+                    }
+                    app->plot_reset_requested = true;
+                } else if (input_event->key == InputKeyOk) {
+                    app->plot_auto_scale = !app->plot_auto_scale;
+                } else if (input_event->key == InputKeyBack) {
+                    app->current_state = AppState_Main;
+                }
+                break;
+            case AppState_Events:
+                if (app->events_browsing) {
+                    furi_mutex_acquire(app->mutex, FuriWaitForever);
+                    uint32_t events = mpu6050_trigger_event_count(&app->trigger);
+                    furi_mutex_release(app->mutex);
+                    if (app->event_index >= events) app->event_index = events ? events - 1 : 0;
+
+                    if (input_event->key == InputKeyLeft && app->event_index > 0) {
+                        app->event_index--;
+                    } else if (input_event->key == InputKeyRight && app->event_index + 1u < events) {
+                        app->event_index++;
+                    } else if (input_event->key == InputKeyDown && events) {
+                        app->event_delete_requested = app->event_index;
+                    } else if (input_event->key == InputKeyOk || input_event->key == InputKeyBack) {
+                        app->events_browsing = false;
+                    }
+                } else if (input_event->key == InputKeyUp) {
+                    if (app->trigger_cursor > 0) {
+                        app->trigger_cursor--;
+                    }
+                } else if (input_event->key == InputKeyDown) {
+                    if (app->trigger_cursor < TriggerItem_Count - 1) {
+                        app->trigger_cursor++;
+                    }
+                } else if (input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                    trigger_setting_step(app, input_event->key == InputKeyRight ? 1 : -1);
+                } else if (input_event->key == InputKeyOk) {
+                    // Browse from the newest event
                     furi_mutex_acquire(app->mutex, FuriWaitForever);
-                    app->max_g_x = 0.0f;
-                    app->max_g_y = 0.0f;
-                    app->max_g_z = 0.0f;
+                    uint32_t events = mpu6050_trigger_event_count(&app->trigger);
                     furi_mutex_release(app->mutex);
+                    app->event_index = events ? events - 1 : 0;
+                    app->events_browsing = true;
                 } else if (input_event->key == InputKeyBack) {
                     app->current_state = AppState_Main;
                 }
@@ -522,10 +2669,83 @@ static void mpu6050_input_callback(InputEvent* input_event, void* context) {
     }
 }
 
+// Settings and sensor profiles of the last run, in place of the defaults. A
+// file with any value out of range is ignored as a whole.
+static void settings_restore(MPU6050App* app) {
+    Mpu6050Settings settings;
+    if (!mpu6050_settings_load(&settings)) return;
+    if ((settings.i2c_address != MPU6050_I2C_ADDR && settings.i2c_address != MPU6050_I2C_ADDR_ALT) ||
+        settings.accel_fsr > 3 || settings.gyro_fsr > 3 || settings.dlpf >= MPU6050_DLPF_CHOICES ||
+        settings.filter_type >= Mpu6050FilterType_Count || settings.filter_stages < 1 ||
+        settings.filter_stages > MPU6050_FILTER_MAX_STAGES || settings.filter_corner_index >= MPU6050_FILTER_CORNERS ||
+        settings.spectrum_rate_index >= MPU6050_SPECTRUM_RATES || settings.power_idle_index >= MPU6050_POWER_CHOICES ||
+        settings.power_motion_index >= MPU6050_POWER_CHOICES || settings.replay_speed >= Mpu6050ReplaySpeed_Count) {
+        return;
+    }
+
+    app->i2c_address = settings.i2c_address;
+    app->accel_fsr_index = settings.accel_fsr;
+    app->gyro_fsr_index = settings.gyro_fsr;
+    app->dlpf_index = settings.dlpf;
+    app->sensor_data.accel_fsr = settings.accel_fsr;
+    app->sensor_data.gyro_fsr = settings.gyro_fsr;
+    app->filter_config.type = static_cast<Mpu6050FilterType>(settings.filter_type);
+    app->filter_config.stages = settings.filter_stages;
+    app->filter_corner_index = settings.filter_corner_index;
+    app->filter_config.corner_hz = filter_corner_hz[app->filter_corner_index];
+    app->spectrum_rate_index = settings.spectrum_rate_index;
+    app->power_idle_index = settings.power_idle_index;
+    app->power_motion_index = settings.power_motion_index;
+    app->replay_speed = settings.replay_speed;
+    memcpy(app->profiles, settings.profiles, sizeof(app->profiles));
+}
+
+// Puts the sensors to sleep for the time the app is closed. They keep their
+// configuration, so the next launch wakes them with Mpu6050::resume(); one that
+// did not take the write has no profile saved and is reset then.
+static void park_mpu6050(MPU6050App* app) {
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (device->initialized && !device->sensor.sleep()) device->initialized = false;
+    }
+}
+
+// Saves the Settings for the next run, with the profile of every sensor left
+// asleep from full rate; one in motion wake or mid bring-up starts cold. Runs
+// once the sampler has stopped.
+static void settings_store(MPU6050App* app) {
+    Mpu6050Settings settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.i2c_address = app->i2c_address;
+    settings.accel_fsr = app->accel_fsr_index;
+    settings.gyro_fsr = app->gyro_fsr_index;
+    settings.dlpf = app->dlpf_index;
+    settings.filter_type = app->filter_config.type;
+    settings.filter_stages = app->filter_config.stages;
+    settings.filter_corner_index = app->filter_corner_index;
+    settings.spectrum_rate_index = app->spectrum_rate_index;
+    settings.power_idle_index = app->power_idle_index;
+    settings.power_motion_index = app->power_motion_index;
+    settings.replay_speed = app->replay_speed;
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050Device* device = &app->devices[i];
+        if (!device->initialized || device->sensor.in_motion_wake()) continue;
+        Mpu6050DeviceProfile* profile = &settings.profiles[device->sensor.config().address - MPU6050_I2C_ADDR];
+        profile->valid = true;
+        profile->who_am_i = device->sensor.who_am_i();
+        device->sensor.config().config_block(profile->config);
+    }
+    mpu6050_settings_save(&settings);
+}
+
 // Application allocation and initialization
 static MPU6050App* mpu6050_app_alloc() {
-    MPU6050App* app = static_cast<MPU6050App*>(malloc(sizeof(MPU6050App)));
+    // Value-initialise so the atomics are constructed and the rings start NULL
+    MPU6050App* app = new (malloc(sizeof(MPU6050App))) MPU6050App();
     furi_assert(app);
+#ifdef MPU6050_PROFILE
+    app->launch_ms = tick_now_ms();
+#endif
     app->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     app->gui = static_cast<Gui*>(furi_record_open(RECORD_GUI));
     app->view_port = view_port_alloc();
@@ -534,19 +2754,81 @@ static MPU6050App* mpu6050_app_alloc() {
     gui_add_view_port(app->gui, app->view_port, GuiLayerFullscreen);
     app->running = true;
     app->current_state = AppState_Main;
-    app->is_sensor_initialized = false;
     
     // Initialize sensor data
-    app->sensor_data = (Mpu6050Data){0, 0, 0, 0.0f, 0.0f, 0.0f};
-    app->max_g_x = 0.0f; // Initialize max G values
-    app->max_g_y = 0.0f;
-    app->max_g_z = 0.0f;
+    memset(&app->sensor_data, 0, sizeof(app->sensor_data));
+    app->sensor_data.accel_fsr = mpu6050_default_config.accel_fsr;
+    app->sensor_data.gyro_fsr = mpu6050_default_config.gyro_fsr;
+    app->main_page = MainPage_Accel;
+    app->stats.init(mpu6050_default_config.sample_rate_hz()); // Max G screen statistics
+    app->stats_window = Mpu6050StatsWindow_1s;
+    app->stats_page = StatsPage_Range;
 
     // Settings initialization
     app->settings_cursor = SettingsItem_Address;
     app->i2c_address = MPU6050_I2C_ADDR;
-    app->accel_fsr_index = 1; // Default +/- 4g, index 1
-    app->gyro_fsr_index = 1;  // Default +/- 500 deg/s, index 1
+    app->accel_fsr_index = mpu6050_default_config.accel_fsr; // Default +/- 4g, index 1
+    app->gyro_fsr_index = mpu6050_default_config.gyro_fsr;   // Default +/- 500 deg/s, index 1
+    app->dlpf_index = mpu6050_default_config.dlpf;           // Default 20 Hz
+    app->power_idle_index = 0;
+    app->power_motion_index = 1;
+    app->replay_speed = Mpu6050ReplaySpeed_1x;
+    app->filter_config.type = Mpu6050FilterType_Off;
+    app->filter_config.stages = 2;
+    app->filter_corner_index = 3; // 10 Hz
+    app->filter_config.corner_hz = filter_corner_hz[app->filter_corner_index];
+    app->spectrum_rate_index = 0;
+    settings_restore(app);
+    Mpu6050PowerConfig power_config = settings_power_config(app);
+    mpu6050_power_init(&app->power, &power_config, tick_now_ms());
+
+    mpu6050_filter_init(&app->filter, &app->filter_config, settings_config(app).sample_rate_hz());
+
+    app->spectrum_size = Mpu6050FftSize_512;
+    app->spectrum_axis = 2; // Z: normal to the board, usually the vibrating one
+    spectrum_start(app, settings_config(app).sample_rate_hz());
+
+    app->trigger_config = trigger_default_config;
+    mpu6050_trigger_init(&app->trigger, app->trigger_config, mpu6050_default_config.sample_rate_hz());
+    app->event_delete_requested = -1;
+    app->trigger_cursor = TriggerItem_Mode;
+
+    app->fusion_filter = Mpu6050FusionFilter_Madgwick;
+    mpu6050_fusion_init(
+        &app->fusion, static_cast<Mpu6050FusionFilter>(app->fusion_filter), mpu6050_default_config.sample_rate_hz());
+
+    app->plot_view = 3;     // Accel X Y Z
+    app->plot_timebase = 3; // 8 samples per column, about 1 s per screen at 1 kHz
+    app->plot_auto_scale = true;
+    mpu6050_decimator_init(&app->decimator, plot_samples_per_column[app->plot_timebase]);
+
+    mpu6050_frame_scheduler_init(&app->frames, MPU6050_MAX_FPS);
+
+    // Calibrations saved by earlier runs, restored by every sensor init
+    for (size_t slot = 0; slot < 2; slot++) {
+        app->has_stored_offsets[slot] = mpu6050_offsets_load(MPU6050_I2C_ADDR + slot, &app->stored_offsets[slot]);
+    }
+    mpu6050_calibration_init(&app->calibration, mpu6050_default_config.sample_rate_hz());
+
+    // Sensor bus on the external I2C header
+#ifdef MPU6050_PROFILE
+    mpu6050_profile_init(&app->profile);
+    mpu6050_bus_init_external(&app->i2c_bus);
+    mpu6050_profile_bind_bus(&app->profile, &app->i2c_bus, &app->bus);
+    app->diag_tick = furi_get_tick();
+#else
+    mpu6050_bus_init_external(&app->bus);
+#endif
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        app->devices[i].sensor.bind(&app->bus);
+        mpu6050_link_init(
+            &app->devices[i].link, i ? MPU6050_ALT_BACKOFF_MAX_MS : MPU6050_MAIN_BACKOFF_MAX_MS, tick_now_ms());
+        mpu6050_timebase_init(&app->devices[i].timebase, device_config(app, i).sample_rate_hz());
+    }
+
+    app->sampler_thread =
+        furi_thread_alloc_ex("Mpu6050Sampler", MPU6050_SAMPLER_STACK_SIZE, mpu6050_sampler_thread, app);
+    furi_thread_set_priority(app->sampler_thread, FuriThreadPriorityHigh);
     
     return app;
 }
@@ -554,10 +2836,18 @@ static MPU6050App* mpu6050_app_alloc() {
 // Free resources
 static void mpu6050_app_free(MPU6050App* app) {
     furi_assert(app);
+    furi_thread_free(app->sampler_thread);
     gui_remove_view_port(app->gui, app->view_port);
     view_port_free(app->view_port);
     furi_record_close(RECORD_GUI);
     furi_mutex_free(app->mutex);
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        Mpu6050SampleRing* ring = app->devices[i].ring;
+        if (!ring) continue;
+        ring->~Mpu6050SampleRing();
+        free(ring);
+    }
+    app->~MPU6050App();
     free(app);
 }
 
@@ -565,20 +2855,57 @@ static void mpu6050_app_free(MPU6050App* app) {
 extern "C" int32_t mpu6050_reader_app(void* p) { 
     UNUSED(p);
     MPU6050App* app = mpu6050_app_alloc();
+    furi_thread_start(app->sampler_thread);
 
-
-    
+    // Sampling runs on its own thread; this loop consumes every pass and draws
+    // only when a frame is due and the screen would change
+    MPU6050_PROFILE_START(last_pass);
     while (app->running) {
-        if(!app->is_sensor_initialized) {
-            app->is_sensor_initialized = init_mpu6050(app);
+        MPU6050_PROFILE_PERIOD(&app->profile, Mpu6050ProfileStage_LoopPeriod, last_pass);
+        if (app->record_toggle_requested.exchange(false)) {
+            toggle_recording(app);
         }
-
-        if(app->is_sensor_initialized) {
-            read_mpu6050(app);
+        if (mpu6050_logger_failed(&app->logger)) {
+            // The writer could not create the file; the recording ends here
+            mpu6050_logger_stop(&app->logger);
+            app->record_failed = true;
         }
+        if (app->stream_toggle_requested.exchange(false)) {
+            toggle_streaming(app);
+        }
+        process_replay(app);
+        process_filter(app);
+        consume_samples(app);
+        process_spectrum(app);
+        process_events(app);
+        process_plot(app);
+        process_fusion(app);
+        process_calibration(app);
+        process_bus_load(app);
+#ifdef MPU6050_PROFILE
+        process_diagnostics(app);
+#endif
+        if (mpu6050_frame_due(&app->frames, frame_signature(app))) {
+            view_port_update(app->view_port);
+        }
+        if (replay_unpaced(app)) {
+            furi_thread_yield();
+            continue;
+        }
+        // Nothing arrives while idle; input still draws within one pass
+        bool idle = mpu6050_power_is_idle(&app->power) && !mpu6050_replay_is_playing(&app->replay);
+        furi_delay_ms(idle ? MPU6050_IDLE_LOOP_PERIOD_MS : MPU6050_LOOP_PERIOD_MS);
+    }
 
-        view_port_update(app->view_port);
-        furi_delay_ms(100); 
+    furi_thread_join(app->sampler_thread);
+    park_mpu6050(app);
+    settings_store(app);
+    mpu6050_replay_stop(&app->replay);
+    consume_samples(app); // Record what the sampler queued before it stopped
+    mpu6050_logger_stop(&app->logger);
+    mpu6050_streamer_stop(&app->streamer);
+    while (app->event_export.thread && !mpu6050_event_export_poll(&app->event_export)) {
+        furi_delay_ms(10);
     }
     
     mpu6050_app_free(app);
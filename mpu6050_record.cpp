@@ -0,0 +1,71 @@
+#include "mpu6050_record.h"
+#include <storage/storage.h>
+#include "mpu6050_logger.h"
+
+// Larger than any payload the app stores
+#define MPU6050_RECORD_MAX_SIZE 64
+
+static uint8_t record_check(const uint8_t* data, size_t size) {
+    uint8_t check = 0;
+    for (size_t i = 0; i < size; i++) check ^= data[i];
+    return check;
+}
+
+bool mpu6050_record_save(const char* path, uint16_t magic, uint8_t version, const uint8_t* payload, size_t size) {
+    uint8_t data[MPU6050_RECORD_MAX_SIZE];
+    size_t length = size + MPU6050_RECORD_OVERHEAD;
+    if (length > sizeof(data)) return false;
+    data[0] = magic & 0xFF;
+    data[1] = magic >> 8;
+    data[2] = version;
+    data[3] = static_cast<uint8_t>(length);
+    memcpy(&data[4], payload, size);
+    data[length - 1] = record_check(data, length - 1);
+
+    Storage* storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    storage_simply_mkdir(storage, MPU6050_LOG_DIR);
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if (ok) {
+        ok = storage_file_write(file, data, length) == length;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+bool mpu6050_record_load(const char* path, uint16_t magic, uint8_t version, uint8_t* payload, size_t size) {
+    uint8_t data[MPU6050_RECORD_MAX_SIZE];
+    size_t length = size + MPU6050_RECORD_OVERHEAD;
+    if (length > sizeof(data)) return false;
+
+    Storage* storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
+    if (ok) {
+        ok = storage_file_read(file, data, length) == length;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    if (!ok) return false;
+
+    if (data[0] != (magic & 0xFF) || data[1] != (magic >> 8) || data[2] != version || data[3] != length ||
+        data[length - 1] != record_check(data, length - 1)) {
+        return false;
+    }
+    memcpy(payload, &data[4], size);
+    return true;
+}
+
+uint8_t* mpu6050_record_put16(uint8_t* data, int16_t value) {
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+    return data + 2;
+}
+
+const uint8_t* mpu6050_record_get16(const uint8_t* data, int16_t* value) {
+    *value = static_cast<int16_t>(data[0] | (data[1] << 8));
+    return data + 2;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Small fixed-size files the app keeps in MPU6050_LOG_DIR, the settings and
+// the calibration: magic, version, file length, the payload, then an XOR of
+// everything before it. A file that fails any of these reads as missing.
+
+#define MPU6050_RECORD_OVERHEAD 5 // Header and check around the payload
+
+bool mpu6050_record_save(const char* path, uint16_t magic, uint8_t version, const uint8_t* payload, size_t size);
+
+// False, with `payload` untouched, when there is no valid file of `size` bytes
+bool mpu6050_record_load(const char* path, uint16_t magic, uint8_t version, uint8_t* payload, size_t size);
+
+// Little-endian int16 packing; each returns the position after the value
+uint8_t* mpu6050_record_put16(uint8_t* data, int16_t value);
+const uint8_t* mpu6050_record_get16(const uint8_t* data, int16_t* value);
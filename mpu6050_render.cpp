@@ -0,0 +1,91 @@
+#include "mpu6050_render.h"
+
+static const int32_t render_decimal_step[4] = {1000, 100, 10, 1};
+
+void mpu6050_frame_scheduler_init(Mpu6050FrameScheduler* scheduler, uint32_t max_fps) {
+    scheduler->interval_ms = 1000 / max_fps;
+    scheduler->last_frame_tick = furi_get_tick() - furi_ms_to_ticks(scheduler->interval_ms);
+    scheduler->signature = 0;
+    scheduler->forced = true;
+    scheduler->frames_drawn = 0;
+    scheduler->frames_skipped = 0;
+    scheduler->draw_us_last = 0;
+    scheduler->draw_us_max = 0;
+    scheduler->draw_us_total = 0;
+}
+
+void mpu6050_frame_invalidate(Mpu6050FrameScheduler* scheduler) {
+    scheduler->forced.store(true, std::memory_order_release);
+}
+
+bool mpu6050_frame_due(Mpu6050FrameScheduler* scheduler, uint32_t signature) {
+    uint32_t now = furi_get_tick();
+    if (now - scheduler->last_frame_tick < furi_ms_to_ticks(scheduler->interval_ms)) return false;
+
+    bool forced = scheduler->forced.exchange(false, std::memory_order_acq_rel);
+    // Either way this frame slot is used up
+    scheduler->last_frame_tick = now;
+    if (!forced && signature == scheduler->signature) {
+        scheduler->frames_skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    scheduler->signature = signature;
+    return true;
+}
+
+void mpu6050_frame_end(Mpu6050FrameScheduler* scheduler, uint32_t begin) {
+    uint32_t took = (DWT->CYCCNT - begin) / furi_hal_cortex_instructions_per_microsecond();
+    scheduler->frames_drawn.fetch_add(1, std::memory_order_relaxed);
+    scheduler->draw_us_last.store(took, std::memory_order_relaxed);
+    scheduler->draw_us_total.fetch_add(took, std::memory_order_relaxed);
+    if (took > scheduler->draw_us_max.load(std::memory_order_relaxed)) {
+        scheduler->draw_us_max.store(took, std::memory_order_relaxed);
+    }
+}
+
+void mpu6050_frame_get_stats(const Mpu6050FrameScheduler* scheduler, Mpu6050FrameStats* stats) {
+    stats->frames_drawn = scheduler->frames_drawn.load(std::memory_order_relaxed);
+    stats->frames_skipped = scheduler->frames_skipped.load(std::memory_order_relaxed);
+    stats->draw_us_last = scheduler->draw_us_last.load(std::memory_order_relaxed);
+    stats->draw_us_max = scheduler->draw_us_max.load(std::memory_order_relaxed);
+    uint32_t total = scheduler->draw_us_total.load(std::memory_order_relaxed);
+    stats->draw_us_average = stats->frames_drawn ? total / stats->frames_drawn : 0;
+}
+
+int32_t mpu6050_quantize_milli(int32_t milli, uint8_t decimals) {
+    int32_t step = render_decimal_step[decimals & 0x03];
+    // Round half away from zero, like printf did
+    return milli < 0 ? -((-milli + step / 2) / step) : (milli + step / 2) / step;
+}
+
+const char* mpu6050_format_milli(char* buffer, size_t size, int32_t milli, uint8_t decimals) {
+    decimals &= 0x03;
+    int32_t quantized = mpu6050_quantize_milli(milli, decimals);
+    uint32_t magnitude = quantized < 0 ? -quantized : quantized;
+    uint32_t scale = 1000 / render_decimal_step[decimals]; // 10^decimals
+    if (decimals == 0) {
+        snprintf(buffer, size, "%s%lu", quantized < 0 ? "-" : "", (unsigned long)magnitude);
+    } else {
+        snprintf(
+            buffer,
+            size,
+            "%s%lu.%0*lu",
+            quantized < 0 ? "-" : "",
+            (unsigned long)(magnitude / scale),
+            decimals,
+            (unsigned long)(magnitude % scale));
+    }
+    return buffer;
+}
+
+const char* mpu6050_cached_milli(Mpu6050CachedText* cache, int32_t milli, uint8_t decimals, const char* suffix) {
+    int32_t quantized = mpu6050_quantize_milli(milli, decimals);
+    if (!cache->valid || cache->quantized != quantized) {
+        char number[12];
+        mpu6050_format_milli(number, sizeof(number), milli, decimals);
+        snprintf(cache->text, sizeof(cache->text), "%s%s", number, suffix);
+        cache->quantized = quantized;
+        cache->valid = true;
+    }
+    return cache->text;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include <furi.h>
+#include <furi_hal.h>
+
+// Display frame scheduling.
+//
+// The GUI loop runs faster than the display needs to, to keep the sample ring
+// drained. A frame is requested at most every 1000 / max_fps ms, and only when
+// the screen would change: every screen reduces what it shows, quantised the
+// way it is printed, to a signature, and an unchanged signature skips the frame.
+// Input and screen switches force the next frame.
+
+typedef struct {
+    uint32_t frames_drawn;
+    uint32_t frames_skipped; // Frames due but unchanged
+    uint32_t draw_us_last;
+    uint32_t draw_us_max;
+    uint32_t draw_us_average;
+} Mpu6050FrameStats;
+
+typedef struct {
+    uint32_t interval_ms;
+    uint32_t last_frame_tick;
+    uint32_t signature; // Of the last frame requested
+    std::atomic<bool> forced;
+
+    std::atomic<uint32_t> frames_drawn;
+    std::atomic<uint32_t> frames_skipped;
+    std::atomic<uint32_t> draw_us_last;
+    std::atomic<uint32_t> draw_us_max;
+    std::atomic<uint32_t> draw_us_total;
+} Mpu6050FrameScheduler;
+
+void mpu6050_frame_scheduler_init(Mpu6050FrameScheduler* scheduler, uint32_t max_fps);
+
+// Any thread: the next due frame is drawn whatever its signature
+void mpu6050_frame_invalidate(Mpu6050FrameScheduler* scheduler);
+
+// GUI loop: true when a frame should be requested now
+bool mpu6050_frame_due(Mpu6050FrameScheduler* scheduler, uint32_t signature);
+
+// Draw callback: brackets one frame to measure it
+static inline uint32_t mpu6050_frame_begin(void) {
+    return DWT->CYCCNT;
+}
+void mpu6050_frame_end(Mpu6050FrameScheduler* scheduler, uint32_t begin);
+
+void mpu6050_frame_get_stats(const Mpu6050FrameScheduler* scheduler, Mpu6050FrameStats* stats);
+
+// Frame signatures: FNV-1a over the quantised values a screen shows
+#define MPU6050_SIGNATURE_INIT 2166136261U
+
+static inline uint32_t mpu6050_signature_add(uint32_t signature, int32_t value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; i++) {
+        signature = (signature ^ (bits & 0xFF)) * 16777619U;
+        bits >>= 8;
+    }
+    return signature;
+}
+
+// Integer text formatting, no float printf
+
+// A milli-unit value (mg, mdps, milli-C) rounded to `decimals` (0..3) places,
+// in units of the last printed digit; what a signature should hash
+int32_t mpu6050_quantize_milli(int32_t milli, uint8_t decimals);
+
+// Formats a milli-unit value with `decimals` places, e.g. -1234 -> "-1.23";
+// a value that rounds to zero never prints a minus sign. Returns `buffer`.
+const char* mpu6050_format_milli(char* buffer, size_t size, int32_t milli, uint8_t decimals);
+
+// Formatted text that is only re-printed when its quantised value changes
+typedef struct {
+    int32_t quantized;
+    bool valid;
+    char text[16];
+} Mpu6050CachedText;
+
+const char* mpu6050_cached_milli(Mpu6050CachedText* cache, int32_t milli, uint8_t decimals, const char* suffix);
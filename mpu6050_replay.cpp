@@ -0,0 +1,162 @@
+#include "mpu6050_replay.h"
+
+// Recorded time that passes per unit of the caller's clock; 0 = unpaced
+static const uint8_t replay_speed_factor[Mpu6050ReplaySpeed_Count] = {1, 4, 16, 0};
+
+// Moves what is left to the front of the buffer and tops it up from the file
+static void replay_refill(Mpu6050Replay* replay) {
+    uint32_t left = replay->fill - replay->pos;
+    memmove(replay->buffer, replay->buffer + replay->pos, left);
+    replay->fill = left;
+    replay->pos = 0;
+
+    size_t wanted = sizeof(replay->buffer) - left;
+    size_t got = storage_file_read(replay->file, replay->buffer + left, wanted);
+    replay->fill += static_cast<uint32_t>(got);
+    replay->bytes_read.fetch_add(static_cast<uint32_t>(got), std::memory_order_relaxed);
+    if (got < wanted) replay->eof = true;
+}
+
+// Decodes the next chunk into replay->block; false at the end of the file
+static bool replay_decode(Mpu6050Replay* replay) {
+    Mpu6050LogChunkHeader chunk;
+    while (true) {
+        if (!replay->eof && replay->fill - replay->pos < MPU6050_LOG_CHUNK_MAX) replay_refill(replay);
+        if (replay->pos >= replay->fill) return false;
+
+        size_t used = mpu6050_log_decode_chunk(
+            replay->buffer + replay->pos, replay->fill - replay->pos, &chunk, &replay->block);
+        if (!used) {
+            // Resynchronise on the next sync marker, like the converter does
+            replay->pos++;
+            replay->damaged_bytes.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        replay->pos += static_cast<uint32_t>(used);
+
+        if (chunk.sequence > replay->expected_sequence) {
+            replay->chunks_dropped.fetch_add(chunk.sequence - replay->expected_sequence, std::memory_order_relaxed);
+        }
+        replay->expected_sequence = chunk.sequence + 1;
+        replay->chunks.fetch_add(1, std::memory_order_relaxed);
+        if (replay->block.count) return true;
+    }
+}
+
+bool mpu6050_replay_find_latest(Storage* storage, char* path, size_t path_size) {
+    char candidate[64];
+    bool found = false;
+    for (uint32_t i = 0; i < MPU6050_LOG_MAX_FILES; i++) {
+        snprintf(candidate, sizeof(candidate), MPU6050_LOG_DIR "/log_%03lu.bin", (unsigned long)i);
+        if (!storage_file_exists(storage, candidate)) break;
+        snprintf(path, path_size, "%s", candidate);
+        found = true;
+    }
+    return found;
+}
+
+bool mpu6050_replay_start(Mpu6050Replay* replay, Mpu6050ReplaySpeed speed) {
+    if (replay->playing) return true;
+
+    replay->speed = speed;
+    replay->fill = 0;
+    replay->pos = 0;
+    replay->eof = false;
+    replay->block_ready = false;
+    replay->clock_started = false;
+    replay->expected_sequence = 0;
+    replay->samples = 0;
+    replay->chunks = 0;
+    replay->chunks_dropped = 0;
+    replay->damaged_bytes = 0;
+    replay->bytes_read = 0;
+    replay->file_size = 0;
+    replay->start_tick = 0;
+    replay->stop_tick = 0;
+
+    replay->storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    replay->file = storage_file_alloc(replay->storage);
+    bool ok = mpu6050_replay_find_latest(replay->storage, replay->path, sizeof(replay->path)) &&
+              storage_file_open(replay->file, replay->path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+              storage_file_read(replay->file, &replay->header, sizeof(replay->header)) == sizeof(replay->header) &&
+              mpu6050_log_header_valid(&replay->header) && replay->header.sample_rate_hz;
+    if (!ok) {
+        storage_file_free(replay->file);
+        furi_record_close(RECORD_STORAGE);
+        replay->file = NULL;
+        return false;
+    }
+
+    replay->file_size = static_cast<uint32_t>(storage_file_size(replay->file));
+    replay->bytes_read = sizeof(replay->header);
+    replay->playing = true;
+    return true;
+}
+
+const Mpu6050SampleBlock* mpu6050_replay_next(Mpu6050Replay* replay, uint32_t now_us) {
+    if (!replay->playing) return NULL;
+    if (!replay->block_ready) {
+        replay->block_ready = replay_decode(replay);
+        if (!replay->block_ready) return NULL;
+    }
+
+    const Mpu6050SampleBlock* block = &replay->block;
+    if (!replay->clock_started) {
+        // The recording's clock starts with its first sample, the caller's with this call
+        replay->clock_started = true;
+        replay->first_us = block->timestamp[0];
+        replay->start_us = now_us;
+        replay->start_tick = furi_get_tick();
+    }
+
+    uint8_t factor = replay_speed_factor[replay->speed];
+    if (factor) {
+        // A block is due once its newest sample would have been captured
+        uint32_t recorded_us = block->timestamp[block->count - 1] - replay->first_us;
+        uint64_t played_us = static_cast<uint64_t>(now_us - replay->start_us) * factor;
+        if (played_us < recorded_us) return NULL;
+    }
+
+    replay->block_ready = false;
+    replay->samples.fetch_add(block->count, std::memory_order_relaxed);
+    return block;
+}
+
+bool mpu6050_replay_at_end(const Mpu6050Replay* replay) {
+    return replay->eof && replay->pos >= replay->fill && !replay->block_ready;
+}
+
+void mpu6050_replay_stop(Mpu6050Replay* replay) {
+    if (!replay->playing) return;
+    replay->stop_tick = furi_get_tick();
+    replay->playing = false;
+
+    storage_file_close(replay->file);
+    storage_file_free(replay->file);
+    furi_record_close(RECORD_STORAGE);
+    replay->file = NULL;
+}
+
+bool mpu6050_replay_is_playing(const Mpu6050Replay* replay) {
+    return replay->playing.load(std::memory_order_relaxed);
+}
+
+const char* mpu6050_replay_file_name(const Mpu6050Replay* replay) {
+    const char* slash = strrchr(replay->path, '/');
+    return slash ? slash + 1 : replay->path;
+}
+
+void mpu6050_replay_get_stats(const Mpu6050Replay* replay, Mpu6050ReplayStats* stats) {
+    stats->samples = replay->samples.load(std::memory_order_relaxed);
+    stats->chunks = replay->chunks.load(std::memory_order_relaxed);
+    stats->chunks_dropped = replay->chunks_dropped.load(std::memory_order_relaxed);
+    stats->damaged_bytes = replay->damaged_bytes.load(std::memory_order_relaxed);
+    stats->bytes_read = replay->bytes_read.load(std::memory_order_relaxed);
+    stats->file_size = replay->file_size.load(std::memory_order_relaxed);
+
+    uint32_t start = replay->start_tick.load(std::memory_order_relaxed);
+    uint32_t end = replay->playing.load(std::memory_order_relaxed) ? furi_get_tick() :
+                                                                     replay->stop_tick.load(std::memory_order_relaxed);
+    uint64_t ticks = stats->samples ? end - start : 0;
+    stats->elapsed_ms = static_cast<uint32_t>(ticks * 1000 / furi_kernel_get_tick_frequency());
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <furi.h>
+#include <storage/storage.h>
+#include "mpu6050_log.h"
+#include "mpu6050_logger.h"
+
+// Plays a recording back into the pipeline in place of the sensor. Blocks come
+// out of the file as they were recorded, timestamps included, paced by their
+// timestamps at 1x, 4x or 16x, or as fast as the consumer takes them. The caller
+// pushes each block into the ring the sensor would have fed, so everything
+// downstream of it runs unchanged.
+//
+// The file is read on the thread that calls mpu6050_replay_next(); while a
+// replay runs that thread has no sensor to poll, so storage may block it.
+
+// Holds two whole chunks, so one is always complete after a refill
+#define MPU6050_REPLAY_BUFFER_SIZE 4096
+
+static_assert(MPU6050_REPLAY_BUFFER_SIZE >= 2 * MPU6050_LOG_CHUNK_MAX, "the buffer must hold at least two chunks");
+
+typedef enum {
+    Mpu6050ReplaySpeed_1x,
+    Mpu6050ReplaySpeed_4x,
+    Mpu6050ReplaySpeed_16x,
+    Mpu6050ReplaySpeed_Max, // As fast as the pipeline consumes
+    Mpu6050ReplaySpeed_Count
+} Mpu6050ReplaySpeed;
+
+typedef struct {
+    uint32_t samples;        // Samples handed out
+    uint32_t chunks;
+    uint32_t chunks_dropped; // Sequence gaps in the file, i.e. lost while recording
+    uint32_t damaged_bytes;  // Skipped while resynchronising
+    uint32_t bytes_read;     // Of file_size, for progress
+    uint32_t file_size;
+    uint32_t elapsed_ms;     // From the first block to the end, or until now
+} Mpu6050ReplayStats;
+
+typedef struct {
+    Storage* storage;
+    File* file;
+    char path[64];
+    Mpu6050LogHeader header;
+    uint8_t speed; // Mpu6050ReplaySpeed
+
+    // Reader side only
+    uint8_t buffer[MPU6050_REPLAY_BUFFER_SIZE];
+    uint32_t fill;              // Bytes in buffer
+    uint32_t pos;               // Next byte to decode
+    bool eof;                   // The last read came up short
+    Mpu6050SampleBlock block;   // Decoded ahead, waiting until it is due
+    bool block_ready;
+    bool clock_started;
+    uint32_t first_us;          // Recorded timestamp of the first sample
+    uint32_t start_us;          // Caller's clock when the first block went out
+    uint32_t expected_sequence;
+
+    std::atomic<bool> playing;
+    std::atomic<uint32_t> samples;
+    std::atomic<uint32_t> chunks;
+    std::atomic<uint32_t> chunks_dropped;
+    std::atomic<uint32_t> damaged_bytes;
+    std::atomic<uint32_t> bytes_read;
+    std::atomic<uint32_t> file_size;
+    std::atomic<uint32_t> start_tick;
+    std::atomic<uint32_t> stop_tick;
+} Mpu6050Replay;
+
+// Newest recording: the logger takes the first free log_NNN.bin, so that is the
+// last one before the first gap. Returns false when there is none.
+bool mpu6050_replay_find_latest(Storage* storage, char* path, size_t path_size);
+
+// Opens the newest recording and checks its header
+bool mpu6050_replay_start(Mpu6050Replay* replay, Mpu6050ReplaySpeed speed);
+
+// The next block once it is due at `now_us` on the caller's microsecond clock,
+// else NULL. The block stays valid until the next call.
+const Mpu6050SampleBlock* mpu6050_replay_next(Mpu6050Replay* replay, uint32_t now_us);
+
+// Every block has been handed out
+bool mpu6050_replay_at_end(const Mpu6050Replay* replay);
+
+// Closes the file; the statistics stay until the next start
+void mpu6050_replay_stop(Mpu6050Replay* replay);
+
+bool mpu6050_replay_is_playing(const Mpu6050Replay* replay);
+
+// Name of the file being or last played, without the directory
+const char* mpu6050_replay_file_name(const Mpu6050Replay* replay);
+
+void mpu6050_replay_get_stats(const Mpu6050Replay* replay, Mpu6050ReplayStats* stats);
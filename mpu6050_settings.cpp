@@ -0,0 +1,76 @@
+#include "mpu6050_settings.h"
+#include "mpu6050_logger.h"
+#include "mpu6050_record.h"
+
+// Settings file payload: the settings bytes, then per address a profile (valid,
+// WHO_AM_I, register image)
+#define MPU6050_SETTINGS_MAGIC 0x5453 // "ST"
+#define MPU6050_SETTINGS_VERSION 1
+#define MPU6050_SETTINGS_VALUES 11
+#define MPU6050_SETTINGS_PROFILE_SIZE (2 + MPU6050_CONFIG_BLOCK_SIZE)
+#define MPU6050_SETTINGS_PAYLOAD_SIZE \
+    (MPU6050_SETTINGS_VALUES + MPU6050_SETTINGS_PROFILES * MPU6050_SETTINGS_PROFILE_SIZE)
+
+void mpu6050_settings_path(char* path, size_t size) {
+    snprintf(path, size, MPU6050_LOG_DIR "/" MPU6050_SETTINGS_FILE);
+}
+
+bool mpu6050_settings_save(const Mpu6050Settings* settings) {
+    uint8_t data[MPU6050_SETTINGS_PAYLOAD_SIZE];
+    uint8_t* out = data;
+    const uint8_t values[MPU6050_SETTINGS_VALUES] = {
+        settings->i2c_address,
+        settings->accel_fsr,
+        settings->gyro_fsr,
+        settings->dlpf,
+        settings->filter_type,
+        settings->filter_stages,
+        settings->filter_corner_index,
+        settings->spectrum_rate_index,
+        settings->power_idle_index,
+        settings->power_motion_index,
+        settings->replay_speed};
+    memcpy(out, values, sizeof(values));
+    out += sizeof(values);
+    for (size_t slot = 0; slot < MPU6050_SETTINGS_PROFILES; slot++) {
+        const Mpu6050DeviceProfile* profile = &settings->profiles[slot];
+        *out++ = profile->valid ? 1 : 0;
+        *out++ = profile->who_am_i;
+        memcpy(out, profile->config, MPU6050_CONFIG_BLOCK_SIZE);
+        out += MPU6050_CONFIG_BLOCK_SIZE;
+    }
+
+    char path[64];
+    mpu6050_settings_path(path, sizeof(path));
+    return mpu6050_record_save(path, MPU6050_SETTINGS_MAGIC, MPU6050_SETTINGS_VERSION, data, sizeof(data));
+}
+
+bool mpu6050_settings_load(Mpu6050Settings* settings) {
+    uint8_t data[MPU6050_SETTINGS_PAYLOAD_SIZE];
+    char path[64];
+    mpu6050_settings_path(path, sizeof(path));
+    if (!mpu6050_record_load(path, MPU6050_SETTINGS_MAGIC, MPU6050_SETTINGS_VERSION, data, sizeof(data))) {
+        return false;
+    }
+
+    const uint8_t* in = data;
+    settings->i2c_address = *in++;
+    settings->accel_fsr = *in++;
+    settings->gyro_fsr = *in++;
+    settings->dlpf = *in++;
+    settings->filter_type = *in++;
+    settings->filter_stages = *in++;
+    settings->filter_corner_index = *in++;
+    settings->spectrum_rate_index = *in++;
+    settings->power_idle_index = *in++;
+    settings->power_motion_index = *in++;
+    settings->replay_speed = *in++;
+    for (size_t slot = 0; slot < MPU6050_SETTINGS_PROFILES; slot++) {
+        Mpu6050DeviceProfile* profile = &settings->profiles[slot];
+        profile->valid = *in++ != 0;
+        profile->who_am_i = *in++;
+        memcpy(profile->config, in, MPU6050_CONFIG_BLOCK_SIZE);
+        in += MPU6050_CONFIG_BLOCK_SIZE;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050.h"
+
+// Settings and sensor profiles kept across launches.
+//
+// One small file holds the Settings screen choices and, per sensor address, the
+// profile of the chip as the app left it asleep: WHO_AM_I and the register
+// image of SMPLRT_DIV..ACCEL_CONFIG. The app saves it on exit. On launch the
+// settings come back, and a sensor whose profile matches them is taken over
+// with a few register reads instead of a reset and reconfiguration, see
+// Mpu6050::resume(). The offsets are not part of the profile: they live only in
+// the calibration file, and resume() checks the chip against that. A file that
+// fails the record checks (mpu6050_record.h) leaves the defaults.
+
+#define MPU6050_SETTINGS_FILE "settings.bin" // In MPU6050_LOG_DIR
+#define MPU6050_SETTINGS_PROFILES 2          // One per address, 0x68 and 0x69
+
+// A chip as the app left it
+typedef struct {
+    bool valid;   // Running under this profile at exit
+    uint8_t who_am_i;
+    uint8_t config[MPU6050_CONFIG_BLOCK_SIZE]; // SMPLRT_DIV..ACCEL_CONFIG
+} Mpu6050DeviceProfile;
+
+// Indices as the Settings screen keeps them; the app checks their ranges
+typedef struct {
+    uint8_t i2c_address;
+    uint8_t accel_fsr;
+    uint8_t gyro_fsr;
+    uint8_t dlpf;
+    uint8_t filter_type;
+    uint8_t filter_stages;
+    uint8_t filter_corner_index;
+    uint8_t spectrum_rate_index;
+    uint8_t power_idle_index;
+    uint8_t power_motion_index;
+    uint8_t replay_speed;
+    Mpu6050DeviceProfile profiles[MPU6050_SETTINGS_PROFILES]; // By address - MPU6050_I2C_ADDR
+} Mpu6050Settings;
+
+bool mpu6050_settings_save(const Mpu6050Settings* settings);
+
+// False, with `settings` untouched, when there is no valid file
+bool mpu6050_settings_load(Mpu6050Settings* settings);
+
+// Full path of the settings file, for tools and tests
+void mpu6050_settings_path(char* path, size_t size);
@@ -0,0 +1,146 @@
+#include "mpu6050_stats.h"
+#include <string.h>
+
+const uint16_t mpu6050_stats_window_ms[Mpu6050StatsWindow_Count] = {100, 1000, 10000};
+
+void Mpu6050RollingWindow::init(uint32_t bucket_samples) {
+    bucket_samples_ = bucket_samples ? bucket_samples : 1;
+    reset();
+}
+
+void Mpu6050RollingWindow::reset() {
+    sequence_ = 0;
+    completed_ = 0;
+    memset(sum_, 0, sizeof(sum_));
+    memset(sum_sq_, 0, sizeof(sum_sq_));
+    for (int channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+        min_deque_[channel].head = min_deque_[channel].tail = 0;
+        max_deque_[channel].head = max_deque_[channel].tail = 0;
+    }
+    open_bucket();
+}
+
+void Mpu6050RollingWindow::open_bucket() {
+    open_count_ = 0;
+    for (int channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+        open_min_[channel] = INT32_MAX;
+        open_max_[channel] = INT32_MIN;
+        open_sum_[channel] = 0;
+        open_sum_sq_[channel] = 0;
+    }
+}
+
+void Mpu6050RollingWindow::close_bucket() {
+    uint32_t sequence = sequence_++;
+    uint32_t slot = sequence % MPU6050_STATS_BUCKETS;
+    const uint32_t kept = MPU6050_STATS_BUCKETS - 1;
+
+    // The bucket `kept` places back leaves the window
+    bool evict = completed_ == kept;
+    uint32_t evicted = (sequence + 1) % MPU6050_STATS_BUCKETS;
+    if (!evict) completed_++;
+    bucket_sequence_[slot] = sequence;
+
+    for (int channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+        if (evict) {
+            sum_[channel] -= bucket_sum_[channel][evicted];
+            sum_sq_[channel] -= bucket_sum_sq_[channel][evicted];
+        }
+        bucket_min_[channel][slot] = open_min_[channel];
+        bucket_max_[channel][slot] = open_max_[channel];
+        bucket_sum_[channel][slot] = open_sum_[channel];
+        bucket_sum_sq_[channel][slot] = open_sum_sq_[channel];
+        sum_[channel] += open_sum_[channel];
+        sum_sq_[channel] += open_sum_sq_[channel];
+
+        // Drop buckets the new one dominates, append it, then expire from the front
+        Deque* min = &min_deque_[channel];
+        while (min->tail != min->head &&
+               bucket_min_[channel][min->slots[(min->tail - 1) & (MPU6050_STATS_DEQUE_SIZE - 1)]] >=
+                   open_min_[channel]) {
+            min->tail--;
+        }
+        min->slots[min->tail++ & (MPU6050_STATS_DEQUE_SIZE - 1)] = static_cast<uint8_t>(slot);
+        while (bucket_sequence_[min->slots[min->head & (MPU6050_STATS_DEQUE_SIZE - 1)]] + kept <= sequence) {
+            min->head++;
+        }
+
+        Deque* max = &max_deque_[channel];
+        while (max->tail != max->head &&
+               bucket_max_[channel][max->slots[(max->tail - 1) & (MPU6050_STATS_DEQUE_SIZE - 1)]] <=
+                   open_max_[channel]) {
+            max->tail--;
+        }
+        max->slots[max->tail++ & (MPU6050_STATS_DEQUE_SIZE - 1)] = static_cast<uint8_t>(slot);
+        while (bucket_sequence_[max->slots[max->head & (MPU6050_STATS_DEQUE_SIZE - 1)]] + kept <= sequence) {
+            max->head++;
+        }
+    }
+    open_bucket();
+}
+
+void Mpu6050RollingWindow::result(uint8_t channel, Mpu6050StatsResult* out) const {
+    uint32_t count = completed_ * bucket_samples_ + open_count_;
+    memset(out, 0, sizeof(*out));
+    out->samples = count;
+    if (!count) return;
+
+    int32_t min = open_min_[channel];
+    int32_t max = open_max_[channel];
+    const Deque* min_deque = &min_deque_[channel];
+    const Deque* max_deque = &max_deque_[channel];
+    if (min_deque->head != min_deque->tail) {
+        int32_t oldest = bucket_min_[channel][min_deque->slots[min_deque->head & (MPU6050_STATS_DEQUE_SIZE - 1)]];
+        if (oldest < min) min = oldest;
+    }
+    if (max_deque->head != max_deque->tail) {
+        int32_t oldest = bucket_max_[channel][max_deque->slots[max_deque->head & (MPU6050_STATS_DEQUE_SIZE - 1)]];
+        if (oldest > max) max = oldest;
+    }
+
+    int64_t sum = sum_[channel] + open_sum_[channel];
+    int64_t sum_sq = sum_sq_[channel] + open_sum_sq_[channel];
+    // n * sum(x^2) - sum(x)^2 stays within int64 for a 10 s window of 17-bit values
+    int64_t spread = sum_sq * count - sum * sum;
+    uint64_t count_sq = static_cast<uint64_t>(count) * count;
+
+    out->min = min;
+    out->max = max;
+    out->mean = static_cast<int32_t>(sum / static_cast<int64_t>(count));
+    out->rms = static_cast<int32_t>(mpu6050_isqrt64(static_cast<uint64_t>(sum_sq) / count));
+    out->std_dev = static_cast<int32_t>(mpu6050_isqrt64(spread > 0 ? static_cast<uint64_t>(spread) / count_sq : 0));
+    out->peak_to_peak = max - min;
+}
+
+void Mpu6050Stats::init(uint16_t sample_rate_hz) {
+    for (int window = 0; window < Mpu6050StatsWindow_Count; window++) {
+        uint32_t samples = static_cast<uint32_t>(sample_rate_hz) * mpu6050_stats_window_ms[window] / 1000;
+        windows_[window].init(samples / MPU6050_STATS_BUCKETS);
+    }
+    accel_fsr_ = 0;
+}
+
+void Mpu6050Stats::reset() {
+    for (int window = 0; window < Mpu6050StatsWindow_Count; window++) {
+        windows_[window].reset();
+    }
+}
+
+void Mpu6050Stats::push(const Mpu6050SampleBlock& block) {
+    if (block.accel_fsr != accel_fsr_) {
+        reset();
+        accel_fsr_ = block.accel_fsr;
+    }
+
+    for (uint32_t i = 0; i < block.count; i++) {
+        int32_t x = block.acc[0][i];
+        int32_t y = block.acc[1][i];
+        int32_t z = block.acc[2][i];
+        // At most 3 * 32768^2, which fits uint32
+        uint32_t square = static_cast<uint32_t>(x * x) + static_cast<uint32_t>(y * y) + static_cast<uint32_t>(z * z);
+        int32_t values[MPU6050_STATS_CHANNELS] = {x, y, z, static_cast<int32_t>(mpu6050_isqrt32(square))};
+        for (int window = 0; window < Mpu6050StatsWindow_Count; window++) {
+            windows_[window].add(values);
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_block.h"
+#include "mpu6050_units.h"
+
+// Sliding-window statistics over the accelerometer stream.
+//
+// Each window is split into MPU6050_STATS_BUCKETS buckets. Samples update the
+// open bucket (min, max, sum, sum of squares); a completed bucket is added to
+// the running sums and to monotonic min/max deques, and the bucket that falls
+// out of the window is subtracted. Every sample therefore costs O(1) regardless
+// of window length, and memory grows with the bucket count, not with the 10 000
+// samples of a 10 s window. The window covers the last BUCKETS - 1 completed
+// buckets plus the open one, so its edge advances in steps of 1/BUCKETS of its
+// length; values over the covered samples are exact.
+
+#define MPU6050_STATS_BUCKETS 50
+#define MPU6050_STATS_DEQUE_SIZE 64 // Power of two >= BUCKETS
+
+// Channels: accel X, Y, Z and the vector magnitude
+#define MPU6050_STATS_CHANNELS 4
+#define MPU6050_STATS_MAGNITUDE 3
+
+static_assert(MPU6050_STATS_DEQUE_SIZE >= MPU6050_STATS_BUCKETS, "deque must hold a full window");
+static_assert((MPU6050_STATS_DEQUE_SIZE & (MPU6050_STATS_DEQUE_SIZE - 1)) == 0, "deque size must be a power of two");
+
+typedef enum {
+    Mpu6050StatsWindow_100ms,
+    Mpu6050StatsWindow_1s,
+    Mpu6050StatsWindow_10s,
+    Mpu6050StatsWindow_Count
+} Mpu6050StatsWindow;
+
+// Results in raw accelerometer counts
+typedef struct {
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    int32_t rms;
+    int32_t std_dev;
+    int32_t peak_to_peak;
+    uint32_t samples; // Samples the window currently covers
+} Mpu6050StatsResult;
+
+class Mpu6050RollingWindow {
+public:
+    void init(uint32_t bucket_samples);
+    void reset();
+
+    // Adds one sample (MPU6050_STATS_CHANNELS values)
+    inline void add(const int32_t* values) {
+        for (int channel = 0; channel < MPU6050_STATS_CHANNELS; channel++) {
+            int32_t value = values[channel];
+            if (value < open_min_[channel]) open_min_[channel] = value;
+            if (value > open_max_[channel]) open_max_[channel] = value;
+            open_sum_[channel] += value;
+            open_sum_sq_[channel] += static_cast<int64_t>(value) * value;
+        }
+        if (++open_count_ == bucket_samples_) close_bucket();
+    }
+
+    void result(uint8_t channel, Mpu6050StatsResult* out) const;
+
+    // Window length in samples
+    uint32_t length() const {
+        return bucket_samples_ * MPU6050_STATS_BUCKETS;
+    }
+
+private:
+    typedef struct {
+        uint8_t slots[MPU6050_STATS_DEQUE_SIZE]; // Bucket slots, oldest first
+        uint32_t head;
+        uint32_t tail;
+    } Deque;
+
+    void close_bucket();
+    void open_bucket();
+
+    uint32_t bucket_samples_;
+    uint32_t sequence_;  // Sequence number of the next completed bucket
+    uint32_t completed_; // Completed buckets in the window, up to BUCKETS - 1
+
+    // Open bucket
+    uint32_t open_count_;
+    int32_t open_min_[MPU6050_STATS_CHANNELS];
+    int32_t open_max_[MPU6050_STATS_CHANNELS];
+    int32_t open_sum_[MPU6050_STATS_CHANNELS];
+    int64_t open_sum_sq_[MPU6050_STATS_CHANNELS];
+
+    // Completed buckets, ring indexed by sequence % BUCKETS
+    uint32_t bucket_sequence_[MPU6050_STATS_BUCKETS];
+    int32_t bucket_min_[MPU6050_STATS_CHANNELS][MPU6050_STATS_BUCKETS];
+    int32_t bucket_max_[MPU6050_STATS_CHANNELS][MPU6050_STATS_BUCKETS];
+    int32_t bucket_sum_[MPU6050_STATS_CHANNELS][MPU6050_STATS_BUCKETS];
+    int64_t bucket_sum_sq_[MPU6050_STATS_CHANNELS][MPU6050_STATS_BUCKETS];
+
+    // Running totals and monotonic deques over the completed buckets
+    int64_t sum_[MPU6050_STATS_CHANNELS];
+    int64_t sum_sq_[MPU6050_STATS_CHANNELS];
+    Deque min_deque_[MPU6050_STATS_CHANNELS]; // Increasing bucket minima
+    Deque max_deque_[MPU6050_STATS_CHANNELS]; // Decreasing bucket maxima
+};
+
+// Statistics engine: 100 ms, 1 s and 10 s windows fed with every sample
+class Mpu6050Stats {
+public:
+    void init(uint16_t sample_rate_hz);
+    void reset();
+
+    // Feeds a block; an accelerometer FSR change restarts every window
+    void push(const Mpu6050SampleBlock& block);
+
+    const Mpu6050RollingWindow& window(Mpu6050StatsWindow window) const {
+        return windows_[window];
+    }
+    uint8_t accel_fsr() const {
+        return accel_fsr_;
+    }
+
+private:
+    Mpu6050RollingWindow windows_[Mpu6050StatsWindow_Count];
+    uint8_t accel_fsr_;
+};
+
+// Window lengths in milliseconds, indexed by Mpu6050StatsWindow
+extern const uint16_t mpu6050_stats_window_ms[Mpu6050StatsWindow_Count];
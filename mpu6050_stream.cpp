@@ -0,0 +1,158 @@
+#include "mpu6050_stream.h"
+#include <string.h>
+
+// Channel order of the payload: acc X/Y/Z, gyro X/Y/Z
+static inline int16_t* stream_channel(Mpu6050SampleBlock* block, int channel) {
+    return channel < 3 ? block->acc[channel] : block->gyro[channel - 3];
+}
+
+static inline const int16_t* stream_channel(const Mpu6050SampleBlock* block, int channel) {
+    return channel < 3 ? block->acc[channel] : block->gyro[channel - 3];
+}
+
+uint16_t mpu6050_stream_crc(const uint8_t* data, size_t size) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= static_cast<uint16_t>(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t mpu6050_stream_encode(const Mpu6050SampleBlock* block, uint32_t sequence, bool delta, uint8_t* out) {
+    uint32_t count = block->count;
+    uint8_t* cursor = out + sizeof(Mpu6050StreamHeader);
+
+    for (int channel = 0; channel < MPU6050_STREAM_CHANNELS; channel++) {
+        const int16_t* row = stream_channel(block, channel);
+        if (delta) {
+            int32_t previous = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                cursor = put_varint(cursor, zigzag_encode(row[i] - previous));
+                previous = row[i];
+            }
+        } else {
+            memcpy(cursor, row, count * sizeof(int16_t));
+            cursor += count * sizeof(int16_t);
+        }
+    }
+
+    Mpu6050StreamHeader header;
+    header.sync = MPU6050_STREAM_SYNC;
+    header.version = MPU6050_STREAM_VERSION;
+    header.flags = delta ? MPU6050_STREAM_FLAG_DELTA : 0;
+    header.sequence = sequence;
+    header.timestamp_us = count ? block->timestamp[0] : 0;
+    header.period_us = count > 1 ? (block->timestamp[count - 1] - block->timestamp[0]) / (count - 1) : 0;
+    header.payload_size = static_cast<uint16_t>(cursor - out - sizeof(header));
+    header.count = static_cast<uint8_t>(count);
+    header.fsr = static_cast<uint8_t>((block->accel_fsr << 4) | block->gyro_fsr);
+    memcpy(out, &header, sizeof(header));
+
+    uint16_t crc = mpu6050_stream_crc(out, cursor - out);
+    memcpy(cursor, &crc, sizeof(crc));
+    return cursor - out + sizeof(crc);
+}
+
+void mpu6050_stream_parser_init(Mpu6050StreamParser* parser) {
+    memset(parser, 0, sizeof(*parser));
+}
+
+size_t mpu6050_stream_parser_feed(Mpu6050StreamParser* parser, const uint8_t* data, size_t size) {
+    size_t space = sizeof(parser->buffer) - parser->fill;
+    size_t n = size < space ? size : space;
+    memcpy(&parser->buffer[parser->fill], data, n);
+    parser->fill += n;
+    parser->bytes += n;
+    return n;
+}
+
+// Drops `size` bytes from the front of the buffer
+static void parser_consume(Mpu6050StreamParser* parser, size_t size) {
+    memmove(parser->buffer, &parser->buffer[size], parser->fill - size);
+    parser->fill -= size;
+}
+
+static bool parser_decode_payload(const Mpu6050StreamHeader* header, const uint8_t* payload, Mpu6050SampleBlock* block) {
+    const uint8_t* cursor = payload;
+    const uint8_t* end = payload + header->payload_size;
+    for (int channel = 0; channel < MPU6050_STREAM_CHANNELS; channel++) {
+        int16_t* row = stream_channel(block, channel);
+        if (header->flags & MPU6050_STREAM_FLAG_DELTA) {
+            int32_t previous = 0;
+            for (uint32_t i = 0; i < header->count; i++) {
+                uint32_t value;
+                cursor = get_varint(cursor, end, &value);
+                if (!cursor) return false;
+                previous += zigzag_decode(value);
+                row[i] = static_cast<int16_t>(previous);
+            }
+        } else {
+            size_t size = header->count * sizeof(int16_t);
+            if (static_cast<size_t>(end - cursor) < size) return false;
+            memcpy(row, cursor, size);
+            cursor += size;
+        }
+    }
+    return cursor == end;
+}
+
+bool mpu6050_stream_parser_next(Mpu6050StreamParser* parser, Mpu6050StreamHeader* header, Mpu6050SampleBlock* block) {
+    const uint8_t sync[2] = {MPU6050_STREAM_SYNC & 0xFF, MPU6050_STREAM_SYNC >> 8};
+    while (parser->fill >= sizeof(*header)) {
+        if (parser->buffer[0] != sync[0] || parser->buffer[1] != sync[1]) {
+            parser_consume(parser, 1);
+            parser->bytes_skipped++;
+            continue;
+        }
+        memcpy(header, parser->buffer, sizeof(*header));
+        size_t frame_size = sizeof(*header) + header->payload_size + MPU6050_STREAM_CRC_SIZE;
+        if (header->version != MPU6050_STREAM_VERSION || header->count > MPU6050_BLOCK_SIZE ||
+            frame_size > MPU6050_STREAM_FRAME_BOUND(header->count)) {
+            // Not a header after all
+            parser_consume(parser, 1);
+            parser->bytes_skipped++;
+            continue;
+        }
+        if (parser->fill < frame_size) return false;
+
+        uint16_t crc;
+        memcpy(&crc, &parser->buffer[frame_size - MPU6050_STREAM_CRC_SIZE], sizeof(crc));
+        if (crc != mpu6050_stream_crc(parser->buffer, frame_size - MPU6050_STREAM_CRC_SIZE) ||
+            !parser_decode_payload(header, &parser->buffer[sizeof(*header)], block)) {
+            parser->crc_errors++;
+            parser_consume(parser, 1);
+            parser->bytes_skipped++;
+            continue;
+        }
+        parser_consume(parser, frame_size);
+
+        for (uint32_t i = 0; i < header->count; i++) {
+            block->timestamp[i] = header->timestamp_us + i * header->period_us;
+        }
+        block->count = header->count;
+        block->accel_fsr = header->fsr >> 4;
+        block->gyro_fsr = header->fsr & 0x0F;
+
+        // A sequence that goes backwards is a sender that started over, not 4
+        // billion dropped frames; its timestamps start over with it
+        int32_t gap = static_cast<int32_t>(header->sequence - parser->next_sequence);
+        uint32_t end_us = header->timestamp_us + header->count * header->period_us;
+        if (parser->started && gap < 0) parser->resyncs++;
+        if (parser->started && gap > 0) parser->frames_dropped += gap;
+        if (parser->started && gap == 0) {
+            parser->span_us += end_us - parser->end_us;
+        } else {
+            parser->span_us += header->count * header->period_us;
+        }
+        parser->end_us = end_us;
+        parser->started = true;
+        parser->next_sequence = header->sequence + 1;
+        parser->frames++;
+        parser->samples += header->count;
+        return true;
+    }
+    return false;
+}
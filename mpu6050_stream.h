@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "mpu6050_block.h"
+#include "mpu6050_varint.h"
+
+// Live streaming format. The stream is a sequence of self-contained frames with
+// no header of its own, so a reader can attach at any point: every frame starts
+// with a sync word, carries its sequence number and the timestamp of its first
+// sample, and ends with a CRC over everything before it. All fields are
+// little-endian.
+//
+// Payload: the six motion channels one after another (acc X/Y/Z, gyro X/Y/Z),
+// each as `count` values. Raw frames hold plain int16s; delta frames hold zigzag
+// varints of the difference to the previous sample of the channel (the first
+// one relative to zero), as the recording format does.
+
+#define MPU6050_STREAM_SYNC 0x5AA5
+#define MPU6050_STREAM_VERSION 1
+#define MPU6050_STREAM_CHANNELS 6
+#define MPU6050_STREAM_FLAG_DELTA (1 << 0)
+
+typedef struct __attribute__((packed)) {
+    uint16_t sync;         // MPU6050_STREAM_SYNC
+    uint8_t version;       // MPU6050_STREAM_VERSION
+    uint8_t flags;         // MPU6050_STREAM_FLAG_*
+    uint32_t sequence;     // Frame number; a gap means frames were dropped
+    uint32_t timestamp_us; // First sample
+    uint32_t period_us;    // Spacing of the following samples
+    uint16_t payload_size; // Bytes between this header and the CRC
+    uint8_t count;         // Samples in the frame
+    uint8_t fsr;           // accel_fsr << 4 | gyro_fsr
+} Mpu6050StreamHeader;
+
+// CRC-16/CCITT-FALSE of header and payload, after the payload
+#define MPU6050_STREAM_CRC_SIZE 2
+
+// Largest frame `count` samples can produce
+#define MPU6050_STREAM_FRAME_BOUND(count)                                                \
+    (sizeof(Mpu6050StreamHeader) + MPU6050_STREAM_CHANNELS * (count) * MPU6050_VARINT_MAX + \
+     MPU6050_STREAM_CRC_SIZE)
+#define MPU6050_STREAM_FRAME_MAX MPU6050_STREAM_FRAME_BOUND(MPU6050_BLOCK_SIZE)
+
+uint16_t mpu6050_stream_crc(const uint8_t* data, size_t size);
+
+// Encodes `block` as frame `sequence` into `out` (at least MPU6050_STREAM_FRAME_MAX
+// bytes) and returns the bytes written
+size_t mpu6050_stream_encode(const Mpu6050SampleBlock* block, uint32_t sequence, bool delta, uint8_t* out);
+
+// Receiving side: finds frames in a byte stream that may start mid-frame, skip
+// bytes or carry corrupted frames
+typedef struct {
+    uint8_t buffer[2 * MPU6050_STREAM_FRAME_MAX];
+    size_t fill;
+    bool started;           // A frame has been received
+    uint32_t next_sequence; // Expected after the last frame
+
+    uint32_t frames;         // Valid frames
+    uint32_t samples;
+    uint32_t frames_dropped; // Sequence gaps after the first frame
+    uint32_t resyncs;        // Sequence went backwards: the sender started over
+    uint32_t crc_errors;
+    uint32_t bytes_skipped;  // Searching for a sync word
+    uint64_t bytes;          // Fed in total
+
+    // Sender time the frames cover, without the gaps, for the rate the samples
+    // were taken at rather than the rate they happened to arrive at
+    uint32_t end_us; // Just past the last sample
+    uint64_t span_us;
+} Mpu6050StreamParser;
+
+void mpu6050_stream_parser_init(Mpu6050StreamParser* parser);
+
+// Appends received bytes; returns how many fitted (call next() to make room)
+size_t mpu6050_stream_parser_feed(Mpu6050StreamParser* parser, const uint8_t* data, size_t size);
+
+// Takes the next complete, valid frame out of the buffered bytes
+bool mpu6050_stream_parser_next(Mpu6050StreamParser* parser, Mpu6050StreamHeader* header, Mpu6050SampleBlock* block);
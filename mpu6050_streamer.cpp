@@ -0,0 +1,166 @@
+#include "mpu6050_streamer.h"
+#include <string.h>
+
+// Sender thread flags
+#define MPU6050_STREAMER_FLAG_DATA (1 << 0)    // The producer queued a frame
+#define MPU6050_STREAMER_FLAG_TX_DONE (1 << 1) // The last packet went out
+#define MPU6050_STREAMER_FLAG_RX (1 << 2)      // The host sent something
+#define MPU6050_STREAMER_FLAG_LINE (1 << 3)    // DTR changed
+#define MPU6050_STREAMER_FLAG_STOP (1 << 4)
+#define MPU6050_STREAMER_FLAGS_ALL                                                                 \
+    (MPU6050_STREAMER_FLAG_DATA | MPU6050_STREAMER_FLAG_TX_DONE | MPU6050_STREAMER_FLAG_RX |       \
+     MPU6050_STREAMER_FLAG_LINE | MPU6050_STREAMER_FLAG_STOP)
+
+// CDC callbacks run in the USB interrupt: they only wake the sender
+static void streamer_tx_callback(void* context) {
+    Mpu6050Streamer* streamer = static_cast<Mpu6050Streamer*>(context);
+    furi_thread_flags_set(furi_thread_get_id(streamer->thread), MPU6050_STREAMER_FLAG_TX_DONE);
+}
+
+static void streamer_rx_callback(void* context) {
+    Mpu6050Streamer* streamer = static_cast<Mpu6050Streamer*>(context);
+    furi_thread_flags_set(furi_thread_get_id(streamer->thread), MPU6050_STREAMER_FLAG_RX);
+}
+
+static void streamer_ctrl_line_callback(void* context, CdcCtrlLine ctrl_lines) {
+    Mpu6050Streamer* streamer = static_cast<Mpu6050Streamer*>(context);
+    streamer->connected.store((ctrl_lines & CdcCtrlLineDTR) != 0, std::memory_order_release);
+    furi_thread_flags_set(furi_thread_get_id(streamer->thread), MPU6050_STREAMER_FLAG_LINE);
+}
+
+static CdcCallbacks streamer_cdc_callbacks = {
+    streamer_tx_callback,
+    streamer_rx_callback,
+    NULL,
+    streamer_ctrl_line_callback,
+    NULL,
+};
+
+// Sender: copies the next packet out of the ring and hands it to USB
+static uint32_t streamer_send_packet(Mpu6050Streamer* streamer) {
+    uint32_t tail = streamer->tail.load(std::memory_order_relaxed);
+    uint32_t used = streamer->head.load(std::memory_order_acquire) - tail;
+    uint32_t n = used < CDC_DATA_SZ ? used : CDC_DATA_SZ;
+    if (!n) return 0;
+
+    uint32_t offset = tail & (MPU6050_STREAM_RING_SIZE - 1);
+    uint32_t first = MPU6050_STREAM_RING_SIZE - offset < n ? MPU6050_STREAM_RING_SIZE - offset : n;
+    memcpy(streamer->packet, &streamer->ring[offset], first);
+    memcpy(&streamer->packet[first], streamer->ring, n - first);
+    streamer->tail.store(tail + n, std::memory_order_release);
+
+    furi_hal_cdc_send(MPU6050_STREAM_CDC_IF, streamer->packet, static_cast<uint16_t>(n));
+    return n;
+}
+
+// Sender: commands from the host
+static void streamer_receive(Mpu6050Streamer* streamer) {
+    uint8_t command[CDC_DATA_SZ];
+    int32_t size = furi_hal_cdc_receive(MPU6050_STREAM_CDC_IF, command, sizeof(command));
+    for (int32_t i = 0; i < size; i++) {
+        if (command[i] == 'd') streamer->delta.store(true, std::memory_order_relaxed);
+        if (command[i] == 'r') streamer->delta.store(false, std::memory_order_relaxed);
+    }
+}
+
+static int32_t mpu6050_streamer_thread(void* context) {
+    Mpu6050Streamer* streamer = static_cast<Mpu6050Streamer*>(context);
+    uint32_t in_flight = 0; // Bytes of the packet USB has not finished yet
+
+    while (true) {
+        uint32_t flags = furi_thread_flags_wait(MPU6050_STREAMER_FLAGS_ALL, FuriFlagWaitAny, FuriWaitForever);
+        if (flags & MPU6050_STREAMER_FLAG_STOP) break;
+        if (flags & MPU6050_STREAMER_FLAG_RX) streamer_receive(streamer);
+        if (flags & MPU6050_STREAMER_FLAG_TX_DONE) {
+            streamer->bytes.fetch_add(in_flight, std::memory_order_relaxed);
+            in_flight = 0;
+        }
+        // A closed port never completes its packet; start over when it opens again
+        if ((flags & MPU6050_STREAMER_FLAG_LINE) && !streamer->connected.load(std::memory_order_acquire)) {
+            in_flight = 0;
+        }
+        if (!in_flight && streamer->connected.load(std::memory_order_acquire)) {
+            in_flight = streamer_send_packet(streamer);
+        }
+    }
+    return 0;
+}
+
+bool mpu6050_streamer_start(Mpu6050Streamer* streamer) {
+    if (streamer->streaming) return true;
+
+    streamer->usb_previous = furi_hal_usb_get_config();
+    furi_hal_usb_unlock();
+    if (!furi_hal_usb_set_config(&usb_cdc_dual, NULL)) return false;
+
+    streamer->head = 0;
+    streamer->tail = 0;
+    streamer->sequence = 0;
+    streamer->start_tick = furi_get_tick();
+    streamer->connected = (furi_hal_cdc_get_ctrl_line_state(MPU6050_STREAM_CDC_IF) & CdcCtrlLineDTR) != 0;
+    streamer->delta = true;
+    streamer->bytes = 0;
+    streamer->frames = 0;
+    streamer->samples = 0;
+    streamer->frames_dropped = 0;
+
+    streamer->thread =
+        furi_thread_alloc_ex("Mpu6050Streamer", MPU6050_STREAMER_STACK_SIZE, mpu6050_streamer_thread, streamer);
+    furi_thread_start(streamer->thread);
+    furi_hal_cdc_set_callbacks(MPU6050_STREAM_CDC_IF, &streamer_cdc_callbacks, streamer);
+    streamer->streaming = true;
+    return true;
+}
+
+void mpu6050_streamer_write(Mpu6050Streamer* streamer, const Mpu6050SampleBlock* block) {
+    if (!streamer->streaming || !block->count) return;
+
+    // Numbered even when dropped, so the host sees the gap
+    uint32_t sequence = streamer->sequence++;
+    uint32_t head = streamer->head.load(std::memory_order_relaxed);
+    uint32_t space = MPU6050_STREAM_RING_SIZE - (head - streamer->tail.load(std::memory_order_acquire));
+    if (!streamer->connected.load(std::memory_order_acquire) || space < MPU6050_STREAM_FRAME_BOUND(block->count)) {
+        streamer->frames_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t size = mpu6050_stream_encode(
+        block, sequence, streamer->delta.load(std::memory_order_relaxed), streamer->frame);
+    uint32_t offset = head & (MPU6050_STREAM_RING_SIZE - 1);
+    size_t first = MPU6050_STREAM_RING_SIZE - offset < size ? MPU6050_STREAM_RING_SIZE - offset : size;
+    memcpy(&streamer->ring[offset], streamer->frame, first);
+    memcpy(streamer->ring, &streamer->frame[first], size - first);
+    streamer->head.store(head + static_cast<uint32_t>(size), std::memory_order_release);
+
+    streamer->frames.fetch_add(1, std::memory_order_relaxed);
+    streamer->samples.fetch_add(block->count, std::memory_order_relaxed);
+    furi_thread_flags_set(furi_thread_get_id(streamer->thread), MPU6050_STREAMER_FLAG_DATA);
+}
+
+void mpu6050_streamer_stop(Mpu6050Streamer* streamer) {
+    if (!streamer->streaming) return;
+
+    streamer->streaming = false;
+    furi_hal_cdc_set_callbacks(MPU6050_STREAM_CDC_IF, NULL, NULL);
+    furi_thread_flags_set(furi_thread_get_id(streamer->thread), MPU6050_STREAMER_FLAG_STOP);
+    furi_thread_join(streamer->thread);
+    furi_thread_free(streamer->thread);
+    streamer->thread = NULL;
+
+    furi_hal_usb_set_config(streamer->usb_previous, NULL);
+    streamer->stop_tick = furi_get_tick();
+}
+
+bool mpu6050_streamer_is_streaming(const Mpu6050Streamer* streamer) {
+    return streamer->streaming;
+}
+
+void mpu6050_streamer_get_stats(const Mpu6050Streamer* streamer, Mpu6050StreamerStats* stats) {
+    stats->bytes = streamer->bytes.load(std::memory_order_relaxed);
+    stats->frames = streamer->frames.load(std::memory_order_relaxed);
+    stats->samples = streamer->samples.load(std::memory_order_relaxed);
+    stats->frames_dropped = streamer->frames_dropped.load(std::memory_order_relaxed);
+    stats->elapsed_ms = (streamer->streaming ? furi_get_tick() : streamer->stop_tick.load()) - streamer->start_tick;
+    stats->connected = streamer->connected.load(std::memory_order_relaxed);
+    stats->delta = streamer->delta.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <furi.h>
+#include <furi_hal.h>
+#include "mpu6050_stream.h"
+
+// Frames waiting for the USB port: about 300 ms of raw 1 kHz data
+#define MPU6050_STREAM_RING_SIZE 4096
+#define MPU6050_STREAMER_STACK_SIZE 1024
+// The second port of the dual CDC configuration; the CLI keeps the first
+#define MPU6050_STREAM_CDC_IF 1
+
+static_assert((MPU6050_STREAM_RING_SIZE & (MPU6050_STREAM_RING_SIZE - 1)) == 0, "ring size must be a power of two");
+static_assert(MPU6050_STREAM_RING_SIZE >= 2 * MPU6050_STREAM_FRAME_MAX, "the ring must hold at least two frames");
+
+typedef struct {
+    uint32_t bytes;          // Handed to USB
+    uint32_t frames;         // Queued for USB
+    uint32_t samples;
+    uint32_t frames_dropped; // No host on the port, or the ring was full
+    uint32_t elapsed_ms;
+    bool connected;          // A host has the port open (DTR)
+    bool delta;              // Frames are delta encoded
+} Mpu6050StreamerStats;
+
+// USB CDC sender. The producer encodes every sample block into a frame and
+// copies it into a byte ring; a sender thread feeds the ring to the CDC port one
+// packet at a time, each after the previous one completed. The producer never
+// waits for USB: while no host has the port open, or when a stalled host has let
+// the ring fill, whole frames are dropped and counted, and the sequence numbers
+// show the gap. The host picks the encoding by sending 'd' (delta, the default)
+// or 'r' (raw).
+typedef struct {
+    FuriThread* thread;
+    FuriHalUsbInterface* usb_previous; // Configuration to restore on stop
+
+    uint8_t ring[MPU6050_STREAM_RING_SIZE];
+    std::atomic<uint32_t> head; // Written by the producer
+    std::atomic<uint32_t> tail; // Written by the sender
+    uint8_t frame[MPU6050_STREAM_FRAME_MAX]; // Producer scratch
+    uint8_t packet[CDC_DATA_SZ];             // Sender scratch
+    uint32_t sequence;
+    uint32_t start_tick;
+    std::atomic<uint32_t> stop_tick;
+
+    std::atomic<bool> streaming;
+    std::atomic<bool> connected;
+    std::atomic<bool> delta;
+
+    std::atomic<uint32_t> bytes;
+    std::atomic<uint32_t> frames;
+    std::atomic<uint32_t> samples;
+    std::atomic<uint32_t> frames_dropped;
+} Mpu6050Streamer;
+
+// Switches USB to the dual CDC configuration and starts the sender thread
+bool mpu6050_streamer_start(Mpu6050Streamer* streamer);
+
+// Producer: queues a block; never blocks on USB
+void mpu6050_streamer_write(Mpu6050Streamer* streamer, const Mpu6050SampleBlock* block);
+
+// Producer: stops the sender and restores the previous USB configuration
+void mpu6050_streamer_stop(Mpu6050Streamer* streamer);
+
+bool mpu6050_streamer_is_streaming(const Mpu6050Streamer* streamer);
+void mpu6050_streamer_get_stats(const Mpu6050Streamer* streamer, Mpu6050StreamerStats* stats);
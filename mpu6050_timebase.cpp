@@ -0,0 +1,130 @@
+#include "mpu6050_timebase.h"
+
+static inline uint32_t timebase_us(int64_t q16) {
+    return static_cast<uint32_t>((q16 < 0 ? -q16 : q16) >> 16);
+}
+
+static void timebase_publish_period(Mpu6050Timebase* timebase) {
+    int64_t period = timebase->period_q16;
+    timebase->rate_mhz.store(
+        static_cast<uint32_t>((static_cast<int64_t>(1000000000) << 16) / period), std::memory_order_relaxed);
+    timebase->drift_ppm.store(
+        static_cast<int32_t>((timebase->nominal_q16 - period) * 1000000 / period), std::memory_order_relaxed);
+}
+
+static void timebase_set_rate(Mpu6050Timebase* timebase, uint32_t sample_rate_hz) {
+    timebase->sample_rate_hz = sample_rate_hz;
+    timebase->nominal_q16 = (static_cast<int64_t>(1000000) << 16) / (sample_rate_hz ? sample_rate_hz : 1);
+    timebase->period_q16 = timebase->nominal_q16;
+    timebase->locked = false;
+    timebase->shift = MPU6050_TIMEBASE_SHIFT_MIN;
+    timebase->shift_bursts = 0;
+    timebase->window_samples = 0;
+    timebase->window_anchor_us = 0;
+    timebase->window_step_us = 0;
+    timebase_publish_period(timebase);
+}
+
+void mpu6050_timebase_init(Mpu6050Timebase* timebase, uint32_t sample_rate_hz) {
+    timebase->next_q16 = 0;
+    timebase->anchor_error_us = 0;
+    timebase->step_us = 0;
+    timebase->samples = 0;
+    timebase->dropped = 0;
+    timebase->resyncs = 0;
+    timebase_set_rate(timebase, sample_rate_hz);
+}
+
+void mpu6050_timebase_restart(Mpu6050Timebase* timebase) {
+    timebase->locked = false;
+}
+
+void mpu6050_timebase_stamp(
+    Mpu6050Timebase* timebase,
+    Mpu6050SampleBlock* block,
+    uint32_t sample_rate_hz,
+    uint32_t now_us,
+    uint32_t lost) {
+    if (sample_rate_hz != timebase->sample_rate_hz) timebase_set_rate(timebase, sample_rate_hz);
+    int64_t period = timebase->period_q16;
+    uint32_t count = block->count;
+    if (lost) timebase->dropped.fetch_add(lost, std::memory_order_relaxed);
+    if (!count) {
+        if (timebase->locked) timebase->next_q16 += lost * period;
+        return;
+    }
+
+    // The newest sample was captured within the period before the anchor, half
+    // of it on average
+    uint64_t first;
+    uint64_t newest;
+    int64_t error = 0;
+    if (!timebase->locked) {
+        newest = (static_cast<uint64_t>(now_us) << 16) - period / 2;
+        first = newest - (count - 1) * period;
+        timebase->locked = true;
+        timebase->shift = MPU6050_TIMEBASE_SHIFT_MIN;
+        timebase->shift_bursts = 0;
+    } else {
+        first = timebase->next_q16 + lost * period;
+        newest = first + (count - 1) * period;
+        int32_t ahead_us = static_cast<int32_t>(now_us - static_cast<uint32_t>(newest >> 16));
+        error = (static_cast<int64_t>(ahead_us) << 16) - static_cast<int64_t>(newest & 0xFFFF) - period / 2;
+        if (timebase_us(error) > MPU6050_TIMEBASE_RESYNC_US) {
+            // A late burst means samples went missing unnoticed; an early one, a
+            // clock that jumped. Either way the burst moves onto its anchor.
+            if (error > 0) {
+                uint32_t gap = static_cast<uint32_t>((error + period / 2) / period);
+                timebase->dropped.fetch_add(gap, std::memory_order_relaxed);
+            }
+            timebase->resyncs.fetch_add(1, std::memory_order_relaxed);
+            first += error;
+            newest += error;
+            error = 0;
+        }
+    }
+
+    uint64_t time = first;
+    for (uint32_t i = 0; i < count; i++) {
+        block->timestamp[i] = static_cast<uint32_t>(time >> 16);
+        time += period;
+    }
+
+    // Phase and period follow the anchors; the phase correction is the step the
+    // next burst's first sample takes
+    uint8_t shift = timebase->shift;
+    int64_t step = error / (static_cast<int64_t>(1) << shift);
+    timebase->next_q16 = newest + period + step;
+    period += error / ((static_cast<int64_t>(1) << (2 * shift + 2)) * (count + lost));
+    if (shift < MPU6050_TIMEBASE_SHIFT_MAX && ++timebase->shift_bursts >= MPU6050_TIMEBASE_SHIFT_BURSTS) {
+        timebase->shift++;
+        timebase->shift_bursts = 0;
+    }
+    int64_t limit = timebase->nominal_q16 * MPU6050_TIMEBASE_MAX_DRIFT_PCT / 100;
+    if (period > timebase->nominal_q16 + limit) period = timebase->nominal_q16 + limit;
+    if (period < timebase->nominal_q16 - limit) period = timebase->nominal_q16 - limit;
+    timebase->period_q16 = period;
+    timebase_publish_period(timebase);
+
+    timebase->samples.fetch_add(count, std::memory_order_relaxed);
+    if (timebase_us(error) > timebase->window_anchor_us) timebase->window_anchor_us = timebase_us(error);
+    if (timebase_us(step) > timebase->window_step_us) timebase->window_step_us = timebase_us(step);
+    timebase->window_samples += count;
+    if (timebase->window_samples >= timebase->sample_rate_hz) {
+        timebase->anchor_error_us.store(timebase->window_anchor_us, std::memory_order_relaxed);
+        timebase->step_us.store(timebase->window_step_us, std::memory_order_relaxed);
+        timebase->window_samples = 0;
+        timebase->window_anchor_us = 0;
+        timebase->window_step_us = 0;
+    }
+}
+
+void mpu6050_timebase_get_stats(const Mpu6050Timebase* timebase, Mpu6050TimebaseStats* stats) {
+    stats->rate_mhz = timebase->rate_mhz.load(std::memory_order_relaxed);
+    stats->drift_ppm = timebase->drift_ppm.load(std::memory_order_relaxed);
+    stats->anchor_error_us = timebase->anchor_error_us.load(std::memory_order_relaxed);
+    stats->step_us = timebase->step_us.load(std::memory_order_relaxed);
+    stats->samples = timebase->samples.load(std::memory_order_relaxed);
+    stats->dropped = timebase->dropped.load(std::memory_order_relaxed);
+    stats->resyncs = timebase->resyncs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include "mpu6050_block.h"
+
+// Sample clock of one sensor, reconstructed from the bursts it delivers.
+//
+// The FIFO carries no time, so each burst is anchored to the system tick taken
+// when its FIFO count was read: the newest sample in it was captured within one
+// sample period before that. The samples are laid out backwards from there at
+// the estimated period, which starts at the configured one (SMPLRT_DIV and the
+// DLPF) and is tracked against the system clock. The chip's oscillator is a few
+// percent off and drifts with temperature.
+//
+// The tracking is a critically damped second-order loop on the anchor error:
+// every burst moves the next timestamp by 1/2^shift of the error and the period
+// by 1/2^(2 shift + 2) of it per sample. The shift starts at
+// MPU6050_TIMEBASE_SHIFT_MIN to pull in the clock error quickly and grows by one
+// every MPU6050_TIMEBASE_SHIFT_BURSTS bursts up to MPU6050_TIMEBASE_SHIFT_MAX,
+// which averages away the 1 ms tick and the poll jitter: timestamps continue
+// from burst to burst with steps of tens of µs. Samples the FIFO lost are
+// skipped over. A burst that lands more than MPU6050_TIMEBASE_RESYNC_US off
+// (samples gone unnoticed, a stall) restarts the phase at the anchor and counts
+// the samples the gap held.
+//
+// Anchors should be the middle of the tick they were read in. Times are µs << 16
+// in 64 bits; the low 32 bits of the µs part are the wrapping block timestamps.
+// Only the sampler writes; the statistics are atomics any thread can read.
+
+#define MPU6050_TIMEBASE_SHIFT_MIN 2
+#define MPU6050_TIMEBASE_SHIFT_MAX 5
+#define MPU6050_TIMEBASE_SHIFT_BURSTS 64
+#define MPU6050_TIMEBASE_RESYNC_US 20000
+#define MPU6050_TIMEBASE_MAX_DRIFT_PCT 10 // Period estimates are held within this of the nominal
+
+typedef struct {
+    uint32_t rate_mhz;        // Achieved sample rate, milli-Hz
+    int32_t drift_ppm;        // Of the sample clock against the host clock; positive = fast
+    uint32_t anchor_error_us; // Largest distance of a burst from the model over the last second
+    uint32_t step_us;         // Largest timestamp step away from the period over the last second
+    uint32_t samples;         // Stamped
+    uint32_t dropped;         // Lost by the FIFO or between bursts
+    uint32_t resyncs;
+} Mpu6050TimebaseStats;
+
+typedef struct {
+    uint32_t sample_rate_hz; // Configured
+    int64_t nominal_q16;     // Configured period, µs << 16
+    int64_t period_q16;      // Estimated period
+    uint64_t next_q16;       // Time of the next sample
+    bool locked;             // next_q16 follows the samples; false until the first burst
+    uint8_t shift;           // Loop gains, see above
+    uint8_t shift_bursts;    // Bursts at this shift
+
+    // Peaks of the window being measured, published once it covers a second
+    uint32_t window_samples;
+    uint32_t window_anchor_us;
+    uint32_t window_step_us;
+
+    // Written by the sampler, read by anyone
+    std::atomic<uint32_t> rate_mhz;
+    std::atomic<int32_t> drift_ppm;
+    std::atomic<uint32_t> anchor_error_us;
+    std::atomic<uint32_t> step_us;
+    std::atomic<uint32_t> samples;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> resyncs;
+} Mpu6050Timebase;
+
+void mpu6050_timebase_init(Mpu6050Timebase* timebase, uint32_t sample_rate_hz);
+
+// The sensor's FIFO was restarted (bring-up, wake, flush): the next burst sets
+// the phase again without counting a gap. The period estimate carries over.
+void mpu6050_timebase_restart(Mpu6050Timebase* timebase);
+
+// Stamps the block->count samples of a burst read at `now_us`, which the FIFO
+// says came after `lost` samples it dropped. A different `sample_rate_hz` than
+// before starts the estimate over.
+void mpu6050_timebase_stamp(
+    Mpu6050Timebase* timebase,
+    Mpu6050SampleBlock* block,
+    uint32_t sample_rate_hz,
+    uint32_t now_us,
+    uint32_t lost);
+
+void mpu6050_timebase_get_stats(const Mpu6050Timebase* timebase, Mpu6050TimebaseStats* stats);
@@ -0,0 +1,260 @@
+#include "mpu6050_trigger.h"
+#include "mpu6050_logger.h"
+
+#define MPU6050_TRIGGER_EXPORT_BUFFER 512
+
+static inline int32_t trigger_magnitude(int32_t x, int32_t y, int32_t z) {
+    // At most 3 * 32768^2, which fits uint32
+    uint32_t square = static_cast<uint32_t>(x * x) + static_cast<uint32_t>(y * y) + static_cast<uint32_t>(z * z);
+    return static_cast<int32_t>(mpu6050_isqrt32(square));
+}
+
+// Resolves the millisecond and milli-g settings for the current FSR and rate
+static void trigger_resolve(Mpu6050Trigger* trigger) {
+    const Mpu6050TriggerConfig* config = &trigger->config;
+    trigger->level = (config->level_mg * (1 << mpu6050_accel_shift[trigger->accel_fsr & 0x03])) / 1000;
+    trigger->pre_samples = static_cast<uint32_t>(config->pre_ms) * trigger->sample_rate_hz / 1000;
+    if (trigger->pre_samples > MPU6050_EVENT_SAMPLES - 1) trigger->pre_samples = MPU6050_EVENT_SAMPLES - 1;
+    trigger->holdoff_samples = static_cast<uint32_t>(config->holdoff_ms) * trigger->sample_rate_hz / 1000;
+}
+
+// Drops the history and any capture in progress, e.g. after an FSR change
+static void trigger_restart(Mpu6050Trigger* trigger) {
+    if (trigger->capture) trigger->capture->state = Mpu6050EventState_Free;
+    trigger->capture = NULL;
+    trigger->sample = 0;
+    trigger->history_fill = 0;
+    trigger->rearm_sample = 0;
+}
+
+// Fires on the current sample (already in history): claims a free event and
+// copies the pre-trigger history into it
+static void trigger_fire(Mpu6050Trigger* trigger, uint32_t timestamp_us) {
+    uint32_t number = trigger->triggers++;
+    trigger->rearm_sample = trigger->sample + 1 + trigger->holdoff_samples;
+    if (trigger->config.mode == Mpu6050TriggerMode_Single) trigger->armed = false;
+
+    Mpu6050Event* event = NULL;
+    for (uint32_t i = 0; i < MPU6050_EVENT_POOL && !event; i++) {
+        if (trigger->events[i].state == Mpu6050EventState_Free) event = &trigger->events[i];
+    }
+    if (!event) {
+        trigger->missed++;
+        return;
+    }
+
+    // History up to and including the trigger sample, at most two copies per row
+    uint32_t pre = trigger->pre_samples < trigger->history_fill - 1 ? trigger->pre_samples :
+                                                                      trigger->history_fill - 1;
+    uint32_t count = pre + 1;
+    uint32_t start = (trigger->sample - pre) & (MPU6050_TRIGGER_HISTORY - 1);
+    uint32_t first = MPU6050_TRIGGER_HISTORY - start < count ? MPU6050_TRIGGER_HISTORY - start : count;
+    for (int axis = 0; axis < 3; axis++) {
+        memcpy(event->acc[axis], &trigger->history[axis][start], first * sizeof(int16_t));
+        memcpy(&event->acc[axis][first], trigger->history[axis], (count - first) * sizeof(int16_t));
+    }
+
+    event->timestamp_us = timestamp_us;
+    event->number = number;
+    event->pre_samples = static_cast<uint16_t>(pre);
+    event->count = static_cast<uint16_t>(count);
+    event->period_us = static_cast<uint16_t>(1000000 / trigger->sample_rate_hz);
+    event->level = trigger->level;
+    event->accel_fsr = trigger->accel_fsr;
+    event->source = trigger->config.source;
+    event->edge = trigger->config.edge;
+    event->state = Mpu6050EventState_Capturing;
+    trigger->capture = event;
+}
+
+void mpu6050_trigger_init(Mpu6050Trigger* trigger, const Mpu6050TriggerConfig& config, uint16_t sample_rate_hz) {
+    trigger->sample_rate_hz = sample_rate_hz;
+    trigger->accel_fsr = 0;
+    for (uint32_t i = 0; i < MPU6050_EVENT_POOL; i++) {
+        trigger->events[i].state = Mpu6050EventState_Free;
+    }
+    trigger->capture = NULL;
+    trigger->triggers = 0;
+    trigger->missed = 0;
+    mpu6050_trigger_configure(trigger, config);
+}
+
+void mpu6050_trigger_configure(Mpu6050Trigger* trigger, const Mpu6050TriggerConfig& config) {
+    trigger->config = config;
+    trigger->armed = config.mode != Mpu6050TriggerMode_Off;
+    trigger_resolve(trigger);
+    trigger_restart(trigger);
+}
+
+void mpu6050_trigger_push(Mpu6050Trigger* trigger, const Mpu6050SampleBlock* block) {
+    if (block->accel_fsr != trigger->accel_fsr) {
+        // Keep a capture cut short by the change, its samples share one FSR
+        if (trigger->capture) trigger->capture->state = Mpu6050EventState_Done;
+        trigger->capture = NULL;
+        trigger->accel_fsr = block->accel_fsr;
+        trigger_resolve(trigger);
+        trigger_restart(trigger);
+    }
+
+    const uint8_t source = trigger->config.source;
+    const bool rising = trigger->config.edge == Mpu6050TriggerEdge_Rising;
+    const int32_t level = trigger->level;
+    for (uint32_t i = 0; i < block->count; i++) {
+        int32_t x = block->acc[0][i];
+        int32_t y = block->acc[1][i];
+        int32_t z = block->acc[2][i];
+        uint32_t slot = trigger->sample & (MPU6050_TRIGGER_HISTORY - 1);
+        trigger->history[0][slot] = static_cast<int16_t>(x);
+        trigger->history[1][slot] = static_cast<int16_t>(y);
+        trigger->history[2][slot] = static_cast<int16_t>(z);
+        if (trigger->history_fill < MPU6050_TRIGGER_HISTORY) trigger->history_fill++;
+
+        Mpu6050Event* event = trigger->capture;
+        if (event) {
+            uint32_t n = event->count++;
+            event->acc[0][n] = static_cast<int16_t>(x);
+            event->acc[1][n] = static_cast<int16_t>(y);
+            event->acc[2][n] = static_cast<int16_t>(z);
+            if (event->count == MPU6050_EVENT_SAMPLES) {
+                event->state = Mpu6050EventState_Done;
+                trigger->capture = NULL;
+            }
+        }
+
+        int32_t value = source == Mpu6050TriggerSource_Magnitude ? trigger_magnitude(x, y, z) :
+                        source == Mpu6050TriggerSource_X         ? x :
+                        source == Mpu6050TriggerSource_Y         ? y :
+                                                                   z;
+        // An edge needs the previous sample, so the first one after a restart never fires
+        if (trigger->armed && !trigger->capture && trigger->history_fill > 1 &&
+            trigger->sample >= trigger->rearm_sample) {
+            bool crossed = rising ? (trigger->previous < level && value >= level) :
+                                    (trigger->previous > level && value <= level);
+            if (crossed) trigger_fire(trigger, block->timestamp[i]);
+        }
+        trigger->previous = value;
+        trigger->sample++;
+    }
+}
+
+uint32_t mpu6050_trigger_event_count(const Mpu6050Trigger* trigger) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MPU6050_EVENT_POOL; i++) {
+        if (trigger->events[i].state == Mpu6050EventState_Done) count++;
+    }
+    return count;
+}
+
+const Mpu6050Event* mpu6050_trigger_event(const Mpu6050Trigger* trigger, uint32_t index) {
+    // The pool is tiny: pick the index-th oldest by trigger number
+    const Mpu6050Event* found = NULL;
+    for (uint32_t i = 0; i < MPU6050_EVENT_POOL; i++) {
+        const Mpu6050Event* event = &trigger->events[i];
+        if (event->state != Mpu6050EventState_Done) continue;
+        uint32_t older = 0;
+        for (uint32_t j = 0; j < MPU6050_EVENT_POOL; j++) {
+            const Mpu6050Event* other = &trigger->events[j];
+            if (other->state == Mpu6050EventState_Done && other->number < event->number) older++;
+        }
+        if (older == index) found = event;
+    }
+    return found;
+}
+
+void mpu6050_trigger_delete(Mpu6050Trigger* trigger, uint32_t index) {
+    const Mpu6050Event* event = mpu6050_trigger_event(trigger, index);
+    if (event) trigger->events[event - trigger->events].state = Mpu6050EventState_Free;
+}
+
+int32_t mpu6050_event_value(const Mpu6050Event* event, uint32_t n) {
+    if (event->source == Mpu6050TriggerSource_Magnitude) {
+        return trigger_magnitude(event->acc[0][n], event->acc[1][n], event->acc[2][n]);
+    }
+    return event->acc[event->source][n];
+}
+
+int32_t mpu6050_event_peak(const Mpu6050Event* event) {
+    if (event->source != Mpu6050TriggerSource_Magnitude) {
+        return mpu6050_row_peak(event->acc[event->source], event->count);
+    }
+    int32_t peak = 0;
+    for (uint32_t n = 0; n < event->count; n++) {
+        int32_t value = mpu6050_event_value(event, n);
+        if (value > peak) peak = value;
+    }
+    return peak;
+}
+
+// Export thread: names the file and writes the copied events
+static int32_t mpu6050_event_export_thread(void* context) {
+    Mpu6050EventExport* exporter = static_cast<Mpu6050EventExport*>(context);
+    Storage* storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    storage_simply_mkdir(storage, MPU6050_LOG_DIR);
+
+    bool named = false;
+    for (uint32_t i = 0; i < MPU6050_LOG_MAX_FILES && !named; i++) {
+        snprintf(exporter->path, sizeof(exporter->path), MPU6050_LOG_DIR "/events_%03lu.csv", (unsigned long)i);
+        named = !storage_file_exists(storage, exporter->path);
+    }
+
+    File* file = storage_file_alloc(storage);
+    bool ok = named && storage_file_open(file, exporter->path, FSAM_WRITE, FSOM_CREATE_NEW);
+    if (ok) {
+        // Lines are batched so storage sees a few large writes
+        char buffer[MPU6050_TRIGGER_EXPORT_BUFFER];
+        size_t fill = snprintf(buffer, sizeof(buffer), "event,trigger_us,t_us,ax_mg,ay_mg,az_mg\n");
+        for (uint32_t index = 0; index < exporter->count && ok; index++) {
+            const Mpu6050Event* event = &exporter->events[index];
+            for (uint32_t n = 0; n < event->count && ok; n++) {
+                if (sizeof(buffer) - fill < 64) {
+                    ok = storage_file_write(file, buffer, fill) == fill;
+                    fill = 0;
+                }
+                int32_t t_us = (static_cast<int32_t>(n) - event->pre_samples) * event->period_us;
+                fill += snprintf(
+                    &buffer[fill],
+                    sizeof(buffer) - fill,
+                    "%lu,%lu,%ld,%ld,%ld,%ld\n",
+                    (unsigned long)event->number,
+                    (unsigned long)event->timestamp_us,
+                    (long)t_us,
+                    (long)mpu6050_accel_counts_to_mg(event->acc[0][n], event->accel_fsr),
+                    (long)mpu6050_accel_counts_to_mg(event->acc[1][n], event->accel_fsr),
+                    (long)mpu6050_accel_counts_to_mg(event->acc[2][n], event->accel_fsr));
+            }
+        }
+        if (ok && fill) ok = storage_file_write(file, buffer, fill) == fill;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    exporter->ok = ok;
+    exporter->done.store(true, std::memory_order_release);
+    return 0;
+}
+
+bool mpu6050_event_export_start(Mpu6050EventExport* exporter, const Mpu6050Trigger* trigger) {
+    if (exporter->thread) return false;
+
+    exporter->count = mpu6050_trigger_event_count(trigger);
+    exporter->events = static_cast<Mpu6050Event*>(malloc(sizeof(Mpu6050Event) * MPU6050_EVENT_POOL));
+    for (uint32_t index = 0; index < exporter->count; index++) {
+        exporter->events[index] = *mpu6050_trigger_event(trigger, index);
+    }
+    exporter->done = false;
+    exporter->thread = furi_thread_alloc_ex(
+        "Mpu6050Export", MPU6050_EVENT_EXPORT_STACK_SIZE, mpu6050_event_export_thread, exporter);
+    furi_thread_start(exporter->thread);
+    return true;
+}
+
+int8_t mpu6050_event_export_poll(Mpu6050EventExport* exporter) {
+    if (!exporter->thread || !exporter->done.load(std::memory_order_acquire)) return 0;
+    furi_thread_join(exporter->thread);
+    furi_thread_free(exporter->thread);
+    exporter->thread = NULL;
+    free(exporter->events);
+    exporter->events = NULL;
+    return exporter->ok ? 1 : -1;
+}
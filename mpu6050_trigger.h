@@ -0,0 +1,146 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <atomic>
+#include <furi.h>
+#include "mpu6050_block.h"
+#include "mpu6050_units.h"
+
+// Oscilloscope-style event capture on the accelerometer stream.
+//
+// Every sample goes into a short history ring and is tested against a level on
+// one axis or on the vector magnitude. On the selected edge the last `pre_ms` of
+// history is copied into a free event from a fixed pool and the following
+// samples are appended at full rate until the event is full. After a trigger the
+// next one is held off for `holdoff_ms`. Nothing is allocated after init; a
+// trigger that finds the pool full is counted as missed.
+
+#define MPU6050_EVENT_SAMPLES 256 // Pre- plus post-trigger samples per event
+#define MPU6050_EVENT_POOL 4
+#define MPU6050_TRIGGER_HISTORY 256 // Power of two >= EVENT_SAMPLES
+
+static_assert(MPU6050_TRIGGER_HISTORY >= MPU6050_EVENT_SAMPLES, "history must cover the longest pre-trigger");
+static_assert(
+    (MPU6050_TRIGGER_HISTORY & (MPU6050_TRIGGER_HISTORY - 1)) == 0,
+    "history size must be a power of two");
+
+typedef enum {
+    Mpu6050TriggerMode_Off,
+    Mpu6050TriggerMode_Auto,   // Re-arms after every capture
+    Mpu6050TriggerMode_Single, // Disarms after one capture
+    Mpu6050TriggerMode_Count
+} Mpu6050TriggerMode;
+
+typedef enum {
+    Mpu6050TriggerSource_X,
+    Mpu6050TriggerSource_Y,
+    Mpu6050TriggerSource_Z,
+    Mpu6050TriggerSource_Magnitude,
+    Mpu6050TriggerSource_Count
+} Mpu6050TriggerSource;
+
+typedef enum {
+    Mpu6050TriggerEdge_Rising,
+    Mpu6050TriggerEdge_Falling,
+    Mpu6050TriggerEdge_Count
+} Mpu6050TriggerEdge;
+
+typedef struct {
+    uint8_t mode;        // Mpu6050TriggerMode
+    uint8_t source;      // Mpu6050TriggerSource
+    uint8_t edge;        // Mpu6050TriggerEdge
+    int32_t level_mg;    // Threshold, milli-g
+    uint16_t pre_ms;     // History kept ahead of the trigger
+    uint16_t holdoff_ms; // Dead time after a trigger
+} Mpu6050TriggerConfig;
+
+typedef enum {
+    Mpu6050EventState_Free,
+    Mpu6050EventState_Capturing,
+    Mpu6050EventState_Done,
+} Mpu6050EventState;
+
+typedef struct {
+    int16_t acc[3][MPU6050_EVENT_SAMPLES]; // Raw accelerometer counts X, Y, Z
+    uint32_t timestamp_us; // Trigger sample
+    uint32_t number;       // Trigger number; orders the pool
+    uint16_t pre_samples;  // Samples ahead of the trigger sample
+    uint16_t count;        // Captured samples; short if the FSR changed mid-capture
+    uint16_t period_us;
+    int32_t level;         // Threshold in counts at accel_fsr
+    uint8_t accel_fsr;
+    uint8_t source;        // Mpu6050TriggerSource
+    uint8_t edge;          // Mpu6050TriggerEdge
+    uint8_t state;         // Mpu6050EventState
+} Mpu6050Event;
+
+typedef struct {
+    Mpu6050TriggerConfig config;
+    uint16_t sample_rate_hz;
+
+    // Config resolved against the current FSR and sample rate
+    uint8_t accel_fsr;
+    int32_t level;            // Counts
+    uint32_t pre_samples;
+    uint32_t holdoff_samples;
+
+    // Recent samples, indexed by sample number
+    int16_t history[3][MPU6050_TRIGGER_HISTORY];
+    uint32_t sample;          // Samples seen since the last reset
+    uint32_t history_fill;    // Valid samples in history, up to HISTORY
+    int32_t previous;         // Source value of the previous sample
+    bool armed;
+    uint32_t rearm_sample;    // First sample a new trigger may fire on
+
+    Mpu6050Event events[MPU6050_EVENT_POOL];
+    Mpu6050Event* capture;    // Event being filled, NULL when none
+    uint32_t triggers;        // Triggers fired, captured or not
+    uint32_t missed;          // Triggers that found the pool full
+} Mpu6050Trigger;
+
+// Clears the pool and arms with `config` (level etc. resolved on the first block)
+void mpu6050_trigger_init(Mpu6050Trigger* trigger, const Mpu6050TriggerConfig& config, uint16_t sample_rate_hz);
+
+// Applies a new configuration and re-arms; an event being captured is dropped,
+// finished events are kept
+void mpu6050_trigger_configure(Mpu6050Trigger* trigger, const Mpu6050TriggerConfig& config);
+
+// Runs the trigger over every sample of `block`; O(1) per sample apart from the
+// pre-trigger copy when a trigger fires
+void mpu6050_trigger_push(Mpu6050Trigger* trigger, const Mpu6050SampleBlock* block);
+
+// Finished events, oldest first
+uint32_t mpu6050_trigger_event_count(const Mpu6050Trigger* trigger);
+const Mpu6050Event* mpu6050_trigger_event(const Mpu6050Trigger* trigger, uint32_t index);
+void mpu6050_trigger_delete(Mpu6050Trigger* trigger, uint32_t index);
+
+// Value of the event's trigger source at sample `n`, in counts
+int32_t mpu6050_event_value(const Mpu6050Event* event, uint32_t n);
+
+// Largest absolute value of the trigger source over the event, in counts
+int32_t mpu6050_event_peak(const Mpu6050Event* event);
+
+// Export of the finished events to the next free events_NNN.csv in the log
+// directory. Finding the name and writing some 36 kB take far longer than a
+// frame, so a thread of its own does both, from a copy of the events taken at
+// the start; the caller keeps consuming samples meanwhile.
+
+#define MPU6050_EVENT_EXPORT_STACK_SIZE 2048
+
+typedef struct {
+    Mpu6050Event* events; // Copy, oldest first; allocated while an export runs
+    uint32_t count;
+    char path[64];        // File written
+    FuriThread* thread;
+    std::atomic<bool> done;
+    bool ok;
+} Mpu6050EventExport;
+
+// Copies the finished events of `trigger` and starts writing them; false while
+// the previous export is still running. The caller guards `trigger`.
+bool mpu6050_event_export_start(Mpu6050EventExport* exporter, const Mpu6050Trigger* trigger);
+
+// Once the export has finished, frees it and returns 1 if the file was saved or
+// -1 on a storage error; 0 while it runs or when none was started
+int8_t mpu6050_event_export_poll(Mpu6050EventExport* exporter);
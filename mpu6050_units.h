@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include "mpu6050.h"
+
+// Fixed-point unit conversion. Samples stay raw int16 counts through every
+// processing stage; these helpers turn counts into milli-g, milli-deg/s and
+// centi-deg C only where a value is shown or exported.
+
+// Accel: 1 g is 16384 >> fsr counts, so counts -> mg is a multiply and a shift
+static constexpr uint8_t mpu6050_accel_shift[Mpu6050AccelFsr_Count] = {14, 13, 12, 11};
+
+static_assert(
+    (1 << mpu6050_accel_shift[Mpu6050AccelFsr_4g]) == mpu6050_accel_lsb_per_g[Mpu6050AccelFsr_4g],
+    "accel shift table out of sync with the sensitivity table");
+
+static inline int32_t mpu6050_accel_counts_to_mg(int32_t counts, uint8_t fsr) {
+    return (counts * 1000) >> mpu6050_accel_shift[fsr & 0x03];
+}
+
+// Gyro: LSB per deg/s is not a power of two (131, 65.5, 32.8, 16.4), so the scale
+// is a Q16 multiplier resolved at compile time
+static constexpr int32_t mpu6050_gyro_mdps_q16(uint8_t fsr) {
+    return static_cast<int32_t>(
+        (10000LL * 65536 + mpu6050_gyro_lsb_per_dps_x10[fsr] / 2) / mpu6050_gyro_lsb_per_dps_x10[fsr]);
+}
+
+static constexpr int32_t mpu6050_gyro_scale_q16[Mpu6050GyroFsr_Count] = {
+    mpu6050_gyro_mdps_q16(Mpu6050GyroFsr_250),
+    mpu6050_gyro_mdps_q16(Mpu6050GyroFsr_500),
+    mpu6050_gyro_mdps_q16(Mpu6050GyroFsr_1000),
+    mpu6050_gyro_mdps_q16(Mpu6050GyroFsr_2000),
+};
+
+static inline int32_t mpu6050_gyro_counts_to_mdps(int32_t counts, uint8_t fsr) {
+    return static_cast<int32_t>((static_cast<int64_t>(counts) * mpu6050_gyro_scale_q16[fsr & 0x03]) >> 16);
+}
+
+// Temperature: centi-deg C = raw * 100 / LSB-per-C + offset, per part
+template <Mpu6050Variant Variant>
+static inline int32_t mpu6050_temp_counts_to_centi_c(int32_t counts) {
+    typedef Mpu6050Traits<Variant> Traits;
+    constexpr int32_t scale_q16 = static_cast<int32_t>(100.0f * 65536.0f / Traits::temp_lsb_per_c + 0.5f);
+    constexpr int32_t offset = static_cast<int32_t>(Traits::temp_offset_c * 100.0f + 0.5f);
+    return ((counts * scale_q16) >> 16) + offset;
+}
+
+// Smallest and largest value of an int16 row; a plain reduction the compiler
+// vectorises on the host
+static inline void mpu6050_row_range(const int16_t* row, uint32_t count, int16_t* min, int16_t* max) {
+    int16_t lo = INT16_MAX;
+    int16_t hi = INT16_MIN;
+    for (uint32_t i = 0; i < count; i++) {
+        lo = row[i] < lo ? row[i] : lo;
+        hi = row[i] > hi ? row[i] : hi;
+    }
+    *min = lo;
+    *max = hi;
+}
+
+// Largest absolute value of an int16 row, in counts (int32: |INT16_MIN| fits)
+static inline int32_t mpu6050_row_peak(const int16_t* row, uint32_t count) {
+    int16_t lo;
+    int16_t hi;
+    mpu6050_row_range(row, count, &lo, &hi);
+    int32_t peak = -static_cast<int32_t>(lo);
+    return hi > peak ? hi : peak;
+}
+
+// Integer square roots (bit-by-bit, no division), for magnitudes, RMS and amplitudes
+static inline uint32_t mpu6050_isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(result);
+}
+
+static inline uint32_t mpu6050_isqrt32(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Zigzag varints for sample deltas, shared by the recording and streaming formats.
+// Small differences of either sign take one byte; the difference of two int16
+// values fits in 17 bits, i.e. at most MPU6050_VARINT_MAX bytes.
+
+#define MPU6050_VARINT_MAX 3
+
+static inline uint32_t zigzag_encode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static inline int32_t zigzag_decode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+static inline uint8_t* put_varint(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+// Returns NULL on a truncated or over-long varint
+static inline const uint8_t* get_varint(const uint8_t* in, const uint8_t* end, uint32_t* value) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 7 * MPU6050_VARINT_MAX; shift += 7) {
+        if (in == end) return NULL;
+        uint8_t byte = *in++;
+        result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return in;
+        }
+    }
+    return NULL;
+}